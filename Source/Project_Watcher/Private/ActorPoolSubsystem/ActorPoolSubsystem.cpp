@@ -0,0 +1,403 @@
+//Project Watcher 2024 & Beyond
+
+#include "ActorPoolSubsystem.h"
+#include "PooledActorInterface.h"
+#include "Components/ActorComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "GameFramework/MovementComponent.h"
+#include "GameFramework/Pawn.h"
+#include "HAL/IConsoleManager.h"
+#include "UObject/UObjectGlobals.h"
+
+DECLARE_LOG_CATEGORY_EXTERN(LogActorPool, Log, All);
+DEFINE_LOG_CATEGORY(LogActorPool);
+
+DECLARE_STATS_GROUP(TEXT("ActorPool"), STATGROUP_ActorPool, STATCAT_Advanced);
+DECLARE_CYCLE_STAT(TEXT("Acquire"), STAT_ActorPool_Acquire, STATGROUP_ActorPool);
+DECLARE_CYCLE_STAT(TEXT("Release"), STAT_ActorPool_Release, STATGROUP_ActorPool);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pooled Actors In Use"), STAT_ActorPool_InUse, STATGROUP_ActorPool);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pooled Actors Available"), STAT_ActorPool_Available, STATGROUP_ActorPool);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Pool Misses"), STAT_ActorPool_Misses, STATGROUP_ActorPool);
+
+const FName UActorPoolSubsystem::PooledActorTag(TEXT("ActorPool.Pooled"));
+
+void UActorPoolSubsystem::Deinitialize()
+{
+	this->LogPoolStats();
+	this->Pools.Empty();
+	Super::Deinitialize();
+}
+
+void UActorPoolSubsystem::PrewarmPool(TSubclassOf<AActor> ActorClass, const int32 Count)
+{
+	UWorld* World = GetWorld();
+	if (!World || !this->CanPoolClass(ActorClass))
+	{
+		return;
+	}
+
+	FActorPool& Pool = this->Pools.FindOrAdd(ActorClass);
+	const int32 TargetCount = FMath::Min(Count, this->MaxPooledActorsPerClass);
+	while (Pool.Available.Num() < TargetCount)
+	{
+		AActor* Actor = this->SpawnPooledActor(World, ActorClass);
+		if (!Actor)
+		{
+			break;
+		}
+		Pool.Available.Add(Actor);
+		Pool.Stats.Available = Pool.Available.Num();
+		INC_DWORD_STAT(STAT_ActorPool_Available);
+	}
+}
+
+AActor* UActorPoolSubsystem::AcquireActor(TSubclassOf<AActor> ActorClass, const FTransform& Transform, AActor* Owner, APawn* Instigator)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ActorPool_Acquire);
+
+	UWorld* World = GetWorld();
+	if (!World || !ActorClass)
+	{
+		return nullptr;
+	}
+
+	if (!this->CanPoolClass(ActorClass))
+	{
+		//Not poolable here, behave like a regular spawn so callers don't need a second path
+		FActorSpawnParameters SpawnParameters;
+		SpawnParameters.Owner = Owner;
+		SpawnParameters.Instigator = Instigator;
+		SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		return World->SpawnActor<AActor>(ActorClass, Transform, SpawnParameters);
+	}
+
+	FActorPool& Pool = this->Pools.FindOrAdd(ActorClass);
+
+	AActor* Actor = nullptr;
+	while (!Actor && !Pool.Available.IsEmpty())
+	{
+		//Parked actors can still be killed by level teardown, skip anything that isn't usable
+		AActor* Candidate = Pool.Available.Pop(EAllowShrinking::No);
+		DEC_DWORD_STAT(STAT_ActorPool_Available);
+		if (IsValid(Candidate))
+		{
+			Actor = Candidate;
+		}
+	}
+
+	if (Actor)
+	{
+		Pool.Stats.Hits++;
+	}
+	else
+	{
+		Actor = this->SpawnPooledActor(World, ActorClass);
+		if (!Actor)
+		{
+			return nullptr;
+		}
+		Pool.Stats.Misses++;
+		INC_DWORD_STAT(STAT_ActorPool_Misses);
+	}
+
+	Pool.InUse.Add(Actor);
+	Pool.Stats.InUse = Pool.InUse.Num();
+	Pool.Stats.Available = Pool.Available.Num();
+	Pool.Stats.PeakInUse = FMath::Max(Pool.Stats.PeakInUse, Pool.Stats.InUse);
+	INC_DWORD_STAT(STAT_ActorPool_InUse);
+
+	this->UnparkActor(Actor, Transform, Owner, Instigator);
+	return Actor;
+}
+
+bool UActorPoolSubsystem::ReleaseActor(AActor* Actor)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ActorPool_Release);
+
+	if (!IsValid(Actor))
+	{
+		return false;
+	}
+
+	FActorPool* Pool = this->Pools.Find(Actor->GetClass());
+	if (!Pool || !Pool->InUse.Contains(Actor))
+	{
+		UE_LOG(LogActorPool, Verbose, TEXT("%s was not acquired from a pool, destroying instead"), *GetNameSafe(Actor));
+		Actor->Destroy();
+		return false;
+	}
+
+	Pool->InUse.Remove(Actor);
+	Pool->Stats.InUse = Pool->InUse.Num();
+	DEC_DWORD_STAT(STAT_ActorPool_InUse);
+
+	if (Pool->Available.Num() >= this->MaxPooledActorsPerClass)
+	{
+		Pool->Stats.Overflows++;
+		Actor->OnDestroyed.RemoveDynamic(this, &ThisClass::OnPooledActorDestroyed);
+		Actor->Destroy();
+		return false;
+	}
+
+	this->ParkActor(Actor);
+	Pool->Available.Add(Actor);
+	Pool->Stats.Available = Pool->Available.Num();
+	INC_DWORD_STAT(STAT_ActorPool_Available);
+	return true;
+}
+
+void UActorPoolSubsystem::DrainPool(TSubclassOf<AActor> ActorClass)
+{
+	FActorPool* Pool = this->Pools.Find(ActorClass);
+	if (!Pool)
+	{
+		return;
+	}
+
+	//Copy out first, Destroy fires OnPooledActorDestroyed which edits the pool
+	TArray<TObjectPtr<AActor>> ToDestroy = MoveTemp(Pool->Available);
+	Pool->Available.Reset();
+	Pool->Stats.Available = 0;
+	DEC_DWORD_STAT_BY(STAT_ActorPool_Available, ToDestroy.Num());
+
+	for (AActor* Actor : ToDestroy)
+	{
+		if (IsValid(Actor))
+		{
+			Actor->OnDestroyed.RemoveDynamic(this, &ThisClass::OnPooledActorDestroyed);
+			Actor->Destroy();
+		}
+	}
+}
+
+FActorPoolStats UActorPoolSubsystem::GetPoolStats(TSubclassOf<AActor> ActorClass) const
+{
+	if (const FActorPool* Pool = this->Pools.Find(ActorClass))
+	{
+		return Pool->Stats;
+	}
+	return FActorPoolStats();
+}
+
+void UActorPoolSubsystem::LogPoolStats() const
+{
+	for (const TPair<TSubclassOf<AActor>, FActorPool>& Pair : this->Pools)
+	{
+		const FActorPoolStats& Stats = Pair.Value.Stats;
+		const int32 Requests = Stats.Hits + Stats.Misses;
+		const float HitRate = Requests > 0 ? static_cast<float>(Stats.Hits) / Requests * 100.f : 0.f;
+		UE_LOG(LogActorPool, Display, TEXT("%s: InUse %d, Available %d, Peak %d, Hits %d, Misses %d (%.1f%% hit rate), Overflows %d"),
+			*GetNameSafe(Pair.Key), Stats.InUse, Stats.Available, Stats.PeakInUse, Stats.Hits, Stats.Misses, HitRate, Stats.Overflows);
+	}
+}
+
+AActor* UActorPoolSubsystem::SpawnPooledActor(UWorld* World, TSubclassOf<AActor> ActorClass)
+{
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	SpawnParameters.ObjectFlags |= RF_Transient;
+	//Tagged before OnActorSpawned fires, spawn listeners already see it as pooled
+	SpawnParameters.CustomPreSpawnInitalization = [](AActor* Actor)
+	{
+		Actor->Tags.AddUnique(PooledActorTag);
+	};
+
+	AActor* Actor = World->SpawnActor<AActor>(ActorClass, FTransform::Identity, SpawnParameters);
+	if (!Actor)
+	{
+		UE_LOG(LogActorPool, Warning, TEXT("Failed to spawn pooled actor of class %s"), *GetNameSafe(ActorClass));
+		return nullptr;
+	}
+
+	Actor->OnDestroyed.AddUniqueDynamic(this, &ThisClass::OnPooledActorDestroyed);
+	this->ParkActor(Actor);
+	return Actor;
+}
+
+void UActorPoolSubsystem::ParkActor(AActor* Actor) const
+{
+	if (Actor->Implements<UPooledActorInterface>())
+	{
+		IPooledActorInterface::Execute_OnReleasedToPool(Actor);
+	}
+
+	Actor->SetActorHiddenInGame(true);
+	Actor->SetActorEnableCollision(false);
+	Actor->SetActorTickEnabled(false);
+
+	for (UActorComponent* Component : Actor->GetComponents())
+	{
+		if (UMovementComponent* MovementComponent = Cast<UMovementComponent>(Component))
+		{
+			MovementComponent->StopMovementImmediately();
+		}
+		Component->SetComponentTickEnabled(false);
+	}
+
+	if (Actor->GetIsReplicated() && Actor->HasAuthority())
+	{
+		//Send the hidden state once, then stop considering the actor for replication while it sits in the pool
+		Actor->ForceNetUpdate();
+		Actor->SetNetDormancy(DORM_DormantAll);
+	}
+}
+
+void UActorPoolSubsystem::UnparkActor(AActor* Actor, const FTransform& Transform, AActor* Owner, APawn* Instigator) const
+{
+	if (Actor->GetIsReplicated() && Actor->HasAuthority())
+	{
+		Actor->SetNetDormancy(DORM_Awake);
+	}
+
+	Actor->SetOwner(Owner);
+	Actor->SetInstigator(Instigator);
+	Actor->SetActorTransform(Transform, false, nullptr, ETeleportType::ResetPhysics);
+	Actor->SetActorHiddenInGame(false);
+	Actor->SetActorEnableCollision(true);
+	Actor->SetActorTickEnabled(Actor->PrimaryActorTick.bStartWithTickEnabled);
+
+	for (UActorComponent* Component : Actor->GetComponents())
+	{
+		Component->SetComponentTickEnabled(Component->PrimaryComponentTick.bStartWithTickEnabled);
+	}
+
+	if (Actor->Implements<UPooledActorInterface>())
+	{
+		IPooledActorInterface::Execute_OnAcquiredFromPool(Actor);
+	}
+
+	if (Actor->GetIsReplicated() && Actor->HasAuthority())
+	{
+		Actor->ForceNetUpdate();
+	}
+}
+
+bool UActorPoolSubsystem::CanPoolClass(TSubclassOf<AActor> ActorClass) const
+{
+	if (!ActorClass || ActorClass->HasAnyClassFlags(CLASS_Abstract))
+	{
+		return false;
+	}
+
+	//Replicated actors are spawned by the server, clients receive them through their channels
+	const AActor* ActorCDO = ActorClass->GetDefaultObject<AActor>();
+	const UWorld* World = GetWorld();
+	if (ActorCDO->GetIsReplicated() && World && World->GetNetMode() == NM_Client)
+	{
+		return false;
+	}
+
+	return true;
+}
+
+void UActorPoolSubsystem::OnPooledActorDestroyed(AActor* DestroyedActor)
+{
+	FActorPool* Pool = this->Pools.Find(DestroyedActor->GetClass());
+	if (!Pool)
+	{
+		return;
+	}
+
+	if (Pool->InUse.Remove(DestroyedActor) > 0)
+	{
+		DEC_DWORD_STAT(STAT_ActorPool_InUse);
+	}
+	if (Pool->Available.Remove(DestroyedActor) > 0)
+	{
+		DEC_DWORD_STAT(STAT_ActorPool_Available);
+	}
+	Pool->Stats.InUse = Pool->InUse.Num();
+	Pool->Stats.Available = Pool->Available.Num();
+}
+
+//Benchmark//
+
+/**
+ * Watcher.ActorPool.Benchmark [ClassPath] [Rounds] [ActorsPerRound]
+ * Runs the same spawn-heavy churn with SpawnActor / Destroy and with the pool, then forces a GC after each
+ * so the log shows both the per-round game thread cost and the garbage each approach leaves behind.
+ */
+static FAutoConsoleCommandWithWorldAndArgs GActorPoolBenchmarkCommand(
+	TEXT("Watcher.ActorPool.Benchmark"),
+	TEXT("Compares SpawnActor/Destroy churn against UActorPoolSubsystem. Args: [ClassPath] [Rounds=50] [ActorsPerRound=200]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		UActorPoolSubsystem* ActorPool = World ? World->GetSubsystem<UActorPoolSubsystem>() : nullptr;
+		if (!ActorPool)
+		{
+			UE_LOG(LogActorPool, Warning, TEXT("No ActorPoolSubsystem in this world"));
+			return;
+		}
+
+		UClass* ActorClass = AActor::StaticClass();
+		if (Args.Num() > 0)
+		{
+			ActorClass = LoadClass<AActor>(nullptr, *Args[0]);
+			if (!ActorClass)
+			{
+				UE_LOG(LogActorPool, Warning, TEXT("Could not load actor class %s"), *Args[0]);
+				return;
+			}
+		}
+		const int32 Rounds = Args.Num() > 1 ? FCString::Atoi(*Args[1]) : 50;
+		const int32 ActorsPerRound = Args.Num() > 2 ? FCString::Atoi(*Args[2]) : 200;
+
+		TArray<AActor*> Live;
+		Live.Reserve(ActorsPerRound);
+
+		//Without pooling
+		double StartTime = FPlatformTime::Seconds();
+		for (int32 Round = 0; Round < Rounds; ++Round)
+		{
+			for (int32 Index = 0; Index < ActorsPerRound; ++Index)
+			{
+				FActorSpawnParameters SpawnParameters;
+				SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+				Live.Add(World->SpawnActor<AActor>(ActorClass, FTransform::Identity, SpawnParameters));
+			}
+			for (AActor* Actor : Live)
+			{
+				if (Actor)
+				{
+					Actor->Destroy();
+				}
+			}
+			Live.Reset();
+		}
+		const double SpawnSeconds = FPlatformTime::Seconds() - StartTime;
+
+		StartTime = FPlatformTime::Seconds();
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+		const double SpawnGCSeconds = FPlatformTime::Seconds() - StartTime;
+
+		//With pooling
+		ActorPool->PrewarmPool(ActorClass, ActorsPerRound);
+		StartTime = FPlatformTime::Seconds();
+		for (int32 Round = 0; Round < Rounds; ++Round)
+		{
+			for (int32 Index = 0; Index < ActorsPerRound; ++Index)
+			{
+				Live.Add(ActorPool->AcquireActor(ActorClass, FTransform::Identity));
+			}
+			for (AActor* Actor : Live)
+			{
+				ActorPool->ReleaseActor(Actor);
+			}
+			Live.Reset();
+		}
+		const double PoolSeconds = FPlatformTime::Seconds() - StartTime;
+
+		StartTime = FPlatformTime::Seconds();
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+		const double PoolGCSeconds = FPlatformTime::Seconds() - StartTime;
+
+		const int32 Total = FMath::Max(Rounds * ActorsPerRound, 1);
+		UE_LOG(LogActorPool, Display, TEXT("Benchmark %s, %d rounds x %d actors"), *GetNameSafe(ActorClass), Rounds, ActorsPerRound);
+		UE_LOG(LogActorPool, Display, TEXT("  Spawn/Destroy: %.2f ms total, %.3f us per actor, GC afterwards %.2f ms"), SpawnSeconds * 1000.0, SpawnSeconds * 1000000.0 / Total, SpawnGCSeconds * 1000.0);
+		UE_LOG(LogActorPool, Display, TEXT("  Pooled:        %.2f ms total, %.3f us per actor, GC afterwards %.2f ms"), PoolSeconds * 1000.0, PoolSeconds * 1000000.0 / Total, PoolGCSeconds * 1000.0);
+		ActorPool->LogPoolStats();
+		ActorPool->DrainPool(ActorClass);
+	}));
+
+//Benchmark//
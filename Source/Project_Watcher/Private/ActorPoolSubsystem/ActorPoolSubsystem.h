@@ -0,0 +1,164 @@
+//Project Watcher 2024 & Beyond
+
+#pragma once
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ActorPoolSubsystem.generated.h"
+
+//Wrapper for BP data//
+
+USTRUCT(BlueprintType)
+struct FActorPoolStats
+{
+	GENERATED_USTRUCT_BODY()
+public:
+	/* Actors currently handed out */
+	UPROPERTY(BlueprintReadOnly, Category = "Actor Pool")
+	int32 InUse = 0;
+	/* Actors parked and ready to be handed out */
+	UPROPERTY(BlueprintReadOnly, Category = "Actor Pool")
+	int32 Available = 0;
+	/* Highest InUse value seen since the pool was created */
+	UPROPERTY(BlueprintReadOnly, Category = "Actor Pool")
+	int32 PeakInUse = 0;
+	/* Acquires served from a parked actor */
+	UPROPERTY(BlueprintReadOnly, Category = "Actor Pool")
+	int32 Hits = 0;
+	/* Acquires that had to fall back to SpawnActor */
+	UPROPERTY(BlueprintReadOnly, Category = "Actor Pool")
+	int32 Misses = 0;
+	/* Releases that were destroyed because the pool was already at MaxPooledActorsPerClass */
+	UPROPERTY(BlueprintReadOnly, Category = "Actor Pool")
+	int32 Overflows = 0;
+};
+
+//Wrapper for BP data//
+
+USTRUCT()
+struct FActorPool
+{
+	GENERATED_USTRUCT_BODY()
+public:
+	/* Parked actors, hidden with collision and tick disabled */
+	UPROPERTY()
+	TArray<TObjectPtr<AActor>> Available;
+
+	/* Actors currently handed out by the pool */
+	UPROPERTY()
+	TSet<TObjectPtr<AActor>> InUse;
+
+	FActorPoolStats Stats;
+};
+
+/**
+ * World subsystem that recycles frequently spawned actors (projectiles, interaction effects, etc.)
+ * instead of going through SpawnActor / Destroy every time.
+ * Replicated actors are only pooled on the authority and are put to DORM_DormantAll while parked.
+ */
+UCLASS(Config=Game)
+class UActorPoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+private:
+	//Settings//
+
+	/* Upper bound of parked actors per class, releases past this get destroyed */
+	UPROPERTY(Config)
+	int32 MaxPooledActorsPerClass = 256;
+
+	/* Pools keyed by the exact class that was requested */
+	UPROPERTY()
+	TMap<TSubclassOf<AActor>, FActorPool> Pools;
+
+	//Settings//
+
+public:
+
+	/* Tag every actor spawned for a pool carries from before its construction, so other systems can leave pooled actors alone */
+	static const FName PooledActorTag;
+
+	//Initialization//
+
+	UActorPoolSubsystem() { }
+
+	virtual void Deinitialize() override;
+
+	//Initialization//
+
+	//Pool Interface calls//
+
+	/**
+	 * Spawns parked actors ahead of need so the first acquires don't hitch
+	 * @param ActorClass The class to pre-warm
+	 * @param Count Amount of parked actors the pool should hold after this call
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure=false, Category = "Actor Pool")
+	void PrewarmPool(TSubclassOf<AActor> ActorClass, const int32 Count);
+
+	/**
+	 * Hands out an actor of the given class, spawning one if the pool is empty
+	 * @param ActorClass The class we want an instance of
+	 * @param Transform Where the actor should be placed
+	 * @param Owner Owner applied to the actor
+	 * @param Instigator Instigator applied to the actor
+	 * @return The acquired actor or nullptr if it could not be spawned
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure=false, Category = "Actor Pool", meta = (DeterminesOutputType = "ActorClass"))
+	AActor* AcquireActor(TSubclassOf<AActor> ActorClass, const FTransform& Transform, AActor* Owner = nullptr, APawn* Instigator = nullptr);
+
+	template<typename T>
+	T* AcquireActor(const FTransform& Transform, AActor* Owner = nullptr, APawn* Instigator = nullptr)
+	{
+		return Cast<T>(this->AcquireActor(T::StaticClass(), Transform, Owner, Instigator));
+	}
+
+	/**
+	 * Returns an actor to its pool, actors that weren't acquired from a pool get destroyed
+	 * @param Actor The actor to park
+	 * @return If the actor was parked (false means it got destroyed)
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure=false, Category = "Actor Pool")
+	bool ReleaseActor(AActor* Actor);
+
+	/**
+	 * Destroys every parked actor of the given class, in use actors are left alone
+	 * @param ActorClass The pool to drain
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure=false, Category = "Actor Pool")
+	void DrainPool(TSubclassOf<AActor> ActorClass);
+
+	/**
+	 * Occupancy / miss stats for a single pool
+	 * @param ActorClass The pool to query
+	 * @return The stats, zeroed if no pool exists yet
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Actor Pool")
+	FActorPoolStats GetPoolStats(TSubclassOf<AActor> ActorClass) const;
+
+	/* Logs the stats of every pool */
+	void LogPoolStats() const;
+
+	//Pool Interface calls//
+
+private:
+
+	//Pool internals//
+
+	/* Spawns a new actor for the given pool, already parked */
+	AActor* SpawnPooledActor(UWorld* World, TSubclassOf<AActor> ActorClass);
+
+	/* Hides the actor, disables collision / tick and puts it to sleep on the network */
+	void ParkActor(AActor* Actor) const;
+
+	/* Reverses ParkActor and places the actor at Transform */
+	void UnparkActor(AActor* Actor, const FTransform& Transform, AActor* Owner, APawn* Instigator) const;
+
+	/* Whether this world is allowed to pool the given class */
+	bool CanPoolClass(TSubclassOf<AActor> ActorClass) const;
+
+	/* Keeps the pool consistent when something calls Destroy on a pooled actor */
+	UFUNCTION()
+	void OnPooledActorDestroyed(AActor* DestroyedActor);
+
+	//Pool internals//
+};
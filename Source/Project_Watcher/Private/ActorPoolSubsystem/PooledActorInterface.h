@@ -0,0 +1,35 @@
+//Project Watcher 2024 & Beyond
+
+#pragma once
+#include "CoreMinimal.h"
+#include "UObject/Interface.h"
+#include "PooledActorInterface.generated.h"
+
+UINTERFACE(MinimalAPI, Blueprintable)
+class UPooledActorInterface : public UInterface
+{
+	GENERATED_BODY()
+};
+
+/**
+ * Optional reset hooks for actors handed out by UActorPoolSubsystem.
+ * Actors that don't implement this are still poolable, they just get the default park / unpark handling.
+ */
+class IPooledActorInterface
+{
+	GENERATED_BODY()
+public:
+	/**
+	 * Called after the actor has been taken out of the pool and moved to its spawn transform
+	 * Use this in place of BeginPlay for per-use state
+	 */
+	UFUNCTION(BlueprintNativeEvent, Category = "Actor Pool")
+	void OnAcquiredFromPool();
+
+	/**
+	 * Called before the actor is parked back in the pool
+	 * Use this in place of EndPlay / Destroyed to clear timers, effects and references
+	 */
+	UFUNCTION(BlueprintNativeEvent, Category = "Actor Pool")
+	void OnReleasedToPool();
+};
@@ -0,0 +1,56 @@
+//Project Watcher 2024 & Beyond
+
+#pragma once
+#include "CoreMinimal.h"
+#include "MassEntityTypes.h"
+#include "AmbientCrowdFragments.generated.h"
+
+/* How an ambient entity is currently drawn, picked every frame from the distance to the closest local viewer */
+enum class EAmbientCrowdLOD : uint8
+{
+	/* Full actor, limited to MaxNearActors */
+	Near,
+	/* One instance in the crowd ISM */
+	Far,
+	/* Simulated at a reduced rate, not drawn */
+	Off
+};
+
+/* Marks entities owned by UAmbientCrowdSubsystem */
+USTRUCT()
+struct FAmbientCrowdTag : public FMassTag
+{
+	GENERATED_BODY()
+};
+
+/* Wander state, advanced by UAmbientCrowdMovementProcessor */
+USTRUCT()
+struct FAmbientAgentFragment : public FMassFragment
+{
+	GENERATED_BODY()
+public:
+	/* Ground traced spawn point, targets are picked around it */
+	FVector Home = FVector::ZeroVector;
+	FVector Target = FVector::ZeroVector;
+	FVector Velocity = FVector::ZeroVector;
+	float Speed = 0.f;
+	/* Time not yet simulated because of the LOD update interval */
+	float AccumulatedTime = 0.f;
+	/* Per entity random stream seed, keeps every peer's crowd identical without replication */
+	int32 Seed = 0;
+	/* Spreads reduced rate updates over the interval instead of stepping every entity on the same frame */
+	uint8 UpdatePhase = 0;
+	/* Target was picked off the game thread and still needs its height from a ground trace */
+	bool bNeedsGroundTrace = false;
+};
+
+/* Representation state, owned by the game thread */
+USTRUCT()
+struct FAmbientRepresentationFragment : public FMassFragment
+{
+	GENERATED_BODY()
+public:
+	/* Actor borrowed from UAmbientCrowdSubsystem while Near */
+	TWeakObjectPtr<AActor> Actor;
+	EAmbientCrowdLOD LOD = EAmbientCrowdLOD::Off;
+};
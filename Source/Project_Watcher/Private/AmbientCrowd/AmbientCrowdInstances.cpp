@@ -0,0 +1,19 @@
+//Project Watcher 2024 & Beyond
+
+#include "AmbientCrowdInstances.h"
+#include "Components/InstancedStaticMeshComponent.h"
+
+AAmbientCrowdInstances::AAmbientCrowdInstances()
+{
+	PrimaryActorTick.bCanEverTick = false;
+
+	bReplicates = false;
+
+	CrowdInstances = CreateDefaultSubobject<UInstancedStaticMeshComponent>(TEXT("CrowdInstances"));
+	CrowdInstances->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	CrowdInstances->SetCanEverAffectNavigation(false);
+	CrowdInstances->SetMobility(EComponentMobility::Movable);
+	//Far away the shadows cost more than they add
+	CrowdInstances->SetCastShadow(false);
+	RootComponent = CrowdInstances;
+}
@@ -0,0 +1,28 @@
+//Project Watcher 2024 & Beyond
+
+#pragma once
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "AmbientCrowdInstances.generated.h"
+
+class UInstancedStaticMeshComponent;
+
+/**
+ * Local only actor owning the instanced mesh every Far ambient entity is drawn with.
+ * Spawned by UAmbientCrowdSubsystem, never replicated.
+ */
+UCLASS(NotPlaceable, Transient)
+class AAmbientCrowdInstances : public AActor
+{
+	GENERATED_BODY()
+private:
+	/* One instance per Far entity, rebuilt every frame */
+	UPROPERTY(VisibleAnywhere, Category = "Ambient Crowd")
+	TObjectPtr<UInstancedStaticMeshComponent> CrowdInstances;
+
+public:
+	AAmbientCrowdInstances();
+
+	/* Returns the instanced mesh used for Far entities */
+	UInstancedStaticMeshComponent* GetCrowdInstances() const { return this->CrowdInstances; }
+};
@@ -0,0 +1,145 @@
+//Project Watcher 2024 & Beyond
+
+#include "AmbientCrowdProcessors.h"
+#include "AmbientCrowdFragments.h"
+#include "AmbientCrowdSubsystem.h"
+#include "MassCommonFragments.h"
+#include "MassCommonTypes.h"
+#include "MassExecutionContext.h"
+#include "Engine/World.h"
+
+namespace AmbientCrowd
+{
+	/* Walks the agent towards its target, picks the next one from its own stream once reached */
+	static void StepAgent(FTransform& Transform, FAmbientAgentFragment& Agent, const float WanderRadius)
+	{
+		FVector Location = Transform.GetLocation();
+		const FVector ToTarget(Agent.Target.X - Location.X, Agent.Target.Y - Location.Y, 0.f);
+		const float Distance = ToTarget.Size();
+		const float Step = Agent.Speed * Agent.AccumulatedTime;
+		Agent.AccumulatedTime = 0.f;
+
+		if (Distance <= Step || Distance <= KINDA_SMALL_NUMBER)
+		{
+			Location = Agent.Target;
+
+			FRandomStream Random(Agent.Seed);
+			const float Angle = Random.FRandRange(0.f, UE_TWO_PI);
+			const float Radius = Random.FRandRange(0.25f, 1.f) * WanderRadius;
+			Agent.Seed = Random.GetCurrentSeed();
+			Agent.Target = Agent.Home + FVector(FMath::Cos(Angle) * Radius, FMath::Sin(Angle) * Radius, 0.f);
+			Agent.bNeedsGroundTrace = true;
+			Agent.Velocity = FVector::ZeroVector;
+		}
+		else
+		{
+			const FVector Direction = ToTarget / Distance;
+			Location.X += Direction.X * Step;
+			Location.Y += Direction.Y * Step;
+			Location.Z = FMath::Lerp(Location.Z, Agent.Target.Z, Step / Distance);
+			Agent.Velocity = Direction * Agent.Speed;
+			Transform.SetRotation(FRotator(0.f, Direction.Rotation().Yaw, 0.f).Quaternion());
+		}
+
+		Transform.SetLocation(Location);
+	}
+}
+
+UAmbientCrowdMovementProcessor::UAmbientCrowdMovementProcessor()
+	: EntityQuery(*this)
+{
+	//Cosmetic only, dedicated servers never create UAmbientCrowdSubsystem so there is nothing to query there
+	ExecutionFlags = static_cast<int32>(EProcessorExecutionFlags::Standalone | EProcessorExecutionFlags::Client | EProcessorExecutionFlags::Server);
+	ProcessingPhase = EMassProcessingPhase::PrePhysics;
+	ExecutionOrder.ExecuteInGroup = UE::Mass::ProcessorGroupNames::Movement;
+}
+
+void UAmbientCrowdMovementProcessor::ConfigureQueries()
+{
+	EntityQuery.AddRequirement<FTransformFragment>(EMassFragmentAccess::ReadWrite);
+	EntityQuery.AddRequirement<FAmbientAgentFragment>(EMassFragmentAccess::ReadWrite);
+	EntityQuery.AddRequirement<FAmbientRepresentationFragment>(EMassFragmentAccess::ReadOnly);
+	EntityQuery.AddTagRequirement<FAmbientCrowdTag>(EMassFragmentPresence::All);
+}
+
+void UAmbientCrowdMovementProcessor::Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context)
+{
+	UAmbientCrowdSubsystem* AmbientCrowd = EntityManager.GetWorld() ? EntityManager.GetWorld()->GetSubsystem<UAmbientCrowdSubsystem>() : nullptr;
+	if (!AmbientCrowd || !AmbientCrowd->HasEntities())
+	{
+		return;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+	const FAmbientCrowdSimulationParams Params = AmbientCrowd->GetSimulationParams();
+	const float DeltaTime = Context.GetDeltaTimeSeconds();
+
+	EntityQuery.ParallelForEachEntityChunk(EntityManager, Context, [&Params, DeltaTime](FMassExecutionContext& ChunkContext)
+	{
+		const TArrayView<FTransformFragment> Transforms = ChunkContext.GetMutableFragmentView<FTransformFragment>();
+		const TArrayView<FAmbientAgentFragment> Agents = ChunkContext.GetMutableFragmentView<FAmbientAgentFragment>();
+		const TConstArrayView<FAmbientRepresentationFragment> Representations = ChunkContext.GetFragmentView<FAmbientRepresentationFragment>();
+
+		for (int32 Index = 0; Index < ChunkContext.GetNumEntities(); ++Index)
+		{
+			FAmbientAgentFragment& Agent = Agents[Index];
+			Agent.AccumulatedTime += DeltaTime;
+
+			const EAmbientCrowdLOD LOD = Representations[Index].LOD;
+			const uint32 Interval = LOD == EAmbientCrowdLOD::Near ? 1 : LOD == EAmbientCrowdLOD::Far ? Params.FarUpdateInterval : Params.OffUpdateInterval;
+			if ((Params.FrameCounter + Agent.UpdatePhase) % Interval != 0)
+			{
+				continue;
+			}
+
+			AmbientCrowd::StepAgent(Transforms[Index].GetMutableTransform(), Agent, Params.WanderRadius);
+		}
+	});
+
+	AmbientCrowd->RecordProcessorTime(FPlatformTime::Seconds() - StartTime);
+}
+
+UAmbientCrowdRepresentationProcessor::UAmbientCrowdRepresentationProcessor()
+	: EntityQuery(*this)
+{
+	ExecutionFlags = static_cast<int32>(EProcessorExecutionFlags::Standalone | EProcessorExecutionFlags::Client | EProcessorExecutionFlags::Server);
+	ProcessingPhase = EMassProcessingPhase::PostPhysics;
+	ExecutionOrder.ExecuteInGroup = UE::Mass::ProcessorGroupNames::Representation;
+	//Touches actors and the ISM
+	bRequiresGameThreadExecution = true;
+}
+
+void UAmbientCrowdRepresentationProcessor::ConfigureQueries()
+{
+	EntityQuery.AddRequirement<FTransformFragment>(EMassFragmentAccess::ReadOnly);
+	EntityQuery.AddRequirement<FAmbientAgentFragment>(EMassFragmentAccess::ReadWrite);
+	EntityQuery.AddRequirement<FAmbientRepresentationFragment>(EMassFragmentAccess::ReadWrite);
+	EntityQuery.AddTagRequirement<FAmbientCrowdTag>(EMassFragmentPresence::All);
+}
+
+void UAmbientCrowdRepresentationProcessor::Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context)
+{
+	UAmbientCrowdSubsystem* AmbientCrowd = EntityManager.GetWorld() ? EntityManager.GetWorld()->GetSubsystem<UAmbientCrowdSubsystem>() : nullptr;
+	if (!AmbientCrowd || !AmbientCrowd->HasEntities())
+	{
+		return;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+	AmbientCrowd->BeginRepresentation();
+
+	EntityQuery.ForEachEntityChunk(EntityManager, Context, [AmbientCrowd](FMassExecutionContext& ChunkContext)
+	{
+		const TConstArrayView<FTransformFragment> Transforms = ChunkContext.GetFragmentView<FTransformFragment>();
+		const TArrayView<FAmbientAgentFragment> Agents = ChunkContext.GetMutableFragmentView<FAmbientAgentFragment>();
+		const TArrayView<FAmbientRepresentationFragment> Representations = ChunkContext.GetMutableFragmentView<FAmbientRepresentationFragment>();
+
+		for (int32 Index = 0; Index < ChunkContext.GetNumEntities(); ++Index)
+		{
+			AmbientCrowd->UpdateRepresentation(Transforms[Index].GetTransform(), Agents[Index], Representations[Index]);
+		}
+	});
+
+	AmbientCrowd->EndRepresentation();
+	AmbientCrowd->RecordProcessorTime(FPlatformTime::Seconds() - StartTime);
+}
@@ -0,0 +1,48 @@
+//Project Watcher 2024 & Beyond
+
+#pragma once
+#include "CoreMinimal.h"
+#include "MassProcessor.h"
+#include "MassEntityQuery.h"
+#include "AmbientCrowdProcessors.generated.h"
+
+/**
+ * Moves every ambient entity towards its wander target.
+ * Runs on workers, Near entities step every frame while Far / Off entities step
+ * every FarUpdateInterval / OffUpdateInterval frames with the accumulated time.
+ */
+UCLASS()
+class UAmbientCrowdMovementProcessor : public UMassProcessor
+{
+	GENERATED_BODY()
+private:
+	FMassEntityQuery EntityQuery;
+
+public:
+	UAmbientCrowdMovementProcessor();
+
+protected:
+	virtual void ConfigureQueries() override;
+
+	virtual void Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context) override;
+};
+
+/**
+ * Picks each ambient entity's LOD and hands it to UAmbientCrowdSubsystem,
+ * which moves the borrowed actors and rebuilds the far ISM. Game thread only.
+ */
+UCLASS()
+class UAmbientCrowdRepresentationProcessor : public UMassProcessor
+{
+	GENERATED_BODY()
+private:
+	FMassEntityQuery EntityQuery;
+
+public:
+	UAmbientCrowdRepresentationProcessor();
+
+protected:
+	virtual void ConfigureQueries() override;
+
+	virtual void Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context) override;
+};
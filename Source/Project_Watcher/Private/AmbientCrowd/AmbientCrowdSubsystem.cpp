@@ -0,0 +1,667 @@
+//Project Watcher 2024 & Beyond
+
+#include "AmbientCrowdSubsystem.h"
+#include "AmbientCrowdFragments.h"
+#include "AmbientCrowdInstances.h"
+#include "Components/CapsuleComponent.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/PawnMovementComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+#include "MassCommonFragments.h"
+#include "MassEntityManager.h"
+#include "MassEntitySubsystem.h"
+#include "WorldPartition/WorldPartition.h"
+#include "WorldPartition/WorldPartitionRuntimeCell.h"
+#include "WorldPartition/WorldPartitionStreamingSource.h"
+#include "WorldPartition/WorldPartitionSubsystem.h"
+
+DECLARE_LOG_CATEGORY_EXTERN(LogAmbientCrowd, Log, All);
+DEFINE_LOG_CATEGORY(LogAmbientCrowd);
+
+DECLARE_STATS_GROUP(TEXT("AmbientCrowd"), STATGROUP_AmbientCrowd, STATCAT_Advanced);
+DECLARE_CYCLE_STAT(TEXT("Update Cells"), STAT_AmbientCrowd_Cells, STATGROUP_AmbientCrowd);
+DECLARE_CYCLE_STAT(TEXT("Flush Instances"), STAT_AmbientCrowd_Instances, STATGROUP_AmbientCrowd);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Entities"), STAT_AmbientCrowd_Entities, STATGROUP_AmbientCrowd);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Active Cells"), STAT_AmbientCrowd_Cells_Num, STATGROUP_AmbientCrowd);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Near Actors"), STAT_AmbientCrowd_Near, STATGROUP_AmbientCrowd);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Far Instances"), STAT_AmbientCrowd_Far, STATGROUP_AmbientCrowd);
+
+namespace AmbientCrowd
+{
+	/* Frames simulated before a benchmark stage starts sampling */
+	static constexpr int32 BenchmarkWarmupFrames = 30;
+
+	/* Ground steeper than this isn't used for spawns */
+	static constexpr float MinWalkableNormalZ = 0.7f;
+
+	static FMassEntityManager* GetEntityManager(const UWorld* World)
+	{
+		UMassEntitySubsystem* EntitySubsystem = World ? World->GetSubsystem<UMassEntitySubsystem>() : nullptr;
+		return EntitySubsystem ? &EntitySubsystem->GetMutableEntityManager() : nullptr;
+	}
+}
+
+bool UAmbientCrowdSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	//Nothing to look at on a dedicated server
+	return !IsRunningDedicatedServer() && Super::ShouldCreateSubsystem(Outer);
+}
+
+void UAmbientCrowdSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	if (!this->bEnableAmbientCrowd)
+	{
+		return;
+	}
+
+	FMassEntityManager* EntityManager = AmbientCrowd::GetEntityManager(&InWorld);
+	if (!EntityManager)
+	{
+		UE_LOG(LogAmbientCrowd, Warning, TEXT("MassEntity isn't available in %s, ambient crowd disabled"), *InWorld.GetMapName());
+		return;
+	}
+
+	const TArray<const UScriptStruct*> Composition = {
+		FTransformFragment::StaticStruct(),
+		FAmbientAgentFragment::StaticStruct(),
+		FAmbientRepresentationFragment::StaticStruct(),
+		FAmbientCrowdTag::StaticStruct()
+	};
+	this->Archetype = EntityManager->CreateArchetype(Composition);
+
+	this->LoadedActorClass = this->ActorClass.LoadSynchronous();
+	if (const ACharacter* CharacterCDO = Cast<ACharacter>(this->LoadedActorClass ? this->LoadedActorClass->GetDefaultObject() : nullptr))
+	{
+		this->ActorZOffset = CharacterCDO->GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
+	}
+
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	SpawnParameters.ObjectFlags |= RF_Transient;
+	this->Instances = InWorld.SpawnActor<AAmbientCrowdInstances>(AAmbientCrowdInstances::StaticClass(), FTransform::Identity, SpawnParameters);
+	if (this->Instances)
+	{
+		this->Instances->GetCrowdInstances()->SetStaticMesh(this->FarMesh.LoadSynchronous());
+	}
+
+	this->bInitialized = true;
+	this->bStreamCells = InWorld.GetWorldPartition() != nullptr;
+
+	UE_LOG(LogAmbientCrowd, Log, TEXT("Ambient crowd ready in %s (cell streaming %s)"), *InWorld.GetMapName(), this->bStreamCells ? TEXT("on") : TEXT("off"));
+}
+
+void UAmbientCrowdSubsystem::Deinitialize()
+{
+	//The entity manager is torn down with the world, only our bookkeeping needs clearing
+	this->ActiveCells.Empty();
+	this->BenchmarkEntities.Empty();
+	this->BenchmarkStage = INDEX_NONE;
+	this->ParkedActors.Empty();
+	this->NumEntities = 0;
+	this->NumNearActors = 0;
+	this->bInitialized = false;
+	Super::Deinitialize();
+}
+
+void UAmbientCrowdSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (!this->bInitialized)
+	{
+		return;
+	}
+
+	++this->FrameCounter;
+	this->GatherViewers();
+
+	if (this->BenchmarkStage != INDEX_NONE)
+	{
+		this->TickBenchmark();
+	}
+	else if (this->bStreamCells)
+	{
+		this->UpdateCells();
+	}
+
+	this->ProcessorSeconds = 0.0;
+
+	SET_DWORD_STAT(STAT_AmbientCrowd_Entities, this->NumEntities);
+	SET_DWORD_STAT(STAT_AmbientCrowd_Cells_Num, this->ActiveCells.Num());
+}
+
+TStatId UAmbientCrowdSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UAmbientCrowdSubsystem, STATGROUP_Tickables);
+}
+
+FAmbientCrowdSimulationParams UAmbientCrowdSubsystem::GetSimulationParams() const
+{
+	FAmbientCrowdSimulationParams Params;
+	Params.FrameCounter = this->FrameCounter;
+	Params.FarUpdateInterval = static_cast<uint32>(FMath::Max(this->FarUpdateInterval, 1));
+	Params.OffUpdateInterval = static_cast<uint32>(FMath::Max(this->OffUpdateInterval, 1));
+	Params.WanderRadius = this->WanderRadius;
+	return Params;
+}
+
+void UAmbientCrowdSubsystem::BeginRepresentation()
+{
+	this->FarTransforms.Reset();
+	this->GroundTracesThisFrame = 0;
+}
+
+void UAmbientCrowdSubsystem::UpdateRepresentation(const FTransform& Transform, FAmbientAgentFragment& Agent, FAmbientRepresentationFragment& Representation)
+{
+	const FVector Location = Transform.GetLocation();
+
+	float ClosestDistanceSquared = MAX_flt;
+	for (const FVector& Viewer : this->ViewerLocations)
+	{
+		ClosestDistanceSquared = FMath::Min(ClosestDistanceSquared, static_cast<float>(FVector::DistSquared(Viewer, Location)));
+	}
+
+	//A little slack on the way out so entities walking along the boundary don't swap actor every frame
+	const float NearLimit = Representation.LOD == EAmbientCrowdLOD::Near ? this->NearDistance * 1.1f : this->NearDistance;
+	EAmbientCrowdLOD LOD = ClosestDistanceSquared <= FMath::Square(NearLimit) ? EAmbientCrowdLOD::Near
+		: ClosestDistanceSquared <= FMath::Square(this->FarDistance) ? EAmbientCrowdLOD::Far
+		: EAmbientCrowdLOD::Off;
+
+	if (Representation.LOD == EAmbientCrowdLOD::Near && !Representation.Actor.IsValid())
+	{
+		//Destroyed under us (level teardown), give the slot back and pick a new actor below
+		this->ReleaseActor(nullptr);
+		Representation.LOD = EAmbientCrowdLOD::Far;
+	}
+
+	if (LOD == EAmbientCrowdLOD::Near && Representation.LOD != EAmbientCrowdLOD::Near)
+	{
+		if (AActor* Actor = this->AcquireActor())
+		{
+			Representation.Actor = Actor;
+		}
+		else
+		{
+			//Actor budget is spent, stay instanced
+			LOD = EAmbientCrowdLOD::Far;
+		}
+	}
+	else if (LOD != EAmbientCrowdLOD::Near && Representation.LOD == EAmbientCrowdLOD::Near)
+	{
+		this->ReleaseActor(Representation.Actor.Get());
+		Representation.Actor.Reset();
+	}
+	Representation.LOD = LOD;
+
+	//Only visible entities need their targets on the ground, hidden ones can wait until they come into range
+	if (Agent.bNeedsGroundTrace && LOD != EAmbientCrowdLOD::Off && this->GroundTracesThisFrame < this->MaxGroundTracesPerFrame)
+	{
+		++this->GroundTracesThisFrame;
+		Agent.bNeedsGroundTrace = false;
+
+		FHitResult Hit;
+		const FVector Start(Agent.Target.X, Agent.Target.Y, Agent.Home.Z + this->WanderRadius);
+		const FVector End(Agent.Target.X, Agent.Target.Y, Agent.Home.Z - this->WanderRadius);
+		if (GetWorld()->LineTraceSingleByChannel(Hit, Start, End, this->TraceChannel) && Hit.ImpactNormal.Z >= AmbientCrowd::MinWalkableNormalZ)
+		{
+			Agent.Target.Z = Hit.ImpactPoint.Z;
+		}
+		else
+		{
+			//No ground there, head back home
+			Agent.Target = Agent.Home;
+		}
+	}
+
+	if (LOD == EAmbientCrowdLOD::Near)
+	{
+		AActor* Actor = Representation.Actor.Get();
+		Actor->SetActorLocationAndRotation(Location + FVector(0.f, 0.f, this->ActorZOffset), Transform.GetRotation(), false, nullptr, ETeleportType::TeleportPhysics);
+
+		//The movement component doesn't tick, its velocity is only there to drive the animation blueprint
+		if (const APawn* Pawn = Cast<APawn>(Actor))
+		{
+			if (UPawnMovementComponent* MovementComponent = Pawn->GetMovementComponent())
+			{
+				MovementComponent->Velocity = Agent.Velocity;
+			}
+		}
+	}
+	else if (LOD == EAmbientCrowdLOD::Far)
+	{
+		this->FarTransforms.Add(Transform);
+	}
+}
+
+void UAmbientCrowdSubsystem::EndRepresentation()
+{
+	SCOPE_CYCLE_COUNTER(STAT_AmbientCrowd_Instances);
+
+	SET_DWORD_STAT(STAT_AmbientCrowd_Near, this->NumNearActors);
+	SET_DWORD_STAT(STAT_AmbientCrowd_Far, this->FarTransforms.Num());
+
+	UInstancedStaticMeshComponent* CrowdInstances = this->Instances ? this->Instances->GetCrowdInstances() : nullptr;
+	if (!CrowdInstances || !CrowdInstances->GetStaticMesh())
+	{
+		return;
+	}
+
+	if (CrowdInstances->GetInstanceCount() == this->FarTransforms.Num())
+	{
+		CrowdInstances->BatchUpdateInstancesTransforms(0, this->FarTransforms, true, true, true);
+	}
+	else
+	{
+		CrowdInstances->ClearInstances();
+		CrowdInstances->AddInstances(this->FarTransforms, false, true);
+	}
+}
+
+void UAmbientCrowdSubsystem::UpdateCells()
+{
+	SCOPE_CYCLE_COUNTER(STAT_AmbientCrowd_Cells);
+
+	if (this->ViewerLocations.IsEmpty())
+	{
+		return;
+	}
+
+	const auto GetCellCenter = [this](const FIntPoint& Cell)
+	{
+		return FVector2D((Cell.X + 0.5) * this->CellSize, (Cell.Y + 0.5) * this->CellSize);
+	};
+
+	//Empty cells every viewer has left, one cell of slack so walking along a cell border doesn't churn entities
+	const double KeepRadiusSquared = FMath::Square(this->SpawnRadius + this->CellSize);
+	TArray<FIntPoint> CellsToRemove;
+	for (const TPair<FIntPoint, TArray<FMassEntityHandle>>& Pair : this->ActiveCells)
+	{
+		const FVector2D Center = GetCellCenter(Pair.Key);
+		const bool bKeep = this->ViewerLocations.ContainsByPredicate([&Center, KeepRadiusSquared](const FVector& Viewer)
+		{
+			return FVector2D::DistSquared(FVector2D(Viewer), Center) <= KeepRadiusSquared;
+		});
+		if (!bKeep)
+		{
+			CellsToRemove.Add(Pair.Key);
+		}
+	}
+	for (const FIntPoint& Cell : CellsToRemove)
+	{
+		this->DespawnCell(Cell);
+	}
+
+	struct FCellCandidate
+	{
+		FIntPoint Cell;
+		double DistanceSquared;
+		float Height;
+	};
+
+	TArray<FCellCandidate> Candidates;
+	const double SpawnRadiusSquared = FMath::Square(this->SpawnRadius);
+	for (const FVector& Viewer : this->ViewerLocations)
+	{
+		const FIntPoint MinCell = this->GetCell(Viewer - FVector(this->SpawnRadius));
+		const FIntPoint MaxCell = this->GetCell(Viewer + FVector(this->SpawnRadius));
+		for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+		{
+			for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+			{
+				const FIntPoint Cell(X, Y);
+				const double DistanceSquared = FVector2D::DistSquared(FVector2D(Viewer), GetCellCenter(Cell));
+				if (DistanceSquared > SpawnRadiusSquared || this->ActiveCells.Contains(Cell))
+				{
+					continue;
+				}
+
+				FCellCandidate* Existing = Candidates.FindByPredicate([&Cell](const FCellCandidate& Candidate) { return Candidate.Cell == Cell; });
+				if (!Existing)
+				{
+					Candidates.Add({ Cell, DistanceSquared, static_cast<float>(Viewer.Z) });
+				}
+				else if (DistanceSquared < Existing->DistanceSquared)
+				{
+					Existing->DistanceSquared = DistanceSquared;
+					Existing->Height = static_cast<float>(Viewer.Z);
+				}
+			}
+		}
+	}
+
+	//Closest cells first so the crowd fills in from the viewer outwards
+	Candidates.Sort([](const FCellCandidate& A, const FCellCandidate& B) { return A.DistanceSquared < B.DistanceSquared; });
+
+	int32 CellsSpawned = 0;
+	for (const FCellCandidate& Candidate : Candidates)
+	{
+		if (CellsSpawned >= this->MaxCellsPerTick || this->NumEntities + this->EntitiesPerCell > this->MaxEntities)
+		{
+			break;
+		}
+
+		//Not streamed in yet, the traces would fall through, retry on a later tick
+		if (!this->IsCellStreamedIn(Candidate.Cell, Candidate.Height))
+		{
+			continue;
+		}
+
+		this->SpawnCell(Candidate.Cell, Candidate.Height);
+		++CellsSpawned;
+	}
+}
+
+bool UAmbientCrowdSubsystem::IsCellStreamedIn(const FIntPoint& Cell, const float Height) const
+{
+	const UWorldPartitionSubsystem* WorldPartitionSubsystem = GetWorld()->GetSubsystem<UWorldPartitionSubsystem>();
+	if (!WorldPartitionSubsystem)
+	{
+		return true;
+	}
+
+	FWorldPartitionStreamingQuerySource QuerySource;
+	QuerySource.Location = FVector((Cell.X + 0.5f) * this->CellSize, (Cell.Y + 0.5f) * this->CellSize, Height);
+	QuerySource.Radius = this->CellSize * 0.5f;
+	QuerySource.bUseGridLoadingRange = false;
+	QuerySource.bSpatialQuery = true;
+
+	return WorldPartitionSubsystem->IsStreamingCompleted(EWorldPartitionRuntimeCellState::Activated, { QuerySource }, false);
+}
+
+void UAmbientCrowdSubsystem::SpawnCell(const FIntPoint& Cell, const float Height)
+{
+	//Seeded by the cell alone so every peer builds the same crowd
+	FRandomStream Random(static_cast<int32>(GetTypeHash(Cell)));
+
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(AmbientCrowdSpawn));
+	TArray<FVector> Locations;
+	for (int32 Attempt = 0; Attempt < this->EntitiesPerCell; ++Attempt)
+	{
+		const float X = (Cell.X + Random.FRand()) * this->CellSize;
+		const float Y = (Cell.Y + Random.FRand()) * this->CellSize;
+
+		FHitResult Hit;
+		if (GetWorld()->LineTraceSingleByChannel(Hit, FVector(X, Y, Height + this->TraceHeight), FVector(X, Y, Height - this->TraceHeight), this->TraceChannel, QueryParams)
+			&& Hit.ImpactNormal.Z >= AmbientCrowd::MinWalkableNormalZ)
+		{
+			Locations.Add(Hit.ImpactPoint);
+		}
+	}
+
+	//Added even when empty so cells without ground aren't traced again every tick
+	TArray<FMassEntityHandle>& Entities = this->ActiveCells.Add(Cell);
+	this->SpawnEntities(Locations, Random, Entities);
+}
+
+void UAmbientCrowdSubsystem::DespawnCell(const FIntPoint& Cell)
+{
+	TArray<FMassEntityHandle> Entities;
+	if (this->ActiveCells.RemoveAndCopyValue(Cell, Entities))
+	{
+		this->DestroyEntities(Entities);
+	}
+}
+
+void UAmbientCrowdSubsystem::DespawnAll()
+{
+	for (TPair<FIntPoint, TArray<FMassEntityHandle>>& Pair : this->ActiveCells)
+	{
+		this->DestroyEntities(Pair.Value);
+	}
+	this->ActiveCells.Reset();
+	this->DestroyEntities(this->BenchmarkEntities);
+}
+
+void UAmbientCrowdSubsystem::SpawnEntities(const TArray<FVector>& Locations, FRandomStream& Random, TArray<FMassEntityHandle>& OutEntities)
+{
+	FMassEntityManager* EntityManager = AmbientCrowd::GetEntityManager(GetWorld());
+	if (!EntityManager || Locations.IsEmpty())
+	{
+		return;
+	}
+
+	TArray<FMassEntityHandle> Entities;
+	EntityManager->BatchCreateEntities(this->Archetype, Locations.Num(), Entities);
+
+	for (int32 Index = 0; Index < Entities.Num(); ++Index)
+	{
+		const FMassEntityHandle Entity = Entities[Index];
+
+		EntityManager->GetFragmentDataChecked<FTransformFragment>(Entity).SetTransform(
+			FTransform(FRotator(0.f, Random.FRandRange(0.f, 360.f), 0.f), Locations[Index]));
+
+		//Target == Home makes the first movement step pick a wander target
+		FAmbientAgentFragment& Agent = EntityManager->GetFragmentDataChecked<FAmbientAgentFragment>(Entity);
+		Agent.Home = Locations[Index];
+		Agent.Target = Locations[Index];
+		Agent.Speed = Random.FRandRange(this->MinSpeed, this->MaxSpeed);
+		Agent.Seed = Random.RandHelper(MAX_int32);
+		Agent.UpdatePhase = static_cast<uint8>(Random.RandHelper(MAX_uint8 + 1));
+	}
+
+	this->NumEntities += Entities.Num();
+	OutEntities.Append(Entities);
+}
+
+void UAmbientCrowdSubsystem::DestroyEntities(TArray<FMassEntityHandle>& Entities)
+{
+	this->NumEntities = FMath::Max(0, this->NumEntities - Entities.Num());
+
+	FMassEntityManager* EntityManager = AmbientCrowd::GetEntityManager(GetWorld());
+	if (!EntityManager)
+	{
+		Entities.Reset();
+		return;
+	}
+
+	Entities.RemoveAllSwap([EntityManager](const FMassEntityHandle& Entity) { return !EntityManager->IsEntityValid(Entity); });
+	for (const FMassEntityHandle& Entity : Entities)
+	{
+		const FAmbientRepresentationFragment& Representation = EntityManager->GetFragmentDataChecked<FAmbientRepresentationFragment>(Entity);
+		if (Representation.LOD == EAmbientCrowdLOD::Near)
+		{
+			this->ReleaseActor(Representation.Actor.Get());
+		}
+	}
+
+	EntityManager->BatchDestroyEntities(Entities);
+	Entities.Reset();
+}
+
+FIntPoint UAmbientCrowdSubsystem::GetCell(const FVector& Location) const
+{
+	return FIntPoint(FMath::FloorToInt32(Location.X / this->CellSize), FMath::FloorToInt32(Location.Y / this->CellSize));
+}
+
+void UAmbientCrowdSubsystem::GatherViewers()
+{
+	this->ViewerLocations.Reset();
+	for (FConstPlayerControllerIterator Iterator = GetWorld()->GetPlayerControllerIterator(); Iterator; ++Iterator)
+	{
+		const APlayerController* PlayerController = Iterator->Get();
+		if (PlayerController && PlayerController->IsLocalController())
+		{
+			FVector Location;
+			FRotator Rotation;
+			PlayerController->GetPlayerViewPoint(Location, Rotation);
+			this->ViewerLocations.Add(Location);
+		}
+	}
+}
+
+AActor* UAmbientCrowdSubsystem::AcquireActor()
+{
+	if (this->NumNearActors >= this->MaxNearActors || !this->LoadedActorClass)
+	{
+		return nullptr;
+	}
+
+	AActor* Actor = nullptr;
+	while (!Actor && !this->ParkedActors.IsEmpty())
+	{
+		AActor* Candidate = this->ParkedActors.Pop(EAllowShrinking::No);
+		if (IsValid(Candidate))
+		{
+			Actor = Candidate;
+		}
+	}
+
+	if (!Actor)
+	{
+		Actor = GetWorld()->SpawnActorDeferred<AActor>(this->LoadedActorClass, FTransform::Identity, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+		if (!Actor)
+		{
+			return nullptr;
+		}
+
+		//Local cosmetic copy, a listen server must not push it to clients that simulate their own crowd
+		Actor->SetReplicates(false);
+		Actor->FinishSpawning(FTransform::Identity);
+		Actor->SetActorEnableCollision(false);
+
+		//Positions come from the simulation
+		if (const APawn* Pawn = Cast<APawn>(Actor))
+		{
+			if (UPawnMovementComponent* MovementComponent = Pawn->GetMovementComponent())
+			{
+				MovementComponent->SetComponentTickEnabled(false);
+			}
+		}
+	}
+
+	Actor->SetActorHiddenInGame(false);
+	++this->NumNearActors;
+	return Actor;
+}
+
+void UAmbientCrowdSubsystem::ReleaseActor(AActor* Actor)
+{
+	this->NumNearActors = FMath::Max(0, this->NumNearActors - 1);
+
+	if (IsValid(Actor))
+	{
+		Actor->SetActorHiddenInGame(true);
+		this->ParkedActors.Add(Actor);
+	}
+}
+
+bool UAmbientCrowdSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+//Benchmark//
+
+void UAmbientCrowdSubsystem::StartBenchmark(const TArray<int32>& Counts, const int32 Frames)
+{
+	if (!this->bInitialized || Counts.IsEmpty())
+	{
+		UE_LOG(LogAmbientCrowd, Warning, TEXT("Ambient crowd benchmark needs an initialized crowd, check bEnableAmbientCrowd"));
+		return;
+	}
+
+	this->DespawnAll();
+	this->BenchmarkCounts = Counts;
+	this->BenchmarkFrames = Frames;
+	this->BenchmarkStage = 0;
+	this->BenchmarkFrame = 0;
+	this->BenchmarkGameThreadMs = 0.0;
+	this->BenchmarkProcessorMs = 0.0;
+
+	const int32 Count = this->BenchmarkCounts[this->BenchmarkStage];
+	UE_LOG(LogAmbientCrowd, Display, TEXT("Ambient crowd benchmark: %d entities"), Count);
+
+	//Disc around the first viewer on its ground, spacing stays constant so LOD spread is comparable between counts
+	FVector Center = this->ViewerLocations.IsEmpty() ? FVector::ZeroVector : this->ViewerLocations[0];
+	FHitResult Hit;
+	if (GetWorld()->LineTraceSingleByChannel(Hit, Center, Center - FVector(0.f, 0.f, this->TraceHeight), this->TraceChannel))
+	{
+		Center = Hit.ImpactPoint;
+	}
+
+	FRandomStream Random(1337);
+	const float Radius = FMath::Sqrt(static_cast<float>(Count)) * 100.f;
+	TArray<FVector> Locations;
+	Locations.Reserve(Count);
+	for (int32 Index = 0; Index < Count; ++Index)
+	{
+		const float Angle = Random.FRandRange(0.f, UE_TWO_PI);
+		const float Distance = FMath::Sqrt(Random.FRand()) * Radius;
+		Locations.Add(Center + FVector(FMath::Cos(Angle) * Distance, FMath::Sin(Angle) * Distance, 0.f));
+	}
+
+	this->SpawnEntities(Locations, Random, this->BenchmarkEntities);
+}
+
+void UAmbientCrowdSubsystem::TickBenchmark()
+{
+	++this->BenchmarkFrame;
+	if (this->BenchmarkFrame > AmbientCrowd::BenchmarkWarmupFrames)
+	{
+		this->BenchmarkGameThreadMs += FPlatformTime::ToMilliseconds(GGameThreadTime);
+		this->BenchmarkProcessorMs += this->ProcessorSeconds * 1000.0;
+	}
+
+	if (this->BenchmarkFrame < AmbientCrowd::BenchmarkWarmupFrames + this->BenchmarkFrames)
+	{
+		return;
+	}
+
+	UE_LOG(LogAmbientCrowd, Display, TEXT("%6d entities: game thread %.3f ms/frame, crowd processors %.3f ms/frame, %d near actors, %d far instances over %d frames"),
+		this->BenchmarkCounts[this->BenchmarkStage], this->BenchmarkGameThreadMs / this->BenchmarkFrames, this->BenchmarkProcessorMs / this->BenchmarkFrames,
+		this->NumNearActors, this->FarTransforms.Num(), this->BenchmarkFrames);
+
+	this->DestroyEntities(this->BenchmarkEntities);
+
+	const int32 NextStage = this->BenchmarkStage + 1;
+	if (!this->BenchmarkCounts.IsValidIndex(NextStage))
+	{
+		//Cell streaming picks up again next tick
+		this->BenchmarkStage = INDEX_NONE;
+		UE_LOG(LogAmbientCrowd, Display, TEXT("Ambient crowd benchmark done"));
+		return;
+	}
+
+	TArray<int32> Counts = this->BenchmarkCounts;
+	Counts.RemoveAt(0, NextStage);
+	this->StartBenchmark(Counts, this->BenchmarkFrames);
+}
+
+/**
+ * Watcher.Crowd.Benchmark [Frames=300] [Count...]
+ * Replaces the streamed crowd with N entities around the local player, for each requested count,
+ * and reports the average game thread and crowd processor cost once the LODs have settled.
+ */
+static FAutoConsoleCommandWithWorldAndArgs GAmbientCrowdBenchmarkCommand(
+	TEXT("Watcher.Crowd.Benchmark"),
+	TEXT("Measures UAmbientCrowdSubsystem frame cost. Args: [Frames=300] [Count...=1000 10000]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		UAmbientCrowdSubsystem* AmbientCrowd = World ? World->GetSubsystem<UAmbientCrowdSubsystem>() : nullptr;
+		if (!AmbientCrowd)
+		{
+			UE_LOG(LogAmbientCrowd, Warning, TEXT("Ambient crowd benchmark needs a client or standalone game world"));
+			return;
+		}
+
+		const int32 Frames = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 300;
+		TArray<int32> Counts;
+		for (int32 ArgIndex = 1; ArgIndex < Args.Num(); ++ArgIndex)
+		{
+			Counts.Add(FCString::Atoi(*Args[ArgIndex]));
+		}
+		if (Counts.IsEmpty())
+		{
+			Counts = { 1000, 10000 };
+		}
+
+		AmbientCrowd->StartBenchmark(Counts, Frames);
+	}));
+
+//Benchmark//
@@ -0,0 +1,261 @@
+//Project Watcher 2024 & Beyond
+
+#pragma once
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Engine/EngineTypes.h"
+#include "MassEntityTypes.h"
+#include "MassArchetypeTypes.h"
+#include "AmbientCrowdSubsystem.generated.h"
+
+class AAmbientCrowdInstances;
+class UStaticMesh;
+struct FAmbientAgentFragment;
+struct FAmbientRepresentationFragment;
+
+/* Snapshot of the settings the movement processor needs, copied so workers never touch the subsystem */
+struct FAmbientCrowdSimulationParams
+{
+	uint32 FrameCounter = 0;
+	uint32 FarUpdateInterval = 1;
+	uint32 OffUpdateInterval = 1;
+	float WanderRadius = 0.f;
+};
+
+/**
+ * Ambient crowd / wildlife layer for World Partition maps, simulated with MassEntity instead of one actor per agent.
+ * The map is split in a grid of cells, a cell around a local viewer is populated once World Partition reports it
+ * activated (so the ground traces hit real geometry) and emptied again once every viewer has moved away.
+ * Entities are drawn as full actors near the viewers, as one ISM further out and not at all past FarDistance,
+ * with the simulation rate dropping along with the LOD.
+ * The crowd is cosmetic: every peer seeds its cells identically and simulates locally, dedicated servers skip it.
+ */
+UCLASS(Config=Game)
+class UAmbientCrowdSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+private:
+	//Settings//
+
+	/* Off until the crowd has real actor / far mesh assets, the configured ones are placeholders */
+	UPROPERTY(Config)
+	bool bEnableAmbientCrowd = false;
+
+	/* Actor used for Near entities, spawned locally and never replicated */
+	UPROPERTY(Config)
+	TSoftClassPtr<AActor> ActorClass;
+
+	/* Mesh instanced for Far entities */
+	UPROPERTY(Config)
+	TSoftObjectPtr<UStaticMesh> FarMesh;
+
+	/* Size of a spawn cell in cm */
+	UPROPERTY(Config)
+	float CellSize = 6400.f;
+
+	/* Spawn attempts per cell, attempts that don't find walkable ground are dropped */
+	UPROPERTY(Config)
+	int32 EntitiesPerCell = 16;
+
+	/* Cells whose center is within this distance of a viewer get populated */
+	UPROPERTY(Config)
+	float SpawnRadius = 20000.f;
+
+	/* Hard cap on live entities */
+	UPROPERTY(Config)
+	int32 MaxEntities = 10000;
+
+	/* Cells populated per tick, spreads the ground traces of a fresh area over several frames */
+	UPROPERTY(Config)
+	int32 MaxCellsPerTick = 2;
+
+	UPROPERTY(Config)
+	float NearDistance = 2500.f;
+
+	UPROPERTY(Config)
+	float FarDistance = 15000.f;
+
+	/* Actors alive at once, entities that would be Near past this stay Far */
+	UPROPERTY(Config)
+	int32 MaxNearActors = 24;
+
+	/* Frames between movement updates of Far entities */
+	UPROPERTY(Config)
+	int32 FarUpdateInterval = 4;
+
+	/* Frames between movement updates of Off entities */
+	UPROPERTY(Config)
+	int32 OffUpdateInterval = 16;
+
+	/* Ground traces for new wander targets per frame, the rest wait for the next frame */
+	UPROPERTY(Config)
+	int32 MaxGroundTracesPerFrame = 64;
+
+	UPROPERTY(Config)
+	float WanderRadius = 2000.f;
+
+	UPROPERTY(Config)
+	float MinSpeed = 100.f;
+
+	UPROPERTY(Config)
+	float MaxSpeed = 180.f;
+
+	/* Channel used to find the ground */
+	UPROPERTY(Config)
+	TEnumAsByte<ECollisionChannel> TraceChannel = ECC_WorldStatic;
+
+	/* Ground traces run from this height above to this depth below the viewer */
+	UPROPERTY(Config)
+	float TraceHeight = 20000.f;
+
+	//Settings//
+
+	bool bInitialized = false;
+
+	/* Only World Partition maps stream cells, other maps can still run the benchmark */
+	bool bStreamCells = false;
+
+	FMassArchetypeHandle Archetype;
+
+	/* Populated cells and the entities living in them */
+	TMap<FIntPoint, TArray<FMassEntityHandle>> ActiveCells;
+
+	int32 NumEntities = 0;
+
+	TArray<FVector> ViewerLocations;
+
+	uint32 FrameCounter = 0;
+
+	UPROPERTY()
+	TObjectPtr<AAmbientCrowdInstances> Instances;
+
+	UPROPERTY()
+	TSubclassOf<AActor> LoadedActorClass;
+
+	/* Hidden actors ready for the next Near entity */
+	UPROPERTY()
+	TArray<TObjectPtr<AActor>> ParkedActors;
+
+	int32 NumNearActors = 0;
+
+	/* Offset between the ground and the actor's origin (capsule half height for characters) */
+	float ActorZOffset = 0.f;
+
+	TArray<FTransform> FarTransforms;
+
+	int32 GroundTracesThisFrame = 0;
+
+	double ProcessorSeconds = 0.0;
+
+	//Benchmark state//
+
+	TArray<int32> BenchmarkCounts;
+	TArray<FMassEntityHandle> BenchmarkEntities;
+	int32 BenchmarkStage = INDEX_NONE;
+	int32 BenchmarkFrame = 0;
+	int32 BenchmarkFrames = 0;
+	double BenchmarkGameThreadMs = 0.0;
+	double BenchmarkProcessorMs = 0.0;
+
+	//Benchmark state//
+
+public:
+
+	//Initialization//
+
+	UAmbientCrowdSubsystem() { }
+
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+	virtual void Deinitialize() override;
+
+	//Initialization//
+
+	//Tickable//
+
+	virtual void Tick(float DeltaTime) override;
+
+	virtual TStatId GetStatId() const override;
+
+	//Tickable//
+
+	//Processor Interface calls//
+
+	bool HasEntities() const { return this->NumEntities > 0; }
+
+	FAmbientCrowdSimulationParams GetSimulationParams() const;
+
+	/* Starts the representation pass of this frame */
+	void BeginRepresentation();
+
+	/**
+	 * Picks the LOD of one entity and moves its actor or queues its instance
+	 * @param Transform Simulated transform, on the ground
+	 * @param Agent Wander state, its pending ground trace is resolved here within the frame budget
+	 * @param Representation LOD and borrowed actor
+	 */
+	void UpdateRepresentation(const FTransform& Transform, FAmbientAgentFragment& Agent, FAmbientRepresentationFragment& Representation);
+
+	/* Pushes the Far transforms to the ISM */
+	void EndRepresentation();
+
+	/* Adds processor time to the current benchmark sample */
+	void RecordProcessorTime(const double Seconds) { this->ProcessorSeconds += Seconds; }
+
+	//Processor Interface calls//
+
+	//Benchmark//
+
+	/**
+	 * Replaces the streamed crowd with Count entities around the first viewer, for each count in turn,
+	 * and logs the average game thread and crowd processor time over Frames frames
+	 * @param Counts Entity counts to measure
+	 * @param Frames Frames sampled per count after a short warmup
+	 */
+	void StartBenchmark(const TArray<int32>& Counts, const int32 Frames);
+
+	//Benchmark//
+
+private:
+
+	//Cell internals//
+
+	/* Populates cells around the viewers and empties the ones left behind */
+	void UpdateCells();
+
+	/* Whether World Partition has the cell activated, so its collision is there to trace against */
+	bool IsCellStreamedIn(const FIntPoint& Cell, const float Height) const;
+
+	void SpawnCell(const FIntPoint& Cell, const float Height);
+
+	void DespawnCell(const FIntPoint& Cell);
+
+	void DespawnAll();
+
+	/* Creates entities standing at each location, returns their handles */
+	void SpawnEntities(const TArray<FVector>& Locations, FRandomStream& Random, TArray<FMassEntityHandle>& OutEntities);
+
+	/* Returns borrowed actors and destroys the entities */
+	void DestroyEntities(TArray<FMassEntityHandle>& Entities);
+
+	FIntPoint GetCell(const FVector& Location) const;
+
+	void GatherViewers();
+
+	//Cell internals//
+
+	//Representation internals//
+
+	AActor* AcquireActor();
+
+	void ReleaseActor(AActor* Actor);
+
+	//Representation internals//
+
+	void TickBenchmark();
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+};
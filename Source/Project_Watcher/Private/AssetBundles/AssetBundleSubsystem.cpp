@@ -0,0 +1,271 @@
+//Project Watcher 2024 & Beyond
+
+#include "AssetBundleSubsystem.h"
+#include "WatcherStateAssets.h"
+#include "NetworkManagerGameInstance/NetworkManagerGameInstance.h"
+#include "Engine/AssetManager.h"
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformMemory.h"
+#include "Misc/PackageName.h"
+#include "TimerManager.h"
+#include "UObject/UObjectGlobals.h"
+
+DECLARE_LOG_CATEGORY_EXTERN(LogAssetBundles, Log, All);
+DEFINE_LOG_CATEGORY(LogAssetBundles);
+
+namespace AssetBundles
+{
+	static int32 MeasureBundleStates = 0;
+	static FAutoConsoleVariableRef CVarMeasureBundleStates(
+		TEXT("Watcher.Memory.MeasureBundleStates"),
+		MeasureBundleStates,
+		TEXT("Forces a full garbage collection after every asset state change and samples resident memory for Watcher.Memory.Bundles. Hitches, measuring runs only."));
+}
+
+bool UAssetBundleSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	//Dedicated servers never show the menu, the game map hard references what they need
+	return !IsRunningDedicatedServer() && Super::ShouldCreateSubsystem(Outer);
+}
+
+void UAssetBundleSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	FCoreUObjectDelegates::PostLoadMapWithWorld.AddUObject(this, &ThisClass::HandlePostLoadMap);
+
+	if (UNetworkManagerGameInstance* NetworkManager = Collection.InitializeDependency<UNetworkManagerGameInstance>())
+	{
+		NetworkManager->OnNativeEvent(ENetworkManagerEvent::CreateSessionComplete).AddUObject(this, &ThisClass::HandleSessionStarted);
+		NetworkManager->OnNativeEvent(ENetworkManagerEvent::JoinSessionComplete).AddUObject(this, &ThisClass::HandleSessionStarted);
+		NetworkManager->OnNativeEvent(ENetworkManagerEvent::DestroySessionComplete).AddUObject(this, &ThisClass::HandleSessionEnded);
+		NetworkManager->OnNativeEvent(ENetworkManagerEvent::CreateSessionFailure).AddUObject(this, &ThisClass::HandleSessionEnded);
+		NetworkManager->OnNativeEvent(ENetworkManagerEvent::JoinSessionFailure).AddUObject(this, &ThisClass::HandleSessionEnded);
+	}
+
+	//PIE starts in a world that was never loaded through LoadMap
+	if (UWorld* World = GetGameInstance()->GetWorld())
+	{
+		this->HandlePostLoadMap(World);
+	}
+}
+
+void UAssetBundleSubsystem::Deinitialize()
+{
+	FCoreUObjectDelegates::PostLoadMapWithWorld.RemoveAll(this);
+	GetGameInstance()->GetTimerManager().ClearTimer(this->MemorySampleTimer);
+
+	if (UNetworkManagerGameInstance* NetworkManager = GetGameInstance()->GetSubsystem<UNetworkManagerGameInstance>())
+	{
+		NetworkManager->RemoveNativeListener(this);
+	}
+
+	if (this->BundleHandle.IsValid())
+	{
+		this->BundleHandle->CancelHandle();
+		this->BundleHandle.Reset();
+	}
+
+	if (!this->MemoryReports.IsEmpty())
+	{
+		this->LogMemoryReports();
+	}
+
+	Super::Deinitialize();
+}
+
+void UAssetBundleSubsystem::SetAssetState(const EWatcherAssetState NewState)
+{
+	UAssetManager* AssetManager = UAssetManager::GetIfInitialized();
+	if (!AssetManager || NewState == this->CurrentState)
+	{
+		return;
+	}
+
+	TArray<FPrimaryAssetId> AssetIds;
+	AssetManager->GetPrimaryAssetIdList(UWatcherStateAssets::PrimaryAssetType, AssetIds);
+	if (AssetIds.IsEmpty())
+	{
+		UE_LOG(LogAssetBundles, Warning, TEXT("No %s primary assets registered, check AssetManagerSettings"), *UWatcherStateAssets::PrimaryAssetType.ToString());
+		return;
+	}
+
+	UE_LOG(LogAssetBundles, Display, TEXT("Asset state %s -> %s"), *UEnum::GetValueAsString(this->CurrentState), *UEnum::GetValueAsString(NewState));
+
+	this->CurrentState = NewState;
+	const uint32 Serial = ++this->StateSerial;
+	this->StateChangeTime = FPlatformTime::Seconds();
+	GetGameInstance()->GetTimerManager().ClearTimer(this->MemorySampleTimer);
+
+	const TArray<FName> Bundles = this->GetBundlesForState(NewState);
+	if (Bundles.IsEmpty())
+	{
+		AssetManager->UnloadPrimaryAssets(AssetIds);
+		this->BundleHandle.Reset();
+		this->OnBundlesLoaded(NewState, Serial);
+		return;
+	}
+
+	//Replaces the bundle state of every asset, whatever the previous state loaded and this one doesn't list gets released
+	this->BundleHandle = AssetManager->LoadPrimaryAssets(AssetIds, Bundles, FStreamableDelegate(), FStreamableManager::AsyncLoadHighPriority);
+	if (this->BundleHandle.IsValid() && this->BundleHandle->IsLoadingInProgress())
+	{
+		this->BundleHandle->BindCompleteDelegate(FStreamableDelegate::CreateUObject(this, &ThisClass::OnBundlesLoaded, NewState, Serial));
+	}
+	else
+	{
+		this->OnBundlesLoaded(NewState, Serial);
+	}
+}
+
+EWatcherAssetState UAssetBundleSubsystem::GetAssetState() const
+{
+	return this->CurrentState;
+}
+
+FAssetStateMemoryReport UAssetBundleSubsystem::GetMemoryReport(const EWatcherAssetState State) const
+{
+	const FAssetStateMemoryReport* Report = this->MemoryReports.Find(State);
+	return Report ? *Report : FAssetStateMemoryReport();
+}
+
+void UAssetBundleSubsystem::LogMemoryReports() const
+{
+	if (this->MemoryReports.IsEmpty())
+	{
+		UE_LOG(LogAssetBundles, Display, TEXT("No asset state memory sampled yet, set Watcher.Memory.MeasureBundleStates 1 and change state"));
+		return;
+	}
+
+	for (const TPair<EWatcherAssetState, FAssetStateMemoryReport>& Pair : this->MemoryReports)
+	{
+		const FAssetStateMemoryReport& Report = Pair.Value;
+		UE_LOG(LogAssetBundles, Display, TEXT("%-8s %8.1f MB resident (peak %8.1f MB), %4d bundle assets loaded in %.2f s, %d samples"),
+			*UEnum::GetDisplayValueAsText(Report.State).ToString(), Report.UsedPhysicalMB, Report.PeakUsedPhysicalMB, Report.BundleAssets, Report.LoadSeconds, Report.Samples);
+	}
+}
+
+TArray<FName> UAssetBundleSubsystem::GetBundlesForState(const EWatcherAssetState State) const
+{
+	const FAssetStateBundles* Entry = this->StateBundles.FindByPredicate([State](const FAssetStateBundles& Candidate)
+	{
+		return Candidate.State == State;
+	});
+	return Entry ? Entry->Bundles : TArray<FName>();
+}
+
+void UAssetBundleSubsystem::OnBundlesLoaded(const EWatcherAssetState State, const uint32 Serial)
+{
+	if (Serial != this->StateSerial)
+	{
+		return;
+	}
+
+	int32 LoadedCount = 0;
+	int32 RequestedCount = 0;
+	if (this->BundleHandle.IsValid())
+	{
+		this->BundleHandle->GetLoadedCount(LoadedCount, RequestedCount);
+	}
+	const float LoadSeconds = FPlatformTime::Seconds() - this->StateChangeTime;
+	UE_LOG(LogAssetBundles, Display, TEXT("%s bundles in after %.2f s, %d assets"), *UEnum::GetValueAsString(State), LoadSeconds, LoadedCount);
+
+	if (AssetBundles::MeasureBundleStates == 0)
+	{
+		return;
+	}
+
+	//What the previous state released only leaves memory once it's collected
+	if (GEngine)
+	{
+		GEngine->ForceGarbageCollection(true);
+	}
+
+	GetGameInstance()->GetTimerManager().SetTimer(this->MemorySampleTimer,
+		FTimerDelegate::CreateUObject(this, &ThisClass::SampleMemory, State, LoadedCount, LoadSeconds), FMath::Max(this->MemorySampleDelay, 0.01f), false);
+}
+
+void UAssetBundleSubsystem::SampleMemory(const EWatcherAssetState State, const int32 BundleAssets, const float LoadSeconds)
+{
+	const float UsedPhysicalMB = FPlatformMemory::GetStats().UsedPhysical / (1024.f * 1024.f);
+
+	FAssetStateMemoryReport& Report = this->MemoryReports.FindOrAdd(State);
+	Report.State = State;
+	Report.Samples++;
+	Report.UsedPhysicalMB = UsedPhysicalMB;
+	Report.PeakUsedPhysicalMB = FMath::Max(Report.PeakUsedPhysicalMB, UsedPhysicalMB);
+	Report.BundleAssets = BundleAssets;
+	Report.LoadSeconds = LoadSeconds;
+
+	UE_LOG(LogAssetBundles, Display, TEXT("%s resident: %.1f MB"), *UEnum::GetValueAsString(State), UsedPhysicalMB);
+}
+
+void UAssetBundleSubsystem::HandlePostLoadMap(UWorld* LoadedWorld)
+{
+	if (!LoadedWorld || LoadedWorld->GetGameInstance() != GetGameInstance())
+	{
+		return;
+	}
+
+	//PIE prefixes the package name, compare the end like the memreport capture points do
+	const FString MapName = FPackageName::GetShortName(LoadedWorld->GetOutermost()->GetName());
+	this->SetAssetState(MapName.EndsWith(this->MenuMapName) ? EWatcherAssetState::Menu : EWatcherAssetState::Game);
+}
+
+void UAssetBundleSubsystem::HandleSessionStarted(const FNetworkManagerEvent& Event)
+{
+	//A replacement session hosted during a migration is created from the game map, that stays Game
+	if (this->CurrentState == EWatcherAssetState::Menu)
+	{
+		this->SetAssetState(EWatcherAssetState::Lobby);
+	}
+}
+
+void UAssetBundleSubsystem::HandleSessionEnded(const FNetworkManagerEvent& Event)
+{
+	//In game, the travel back to the menu map switches state once it lands
+	if (this->CurrentState == EWatcherAssetState::Lobby)
+	{
+		this->SetAssetState(EWatcherAssetState::Menu);
+	}
+}
+
+//Console//
+
+static FAutoConsoleCommandWithWorldAndArgs GAssetBundlesReportCommand(
+	TEXT("Watcher.Memory.Bundles"),
+	TEXT("Logs the resident memory sampled in each asset state (Menu / Lobby / Game)."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		const UGameInstance* GameInstance = World ? World->GetGameInstance() : nullptr;
+		if (const UAssetBundleSubsystem* AssetBundles = GameInstance ? GameInstance->GetSubsystem<UAssetBundleSubsystem>() : nullptr)
+		{
+			AssetBundles->LogMemoryReports();
+		}
+	}));
+
+static FAutoConsoleCommandWithWorldAndArgs GAssetBundlesStateCommand(
+	TEXT("Watcher.Memory.BundleState"),
+	TEXT("Switches the loaded asset bundles to a state by hand. Args: Menu|Lobby|Game"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		const UGameInstance* GameInstance = World ? World->GetGameInstance() : nullptr;
+		UAssetBundleSubsystem* AssetBundles = GameInstance ? GameInstance->GetSubsystem<UAssetBundleSubsystem>() : nullptr;
+		if (!AssetBundles || Args.IsEmpty())
+		{
+			return;
+		}
+
+		const int64 State = StaticEnum<EWatcherAssetState>()->GetValueByNameString(Args[0]);
+		if (State == INDEX_NONE)
+		{
+			UE_LOG(LogAssetBundles, Warning, TEXT("Unknown asset state %s"), *Args[0]);
+			return;
+		}
+		AssetBundles->SetAssetState(static_cast<EWatcherAssetState>(State));
+	}));
+
+//Console//
@@ -0,0 +1,169 @@
+//Project Watcher 2024 & Beyond
+
+#pragma once
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Engine/StreamableManager.h"
+#include "AssetBundleSubsystem.generated.h"
+
+struct FNetworkManagerEvent;
+
+//Wrapper for BP data//
+
+/* Which part of the game is running, each one keeps its own bundles resident */
+UENUM(BlueprintType)
+enum class EWatcherAssetState : uint8
+{
+	None,
+	/* Main menu, no session */
+	Menu,
+	/* Session created or joined, on the way to the game map */
+	Lobby,
+	/* In the game map */
+	Game
+};
+
+/* Config entry, bundles of UWatcherStateAssets that a state keeps loaded */
+USTRUCT()
+struct FAssetStateBundles
+{
+	GENERATED_USTRUCT_BODY()
+public:
+	UPROPERTY(Config)
+	EWatcherAssetState State = EWatcherAssetState::None;
+	UPROPERTY(Config)
+	TArray<FName> Bundles;
+};
+
+/* Resident memory of a state, sampled once its bundles are in and the previous ones were collected */
+USTRUCT(BlueprintType)
+struct FAssetStateMemoryReport
+{
+	GENERATED_USTRUCT_BODY()
+public:
+	UPROPERTY(BlueprintReadOnly, Category = "Asset Bundles")
+	EWatcherAssetState State = EWatcherAssetState::None;
+	/* Times the state was entered and sampled */
+	UPROPERTY(BlueprintReadOnly, Category = "Asset Bundles")
+	int32 Samples = 0;
+	/* Process physical memory of the last sample */
+	UPROPERTY(BlueprintReadOnly, Category = "Asset Bundles")
+	float UsedPhysicalMB = 0.f;
+	UPROPERTY(BlueprintReadOnly, Category = "Asset Bundles")
+	float PeakUsedPhysicalMB = 0.f;
+	/* Assets the state's bundles resolved to */
+	UPROPERTY(BlueprintReadOnly, Category = "Asset Bundles")
+	int32 BundleAssets = 0;
+	/* From the state change to the bundles being loaded */
+	UPROPERTY(BlueprintReadOnly, Category = "Asset Bundles")
+	float LoadSeconds = 0.f;
+};
+
+//Wrapper for BP data//
+
+/**
+ * Keeps the bundles of the UWatcherStateAssets primary assets in line with the session state, so the menu doesn't
+ * hold gameplay content and the match doesn't hold menu content. Session events from UNetworkManagerGameInstance move
+ * Menu -> Lobby (the game bundle starts streaming while we travel), arriving in a game map moves to Game and
+ * going back to the menu map, or the session going away, moves to Menu. Bundles are loaded and released async,
+ * released assets leave memory with the next garbage collection. With Watcher.Memory.MeasureBundleStates on, each
+ * state change forces that collection and samples resident memory, which is a hitch meant for measuring runs only.
+ */
+UCLASS(Config=Game)
+class UAssetBundleSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+private:
+	//Settings//
+
+	/* Bundles resident per state, states without an entry release everything */
+	UPROPERTY(Config)
+	TArray<FAssetStateBundles> StateBundles;
+
+	/* Short package name of the menu map, every other map counts as a game map */
+	UPROPERTY(Config)
+	FString MenuMapName = TEXT("MainMenu_Map");
+
+	/* Seconds to let a state settle after its bundles loaded before sampling memory */
+	UPROPERTY(Config)
+	float MemorySampleDelay = 2.f;
+
+	//Settings//
+
+	EWatcherAssetState CurrentState = EWatcherAssetState::None;
+
+	/* Bumped by every state change, loads of an older state finishing late are ignored */
+	uint32 StateSerial = 0;
+
+	double StateChangeTime = 0.0;
+
+	/* Handle of the current bundle load, keeps the bundles resident */
+	TSharedPtr<FStreamableHandle> BundleHandle;
+
+	TMap<EWatcherAssetState, FAssetStateMemoryReport> MemoryReports;
+
+	FTimerHandle MemorySampleTimer;
+
+public:
+
+	//Initialization//
+
+	UAssetBundleSubsystem() { }
+
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	virtual void Deinitialize() override;
+
+	//Initialization//
+
+	//Asset Bundle Interface calls//
+
+	/**
+	 * Loads the bundles of a state and releases the others, does nothing when already in it
+	 * @param NewState State to switch to
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure=false, Category = "Asset Bundles")
+	void SetAssetState(const EWatcherAssetState NewState);
+
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Asset Bundles")
+	EWatcherAssetState GetAssetState() const;
+
+	/**
+	 * Memory sampled in a state
+	 * @param State The state to query
+	 * @return The report, zeroed when the state wasn't sampled yet
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Asset Bundles")
+	FAssetStateMemoryReport GetMemoryReport(const EWatcherAssetState State) const;
+
+	/* Logs the report of every state sampled so far */
+	void LogMemoryReports() const;
+
+	//Asset Bundle Interface calls//
+
+private:
+
+	//Asset Bundle internals//
+
+	/* Bundles configured for a state */
+	TArray<FName> GetBundlesForState(const EWatcherAssetState State) const;
+
+	void OnBundlesLoaded(const EWatcherAssetState State, const uint32 Serial);
+
+	/* Records the resident memory of the current state, only scheduled while Watcher.Memory.MeasureBundleStates is on */
+	void SampleMemory(const EWatcherAssetState State, const int32 BundleAssets, const float LoadSeconds);
+
+	void HandlePostLoadMap(UWorld* LoadedWorld);
+
+	//Asset Bundle internals//
+
+	//Network Manager bindings//
+
+	void HandleSessionStarted(const FNetworkManagerEvent& Event);
+
+	void HandleSessionEnded(const FNetworkManagerEvent& Event);
+
+	//Network Manager bindings//
+};
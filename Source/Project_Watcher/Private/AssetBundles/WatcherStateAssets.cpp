@@ -0,0 +1,5 @@
+//Project Watcher 2024 & Beyond
+
+#include "WatcherStateAssets.h"
+
+const FPrimaryAssetType UWatcherStateAssets::PrimaryAssetType(TEXT("WatcherStateAssets"));
@@ -0,0 +1,43 @@
+//Project Watcher 2024 & Beyond
+
+#pragma once
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "WatcherStateAssets.generated.h"
+
+/**
+ * Primary asset listing what each game state needs resident, scanned from /Game/Core/AssetBundles (AssetManagerSettings).
+ * The Menu / Lobby / Game bundles are the names UAssetBundleSubsystem's StateBundles config refers to.
+ * Everything is soft referenced so nothing here is loaded until UAssetBundleSubsystem asks for the bundle.
+ * Content that only the menu, the lobby or the match uses goes here instead of being hard referenced
+ * from the maps, the game instance Blueprint or the screens.
+ */
+UCLASS(BlueprintType)
+class UWatcherStateAssets : public UPrimaryDataAsset
+{
+	GENERATED_BODY()
+public:
+	/* Type UPrimaryDataAsset registers every UWatcherStateAssets under, the name of the native class */
+	static const FPrimaryAssetType PrimaryAssetType;
+
+	/* Main menu screens, menu backgrounds and music */
+	UPROPERTY(EditDefaultsOnly, Category = "Menu", meta = (AssetBundles = "Menu"))
+	TArray<TSoftObjectPtr<UObject>> MenuAssets;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Menu", meta = (AssetBundles = "Menu"))
+	TArray<TSoftClassPtr<UObject>> MenuClasses;
+
+	/* Lobby screens and whatever the lobby shows while the match is being set up */
+	UPROPERTY(EditDefaultsOnly, Category = "Lobby", meta = (AssetBundles = "Lobby"))
+	TArray<TSoftObjectPtr<UObject>> LobbyAssets;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Lobby", meta = (AssetBundles = "Lobby"))
+	TArray<TSoftClassPtr<UObject>> LobbyClasses;
+
+	/* Characters, weapons, world building materials */
+	UPROPERTY(EditDefaultsOnly, Category = "Game", meta = (AssetBundles = "Game"))
+	TArray<TSoftObjectPtr<UObject>> GameAssets;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Game", meta = (AssetBundles = "Game"))
+	TArray<TSoftClassPtr<UObject>> GameClasses;
+};
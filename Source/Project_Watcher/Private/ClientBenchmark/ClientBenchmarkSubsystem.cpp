@@ -0,0 +1,614 @@
+//Project Watcher 2024 & Beyond
+
+#include "ClientBenchmarkSubsystem.h"
+#include "Project_WatcherCharacter.h"
+#include "Algo/UpperBound.h"
+#include "Dom/JsonObject.h"
+#include "Dom/JsonValue.h"
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "Engine/Level.h"
+#include "Engine/World.h"
+#include "GameFramework/GameModeBase.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/App.h"
+#include "Misc/CommandLine.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+#include "Policies/CondensedJsonPrintPolicy.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "UObject/UObjectGlobals.h"
+#include "WorldPartition/WorldPartition.h"
+#include "WatcherStats/WatcherStats.h"
+
+DECLARE_LOG_CATEGORY_EXTERN(LogClientBenchmark, Log, All);
+DEFINE_LOG_CATEGORY(LogClientBenchmark);
+
+namespace ClientBenchmark
+{
+	static float Average(const TArray<float>& Values)
+	{
+		double Sum = 0.0;
+		for (const float Value : Values)
+		{
+			Sum += Value;
+		}
+		return Values.IsEmpty() ? 0.f : static_cast<float>(Sum / Values.Num());
+	}
+
+	static FString GetSummaryPath()
+	{
+		return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Benchmark"), TEXT("Summary.json"));
+	}
+
+	/* Recorded paths and baselines live together in Content/Benchmark, which is version controlled and staged as is */
+	static FString GetDataPath(const FString& File)
+	{
+		return FPaths::Combine(FPaths::ProjectContentDir(), File);
+	}
+}
+
+bool UClientBenchmarkSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	return !IsRunningDedicatedServer() && Super::ShouldCreateSubsystem(Outer);
+}
+
+void UClientBenchmarkSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	if (!IsBenchmarkRun())
+	{
+		return;
+	}
+
+	if (this->Passes.IsEmpty())
+	{
+		UE_LOG(LogClientBenchmark, Error, TEXT("-WatcherBenchmark given but no passes are configured"));
+		return;
+	}
+
+	//Every frame simulates the same amount of time no matter how long it took, so runs are comparable
+	FApp::SetBenchmarking(true);
+	FApp::SetUseFixedTimeStep(true);
+	FApp::SetFixedDeltaTime(1.0 / FMath::Max(this->FixedFrameRate, 1.f));
+	FMath::RandInit(0);
+	FMath::SRandInit(0);
+
+	if (!this->LoadPath())
+	{
+		UE_LOG(LogClientBenchmark, Warning, TEXT("No recorded path at %s, driving a generated one"), *this->PathFile);
+	}
+
+	this->Summary = MakeShared<FJsonObject>();
+
+	FCoreUObjectDelegates::PostLoadMapWithWorld.AddUObject(this, &ThisClass::HandlePostLoadMap);
+	FWorldDelegates::LevelAddedToWorld.AddUObject(this, &ThisClass::HandleLevelAddedToWorld);
+	FCoreUObjectDelegates::GetPreGarbageCollectDelegate().AddUObject(this, &ThisClass::HandlePreGarbageCollect);
+	FCoreUObjectDelegates::GetPostGarbageCollect().AddUObject(this, &ThisClass::HandlePostGarbageCollect);
+	this->TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &ThisClass::Tick));
+}
+
+void UClientBenchmarkSubsystem::Deinitialize()
+{
+	FTSTicker::GetCoreTicker().RemoveTicker(this->TickerHandle);
+	FTSTicker::GetCoreTicker().RemoveTicker(this->RecordTickerHandle);
+	FCoreUObjectDelegates::PostLoadMapWithWorld.RemoveAll(this);
+	FWorldDelegates::LevelAddedToWorld.RemoveAll(this);
+	FCoreUObjectDelegates::GetPreGarbageCollectDelegate().RemoveAll(this);
+	FCoreUObjectDelegates::GetPostGarbageCollect().RemoveAll(this);
+
+	Super::Deinitialize();
+}
+
+bool UClientBenchmarkSubsystem::IsBenchmarkRun()
+{
+	return FParse::Param(FCommandLine::Get(), TEXT("WatcherBenchmark"));
+}
+
+void UClientBenchmarkSubsystem::StartRecording(const float Seconds)
+{
+	const APlayerController* PlayerController = GetGameInstance()->GetFirstLocalPlayerController();
+	if (!PlayerController || !Cast<ACharacter>(PlayerController->GetPawn()))
+	{
+		UE_LOG(LogClientBenchmark, Warning, TEXT("Recording needs a possessed character"));
+		return;
+	}
+
+	this->Recording.Reset();
+	this->RecordingDuration = Seconds;
+	this->RecordingElapsed = 0.f;
+	this->LastRecordedRotation = PlayerController->GetControlRotation();
+
+	FTSTicker::GetCoreTicker().RemoveTicker(this->RecordTickerHandle);
+	this->RecordTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &ThisClass::TickRecording));
+	UE_LOG(LogClientBenchmark, Display, TEXT("Recording benchmark path for %.1f s"), Seconds);
+}
+
+bool UClientBenchmarkSubsystem::Tick(float DeltaTime)
+{
+	const double Now = FPlatformTime::Seconds();
+	const float FrameMs = static_cast<float>((Now - this->LastFrameTime) * 1000.0);
+	this->LastFrameTime = Now;
+
+	UWorld* World = GetGameInstance()->GetWorld();
+	const int32 FramesPerSecond = FMath::Max(FMath::RoundToInt(this->FixedFrameRate), 1);
+
+	switch (this->Phase)
+	{
+	case EPhase::Idle:
+		if (World)
+		{
+			this->StartNextPass();
+		}
+		break;
+	case EPhase::Warmup:
+	case EPhase::Running:
+	{
+		if (this->Capture.StreamingSettleMs < 0.0 && World && !IsAsyncLoading()
+			&& (!World->GetWorldPartition() || World->GetWorldPartition()->IsStreamingCompleted()))
+		{
+			this->Capture.StreamingSettleMs = (Now - this->PhaseStartTime) * 1000.0;
+		}
+
+		const FClientBenchmarkPass& Pass = this->Passes[this->PassIndex];
+		if (this->Phase == EPhase::Warmup)
+		{
+			if (++this->PhaseFrame >= FMath::CeilToInt(Pass.WarmupSeconds * FramesPerSecond))
+			{
+				this->BeginMeasuring();
+			}
+			break;
+		}
+
+		this->Capture.GameThreadMs.Add(FPlatformTime::ToMilliseconds(GGameThreadTime));
+		this->Capture.FrameMs.Add(FrameMs);
+		if (IsAsyncLoading())
+		{
+			this->Capture.AsyncLoadingFrames++;
+		}
+
+		this->DriveCharacter();
+
+		if (++this->PhaseFrame >= FMath::CeilToInt(Pass.DurationSeconds * FramesPerSecond))
+		{
+			this->FinishPass();
+		}
+		break;
+	}
+	default:
+		break;
+	}
+
+	return this->Phase != EPhase::Done;
+}
+
+void UClientBenchmarkSubsystem::StartNextPass()
+{
+	if (++this->PassIndex >= this->Passes.Num())
+	{
+		this->FinishBenchmark();
+		return;
+	}
+
+	const FClientBenchmarkPass& Pass = this->Passes[this->PassIndex];
+	UE_LOG(LogClientBenchmark, Display, TEXT("Benchmark pass %d/%d: %s"), this->PassIndex + 1, this->Passes.Num(), *Pass.Map);
+
+	this->Phase = EPhase::Loading;
+	GEngine->SetClientTravel(GetGameInstance()->GetWorld(), *Pass.Map, TRAVEL_Absolute);
+}
+
+void UClientBenchmarkSubsystem::BeginMeasuring()
+{
+	this->Phase = EPhase::Running;
+	this->PhaseFrame = 0;
+
+	const FClientBenchmarkPass& Pass = this->Passes[this->PassIndex];
+	if (Pass.bDriveCharacter)
+	{
+		this->PossessBenchmarkCharacter();
+	}
+
+#if CSV_PROFILER
+	const FString CsvFolder = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Benchmark"), TEXT("CSV"));
+	const FString CsvName = FString::Printf(TEXT("%s_%s.csv"), *FPackageName::GetShortName(Pass.Map), *FDateTime::Now().ToString());
+	FCsvProfiler::Get()->BeginCapture(-1, CsvFolder, CsvName);
+#endif
+}
+
+void UClientBenchmarkSubsystem::FinishPass()
+{
+#if CSV_PROFILER
+	FCsvProfiler::Get()->EndCapture();
+#endif
+
+	const FClientBenchmarkPass& Pass = this->Passes[this->PassIndex];
+
+	int32 HitchFrames = 0;
+	for (const float FrameMs : this->Capture.FrameMs)
+	{
+		HitchFrames += FrameMs > this->HitchThresholdMs ? 1 : 0;
+	}
+
+	const TSharedRef<FJsonObject> Metrics = MakeShared<FJsonObject>();
+	Metrics->SetNumberField(TEXT("AvgGameThreadMs"), ClientBenchmark::Average(this->Capture.GameThreadMs));
+	Metrics->SetNumberField(TEXT("P95GameThreadMs"), WatcherStats::Percentile(this->Capture.GameThreadMs, 0.95f));
+	Metrics->SetNumberField(TEXT("MaxGameThreadMs"), WatcherStats::Percentile(this->Capture.GameThreadMs, 1.f));
+	Metrics->SetNumberField(TEXT("AvgFrameMs"), ClientBenchmark::Average(this->Capture.FrameMs));
+	Metrics->SetNumberField(TEXT("P95FrameMs"), WatcherStats::Percentile(this->Capture.FrameMs, 0.95f));
+	Metrics->SetNumberField(TEXT("HitchFrames"), HitchFrames);
+	Metrics->SetNumberField(TEXT("GCCount"), this->Capture.GCCount);
+	Metrics->SetNumberField(TEXT("GCTotalMs"), this->Capture.GCTotalMs);
+	Metrics->SetNumberField(TEXT("GCMaxMs"), this->Capture.GCMaxMs);
+	Metrics->SetNumberField(TEXT("LevelsStreamed"), this->Capture.LevelsStreamed);
+	Metrics->SetNumberField(TEXT("AsyncLoadingFrames"), this->Capture.AsyncLoadingFrames);
+	Metrics->SetNumberField(TEXT("StreamingSettleMs"), this->Capture.StreamingSettleMs);
+	this->Summary->SetObjectField(FPackageName::GetShortName(Pass.Map), Metrics);
+
+	UE_LOG(LogClientBenchmark, Display, TEXT("%s: game thread avg %.2f ms p95 %.2f ms, %d hitches, %d GCs (%.1f ms), streaming settled in %.0f ms"),
+		*Pass.Map, Metrics->GetNumberField(TEXT("AvgGameThreadMs")), Metrics->GetNumberField(TEXT("P95GameThreadMs")),
+		HitchFrames, this->Capture.GCCount, this->Capture.GCTotalMs, this->Capture.StreamingSettleMs);
+
+	this->DrivenCharacter.Reset();
+	this->StartNextPass();
+}
+
+void UClientBenchmarkSubsystem::FinishBenchmark()
+{
+	this->Phase = EPhase::Done;
+
+	const int32 Failures = this->WriteAndCompareSummary();
+	if (Failures > 0)
+	{
+		UE_LOG(LogClientBenchmark, Error, TEXT("Benchmark finished with %d failed metrics"), Failures);
+	}
+	else
+	{
+		UE_LOG(LogClientBenchmark, Display, TEXT("Benchmark finished"));
+	}
+
+	FPlatformMisc::RequestExitWithStatus(false, Failures > 0 ? 1 : 0);
+}
+
+void UClientBenchmarkSubsystem::PossessBenchmarkCharacter()
+{
+	UWorld* World = GetGameInstance()->GetWorld();
+	APlayerController* PlayerController = World ? World->GetFirstPlayerController() : nullptr;
+	if (!PlayerController)
+	{
+		UE_LOG(LogClientBenchmark, Warning, TEXT("No player controller to drive"));
+		return;
+	}
+
+	if (AProject_WatcherCharacter* Existing = Cast<AProject_WatcherCharacter>(PlayerController->GetPawn()))
+	{
+		this->DrivenCharacter = Existing;
+		return;
+	}
+
+	UClass* SpawnClass = this->CharacterClass.LoadSynchronous();
+	if (!SpawnClass || !SpawnClass->IsChildOf<AProject_WatcherCharacter>())
+	{
+		SpawnClass = AProject_WatcherCharacter::StaticClass();
+	}
+
+	//Always start from the same spot so the path covers the same ground every run
+	FTransform SpawnTransform = FTransform::Identity;
+	if (AGameModeBase* GameMode = World->GetAuthGameMode())
+	{
+		if (const AActor* PlayerStart = GameMode->FindPlayerStart(PlayerController))
+		{
+			SpawnTransform = PlayerStart->GetActorTransform();
+		}
+	}
+
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+	ACharacter* Character = World->SpawnActor<ACharacter>(SpawnClass, SpawnTransform, SpawnParameters);
+	if (!Character)
+	{
+		UE_LOG(LogClientBenchmark, Warning, TEXT("Could not spawn %s"), *GetNameSafe(SpawnClass));
+		return;
+	}
+
+	if (APawn* OldPawn = PlayerController->GetPawn())
+	{
+		PlayerController->UnPossess();
+		OldPawn->Destroy();
+	}
+	PlayerController->Possess(Character);
+	PlayerController->SetControlRotation(SpawnTransform.Rotator());
+	this->DrivenCharacter = Character;
+}
+
+void UClientBenchmarkSubsystem::DriveCharacter()
+{
+	ACharacter* Character = this->DrivenCharacter.Get();
+	APlayerController* PlayerController = Character ? Cast<APlayerController>(Character->GetController()) : nullptr;
+	if (!PlayerController)
+	{
+		return;
+	}
+
+	const float Time = this->PhaseFrame / FMath::Max(this->FixedFrameRate, 1.f);
+
+	FPathSample Sample;
+	if (!this->Path.IsEmpty())
+	{
+		const int32 Index = Algo::UpperBoundBy(this->Path, Time, &FPathSample::Time) - 1;
+		Sample = this->Path[FMath::Clamp(Index, 0, this->Path.Num() - 1)];
+	}
+	else
+	{
+		//Slow weave forward while panning, enough to pull in new world partition cells
+		Sample.Move = FVector2D(FMath::Sin(Time * 0.5f), 1.f);
+		Sample.Look = FVector2D(15.f * FMath::Cos(Time * 0.3f), 0.f);
+		Sample.bJump = FMath::Fmod(Time, 7.f) < 0.1f;
+	}
+
+	//Look is a rate, scale it by the fixed step so playback turns as fast as the recording did
+	const FVector2D LookDelta = Sample.Look / FMath::Max(this->FixedFrameRate, 1.f);
+	PlayerController->SetControlRotation(PlayerController->GetControlRotation() + FRotator(LookDelta.Y, LookDelta.X, 0.f));
+
+	//Same axes as AProject_WatcherCharacter::Move
+	const FRotator YawRotation(0.f, PlayerController->GetControlRotation().Yaw, 0.f);
+	Character->AddMovementInput(FRotationMatrix(YawRotation).GetUnitAxis(EAxis::X), Sample.Move.Y);
+	Character->AddMovementInput(FRotationMatrix(YawRotation).GetUnitAxis(EAxis::Y), Sample.Move.X);
+
+	if (Sample.bJump)
+	{
+		Character->Jump();
+	}
+	else
+	{
+		Character->StopJumping();
+	}
+}
+
+bool UClientBenchmarkSubsystem::LoadPath()
+{
+	FString Json;
+	if (!FFileHelper::LoadFileToString(Json, *ClientBenchmark::GetDataPath(this->PathFile)))
+	{
+		return false;
+	}
+
+	TSharedPtr<FJsonObject> Root;
+	if (!FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(Json), Root) || !Root.IsValid())
+	{
+		return false;
+	}
+
+	//Samples are [Time, MoveX, MoveY, LookYawRate, LookPitchRate, Jump], rates in degrees per second
+	this->Path.Reset();
+	for (const TSharedPtr<FJsonValue>& Value : Root->GetArrayField(TEXT("Samples")))
+	{
+		const TArray<TSharedPtr<FJsonValue>>& Fields = Value->AsArray();
+		if (Fields.Num() < 6)
+		{
+			continue;
+		}
+
+		FPathSample& Sample = this->Path.AddDefaulted_GetRef();
+		Sample.Time = Fields[0]->AsNumber();
+		Sample.Move = FVector2D(Fields[1]->AsNumber(), Fields[2]->AsNumber());
+		Sample.Look = FVector2D(Fields[3]->AsNumber(), Fields[4]->AsNumber());
+		Sample.bJump = Fields[5]->AsNumber() != 0.0;
+	}
+
+	UE_LOG(LogClientBenchmark, Display, TEXT("Loaded benchmark path with %d samples"), this->Path.Num());
+	return !this->Path.IsEmpty();
+}
+
+int32 UClientBenchmarkSubsystem::WriteAndCompareSummary() const
+{
+	const TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+	Root->SetNumberField(TEXT("FixedFrameRate"), this->FixedFrameRate);
+	Root->SetStringField(TEXT("Build"), FApp::GetBuildVersion());
+	Root->SetObjectField(TEXT("Maps"), this->Summary);
+
+	FString Json;
+	FJsonSerializer::Serialize(Root, TJsonWriterFactory<>::Create(&Json));
+	const FString SummaryPath = ClientBenchmark::GetSummaryPath();
+	FFileHelper::SaveStringToFile(Json, *SummaryPath);
+	UE_LOG(LogClientBenchmark, Display, TEXT("Wrote %s"), *SummaryPath);
+
+	//A pass whose streaming never settled fails on its own, baseline or not
+	int32 Failures = 0;
+	for (const TPair<FString, TSharedPtr<FJsonValue>>& MapPair : this->Summary->Values)
+	{
+		if (MapPair.Value->AsObject()->GetNumberField(TEXT("StreamingSettleMs")) < 0.0)
+		{
+			Failures++;
+			UE_LOG(LogClientBenchmark, Error, TEXT("%s streaming never settled"), *MapPair.Key);
+		}
+	}
+
+	FString BaselinePath;
+	if (!FParse::Value(FCommandLine::Get(), TEXT("BenchmarkBaseline="), BaselinePath))
+	{
+		BaselinePath = ClientBenchmark::GetDataPath(this->BaselineFile);
+	}
+
+	FString BaselineJson;
+	TSharedPtr<FJsonObject> Baseline;
+	if (!FFileHelper::LoadFileToString(BaselineJson, *BaselinePath)
+		|| !FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(BaselineJson), Baseline) || !Baseline.IsValid())
+	{
+		UE_LOG(LogClientBenchmark, Display, TEXT("No baseline at %s, copy the summary there to start comparing"), *BaselinePath);
+		return Failures;
+	}
+
+	const TSharedPtr<FJsonObject>* BaselineMaps = nullptr;
+	if (!Baseline->TryGetObjectField(TEXT("Maps"), BaselineMaps))
+	{
+		return Failures;
+	}
+
+	//Every metric is lower-is-better
+	for (const TPair<FString, TSharedPtr<FJsonValue>>& MapPair : (*BaselineMaps)->Values)
+	{
+		const TSharedPtr<FJsonObject>* Current = nullptr;
+		if (!this->Summary->TryGetObjectField(MapPair.Key, Current))
+		{
+			UE_LOG(LogClientBenchmark, Warning, TEXT("%s is in the baseline but wasn't benchmarked"), *MapPair.Key);
+			continue;
+		}
+
+		for (const TPair<FString, TSharedPtr<FJsonValue>>& MetricPair : MapPair.Value->AsObject()->Values)
+		{
+			double CurrentValue = 0.0;
+			if (!(*Current)->TryGetNumberField(MetricPair.Key, CurrentValue) || CurrentValue < 0.0)
+			{
+				continue;
+			}
+
+			const double BaselineValue = MetricPair.Value->AsNumber();
+			const float Tolerance = this->GetTolerance(MetricPair.Key);
+			if (CurrentValue > BaselineValue * (1.0 + Tolerance))
+			{
+				Failures++;
+				UE_LOG(LogClientBenchmark, Error, TEXT("%s %s regressed: %.3f vs baseline %.3f (tolerance %.0f%%)"),
+					*MapPair.Key, *MetricPair.Key, CurrentValue, BaselineValue, Tolerance * 100.f);
+			}
+		}
+	}
+
+	return Failures;
+}
+
+float UClientBenchmarkSubsystem::GetTolerance(const FString& Metric) const
+{
+	const FClientBenchmarkTolerance* Entry = this->Tolerances.FindByPredicate([&Metric](const FClientBenchmarkTolerance& Candidate)
+	{
+		return Candidate.Metric == Metric;
+	});
+	return Entry ? Entry->Tolerance : this->DefaultTolerance;
+}
+
+void UClientBenchmarkSubsystem::HandlePostLoadMap(UWorld* LoadedWorld)
+{
+	if (this->Phase != EPhase::Loading || !LoadedWorld || LoadedWorld->GetGameInstance() != GetGameInstance())
+	{
+		return;
+	}
+
+	const FClientBenchmarkPass& Pass = this->Passes[this->PassIndex];
+	if (FPackageName::GetShortName(LoadedWorld->GetOutermost()->GetName()) != FPackageName::GetShortName(Pass.Map))
+	{
+		return;
+	}
+
+	this->Phase = EPhase::Warmup;
+	this->PhaseFrame = 0;
+	this->PhaseStartTime = FPlatformTime::Seconds();
+	this->Capture = FPassCapture();
+}
+
+void UClientBenchmarkSubsystem::HandleLevelAddedToWorld(ULevel* Level, UWorld* World)
+{
+	if (this->Phase == EPhase::Warmup || this->Phase == EPhase::Running)
+	{
+		this->Capture.LevelsStreamed++;
+	}
+}
+
+void UClientBenchmarkSubsystem::HandlePreGarbageCollect()
+{
+	this->GCStartTime = FPlatformTime::Seconds();
+}
+
+void UClientBenchmarkSubsystem::HandlePostGarbageCollect()
+{
+	if (this->Phase != EPhase::Running)
+	{
+		return;
+	}
+
+	const double GCMs = (FPlatformTime::Seconds() - this->GCStartTime) * 1000.0;
+	this->Capture.GCCount++;
+	this->Capture.GCTotalMs += GCMs;
+	this->Capture.GCMaxMs = FMath::Max(this->Capture.GCMaxMs, GCMs);
+}
+
+bool UClientBenchmarkSubsystem::TickRecording(float DeltaTime)
+{
+	const APlayerController* PlayerController = GetGameInstance()->GetFirstLocalPlayerController();
+	const ACharacter* Character = PlayerController ? Cast<ACharacter>(PlayerController->GetPawn()) : nullptr;
+	if (!Character)
+	{
+		UE_LOG(LogClientBenchmark, Warning, TEXT("Lost the character, recording stopped"));
+		return false;
+	}
+
+	const FRotator ControlRotation = PlayerController->GetControlRotation();
+	const FRotator Delta = (ControlRotation - this->LastRecordedRotation).GetNormalized();
+	this->LastRecordedRotation = ControlRotation;
+	//Stored as a rate, the recording runs at a variable frame rate and playback at the fixed one
+	const float InvDeltaTime = DeltaTime > UE_KINDA_SMALL_NUMBER ? 1.f / DeltaTime : 0.f;
+
+	const FRotator YawRotation(0.f, ControlRotation.Yaw, 0.f);
+	const FVector Input = Character->GetLastMovementInputVector();
+
+	FPathSample& Sample = this->Recording.AddDefaulted_GetRef();
+	Sample.Time = this->RecordingElapsed;
+	Sample.Move = FVector2D(FVector::DotProduct(Input, FRotationMatrix(YawRotation).GetUnitAxis(EAxis::Y)),
+		FVector::DotProduct(Input, FRotationMatrix(YawRotation).GetUnitAxis(EAxis::X)));
+	Sample.Look = FVector2D(Delta.Yaw, Delta.Pitch) * InvDeltaTime;
+	Sample.bJump = Character->bPressedJump;
+
+	this->RecordingElapsed += DeltaTime;
+	if (this->RecordingElapsed < this->RecordingDuration)
+	{
+		return true;
+	}
+
+	TArray<TSharedPtr<FJsonValue>> Samples;
+	Samples.Reserve(this->Recording.Num());
+	for (const FPathSample& Recorded : this->Recording)
+	{
+		Samples.Add(MakeShared<FJsonValueArray>(TArray<TSharedPtr<FJsonValue>>{
+			MakeShared<FJsonValueNumber>(Recorded.Time),
+			MakeShared<FJsonValueNumber>(Recorded.Move.X),
+			MakeShared<FJsonValueNumber>(Recorded.Move.Y),
+			MakeShared<FJsonValueNumber>(Recorded.Look.X),
+			MakeShared<FJsonValueNumber>(Recorded.Look.Y),
+			MakeShared<FJsonValueNumber>(Recorded.bJump ? 1.0 : 0.0) }));
+	}
+
+	const TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+	Root->SetArrayField(TEXT("Samples"), Samples);
+
+	FString Json;
+	FJsonSerializer::Serialize(Root, TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&Json));
+	const FString OutputPath = ClientBenchmark::GetDataPath(this->PathFile);
+	if (FFileHelper::SaveStringToFile(Json, *OutputPath))
+	{
+		UE_LOG(LogClientBenchmark, Display, TEXT("Recorded %d samples to %s"), this->Recording.Num(), *OutputPath);
+	}
+
+	this->Recording.Empty();
+	return false;
+}
+
+//Benchmark//
+
+static FAutoConsoleCommandWithWorldAndArgs GClientBenchmarkRecordCommand(
+	TEXT("Watcher.Benchmark.Record"),
+	TEXT("Records the local character's input as the benchmark path. Args: [Seconds=60]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		const UGameInstance* GameInstance = World ? World->GetGameInstance() : nullptr;
+		if (UClientBenchmarkSubsystem* ClientBenchmark = GameInstance ? GameInstance->GetSubsystem<UClientBenchmarkSubsystem>() : nullptr)
+		{
+			ClientBenchmark->StartRecording(Args.Num() > 0 ? FCString::Atof(*Args[0]) : 60.f);
+		}
+	}));
+
+//Benchmark//
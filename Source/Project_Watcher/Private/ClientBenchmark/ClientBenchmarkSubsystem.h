@@ -0,0 +1,226 @@
+//Project Watcher 2024 & Beyond
+
+#pragma once
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "ClientBenchmarkSubsystem.generated.h"
+
+class ACharacter;
+class FJsonObject;
+class ULevel;
+
+//Wrapper for BP data//
+
+/* One map the benchmark visits */
+USTRUCT()
+struct FClientBenchmarkPass
+{
+	GENERATED_USTRUCT_BODY()
+public:
+	/* Map package, /Game/Core/Maps/MainGame_Map_WP etc */
+	UPROPERTY(Config)
+	FString Map;
+	/* Seconds after load before measuring, streaming settle time is measured in here */
+	UPROPERTY(Config)
+	float WarmupSeconds = 5.f;
+	/* Seconds measured */
+	UPROPERTY(Config)
+	float DurationSeconds = 30.f;
+	/* Possess an AProject_WatcherCharacter and play the recorded path */
+	UPROPERTY(Config)
+	bool bDriveCharacter = false;
+};
+
+/* Relative tolerance for a metric when comparing against the baseline */
+USTRUCT()
+struct FClientBenchmarkTolerance
+{
+	GENERATED_USTRUCT_BODY()
+public:
+	UPROPERTY(Config)
+	FString Metric;
+	/* 0.1 allows 10% worse than the baseline */
+	UPROPERTY(Config)
+	float Tolerance = 0.1f;
+};
+
+//Wrapper for BP data//
+
+/**
+ * Repeatable client benchmark, started with -WatcherBenchmark (add -nullrhi for headless runs).
+ * Runs at a fixed timestep, visits every configured map, drives the character along a recorded input path
+ * and captures a CSV profile per map. The per map game thread, streaming and GC numbers are written to
+ * Saved/Benchmark/Summary.json and compared against -BenchmarkBaseline=<file> (or the configured baseline in Content/Benchmark),
+ * the process exits with 1 when any metric regressed past its tolerance or a map's streaming never settled.
+ *
+ * Paths are recorded in game with Watcher.Benchmark.Record [Seconds].
+ */
+UCLASS(Config=Game)
+class UClientBenchmarkSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+private:
+	//Settings//
+
+	UPROPERTY(Config)
+	TArray<FClientBenchmarkPass> Passes;
+
+	/* Frames per second of the fixed timestep */
+	UPROPERTY(Config)
+	float FixedFrameRate = 30.f;
+
+	/* Frames slower than this count as hitches */
+	UPROPERTY(Config)
+	float HitchThresholdMs = 50.f;
+
+	/* Character possessed when the map's default pawn isn't an AProject_WatcherCharacter */
+	UPROPERTY(Config)
+	TSoftClassPtr<ACharacter> CharacterClass;
+
+	/* Recorded input path, relative to the project Content folder like the baseline (Content/Benchmark is staged as non UFS) */
+	UPROPERTY(Config)
+	FString PathFile = TEXT("Benchmark/MainGame_Path.json");
+
+	/* Baseline summary, relative to the project Content folder */
+	UPROPERTY(Config)
+	FString BaselineFile = TEXT("Benchmark/Baseline.json");
+
+	/* Used for metrics without their own entry in Tolerances */
+	UPROPERTY(Config)
+	float DefaultTolerance = 0.1f;
+
+	UPROPERTY(Config)
+	TArray<FClientBenchmarkTolerance> Tolerances;
+
+	//Settings//
+
+	enum class EPhase : uint8
+	{
+		Idle,
+		Loading,
+		Warmup,
+		Running,
+		Done
+	};
+
+	/* One sample of recorded input */
+	struct FPathSample
+	{
+		float Time = 0.f;
+		FVector2D Move = FVector2D::ZeroVector;
+		/* Yaw / pitch rate in degrees per second, independent of the frame rate it was recorded at */
+		FVector2D Look = FVector2D::ZeroVector;
+		bool bJump = false;
+	};
+
+	/* Raw numbers for the running pass */
+	struct FPassCapture
+	{
+		TArray<float> GameThreadMs;
+		TArray<float> FrameMs;
+		int32 GCCount = 0;
+		double GCTotalMs = 0.0;
+		double GCMaxMs = 0.0;
+		int32 LevelsStreamed = 0;
+		/* Frames measured while async loading was in flight */
+		int32 AsyncLoadingFrames = 0;
+		/* From map load until world partition streaming completed, -1 if it never did */
+		double StreamingSettleMs = -1.0;
+	};
+
+	EPhase Phase = EPhase::Idle;
+
+	int32 PassIndex = INDEX_NONE;
+
+	/* Engine frames into the current phase, the path is sampled by frame so runs don't depend on wall time */
+	int32 PhaseFrame = 0;
+
+	double PhaseStartTime = 0.0;
+	double LastFrameTime = 0.0;
+	double GCStartTime = 0.0;
+
+	TArray<FPathSample> Path;
+
+	FPassCapture Capture;
+
+	/* Map short name -> metrics */
+	TSharedPtr<FJsonObject> Summary;
+
+	TWeakObjectPtr<ACharacter> DrivenCharacter;
+
+	FTSTicker::FDelegateHandle TickerHandle;
+
+	/* Recording state for Watcher.Benchmark.Record */
+	TArray<FPathSample> Recording;
+	float RecordingDuration = 0.f;
+	float RecordingElapsed = 0.f;
+	FRotator LastRecordedRotation = FRotator::ZeroRotator;
+	FTSTicker::FDelegateHandle RecordTickerHandle;
+
+public:
+
+	//Initialization//
+
+	UClientBenchmarkSubsystem() { }
+
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	virtual void Deinitialize() override;
+
+	//Initialization//
+
+	//Benchmark Interface calls//
+
+	/* If the process was started as a benchmark run */
+	static bool IsBenchmarkRun();
+
+	/**
+	 * Records the local character's input into PathFile
+	 * @param Seconds Length of the recording
+	 */
+	void StartRecording(const float Seconds);
+
+	//Benchmark Interface calls//
+
+private:
+
+	//Benchmark internals//
+
+	bool Tick(float DeltaTime);
+
+	void StartNextPass();
+
+	void BeginMeasuring();
+
+	void FinishPass();
+
+	void FinishBenchmark();
+
+	/* Makes sure an AProject_WatcherCharacter is possessed by the first player */
+	void PossessBenchmarkCharacter();
+
+	/* Applies the path sample for the current frame to the driven character */
+	void DriveCharacter();
+
+	bool LoadPath();
+
+	/* Writes the summary, returns the number of failed metrics (regressions and passes whose streaming never settled) */
+	int32 WriteAndCompareSummary() const;
+
+	float GetTolerance(const FString& Metric) const;
+
+	void HandlePostLoadMap(UWorld* LoadedWorld);
+
+	void HandleLevelAddedToWorld(ULevel* Level, UWorld* World);
+
+	void HandlePreGarbageCollect();
+
+	void HandlePostGarbageCollect();
+
+	bool TickRecording(float DeltaTime);
+
+	//Benchmark internals//
+};
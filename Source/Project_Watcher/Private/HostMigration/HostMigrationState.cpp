@@ -0,0 +1,161 @@
+//Project Watcher 2024 & Beyond
+
+#include "HostMigrationState.h"
+#include "HostMigrationSubsystem.h"
+#include "Engine/ChildConnection.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "GameFramework/GameStateBase.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
+#include "Net/UnrealNetwork.h"
+#include "TimerManager.h"
+
+AHostMigrationState::AHostMigrationState()
+{
+	PrimaryActorTick.bCanEverTick = false;
+
+	bReplicates = true;
+	bAlwaysRelevant = true;
+	SetReplicatingMovement(false);
+	//Two strings that change when a player joins or leaves
+	NetUpdateFrequency = 1.f;
+}
+
+void AHostMigrationState::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(AHostMigrationState, SuccessorId);
+	DOREPLIFETIME(AHostMigrationState, MigrationToken);
+}
+
+void AHostMigrationState::SetMigrationToken(const FString& Token)
+{
+	this->MigrationToken = Token;
+}
+
+void AHostMigrationState::ClientReceiveSnapshot_Implementation(const FHostMigrationSnapshot& Snapshot)
+{
+	if (UHostMigrationSubsystem* HostMigration = GetGameInstance()->GetSubsystem<UHostMigrationSubsystem>())
+	{
+		HostMigration->StoreSnapshot(Snapshot);
+	}
+}
+
+void AHostMigrationState::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (!HasAuthority())
+	{
+		this->NotifySubsystem();
+		return;
+	}
+
+	if (const UHostMigrationSubsystem* HostMigration = GetGameInstance()->GetSubsystem<UHostMigrationSubsystem>())
+	{
+		GetWorldTimerManager().SetTimer(this->SnapshotTimer, this, &ThisClass::SendSnapshot, HostMigration->GetSnapshotInterval(), true);
+	}
+}
+
+void AHostMigrationState::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	GetWorldTimerManager().ClearTimer(this->SnapshotTimer);
+	Super::EndPlay(EndPlayReason);
+}
+
+void AHostMigrationState::OnRep_MigrationInfo()
+{
+	this->NotifySubsystem();
+}
+
+void AHostMigrationState::SendSnapshot()
+{
+	//Keep the successor while it stays connected, re-electing on ping noise would keep moving the snapshots around
+	APlayerController* Successor = Cast<APlayerController>(GetOwner());
+	if (!IsValid(Successor) || !Successor->PlayerState)
+	{
+		Successor = this->SelectSuccessor();
+	}
+	const FString NewSuccessorId = Successor ? Successor->PlayerState->GetUniqueId().ToString() : FString();
+
+	if (NewSuccessorId != this->SuccessorId)
+	{
+		this->SuccessorId = NewSuccessorId;
+		//Owning connection decides where the Client RPC goes
+		SetOwner(Successor);
+	}
+
+	if (!Successor)
+	{
+		return;
+	}
+
+	const AGameStateBase* GameState = GetWorld()->GetGameState();
+	if (!GameState)
+	{
+		return;
+	}
+
+	FHostMigrationSnapshot Snapshot;
+	Snapshot.Sequence = ++this->SnapshotSequence;
+	Snapshot.ServerWorldTime = GameState->GetServerWorldTimeSeconds();
+	Snapshot.Players.Reserve(GameState->PlayerArray.Num());
+
+	for (const APlayerState* PlayerState : GameState->PlayerArray)
+	{
+		const APawn* Pawn = PlayerState ? PlayerState->GetPawn() : nullptr;
+		if (!Pawn)
+		{
+			continue;
+		}
+
+		FHostMigrationPlayerSnapshot& Entry = Snapshot.Players.AddDefaulted_GetRef();
+		Entry.PlayerId = PlayerState->GetUniqueId().ToString();
+		Entry.State.Location = Pawn->GetActorLocation();
+		Entry.State.Rotation = Pawn->GetActorRotation();
+		Entry.State.ControlRotation = Pawn->GetControlRotation();
+	}
+
+	this->ClientReceiveSnapshot(Snapshot);
+}
+
+APlayerController* AHostMigrationState::SelectSuccessor() const
+{
+	APlayerController* Successor = nullptr;
+	float BestPing = TNumericLimits<float>::Max();
+
+	for (FConstPlayerControllerIterator Iterator = GetWorld()->GetPlayerControllerIterator(); Iterator; ++Iterator)
+	{
+		APlayerController* PlayerController = Iterator->Get();
+		if (!PlayerController || PlayerController->IsLocalController() || !PlayerController->PlayerState)
+		{
+			continue;
+		}
+
+		//Split screen guests ride their primary's connection and can't host on their own
+		if (PlayerController->GetNetConnection() && PlayerController->GetNetConnection()->IsA<UChildConnection>())
+		{
+			continue;
+		}
+
+		const float Ping = PlayerController->PlayerState->GetPingInMilliseconds();
+		if (Ping < BestPing)
+		{
+			BestPing = Ping;
+			Successor = PlayerController;
+		}
+	}
+
+	return Successor;
+}
+
+void AHostMigrationState::NotifySubsystem() const
+{
+	if (UHostMigrationSubsystem* HostMigration = GetGameInstance()->GetSubsystem<UHostMigrationSubsystem>())
+	{
+		HostMigration->SetMigrationInfo(this->SuccessorId, this->MigrationToken);
+	}
+}
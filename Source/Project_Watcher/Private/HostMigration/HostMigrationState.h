@@ -0,0 +1,101 @@
+//Project Watcher 2024 & Beyond
+
+#pragma once
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "PlayerRestore/PlayerRestoreSubsystem.h"
+#include "HostMigrationState.generated.h"
+
+class APlayerController;
+
+//Wrapper for BP data//
+
+/* One player's entry in a migration snapshot */
+USTRUCT()
+struct FHostMigrationPlayerSnapshot
+{
+	GENERATED_USTRUCT_BODY()
+public:
+	/* Unique net id string, how the replacement host recognises the player when it logs back in */
+	UPROPERTY()
+	FString PlayerId;
+	UPROPERTY()
+	FPlayerRestoreData State;
+};
+
+/* Compact authoritative state the host streams to its successor */
+USTRUCT()
+struct FHostMigrationSnapshot
+{
+	GENERATED_USTRUCT_BODY()
+public:
+	/* Increments every snapshot so the successor can tell stale ones apart */
+	UPROPERTY()
+	uint32 Sequence = 0;
+	UPROPERTY()
+	float ServerWorldTime = 0.f;
+	UPROPERTY()
+	TArray<FHostMigrationPlayerSnapshot> Players;
+};
+
+//Wrapper for BP data//
+
+/**
+ * Single always relevant actor per listen server world that picks a successor host and keeps it up to date.
+ * The successor id replicates to everyone so every client knows who will take over,
+ * the actor is owned by the successor's controller so the snapshot RPC only travels to that one connection.
+ * Spawned by UHostMigrationSubsystem on the authority.
+ */
+UCLASS(NotPlaceable, Transient)
+class AHostMigrationState : public AActor
+{
+	GENERATED_BODY()
+private:
+	/* Unique net id string of the player that takes over hosting if we drop */
+	UPROPERTY(ReplicatedUsing = OnRep_MigrationInfo)
+	FString SuccessorId;
+
+	/* Token of the session, the replacement session advertises it so clients can find it */
+	UPROPERTY(ReplicatedUsing = OnRep_MigrationInfo)
+	FString MigrationToken;
+
+	uint32 SnapshotSequence = 0;
+
+	FTimerHandle SnapshotTimer;
+
+public:
+	AHostMigrationState();
+
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	/**
+	 * Sets the token clients search the replacement session with, authority only
+	 * @param Token The session's migration token
+	 */
+	void SetMigrationToken(const FString& Token);
+
+	/**
+	 * Delivers the latest snapshot to the successor
+	 * @param Snapshot State of every player at the time of sending
+	 */
+	UFUNCTION(Client, Unreliable)
+	void ClientReceiveSnapshot(const FHostMigrationSnapshot& Snapshot);
+
+protected:
+	virtual void BeginPlay() override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+	UFUNCTION()
+	void OnRep_MigrationInfo();
+
+	/* Elects a successor if there is none and sends it a fresh snapshot */
+	void SendSnapshot();
+
+	/* Remote player with the lowest ping, the host's own controllers never qualify */
+	APlayerController* SelectSuccessor() const;
+
+	/* Pushes the replicated ids into the local UHostMigrationSubsystem */
+	void NotifySubsystem() const;
+};
@@ -0,0 +1,394 @@
+//Project Watcher 2024 & Beyond
+
+#include "HostMigrationSubsystem.h"
+#include "NetworkManagerGameInstance/NetworkManagerGameInstance.h"
+#include "PlayerRestore/PlayerRestoreSubsystem.h"
+#include "WatcherMemory/WatcherMemoryTags.h"
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "Engine/LocalPlayer.h"
+#include "Engine/NetDriver.h"
+#include "Engine/World.h"
+#include "TimerManager.h"
+#include "UObject/UObjectGlobals.h"
+
+DECLARE_LOG_CATEGORY_EXTERN(LogHostMigration, Log, All);
+DEFINE_LOG_CATEGORY(LogHostMigration);
+
+void UHostMigrationSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+	Collection.InitializeDependency<UPlayerRestoreSubsystem>();
+
+	if (GEngine)
+	{
+		this->NetworkFailureHandle = GEngine->OnNetworkFailure().AddUObject(this, &ThisClass::HandleNetworkFailure);
+		this->TravelFailureHandle = GEngine->OnTravelFailure().AddUObject(this, &ThisClass::HandleTravelFailure);
+	}
+	FCoreUObjectDelegates::PostLoadMapWithWorld.AddUObject(this, &ThisClass::HandlePostLoadMap);
+
+	if (UNetworkManagerGameInstance* NetworkManager = Collection.InitializeDependency<UNetworkManagerGameInstance>())
+	{
+		NetworkManager->OnNativeEvent(ENetworkManagerEvent::DestroySessionComplete).AddUObject(this, &ThisClass::HandleSessionDestroyed);
+		NetworkManager->OnNativeEvent(ENetworkManagerEvent::DestroySessionFailure).AddUObject(this, &ThisClass::HandleSessionDestroyFailure);
+		NetworkManager->OnNativeEvent(ENetworkManagerEvent::CreateSessionComplete).AddUObject(this, &ThisClass::HandleSessionCreated);
+		NetworkManager->OnNativeEvent(ENetworkManagerEvent::CreateSessionFailure).AddUObject(this, &ThisClass::HandleSessionCreateFailure);
+	}
+}
+
+void UHostMigrationSubsystem::Deinitialize()
+{
+	if (GEngine)
+	{
+		GEngine->OnNetworkFailure().Remove(this->NetworkFailureHandle);
+		GEngine->OnTravelFailure().Remove(this->TravelFailureHandle);
+	}
+	FCoreUObjectDelegates::PostLoadMapWithWorld.RemoveAll(this);
+
+	if (UNetworkManagerGameInstance* NetworkManager = this->GetNetworkManager())
+	{
+		NetworkManager->RemoveNativeListener(this);
+	}
+
+	GetGameInstance()->GetTimerManager().ClearTimer(this->SearchTimer);
+
+	Super::Deinitialize();
+}
+
+void UHostMigrationSubsystem::SetMigrationInfo(const FString& NewSuccessorId, const FString& NewMigrationToken)
+{
+	//Mid migration the old host's values are the ones that matter
+	if (this->IsMigrating())
+	{
+		return;
+	}
+
+	const bool bSuccessorChanged = NewSuccessorId != this->SuccessorId;
+	this->SuccessorId = NewSuccessorId;
+	this->MigrationToken = NewMigrationToken;
+
+	if (bSuccessorChanged)
+	{
+		UE_LOG(LogHostMigration, Display, TEXT("Successor host is now %s%s"), *this->SuccessorId, this->IsLocalPlayerSuccessor() ? TEXT(" (local)") : TEXT(""));
+	}
+
+	//Snapshots are only meant for the successor
+	if (!this->IsLocalPlayerSuccessor())
+	{
+		this->LatestSnapshot = FHostMigrationSnapshot();
+	}
+}
+
+void UHostMigrationSubsystem::StoreSnapshot(const FHostMigrationSnapshot& Snapshot)
+{
+	LLM_SCOPE_BYTAG(Watcher_Networking);
+
+	//Unreliable, an older one can arrive after a newer one
+	if (Snapshot.Sequence <= this->LatestSnapshot.Sequence || this->IsMigrating())
+	{
+		return;
+	}
+
+	this->LatestSnapshot = Snapshot;
+}
+
+bool UHostMigrationSubsystem::IsMigrating() const
+{
+	return this->Phase != EHostMigrationPhase::Idle;
+}
+
+bool UHostMigrationSubsystem::IsLocalPlayerSuccessor() const
+{
+	return !this->SuccessorId.IsEmpty() && this->SuccessorId == this->GetLocalPlayerId();
+}
+
+UNetworkManagerGameInstance* UHostMigrationSubsystem::GetNetworkManager() const
+{
+	return GetGameInstance()->GetSubsystem<UNetworkManagerGameInstance>();
+}
+
+FString UHostMigrationSubsystem::GetLocalPlayerId() const
+{
+	if (const ULocalPlayer* LocalPlayer = GetGameInstance()->GetFirstGamePlayer())
+	{
+		return LocalPlayer->GetPreferredUniqueNetId().ToString();
+	}
+	return FString();
+}
+
+void UHostMigrationSubsystem::HandleNetworkFailure(UWorld* World, UNetDriver* NetDriver, ENetworkFailure::Type FailureType, const FString& ErrorString)
+{
+	if (!this->bEnableHostMigration || !NetDriver)
+	{
+		return;
+	}
+
+	//Couldn't reach the replacement host (pending net driver) or lost it while travelling to it, nothing left to migrate to
+	const bool bTravelDriver = NetDriver->NetDriverName == NAME_PendingNetDriver || NetDriver->NetDriverName == NAME_GameNetDriver;
+	if (this->Phase == EHostMigrationPhase::Travelling && bTravelDriver)
+	{
+		UE_LOG(LogHostMigration, Warning, TEXT("Travel to the replacement session failed: %s"), *ErrorString);
+		this->FinishRecovery(false);
+		return;
+	}
+
+	if (NetDriver->NetDriverName != NAME_GameNetDriver)
+	{
+		return;
+	}
+
+	//Only clients lose a host, and only a dropped connection is worth migrating
+	const bool bLostHost = FailureType == ENetworkFailure::ConnectionLost || FailureType == ENetworkFailure::ConnectionTimeout;
+	if (this->IsMigrating() || !bLostHost || !NetDriver->ServerConnection)
+	{
+		return;
+	}
+
+	if (this->SuccessorId.IsEmpty() || this->MigrationToken.IsEmpty())
+	{
+		UE_LOG(LogHostMigration, Warning, TEXT("Lost the host before a successor was chosen, can't migrate: %s"), *ErrorString);
+		return;
+	}
+
+	UE_LOG(LogHostMigration, Display, TEXT("Lost the host (%s), migrating to %s"), ENetworkFailure::ToString(FailureType), *this->SuccessorId);
+	this->RecoveryStartTime = FPlatformTime::Seconds();
+	this->ReplacementSearches = 0;
+
+	//The engine sends us back to the default map first, the migration continues once that load finishes
+	this->Phase = EHostMigrationPhase::WaitingForMenu;
+}
+
+void UHostMigrationSubsystem::HandleTravelFailure(UWorld* World, ETravelFailure::Type FailureType, const FString& ErrorString)
+{
+	if (this->Phase == EHostMigrationPhase::Travelling)
+	{
+		UE_LOG(LogHostMigration, Warning, TEXT("Travel to the replacement session failed (%s): %s"), ETravelFailure::ToString(FailureType), *ErrorString);
+		this->FinishRecovery(false);
+	}
+}
+
+void UHostMigrationSubsystem::HandlePostLoadMap(UWorld* LoadedWorld)
+{
+	if (!LoadedWorld || LoadedWorld->GetGameInstance() != GetGameInstance())
+	{
+		return;
+	}
+
+	switch (this->Phase)
+	{
+	case EHostMigrationPhase::WaitingForMenu:
+		//The dead session may still be registered locally, it has to go before we can host or join the replacement
+		this->Phase = EHostMigrationPhase::DestroyingOldSession;
+		this->GetNetworkManager()->DestroySession();
+		return;
+	case EHostMigrationPhase::Travelling:
+		//A failed travel lands us back on the default map, only arriving as a client or as the new host is a recovery
+		this->FinishRecovery(LoadedWorld->GetNetMode() == NM_Client || LoadedWorld->GetNetMode() == NM_ListenServer);
+		break;
+	default:
+		break;
+	}
+
+	this->SpawnStateActor(LoadedWorld);
+}
+
+void UHostMigrationSubsystem::SpawnStateActor(UWorld* World) const
+{
+	if (!this->bEnableHostMigration || World->GetNetMode() != NM_ListenServer)
+	{
+		return;
+	}
+
+	const UNetworkManagerGameInstance* NetworkManager = this->GetNetworkManager();
+	if (!NetworkManager || NetworkManager->GetMigrationToken().IsEmpty())
+	{
+		return;
+	}
+
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	SpawnParameters.ObjectFlags |= RF_Transient;
+	if (AHostMigrationState* State = World->SpawnActor<AHostMigrationState>(SpawnParameters))
+	{
+		State->SetMigrationToken(NetworkManager->GetMigrationToken());
+	}
+}
+
+void UHostMigrationSubsystem::BeginRecoveryAsSuccessor()
+{
+	UE_LOG(LogHostMigration, Display, TEXT("Taking over as host with snapshot %u (%d players)"), this->LatestSnapshot.Sequence, this->LatestSnapshot.Players.Num());
+
+	this->Phase = EHostMigrationPhase::CreatingReplacement;
+	UNetworkManagerGameInstance* NetworkManager = this->GetNetworkManager();
+	NetworkManager->SetMigrationToken(this->MigrationToken);
+	NetworkManager->CreateSession(this->ReplacementSessionPlayerCount, false);
+}
+
+void UHostMigrationSubsystem::BeginRecoveryAsClient()
+{
+	this->Phase = EHostMigrationPhase::SearchingReplacement;
+	GetGameInstance()->GetTimerManager().SetTimer(this->SearchTimer, this, &ThisClass::SearchForReplacement, this->ReplacementSearchDelay, false);
+}
+
+void UHostMigrationSubsystem::SearchForReplacement()
+{
+	if (this->Phase != EHostMigrationPhase::SearchingReplacement)
+	{
+		return;
+	}
+
+	this->ReplacementSearches++;
+	UE_LOG(LogHostMigration, Display, TEXT("Searching for replacement session %s (%d/%d)"), *this->MigrationToken, this->ReplacementSearches, this->MaxReplacementSearches);
+
+	TWeakObjectPtr<UHostMigrationSubsystem> WeakThis(this);
+	this->GetNetworkManager()->FindSessionByMigrationTokenAsync(this->MigrationToken).Next([WeakThis](const FSessionSearchOutcome& Outcome)
+	{
+		if (UHostMigrationSubsystem* HostMigration = WeakThis.Get())
+		{
+			HostMigration->OnReplacementSearchComplete(Outcome);
+		}
+	});
+}
+
+void UHostMigrationSubsystem::OnReplacementSearchComplete(const FSessionSearchOutcome& Outcome)
+{
+	if (this->Phase != EHostMigrationPhase::SearchingReplacement)
+	{
+		return;
+	}
+
+	if (!Outcome.bSuccessful)
+	{
+		this->RetryReplacementSearch(Outcome.Failure);
+		return;
+	}
+
+	this->Phase = EHostMigrationPhase::JoiningReplacement;
+	TWeakObjectPtr<UHostMigrationSubsystem> WeakThis(this);
+	this->GetNetworkManager()->JoinSessionAsync(USessionSearchResult::Make(Outcome.Results[0])).Next([WeakThis](const FSessionOpOutcome& JoinOutcome)
+	{
+		if (UHostMigrationSubsystem* HostMigration = WeakThis.Get())
+		{
+			HostMigration->OnReplacementJoinComplete(JoinOutcome);
+		}
+	});
+}
+
+void UHostMigrationSubsystem::OnReplacementJoinComplete(const FSessionOpOutcome& Outcome)
+{
+	if (this->Phase != EHostMigrationPhase::JoiningReplacement)
+	{
+		return;
+	}
+
+	if (!Outcome.bSuccessful)
+	{
+		//The successor may not be listening yet, go back to searching
+		this->Phase = EHostMigrationPhase::SearchingReplacement;
+		this->RetryReplacementSearch(Outcome.Failure);
+		return;
+	}
+
+	this->Phase = EHostMigrationPhase::Travelling;
+	if (!this->GetNetworkManager()->ServerTravelAsClient_GameMap())
+	{
+		this->FinishRecovery(false);
+	}
+}
+
+void UHostMigrationSubsystem::RetryReplacementSearch(const FString& Failure)
+{
+	if (this->ReplacementSearches >= this->MaxReplacementSearches)
+	{
+		UE_LOG(LogHostMigration, Warning, TEXT("Replacement session never showed up: %s"), *Failure);
+		this->FinishRecovery(false);
+		return;
+	}
+
+	GetGameInstance()->GetTimerManager().SetTimer(this->SearchTimer, this, &ThisClass::SearchForReplacement, this->ReplacementSearchInterval, false);
+}
+
+void UHostMigrationSubsystem::QueueSnapshotRestores()
+{
+	UPlayerRestoreSubsystem* PlayerRestore = GetGameInstance()->GetSubsystem<UPlayerRestoreSubsystem>();
+	if (!PlayerRestore)
+	{
+		return;
+	}
+
+	for (const FHostMigrationPlayerSnapshot& Player : this->LatestSnapshot.Players)
+	{
+		PlayerRestore->AddPendingRestore(Player.PlayerId, Player.State, this->RestoreTimeToLive);
+	}
+}
+
+void UHostMigrationSubsystem::FinishRecovery(const bool bSuccessful)
+{
+	const float SecondsToRecover = static_cast<float>(FPlatformTime::Seconds() - this->RecoveryStartTime);
+	if (bSuccessful)
+	{
+		UE_LOG(LogHostMigration, Display, TEXT("Host migration recovered in %.2f s"), SecondsToRecover);
+	}
+	else
+	{
+		UE_LOG(LogHostMigration, Warning, TEXT("Host migration failed after %.2f s"), SecondsToRecover);
+	}
+
+	GetGameInstance()->GetTimerManager().ClearTimer(this->SearchTimer);
+	this->Phase = EHostMigrationPhase::Idle;
+	this->LatestSnapshot = FHostMigrationSnapshot();
+	this->SuccessorId.Reset();
+	if (!bSuccessful)
+	{
+		this->MigrationToken.Reset();
+	}
+
+	this->OnMigrationComplete.Broadcast(bSuccessful, SecondsToRecover);
+}
+
+void UHostMigrationSubsystem::HandleSessionDestroyed(const FNetworkManagerEvent& Event)
+{
+	if (this->Phase != EHostMigrationPhase::DestroyingOldSession)
+	{
+		return;
+	}
+
+	if (this->IsLocalPlayerSuccessor())
+	{
+		this->BeginRecoveryAsSuccessor();
+	}
+	else
+	{
+		this->BeginRecoveryAsClient();
+	}
+}
+
+void UHostMigrationSubsystem::HandleSessionDestroyFailure(const FNetworkManagerEvent& Event)
+{
+	//Nothing to destroy is just as good
+	this->HandleSessionDestroyed(Event);
+}
+
+void UHostMigrationSubsystem::HandleSessionCreated(const FNetworkManagerEvent& Event)
+{
+	if (this->Phase != EHostMigrationPhase::CreatingReplacement)
+	{
+		return;
+	}
+
+	this->QueueSnapshotRestores();
+	this->Phase = EHostMigrationPhase::Travelling;
+	if (!this->GetNetworkManager()->ServerTravelAsHost_GameMap())
+	{
+		this->FinishRecovery(false);
+	}
+}
+
+void UHostMigrationSubsystem::HandleSessionCreateFailure(const FNetworkManagerEvent& Event)
+{
+	if (this->Phase == EHostMigrationPhase::CreatingReplacement)
+	{
+		UE_LOG(LogHostMigration, Warning, TEXT("Couldn't host the replacement session: %s"), *Event.Failure);
+		this->FinishRecovery(false);
+	}
+}
@@ -0,0 +1,204 @@
+//Project Watcher 2024 & Beyond
+
+#pragma once
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Engine/EngineBaseTypes.h"
+#include "HostMigrationState.h"
+#include "HostMigrationSubsystem.generated.h"
+
+class UNetDriver;
+class UNetworkManagerGameInstance;
+struct FNetworkManagerEvent;
+struct FSessionOpOutcome;
+struct FSessionSearchOutcome;
+
+//Wrapper for BP data//
+
+/* Where a migration currently is */
+UENUM(BlueprintType)
+enum class EHostMigrationPhase : uint8
+{
+	Idle,
+	/* Host dropped, waiting for the engine to put us back on the menu map */
+	WaitingForMenu,
+	/* Clearing the dead session before hosting or joining the replacement */
+	DestroyingOldSession,
+	/* Successor: hosting the replacement session */
+	CreatingReplacement,
+	/* Client: looking for the replacement session by token */
+	SearchingReplacement,
+	/* Client: joining the replacement session */
+	JoiningReplacement,
+	/* Travelling into the game map of the replacement session */
+	Travelling
+};
+
+//Wrapper for BP data//
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FHostMigration_OnMigrationComplete, const bool, Successful, const float, SecondsToRecover);
+
+/**
+ * Keeps a listen server session alive when its host leaves.
+ * While playing, the host streams snapshots to a successor through AHostMigrationState.
+ * When the connection to the host is lost the successor hosts a replacement session advertising the same migration token,
+ * the remaining clients search for that token and join it, and the snapshot is used to put every player back where they were.
+ */
+UCLASS(Config=Game)
+class UHostMigrationSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+private:
+	//Settings//
+
+	/* Master switch, when off a lost host ends the session as before */
+	UPROPERTY(Config)
+	bool bEnableHostMigration = true;
+
+	/* Seconds between snapshots sent to the successor */
+	UPROPERTY(Config)
+	float SnapshotInterval = 1.f;
+
+	/* Seconds clients give the successor to host before the first search */
+	UPROPERTY(Config)
+	float ReplacementSearchDelay = 3.f;
+
+	/* Seconds between searches for the replacement session */
+	UPROPERTY(Config)
+	float ReplacementSearchInterval = 2.f;
+
+	/* Searches before a client gives up on the replacement session */
+	UPROPERTY(Config)
+	int32 MaxReplacementSearches = 5;
+
+	/* Player count the replacement session is hosted with */
+	UPROPERTY(Config)
+	int32 ReplacementSessionPlayerCount = 8;
+
+	/* Seconds a restored player entry stays valid on the replacement host */
+	UPROPERTY(Config)
+	float RestoreTimeToLive = 60.f;
+
+	//Settings//
+
+	/* Replicated by AHostMigrationState */
+	FString SuccessorId;
+	FString MigrationToken;
+
+	/* Latest snapshot, only filled on the successor */
+	FHostMigrationSnapshot LatestSnapshot;
+
+	EHostMigrationPhase Phase = EHostMigrationPhase::Idle;
+
+	/* When the host was lost */
+	double RecoveryStartTime = 0.0;
+
+	int32 ReplacementSearches = 0;
+
+	FTimerHandle SearchTimer;
+
+	FDelegateHandle NetworkFailureHandle;
+	FDelegateHandle TravelFailureHandle;
+
+public:
+
+	//Initialization//
+
+	UHostMigrationSubsystem() { }
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	virtual void Deinitialize() override;
+
+	//Initialization//
+
+	//Host Migration Interface calls//
+
+	/* Seconds between snapshots */
+	float GetSnapshotInterval() const { return this->SnapshotInterval; }
+
+	/**
+	 * Called when AHostMigrationState replicates
+	 * @param NewSuccessorId Unique net id string of the successor
+	 * @param NewMigrationToken Token of the current session
+	 */
+	void SetMigrationInfo(const FString& NewSuccessorId, const FString& NewMigrationToken);
+
+	/**
+	 * Keeps the newest snapshot received from the host
+	 * @param Snapshot Snapshot sent through AHostMigrationState
+	 */
+	void StoreSnapshot(const FHostMigrationSnapshot& Snapshot);
+
+	/**
+	 * If a migration is in progress
+	 * @return Phase != Idle
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Host Migration")
+	bool IsMigrating() const;
+
+	/**
+	 * If the local player is the one that takes over hosting
+	 * @return true on the successor
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Host Migration")
+	bool IsLocalPlayerSuccessor() const;
+
+	UPROPERTY(BlueprintCallable, BlueprintAssignable, Category = "Host Migration")
+	FHostMigration_OnMigrationComplete OnMigrationComplete;
+
+	//Host Migration Interface calls//
+
+private:
+
+	//Migration internals//
+
+	UNetworkManagerGameInstance* GetNetworkManager() const;
+
+	/* Unique net id string of the first local player */
+	FString GetLocalPlayerId() const;
+
+	void HandleNetworkFailure(UWorld* World, UNetDriver* NetDriver, ENetworkFailure::Type FailureType, const FString& ErrorString);
+
+	void HandleTravelFailure(UWorld* World, ETravelFailure::Type FailureType, const FString& ErrorString);
+
+	void HandlePostLoadMap(UWorld* LoadedWorld);
+
+	/* Spawns the state actor when this world is a listen server in a session */
+	void SpawnStateActor(UWorld* World) const;
+
+	void BeginRecoveryAsSuccessor();
+
+	void BeginRecoveryAsClient();
+
+	void SearchForReplacement();
+
+	/* Outcome of our own token search, other searches running at the same time never reach it */
+	void OnReplacementSearchComplete(const FSessionSearchOutcome& Outcome);
+
+	void OnReplacementJoinComplete(const FSessionOpOutcome& Outcome);
+
+	/* Schedules the next search or gives up after MaxReplacementSearches */
+	void RetryReplacementSearch(const FString& Failure);
+
+	/* Hands the snapshot to UPlayerRestoreSubsystem so players get put back as they log in */
+	void QueueSnapshotRestores();
+
+	void FinishRecovery(const bool bSuccessful);
+
+	//Migration internals//
+
+	//Network Manager callbacks//
+
+	void HandleSessionDestroyed(const FNetworkManagerEvent& Event);
+
+	void HandleSessionDestroyFailure(const FNetworkManagerEvent& Event);
+
+	void HandleSessionCreated(const FNetworkManagerEvent& Event);
+
+	void HandleSessionCreateFailure(const FNetworkManagerEvent& Event);
+
+	//Network Manager callbacks//
+
+	friend class FHostMigrationReplacementSearchTest;
+};
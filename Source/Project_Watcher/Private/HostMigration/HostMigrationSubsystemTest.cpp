@@ -0,0 +1,70 @@
+//Project Watcher 2024 & Beyond
+
+#include "HostMigrationSubsystem.h"
+#include "NetworkManagerGameInstance/NetworkManagerGameInstance.h"
+#include "WatcherTests/WatcherTestGameInstance.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/**
+ * Project.Watcher.HostMigration.ReplacementSearch
+ * Puts a client into the replacement search and checks that only the outcome of its own token search moves the migration on,
+ * a find sessions completion broadcast for somebody else's search must not make it join anything.
+ * Then checks that a travel to the replacement only counts as a recovery when it arrives in a networked world.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHostMigrationReplacementSearchTest, "Project.Watcher.HostMigration.ReplacementSearch",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FHostMigrationReplacementSearchTest::RunTest(const FString& Parameters)
+{
+	const FWatcherTestGameInstance GameInstance;
+	UHostMigrationSubsystem* HostMigration = GameInstance.GetSubsystem<UHostMigrationSubsystem>();
+	UNetworkManagerGameInstance* NetworkManager = GameInstance.GetSubsystem<UNetworkManagerGameInstance>();
+	if (!TestNotNull(TEXT("Host migration subsystem"), HostMigration) || !TestNotNull(TEXT("Network manager"), NetworkManager))
+	{
+		return false;
+	}
+
+	//A client that lost its host and is on its last search for the replacement
+	HostMigration->SuccessorId = TEXT("Successor");
+	HostMigration->MigrationToken = TEXT("TestMigrationToken");
+	HostMigration->RecoveryStartTime = FPlatformTime::Seconds();
+	HostMigration->Phase = EHostMigrationPhase::SearchingReplacement;
+	HostMigration->ReplacementSearches = HostMigration->MaxReplacementSearches;
+
+	//Somebody else's search (server browser, QuickMatch...) finishing while ours is in flight
+	NetworkManager->CallOnFindSessionsComplete({ FOnlineSessionSearchResult() });
+	NetworkManager->FlushEvents(0.f);
+	TestTrue(TEXT("Still searching after an unrelated search completed"), HostMigration->Phase == EHostMigrationPhase::SearchingReplacement);
+
+	//Our own search coming back empty on the last attempt ends the migration
+	FSessionSearchOutcome NotFound;
+	NotFound.Failure = TEXT("Session not found");
+	HostMigration->OnReplacementSearchComplete(NotFound);
+	TestFalse(TEXT("Migrating after the last search failed"), HostMigration->IsMigrating());
+	TestTrue(TEXT("Failed migration forgets its token"), HostMigration->MigrationToken.IsEmpty());
+
+	//A search resolving after the migration ended must not start a join
+	FSessionSearchOutcome Late;
+	Late.bSuccessful = true;
+	Late.Results.Add(FOnlineSessionSearchResult());
+	HostMigration->OnReplacementSearchComplete(Late);
+	TestTrue(TEXT("Late search outcome ignored"), HostMigration->Phase == EHostMigrationPhase::Idle);
+
+	//Travel to the replacement bouncing us back to a standalone map is a failed migration, not a recovery
+	HostMigration->MigrationToken = TEXT("TestMigrationToken");
+	HostMigration->Phase = EHostMigrationPhase::Travelling;
+	HostMigration->HandlePostLoadMap(GameInstance.Get()->GetWorld());
+	TestFalse(TEXT("Migrating after landing on a standalone map"), HostMigration->IsMigrating());
+	TestTrue(TEXT("Standalone landing fails the migration"), HostMigration->MigrationToken.IsEmpty());
+
+	HostMigration->MigrationToken = TEXT("TestMigrationToken");
+	HostMigration->Phase = EHostMigrationPhase::Travelling;
+	HostMigration->HandleTravelFailure(GameInstance.Get()->GetWorld(), ETravelFailure::TravelFailure, TEXT("Test"));
+	TestTrue(TEXT("Travel failure fails the migration"), HostMigration->Phase == EHostMigrationPhase::Idle && HostMigration->MigrationToken.IsEmpty());
+
+	return true;
+}
+
+#endif //WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,221 @@
+//Project Watcher 2024 & Beyond
+
+#include "MatchmakingLoadTestCommandlet.h"
+#include "MatchmakingServiceClient.h"
+#include "MatchmakingSessionIndex.h"
+#include "CoreGlobals.h"
+#include "Containers/Ticker.h"
+#include "HttpManager.h"
+#include "HttpModule.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "WatcherStats/WatcherStats.h"
+
+DECLARE_LOG_CATEGORY_EXTERN(LogMatchmakingLoadTest, Log, All);
+DEFINE_LOG_CATEGORY(LogMatchmakingLoadTest);
+
+namespace MatchmakingLoadTest
+{
+	static const TCHAR* Maps[] = { TEXT("/Game/Core/Maps/MainGame_Map_WP"), TEXT("/Game/Core/Maps/SubGame_Map"), TEXT("/Game/Core/Maps/SubLobby_Map") };
+	static const TCHAR* Regions[] = { TEXT("EU"), TEXT("NA"), TEXT("SA"), TEXT("ASIA"), TEXT("OCE") };
+
+	/* Sessions advertised concurrently while seeding, keeps the socket count sane */
+	static constexpr int32 SeedBatch = 64;
+
+	FMatchmakingSessionEntry MakeSession(FRandomStream& Random, const int32 Number)
+	{
+		FMatchmakingSessionEntry Entry;
+		Entry.OwnerName = FString::Printf(TEXT("LoadTest_%d"), Number);
+		Entry.MapName = Maps[Random.RandHelper(UE_ARRAY_COUNT(Maps))];
+		Entry.Region = Regions[Random.RandHelper(UE_ARRAY_COUNT(Regions))];
+		Entry.ConnectAddress = FString::Printf(TEXT("127.0.0.1:%d"), 7777 + Number % 1000);
+		Entry.BuildId = 1;
+		Entry.MaxPlayers = 8;
+		Entry.OpenSlots = Random.RandRange(0, Entry.MaxPlayers);
+		Entry.bPrivate = Random.FRand() < 0.2f;
+		return Entry;
+	}
+
+	/* The shapes of query the game sends, from browse everything to quick match */
+	FMatchmakingQuery MakeQuery(FRandomStream& Random)
+	{
+		FMatchmakingQuery Query;
+		Query.BuildId = 1;
+		Query.MinOpenSlots = Random.RandRange(1, 4);
+		Query.MaxResults = 50;
+		switch (Random.RandHelper(4))
+		{
+		case 0:
+			break;
+		case 1:
+			Query.MapName = Maps[Random.RandHelper(UE_ARRAY_COUNT(Maps))];
+			break;
+		case 2:
+			Query.Region = Regions[Random.RandHelper(UE_ARRAY_COUNT(Regions))];
+			break;
+		default:
+			Query.MapName = Maps[Random.RandHelper(UE_ARRAY_COUNT(Maps))];
+			Query.Region = Regions[Random.RandHelper(UE_ARRAY_COUNT(Regions))];
+			Query.Privacy = EMatchmakingPrivacy::PublicOnly;
+			break;
+		}
+		return Query;
+	}
+
+	/* Ticks what the HTTP requests need until Done returns true or the engine is asked to exit */
+	void PumpUntil(const TFunctionRef<bool()> Done)
+	{
+		double LastTime = FPlatformTime::Seconds();
+		while (!Done() && !IsEngineExitRequested())
+		{
+			const double Now = FPlatformTime::Seconds();
+			const float DeltaTime = static_cast<float>(Now - LastTime);
+			FHttpModule::Get().GetHttpManager().Tick(DeltaTime);
+			FTSTicker::GetCoreTicker().Tick(DeltaTime);
+			LastTime = Now;
+			FPlatformProcess::Sleep(0.f);
+		}
+	}
+}
+
+UMatchmakingLoadTestCommandlet::UMatchmakingLoadTestCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+	HelpDescription = TEXT("Measures queries/sec and latency percentiles of the matchmaking service");
+	HelpUsage = TEXT("-run=MatchmakingLoadTest [-URL=http://127.0.0.1:8420] [-Sessions=5000] [-Concurrency=32] [-Duration=10] [-InProcess] [-Out=Saved/Matchmaking/LoadTest.csv]");
+}
+
+int32 UMatchmakingLoadTestCommandlet::Main(const FString& Params)
+{
+	FString URL = TEXT("http://127.0.0.1:8420");
+	FParse::Value(*Params, TEXT("URL="), URL);
+	int32 NumSessions = 5000;
+	FParse::Value(*Params, TEXT("Sessions="), NumSessions);
+	int32 Concurrency = 32;
+	FParse::Value(*Params, TEXT("Concurrency="), Concurrency);
+	Concurrency = FMath::Max(1, Concurrency);
+	double Duration = 10.0;
+	FParse::Value(*Params, TEXT("Duration="), Duration);
+	const bool bInProcess = FParse::Param(*Params, TEXT("InProcess"));
+	FString OutFile = FPaths::ProjectSavedDir() / TEXT("Matchmaking/LoadTest.csv");
+	FParse::Value(*Params, TEXT("Out="), OutFile);
+
+	FRandomStream Random(1234);
+	TArray<double> Latencies;
+	int32 Failures = 0;
+	int64 ResultsReturned = 0;
+	double Elapsed = 0.0;
+
+	if (bInProcess)
+	{
+		FMatchmakingSessionIndex Index;
+		for (int32 Number = 0; Number < NumSessions; ++Number)
+		{
+			Index.Add(MatchmakingLoadTest::MakeSession(Random, Number));
+		}
+
+		TArray<FMatchmakingSessionEntry> Entries;
+		const double Start = FPlatformTime::Seconds();
+		while ((Elapsed = FPlatformTime::Seconds() - Start) < Duration)
+		{
+			const FMatchmakingQuery Query = MatchmakingLoadTest::MakeQuery(Random);
+			const double QueryStart = FPlatformTime::Seconds();
+			Index.Query(Query, Entries);
+			Latencies.Add(FPlatformTime::Seconds() - QueryStart);
+			ResultsReturned += Entries.Num();
+		}
+	}
+	else
+	{
+		const TSharedRef<FMatchmakingServiceClient> Client = MakeShared<FMatchmakingServiceClient>(URL);
+
+		//Seed
+		TArray<FString> SeededIds;
+		SeededIds.Reserve(NumSessions);
+		int32 Advertised = 0;
+		int32 InFlight = 0;
+		const double SeedStart = FPlatformTime::Seconds();
+		MatchmakingLoadTest::PumpUntil([&]()
+		{
+			while (InFlight < MatchmakingLoadTest::SeedBatch && Advertised < NumSessions)
+			{
+				++InFlight;
+				Client->Advertise(MatchmakingLoadTest::MakeSession(Random, Advertised++), [&SeededIds, &InFlight](const FString& Id)
+				{
+					--InFlight;
+					if (!Id.IsEmpty())
+					{
+						SeededIds.Add(Id);
+					}
+				});
+			}
+			return Advertised >= NumSessions && InFlight == 0;
+		});
+		UE_LOG(LogMatchmakingLoadTest, Display, TEXT("Advertised %d / %d sessions in %.2fs"), SeededIds.Num(), NumSessions, FPlatformTime::Seconds() - SeedStart);
+		if (SeededIds.IsEmpty())
+		{
+			UE_LOG(LogMatchmakingLoadTest, Error, TEXT("Nothing could be advertised, is the service running at %s?"), *URL);
+			return 1;
+		}
+
+		//Measure, a closed loop keeping Concurrency queries in flight
+		const double Start = FPlatformTime::Seconds();
+		InFlight = 0;
+		MatchmakingLoadTest::PumpUntil([&]()
+		{
+			Elapsed = FPlatformTime::Seconds() - Start;
+			const bool bSending = Elapsed < Duration;
+			while (bSending && InFlight < Concurrency)
+			{
+				++InFlight;
+				const double QueryStart = FPlatformTime::Seconds();
+				Client->Query(MatchmakingLoadTest::MakeQuery(Random), [&, QueryStart](const bool bSuccessful, TArray<FMatchmakingSessionEntry>&& Entries)
+				{
+					--InFlight;
+					if (!bSuccessful)
+					{
+						++Failures;
+						return;
+					}
+					Latencies.Add(FPlatformTime::Seconds() - QueryStart);
+					ResultsReturned += Entries.Num();
+				});
+			}
+			return !bSending && InFlight == 0;
+		});
+		Elapsed = FMath::Min(Elapsed, FPlatformTime::Seconds() - Start);
+
+		for (const FString& Id : SeededIds)
+		{
+			Client->Withdraw(Id);
+		}
+		FHttpModule::Get().GetHttpManager().Flush(EHttpFlushReason::Shutdown);
+	}
+
+	Latencies.Sort();
+	const int32 Completed = Latencies.Num();
+	const double QPS = Elapsed > 0.0 ? Completed / Elapsed : 0.0;
+	const double P50 = WatcherStats::PercentileSorted(Latencies, 0.50) * 1000.0;
+	const double P95 = WatcherStats::PercentileSorted(Latencies, 0.95) * 1000.0;
+	const double P99 = WatcherStats::PercentileSorted(Latencies, 0.99) * 1000.0;
+	const double Max = Completed > 0 ? Latencies.Last() * 1000.0 : 0.0;
+	const double AvgResults = Completed > 0 ? static_cast<double>(ResultsReturned) / Completed : 0.0;
+
+	UE_LOG(LogMatchmakingLoadTest, Display, TEXT("%s, %d sessions, concurrency %d, %.1fs"), bInProcess ? TEXT("In process") : *URL, NumSessions, bInProcess ? 1 : Concurrency, Elapsed);
+	UE_LOG(LogMatchmakingLoadTest, Display, TEXT("  %d queries, %d failed, %.0f queries/s, %.1f results per query"), Completed, Failures, QPS, AvgResults);
+	UE_LOG(LogMatchmakingLoadTest, Display, TEXT("  Latency ms: p50 %.3f, p95 %.3f, p99 %.3f, max %.3f"), P50, P95, P99, Max);
+
+	//One row per run so results of different builds / settings line up in one file
+	const FString Header = TEXT("Mode,Sessions,Concurrency,Seconds,Queries,Failures,QPS,P50Ms,P95Ms,P99Ms,MaxMs\n");
+	const FString Row = FString::Printf(TEXT("%s,%d,%d,%.2f,%d,%d,%.1f,%.3f,%.3f,%.3f,%.3f\n"),
+		bInProcess ? TEXT("InProcess") : TEXT("HTTP"), NumSessions, bInProcess ? 1 : Concurrency, Elapsed, Completed, Failures, QPS, P50, P95, P99, Max);
+	const bool bNewFile = !FPaths::FileExists(OutFile);
+	FFileHelper::SaveStringToFile(bNewFile ? Header + Row : Row, *OutFile, FFileHelper::EEncodingOptions::AutoDetect, &IFileManager::Get(), bNewFile ? FILEWRITE_None : FILEWRITE_Append);
+	UE_LOG(LogMatchmakingLoadTest, Display, TEXT("Appended to %s"), *OutFile);
+
+	return Failures > 0 && Completed == 0 ? 1 : 0;
+}
@@ -0,0 +1,24 @@
+//Project Watcher 2024 & Beyond
+
+#pragma once
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "MatchmakingLoadTestCommandlet.generated.h"
+
+/**
+ * Load test client of the matchmaking service. Advertises -Sessions fake sessions spread over maps / regions / slot counts,
+ * then keeps -Concurrency queries in flight for -Duration seconds and reports queries/sec and latency percentiles.
+ * -InProcess runs the same queries straight against FMatchmakingSessionIndex to separate index cost from HTTP cost.
+ *
+ * UnrealEditor-Cmd Project_Watcher.uproject -run=MatchmakingLoadTest [-URL=http://127.0.0.1:8420] [-Sessions=5000]
+ *     [-Concurrency=32] [-Duration=10] [-InProcess] [-Out=Saved/Matchmaking/LoadTest.csv]
+ */
+UCLASS()
+class UMatchmakingLoadTestCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+public:
+	UMatchmakingLoadTestCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,138 @@
+//Project Watcher 2024 & Beyond
+
+#include "MatchmakingServiceClient.h"
+#include "Dom/JsonObject.h"
+#include "Dom/JsonValue.h"
+#include "HttpModule.h"
+#include "Interfaces/IHttpRequest.h"
+#include "Interfaces/IHttpResponse.h"
+#include "OnlineSessionSettings.h"
+#include "Online/OnlineSessionNames.h"
+#include "NetworkManagerGameInstance/NetworkManagerGameInstance.h"
+
+DECLARE_LOG_CATEGORY_EXTERN(LogMatchmakingClient, Log, All);
+DEFINE_LOG_CATEGORY(LogMatchmakingClient);
+
+FMatchmakingServiceClient::FMatchmakingServiceClient(const FString& BaseURLIn)
+	: BaseURL(BaseURLIn)
+{
+	this->BaseURL.RemoveFromEnd(TEXT("/"));
+}
+
+void FMatchmakingServiceClient::Advertise(const FMatchmakingSessionEntry& Entry, TFunction<void(const FString&)>&& OnComplete)
+{
+	const TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = this->MakeRequest(TEXT("POST"), TEXT("/sessions"));
+	Request->SetContentAsString(MatchmakingJson::Write(Entry.ToJson()));
+	Request->OnProcessRequestComplete().BindLambda([OnComplete = MoveTemp(OnComplete)](FHttpRequestPtr, FHttpResponsePtr Response, bool bConnected)
+	{
+		FString Id;
+		if (bConnected && Response.IsValid() && EHttpResponseCodes::IsOk(Response->GetResponseCode()))
+		{
+			if (const TSharedPtr<FJsonObject> Json = MatchmakingJson::Read(Response->GetContentAsString()))
+			{
+				Json->TryGetStringField(TEXT("id"), Id);
+			}
+		}
+		if (Id.IsEmpty())
+		{
+			UE_LOG(LogMatchmakingClient, Warning, TEXT("Advertise failed (%d)"), Response.IsValid() ? Response->GetResponseCode() : 0);
+		}
+		OnComplete(Id);
+	});
+	Request->ProcessRequest();
+}
+
+void FMatchmakingServiceClient::Heartbeat(const FString& Id, const int32 OpenSlots, TFunction<void(bool)>&& OnComplete)
+{
+	const TSharedRef<FJsonObject> Json = MakeShared<FJsonObject>();
+	Json->SetNumberField(TEXT("openSlots"), OpenSlots);
+
+	const TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = this->MakeRequest(TEXT("PUT"), TEXT("/sessions/") + Id);
+	Request->SetContentAsString(MatchmakingJson::Write(Json));
+	Request->OnProcessRequestComplete().BindLambda([OnComplete = MoveTemp(OnComplete)](FHttpRequestPtr, FHttpResponsePtr Response, bool bConnected)
+	{
+		//Only a 404 means the session is gone, a service that's briefly unreachable keeps it alive on its side for the TTL
+		OnComplete(!Response.IsValid() || Response->GetResponseCode() != EHttpResponseCodes::NotFound);
+	});
+	Request->ProcessRequest();
+}
+
+void FMatchmakingServiceClient::Withdraw(const FString& Id)
+{
+	this->MakeRequest(TEXT("DELETE"), TEXT("/sessions/") + Id)->ProcessRequest();
+}
+
+void FMatchmakingServiceClient::Query(const FMatchmakingQuery& Query, TFunction<void(bool, TArray<FMatchmakingSessionEntry>&&)>&& OnComplete)
+{
+	const TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = this->MakeRequest(TEXT("GET"), TEXT("/sessions") + Query.ToQueryString());
+	Request->OnProcessRequestComplete().BindLambda([OnComplete = MoveTemp(OnComplete)](FHttpRequestPtr, FHttpResponsePtr Response, bool bConnected)
+	{
+		TArray<FMatchmakingSessionEntry> Entries;
+		const TSharedPtr<FJsonObject> Json = bConnected && Response.IsValid() && EHttpResponseCodes::IsOk(Response->GetResponseCode())
+			? MatchmakingJson::Read(Response->GetContentAsString()) : nullptr;
+
+		const TArray<TSharedPtr<FJsonValue>>* Sessions = nullptr;
+		if (!Json.IsValid() || !Json->TryGetArrayField(TEXT("sessions"), Sessions))
+		{
+			UE_LOG(LogMatchmakingClient, Warning, TEXT("Query failed (%d)"), Response.IsValid() ? Response->GetResponseCode() : 0);
+			OnComplete(false, MoveTemp(Entries));
+			return;
+		}
+
+		Entries.Reserve(Sessions->Num());
+		for (const TSharedPtr<FJsonValue>& Value : *Sessions)
+		{
+			FMatchmakingSessionEntry Entry;
+			if (Entry.FromJson(Value->AsObject()))
+			{
+				Entries.Add(MoveTemp(Entry));
+			}
+		}
+		OnComplete(true, MoveTemp(Entries));
+	});
+	Request->ProcessRequest();
+}
+
+void FMatchmakingServiceClient::FindById(const FString& Id, TFunction<void(const FMatchmakingSessionEntry*)>&& OnComplete)
+{
+	const TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = this->MakeRequest(TEXT("GET"), TEXT("/sessions/") + Id);
+	Request->OnProcessRequestComplete().BindLambda([OnComplete = MoveTemp(OnComplete)](FHttpRequestPtr, FHttpResponsePtr Response, bool bConnected)
+	{
+		FMatchmakingSessionEntry Entry;
+		const bool bFound = bConnected && Response.IsValid() && EHttpResponseCodes::IsOk(Response->GetResponseCode())
+			&& Entry.FromJson(MatchmakingJson::Read(Response->GetContentAsString()));
+		OnComplete(bFound ? &Entry : nullptr);
+	});
+	Request->ProcessRequest();
+}
+
+FOnlineSessionSearchResult FMatchmakingServiceClient::ToSearchResult(const FMatchmakingSessionEntry& Entry)
+{
+	FOnlineSessionSearchResult Result;
+	Result.Session.OwningUserName = Entry.OwnerName;
+	Result.Session.NumOpenPublicConnections = Entry.OpenSlots;
+	Result.Session.NumOpenPrivateConnections = 0;
+
+	FOnlineSessionSettings& Settings = Result.Session.SessionSettings;
+	Settings.NumPublicConnections = Entry.MaxPlayers;
+	//Service sessions are reached by ip:port over IpNetDriver, same as LAN ones
+	Settings.bIsLANMatch = true;
+	Settings.bUsesPresence = false;
+	Settings.Set(SETTING_MAPNAME, Entry.MapName, EOnlineDataAdvertisementType::ViaOnlineService);
+	Settings.Set(SETTING_BUILDID, Entry.BuildId, EOnlineDataAdvertisementType::ViaOnlineService);
+	Settings.Set(SETTING_PRIVATE, Entry.bPrivate, EOnlineDataAdvertisementType::ViaOnlineService);
+	Settings.Set(SETTING_REGION, Entry.Region, EOnlineDataAdvertisementType::ViaOnlineService);
+	Settings.Set(SETTING_MIGRATIONTOKEN, Entry.MigrationToken, EOnlineDataAdvertisementType::ViaOnlineService);
+	Settings.Set(SETTING_CONNECTADDRESS, Entry.ConnectAddress, EOnlineDataAdvertisementType::ViaOnlineService);
+	Settings.Set(SETTING_SERVICESESSIONID, Entry.Id, EOnlineDataAdvertisementType::ViaOnlineService);
+	return Result;
+}
+
+TSharedRef<IHttpRequest, ESPMode::ThreadSafe> FMatchmakingServiceClient::MakeRequest(const FString& Verb, const FString& Path) const
+{
+	const TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = FHttpModule::Get().CreateRequest();
+	Request->SetVerb(Verb);
+	Request->SetURL(this->BaseURL + Path);
+	Request->SetHeader(TEXT("Content-Type"), TEXT("application/json"));
+	return Request;
+}
@@ -0,0 +1,64 @@
+//Project Watcher 2024 & Beyond
+
+#pragma once
+#include "CoreMinimal.h"
+#include "MatchmakingTypes.h"
+
+class FOnlineSessionSearchResult;
+class IHttpRequest;
+
+/**
+ * HTTP client of the matchmaking service (UMatchmakingServiceCommandlet).
+ * Completions run on the game thread, from the HTTP manager's tick. Shared so in flight requests can outlive the owner.
+ */
+class FMatchmakingServiceClient : public TSharedFromThis<FMatchmakingServiceClient>
+{
+public:
+	/**
+	 * @param BaseURLIn Service root, e.g. http://127.0.0.1:8420
+	 */
+	explicit FMatchmakingServiceClient(const FString& BaseURLIn);
+
+	/**
+	 * Advertises a session
+	 * @param Entry The session, Id is ignored
+	 * @param OnComplete Gets the id handed out by the service, empty on failure
+	 */
+	void Advertise(const FMatchmakingSessionEntry& Entry, TFunction<void(const FString&)>&& OnComplete);
+
+	/**
+	 * Keeps an advertised session alive
+	 * @param Id Id from Advertise
+	 * @param OpenSlots Current open slots
+	 * @param OnComplete False when the service no longer knows the session and it needs advertising again
+	 */
+	void Heartbeat(const FString& Id, const int32 OpenSlots, TFunction<void(bool)>&& OnComplete);
+
+	/* Removes an advertised session, fire and forget */
+	void Withdraw(const FString& Id);
+
+	/**
+	 * Queries sessions
+	 * @param Query The query
+	 * @param OnComplete Success flag and the matches
+	 */
+	void Query(const FMatchmakingQuery& Query, TFunction<void(bool, TArray<FMatchmakingSessionEntry>&&)>&& OnComplete);
+
+	/**
+	 * Looks a single session up
+	 * @param Id Id from Advertise, as returned by GetJoinedSessionId
+	 * @param OnComplete Gets the session, nullptr when the service doesn't know it
+	 */
+	void FindById(const FString& Id, TFunction<void(const FMatchmakingSessionEntry*)>&& OnComplete);
+
+	/**
+	 * Session result the network manager can show and join, the address travels in SETTING_CONNECTADDRESS
+	 * @param Entry An entry returned by Query
+	 */
+	static FOnlineSessionSearchResult ToSearchResult(const FMatchmakingSessionEntry& Entry);
+
+private:
+	FString BaseURL;
+
+	TSharedRef<IHttpRequest, ESPMode::ThreadSafe> MakeRequest(const FString& Verb, const FString& Path) const;
+};
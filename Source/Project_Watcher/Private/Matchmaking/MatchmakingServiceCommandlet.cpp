@@ -0,0 +1,208 @@
+//Project Watcher 2024 & Beyond
+
+#include "MatchmakingServiceCommandlet.h"
+#include "MatchmakingSessionIndex.h"
+#include "Containers/Ticker.h"
+#include "Dom/JsonObject.h"
+#include "Dom/JsonValue.h"
+#include "HttpPath.h"
+#include "HttpServerModule.h"
+#include "HttpServerRequest.h"
+#include "HttpServerResponse.h"
+#include "IHttpRouter.h"
+#include "CoreGlobals.h"
+
+DECLARE_LOG_CATEGORY_EXTERN(LogMatchmakingService, Log, All);
+DEFINE_LOG_CATEGORY(LogMatchmakingService);
+
+namespace MatchmakingService
+{
+	/* Seconds between expiry sweeps / status lines */
+	static constexpr double SweepInterval = 5.0;
+
+	struct FCounters
+	{
+		int64 Queries = 0;
+		int64 Advertises = 0;
+		int64 Heartbeats = 0;
+		int64 Withdraws = 0;
+		/* Time spent inside FMatchmakingSessionIndex::Query, excludes HTTP */
+		double QuerySeconds = 0.0;
+	};
+
+	FString BodyToString(const FHttpServerRequest& Request)
+	{
+		const FUTF8ToTCHAR Converter(reinterpret_cast<const ANSICHAR*>(Request.Body.GetData()), Request.Body.Num());
+		return FString(Converter.Length(), Converter.Get());
+	}
+
+	TUniquePtr<FHttpServerResponse> JsonResponse(const TSharedRef<FJsonObject>& Json, const EHttpServerResponseCodes Code = EHttpServerResponseCodes::Ok)
+	{
+		TUniquePtr<FHttpServerResponse> Response = FHttpServerResponse::Create(MatchmakingJson::Write(Json), TEXT("application/json"));
+		Response->Code = Code;
+		return Response;
+	}
+}
+
+UMatchmakingServiceCommandlet::UMatchmakingServiceCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+	HelpDescription = TEXT("Runs the local matchmaking service stand-in");
+	HelpUsage = TEXT("-run=MatchmakingService [-Port=8420] [-TTL=30]");
+}
+
+int32 UMatchmakingServiceCommandlet::Main(const FString& Params)
+{
+	int32 Port = 8420;
+	FParse::Value(*Params, TEXT("Port="), Port);
+	double TTL = 30.0;
+	FParse::Value(*Params, TEXT("TTL="), TTL);
+
+	FHttpServerModule& HttpServer = FHttpServerModule::Get();
+	const TSharedPtr<IHttpRouter> Router = HttpServer.GetHttpRouter(Port, true);
+	if (!Router.IsValid())
+	{
+		UE_LOG(LogMatchmakingService, Error, TEXT("Could not bind port %d"), Port);
+		return 1;
+	}
+
+	FMatchmakingSessionIndex Index;
+	MatchmakingService::FCounters Counters;
+
+	Router->BindRoute(FHttpPath(TEXT("/sessions")), EHttpServerRequestVerbs::VERB_GET, FHttpRequestHandler::CreateLambda(
+		[&Index, &Counters](const FHttpServerRequest& Request, const FHttpResultCallback& OnComplete)
+	{
+		const FMatchmakingQuery Query = FMatchmakingQuery::FromQueryParams(Request.QueryParams);
+
+		TArray<FMatchmakingSessionEntry> Entries;
+		const double Start = FPlatformTime::Seconds();
+		Index.Query(Query, Entries);
+		Counters.QuerySeconds += FPlatformTime::Seconds() - Start;
+		Counters.Queries++;
+
+		TArray<TSharedPtr<FJsonValue>> Sessions;
+		Sessions.Reserve(Entries.Num());
+		for (const FMatchmakingSessionEntry& Entry : Entries)
+		{
+			Sessions.Add(MakeShared<FJsonValueObject>(Entry.ToJson()));
+		}
+		const TSharedRef<FJsonObject> Json = MakeShared<FJsonObject>();
+		Json->SetArrayField(TEXT("sessions"), Sessions);
+		OnComplete(MatchmakingService::JsonResponse(Json));
+		return true;
+	}));
+
+	Router->BindRoute(FHttpPath(TEXT("/sessions")), EHttpServerRequestVerbs::VERB_POST, FHttpRequestHandler::CreateLambda(
+		[&Index, &Counters](const FHttpServerRequest& Request, const FHttpResultCallback& OnComplete)
+	{
+		FMatchmakingSessionEntry Entry;
+		if (!Entry.FromJson(MatchmakingJson::Read(MatchmakingService::BodyToString(Request))))
+		{
+			OnComplete(FHttpServerResponse::Error(EHttpServerResponseCodes::BadRequest, TEXT("invalid_session"), TEXT("address and maxPlayers are required")));
+			return true;
+		}
+
+		const TSharedRef<FJsonObject> Json = MakeShared<FJsonObject>();
+		Json->SetStringField(TEXT("id"), Index.Add(MoveTemp(Entry)));
+		Counters.Advertises++;
+		OnComplete(MatchmakingService::JsonResponse(Json, EHttpServerResponseCodes::Created));
+		return true;
+	}));
+
+	Router->BindRoute(FHttpPath(TEXT("/sessions/:id")), EHttpServerRequestVerbs::VERB_GET, FHttpRequestHandler::CreateLambda(
+		[&Index, &Counters](const FHttpServerRequest& Request, const FHttpResultCallback& OnComplete)
+	{
+		const FString* Id = Request.PathParams.Find(TEXT("id"));
+		const FMatchmakingSessionEntry* Entry = Id ? Index.Find(*Id) : nullptr;
+		Counters.Queries++;
+		if (!Entry)
+		{
+			OnComplete(FHttpServerResponse::Error(EHttpServerResponseCodes::NotFound, TEXT("unknown_session")));
+			return true;
+		}
+		OnComplete(MatchmakingService::JsonResponse(Entry->ToJson()));
+		return true;
+	}));
+
+	Router->BindRoute(FHttpPath(TEXT("/sessions/:id")), EHttpServerRequestVerbs::VERB_PUT, FHttpRequestHandler::CreateLambda(
+		[&Index, &Counters](const FHttpServerRequest& Request, const FHttpResultCallback& OnComplete)
+	{
+		const FString* Id = Request.PathParams.Find(TEXT("id"));
+		int32 OpenSlots = -1;
+		if (const TSharedPtr<FJsonObject> Body = MatchmakingJson::Read(MatchmakingService::BodyToString(Request)))
+		{
+			Body->TryGetNumberField(TEXT("openSlots"), OpenSlots);
+		}
+
+		Counters.Heartbeats++;
+		if (!Id || !Index.Heartbeat(*Id, OpenSlots))
+		{
+			//Tells the host to advertise again
+			OnComplete(FHttpServerResponse::Error(EHttpServerResponseCodes::NotFound, TEXT("unknown_session")));
+			return true;
+		}
+		OnComplete(FHttpServerResponse::Ok());
+		return true;
+	}));
+
+	Router->BindRoute(FHttpPath(TEXT("/sessions/:id")), EHttpServerRequestVerbs::VERB_DELETE, FHttpRequestHandler::CreateLambda(
+		[&Index, &Counters](const FHttpServerRequest& Request, const FHttpResultCallback& OnComplete)
+	{
+		const FString* Id = Request.PathParams.Find(TEXT("id"));
+		Counters.Withdraws++;
+		if (!Id || !Index.Remove(*Id))
+		{
+			OnComplete(FHttpServerResponse::Error(EHttpServerResponseCodes::NotFound, TEXT("unknown_session")));
+			return true;
+		}
+		OnComplete(FHttpServerResponse::Ok());
+		return true;
+	}));
+
+	Router->BindRoute(FHttpPath(TEXT("/stats")), EHttpServerRequestVerbs::VERB_GET, FHttpRequestHandler::CreateLambda(
+		[&Index, &Counters](const FHttpServerRequest& Request, const FHttpResultCallback& OnComplete)
+	{
+		const TSharedRef<FJsonObject> Json = MakeShared<FJsonObject>();
+		Json->SetNumberField(TEXT("sessions"), Index.Num());
+		Json->SetNumberField(TEXT("queries"), static_cast<double>(Counters.Queries));
+		Json->SetNumberField(TEXT("advertises"), static_cast<double>(Counters.Advertises));
+		Json->SetNumberField(TEXT("heartbeats"), static_cast<double>(Counters.Heartbeats));
+		Json->SetNumberField(TEXT("withdraws"), static_cast<double>(Counters.Withdraws));
+		Json->SetNumberField(TEXT("avgQueryUs"), Counters.Queries > 0 ? Counters.QuerySeconds * 1e6 / Counters.Queries : 0.0);
+		OnComplete(MatchmakingService::JsonResponse(Json));
+		return true;
+	}));
+
+	HttpServer.StartAllListeners();
+	UE_LOG(LogMatchmakingService, Display, TEXT("Matchmaking service listening on port %d, sessions expire after %.0fs without heartbeat"), Port, TTL);
+
+	//The listeners are driven by the core ticker
+	double LastTime = FPlatformTime::Seconds();
+	double NextSweep = LastTime + MatchmakingService::SweepInterval;
+	int64 QueriesAtLastSweep = 0;
+	while (!IsEngineExitRequested())
+	{
+		const double Now = FPlatformTime::Seconds();
+		FTSTicker::GetCoreTicker().Tick(static_cast<float>(Now - LastTime));
+		LastTime = Now;
+
+		if (Now >= NextSweep)
+		{
+			const int32 Expired = Index.Expire(TTL);
+			const double QPS = (Counters.Queries - QueriesAtLastSweep) / MatchmakingService::SweepInterval;
+			UE_LOG(LogMatchmakingService, Display, TEXT("%d sessions (%d expired), %.0f queries/s, %.1f us avg index time"),
+				Index.Num(), Expired, QPS, Counters.Queries > 0 ? Counters.QuerySeconds * 1e6 / Counters.Queries : 0.0);
+			QueriesAtLastSweep = Counters.Queries;
+			NextSweep = Now + MatchmakingService::SweepInterval;
+		}
+
+		//Yield only, sleeping would show up in the latency the load test measures
+		FPlatformProcess::Sleep(0.f);
+	}
+
+	HttpServer.StopAllListeners();
+	return 0;
+}
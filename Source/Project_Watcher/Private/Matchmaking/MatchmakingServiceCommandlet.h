@@ -0,0 +1,31 @@
+//Project Watcher 2024 & Beyond
+
+#pragma once
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "MatchmakingServiceCommandlet.generated.h"
+
+/**
+ * Stand-in for the online matchmaking backend, a small HTTP service keeping advertised sessions in memory.
+ * Hosts advertise / heartbeat / withdraw their session, clients query by map, region, open slots, build and privacy.
+ * Sessions that miss heartbeats for -TTL seconds are dropped. Point UNetworkManagerGameInstance at it with
+ * SessionBackend=MatchmakingService and MatchmakingServiceURL in DefaultGame.ini.
+ *
+ * GET    /sessions?map=&region=&slots=&build=&private=&max=
+ * GET    /sessions/:id
+ * POST   /sessions            session JSON, answers {"id":"..."}
+ * PUT    /sessions/:id        {"openSlots":N}, answers 404 once the session expired
+ * DELETE /sessions/:id
+ * GET    /stats
+ *
+ * UnrealEditor-Cmd Project_Watcher.uproject -run=MatchmakingService [-Port=8420] [-TTL=30]
+ */
+UCLASS()
+class UMatchmakingServiceCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+public:
+	UMatchmakingServiceCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,174 @@
+//Project Watcher 2024 & Beyond
+
+#include "MatchmakingSessionIndex.h"
+
+FMatchmakingSessionIndex::FMatchmakingSessionIndex()
+{
+	this->BySlots.SetNum(MaxIndexedSlots + 1);
+}
+
+FString FMatchmakingSessionIndex::Add(FMatchmakingSessionEntry Entry)
+{
+	Entry.Id = FGuid::NewGuid().ToString(EGuidFormats::Digits);
+	Entry.OpenSlots = FMath::Clamp(Entry.OpenSlots, 0, Entry.MaxPlayers);
+
+	FIndexedEntry IndexedEntry;
+	IndexedEntry.Entry = MoveTemp(Entry);
+	IndexedEntry.LastHeartbeat = FPlatformTime::Seconds();
+
+	const int32 Index = this->Entries.Add(MoveTemp(IndexedEntry));
+	const FMatchmakingSessionEntry& Added = this->Entries[Index].Entry;
+	this->IdToIndex.Add(Added.Id, Index);
+	this->ByMap.FindOrAdd(Added.MapName).Add(Index);
+	this->ByRegion.FindOrAdd(Added.Region).Add(Index);
+	this->BySlots[SlotBucket(Added.OpenSlots)].Add(Index);
+	return Added.Id;
+}
+
+bool FMatchmakingSessionIndex::Heartbeat(const FString& Id, const int32 OpenSlots)
+{
+	const int32* Index = this->IdToIndex.Find(Id);
+	if (!Index)
+	{
+		return false;
+	}
+
+	FIndexedEntry& IndexedEntry = this->Entries[*Index];
+	IndexedEntry.LastHeartbeat = FPlatformTime::Seconds();
+
+	if (OpenSlots >= 0)
+	{
+		const int32 NewOpenSlots = FMath::Min(OpenSlots, IndexedEntry.Entry.MaxPlayers);
+		if (SlotBucket(NewOpenSlots) != SlotBucket(IndexedEntry.Entry.OpenSlots))
+		{
+			this->BySlots[SlotBucket(IndexedEntry.Entry.OpenSlots)].Remove(*Index);
+			this->BySlots[SlotBucket(NewOpenSlots)].Add(*Index);
+		}
+		IndexedEntry.Entry.OpenSlots = NewOpenSlots;
+	}
+	return true;
+}
+
+bool FMatchmakingSessionIndex::Remove(const FString& Id)
+{
+	int32 Index = INDEX_NONE;
+	if (!this->IdToIndex.RemoveAndCopyValue(Id, Index))
+	{
+		return false;
+	}
+
+	this->Unindex(Index);
+	this->Entries.RemoveAt(Index);
+	return true;
+}
+
+const FMatchmakingSessionEntry* FMatchmakingSessionIndex::Find(const FString& Id) const
+{
+	const int32* Index = this->IdToIndex.Find(Id);
+	return Index ? &this->Entries[*Index].Entry : nullptr;
+}
+
+void FMatchmakingSessionIndex::Query(const FMatchmakingQuery& Query, TArray<FMatchmakingSessionEntry>& OutEntries) const
+{
+	OutEntries.Reset();
+
+	//Walk the most selective index the query allows, Matches checks the rest
+	const TSet<int32>* Candidates = nullptr;
+	if (!Query.MapName.IsEmpty())
+	{
+		Candidates = this->ByMap.Find(Query.MapName);
+		if (!Candidates)
+		{
+			return;
+		}
+	}
+	if (!Query.Region.IsEmpty())
+	{
+		const TSet<int32>* RegionCandidates = this->ByRegion.Find(Query.Region);
+		if (!RegionCandidates)
+		{
+			return;
+		}
+		if (!Candidates || RegionCandidates->Num() < Candidates->Num())
+		{
+			Candidates = RegionCandidates;
+		}
+	}
+
+	if (Candidates)
+	{
+		for (const int32 Index : *Candidates)
+		{
+			const FMatchmakingSessionEntry& Entry = this->Entries[Index].Entry;
+			if (Query.Matches(Entry))
+			{
+				OutEntries.Add(Entry);
+				if (OutEntries.Num() >= Query.MaxResults)
+				{
+					return;
+				}
+			}
+		}
+		return;
+	}
+
+	//No map / region, the slot buckets skip full sessions. Emptiest sessions first
+	for (int32 Bucket = MaxIndexedSlots; Bucket >= SlotBucket(Query.MinOpenSlots); --Bucket)
+	{
+		for (const int32 Index : this->BySlots[Bucket])
+		{
+			const FMatchmakingSessionEntry& Entry = this->Entries[Index].Entry;
+			if (Query.Matches(Entry))
+			{
+				OutEntries.Add(Entry);
+				if (OutEntries.Num() >= Query.MaxResults)
+				{
+					return;
+				}
+			}
+		}
+	}
+}
+
+int32 FMatchmakingSessionIndex::Expire(const double MaxAge)
+{
+	const double Cutoff = FPlatformTime::Seconds() - MaxAge;
+
+	TArray<FString> Expired;
+	for (const FIndexedEntry& IndexedEntry : this->Entries)
+	{
+		if (IndexedEntry.LastHeartbeat < Cutoff)
+		{
+			Expired.Add(IndexedEntry.Entry.Id);
+		}
+	}
+
+	for (const FString& Id : Expired)
+	{
+		this->Remove(Id);
+	}
+	return Expired.Num();
+}
+
+void FMatchmakingSessionIndex::Unindex(const int32 Index)
+{
+	const FMatchmakingSessionEntry& Entry = this->Entries[Index].Entry;
+
+	if (TSet<int32>* MapSet = this->ByMap.Find(Entry.MapName))
+	{
+		MapSet->Remove(Index);
+		if (MapSet->IsEmpty())
+		{
+			this->ByMap.Remove(Entry.MapName);
+		}
+	}
+	if (TSet<int32>* RegionSet = this->ByRegion.Find(Entry.Region))
+	{
+		RegionSet->Remove(Index);
+		if (RegionSet->IsEmpty())
+		{
+			this->ByRegion.Remove(Entry.Region);
+		}
+	}
+	this->BySlots[SlotBucket(Entry.OpenSlots)].Remove(Index);
+}
@@ -0,0 +1,87 @@
+//Project Watcher 2024 & Beyond
+
+#pragma once
+#include "CoreMinimal.h"
+#include "MatchmakingTypes.h"
+
+/**
+ * In memory session registry of the matchmaking service.
+ * Entries live in a sparse array and are indexed by map, region and open slot count,
+ * a query walks the smallest index that applies instead of every advertised session.
+ * Not thread safe, the service only touches it from the game thread.
+ */
+class FMatchmakingSessionIndex
+{
+public:
+	/* Open slot buckets, anything above lands in the last one */
+	static constexpr int32 MaxIndexedSlots = 64;
+
+	FMatchmakingSessionIndex();
+
+	/**
+	 * Adds a session, a new id is assigned
+	 * @param Entry The advertised session, Id is ignored
+	 * @return The id of the session
+	 */
+	FString Add(FMatchmakingSessionEntry Entry);
+
+	/**
+	 * Refreshes the open slot count of a session and keeps it alive
+	 * @param Id Session id from Add
+	 * @param OpenSlots New open slot count, negative leaves it as is
+	 * @return False when the session is unknown (expired or never added)
+	 */
+	bool Heartbeat(const FString& Id, const int32 OpenSlots);
+
+	/**
+	 * Removes a session
+	 * @param Id Session id from Add
+	 * @return False when the session is unknown
+	 */
+	bool Remove(const FString& Id);
+
+	/**
+	 * A single session
+	 * @param Id Session id from Add
+	 * @return nullptr when the session is unknown
+	 */
+	const FMatchmakingSessionEntry* Find(const FString& Id) const;
+
+	/**
+	 * Sessions matching the query, at most Query.MaxResults of them
+	 * @param Query The query
+	 * @param OutEntries Receives the matches
+	 */
+	void Query(const FMatchmakingQuery& Query, TArray<FMatchmakingSessionEntry>& OutEntries) const;
+
+	/**
+	 * Drops sessions whose host stopped sending heartbeats
+	 * @param MaxAge Seconds since the last heartbeat
+	 * @return Amount of sessions dropped
+	 */
+	int32 Expire(const double MaxAge);
+
+	int32 Num() const { return this->IdToIndex.Num(); }
+
+private:
+	struct FIndexedEntry
+	{
+		FMatchmakingSessionEntry Entry;
+		double LastHeartbeat = 0.0;
+	};
+
+	TSparseArray<FIndexedEntry> Entries;
+
+	TMap<FString, int32> IdToIndex;
+
+	TMap<FString, TSet<int32>> ByMap;
+
+	TMap<FString, TSet<int32>> ByRegion;
+
+	/* Index is the open slot count clamped to MaxIndexedSlots */
+	TArray<TSet<int32>> BySlots;
+
+	static int32 SlotBucket(const int32 OpenSlots) { return FMath::Clamp(OpenSlots, 0, MaxIndexedSlots); }
+
+	void Unindex(const int32 Index);
+};
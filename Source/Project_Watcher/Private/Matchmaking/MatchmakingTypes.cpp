@@ -0,0 +1,151 @@
+//Project Watcher 2024 & Beyond
+
+#include "MatchmakingTypes.h"
+#include "Dom/JsonObject.h"
+#include "GenericPlatform/GenericPlatformHttp.h"
+#include "Policies/CondensedJsonPrintPolicy.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+TSharedRef<FJsonObject> FMatchmakingSessionEntry::ToJson() const
+{
+	const TSharedRef<FJsonObject> Json = MakeShared<FJsonObject>();
+	Json->SetStringField(TEXT("id"), this->Id);
+	Json->SetStringField(TEXT("owner"), this->OwnerName);
+	Json->SetStringField(TEXT("map"), this->MapName);
+	Json->SetStringField(TEXT("region"), this->Region);
+	Json->SetStringField(TEXT("address"), this->ConnectAddress);
+	Json->SetStringField(TEXT("migrationToken"), this->MigrationToken);
+	Json->SetNumberField(TEXT("build"), this->BuildId);
+	Json->SetNumberField(TEXT("maxPlayers"), this->MaxPlayers);
+	Json->SetNumberField(TEXT("openSlots"), this->OpenSlots);
+	Json->SetBoolField(TEXT("private"), this->bPrivate);
+	return Json;
+}
+
+bool FMatchmakingSessionEntry::FromJson(const TSharedPtr<FJsonObject>& Json)
+{
+	if (!Json.IsValid() || !Json->TryGetStringField(TEXT("address"), this->ConnectAddress) || !Json->TryGetNumberField(TEXT("maxPlayers"), this->MaxPlayers))
+	{
+		return false;
+	}
+
+	Json->TryGetStringField(TEXT("id"), this->Id);
+	Json->TryGetStringField(TEXT("owner"), this->OwnerName);
+	Json->TryGetStringField(TEXT("map"), this->MapName);
+	Json->TryGetStringField(TEXT("region"), this->Region);
+	Json->TryGetStringField(TEXT("migrationToken"), this->MigrationToken);
+	Json->TryGetNumberField(TEXT("build"), this->BuildId);
+	Json->TryGetBoolField(TEXT("private"), this->bPrivate);
+	if (!Json->TryGetNumberField(TEXT("openSlots"), this->OpenSlots))
+	{
+		this->OpenSlots = this->MaxPlayers;
+	}
+	return true;
+}
+
+FString FMatchmakingQuery::ToQueryString() const
+{
+	TArray<FString> Params;
+	if (!this->MapName.IsEmpty())
+	{
+		Params.Add(TEXT("map=") + FGenericPlatformHttp::UrlEncode(this->MapName));
+	}
+	if (!this->Region.IsEmpty())
+	{
+		Params.Add(TEXT("region=") + FGenericPlatformHttp::UrlEncode(this->Region));
+	}
+	if (this->MinOpenSlots > 0)
+	{
+		Params.Add(FString::Printf(TEXT("slots=%d"), this->MinOpenSlots));
+	}
+	if (this->BuildId != 0)
+	{
+		Params.Add(FString::Printf(TEXT("build=%d"), this->BuildId));
+	}
+	if (this->Privacy != EMatchmakingPrivacy::Any)
+	{
+		Params.Add(FString::Printf(TEXT("private=%d"), this->Privacy == EMatchmakingPrivacy::PrivateOnly ? 1 : 0));
+	}
+	Params.Add(FString::Printf(TEXT("max=%d"), this->MaxResults));
+	return TEXT("?") + FString::Join(Params, TEXT("&"));
+}
+
+FMatchmakingQuery FMatchmakingQuery::FromQueryParams(const TMap<FString, FString>& Params)
+{
+	FMatchmakingQuery Query;
+	if (const FString* Value = Params.Find(TEXT("map")))
+	{
+		Query.MapName = FGenericPlatformHttp::UrlDecode(*Value);
+	}
+	if (const FString* Value = Params.Find(TEXT("region")))
+	{
+		Query.Region = FGenericPlatformHttp::UrlDecode(*Value);
+	}
+	if (const FString* Value = Params.Find(TEXT("slots")))
+	{
+		Query.MinOpenSlots = FCString::Atoi(**Value);
+	}
+	if (const FString* Value = Params.Find(TEXT("build")))
+	{
+		Query.BuildId = FCString::Atoi(**Value);
+	}
+	if (const FString* Value = Params.Find(TEXT("private")))
+	{
+		Query.Privacy = FCString::Atoi(**Value) != 0 ? EMatchmakingPrivacy::PrivateOnly : EMatchmakingPrivacy::PublicOnly;
+	}
+	if (const FString* Value = Params.Find(TEXT("max")))
+	{
+		Query.MaxResults = FCString::Atoi(**Value);
+	}
+	Query.MaxResults = FMath::Clamp(Query.MaxResults, 1, 200);
+	return Query;
+}
+
+bool FMatchmakingQuery::Matches(const FMatchmakingSessionEntry& Entry) const
+{
+	if (Entry.OpenSlots < this->MinOpenSlots)
+	{
+		return false;
+	}
+	if (this->BuildId != 0 && Entry.BuildId != this->BuildId)
+	{
+		return false;
+	}
+	if (this->Privacy != EMatchmakingPrivacy::Any && Entry.bPrivate != (this->Privacy == EMatchmakingPrivacy::PrivateOnly))
+	{
+		return false;
+	}
+	if (!this->MapName.IsEmpty() && Entry.MapName != this->MapName)
+	{
+		return false;
+	}
+	if (!this->Region.IsEmpty() && Entry.Region != this->Region)
+	{
+		return false;
+	}
+	return true;
+}
+
+namespace MatchmakingJson
+{
+	FString Write(const TSharedRef<FJsonObject>& Json)
+	{
+		FString Text;
+		const TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> Writer = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&Text);
+		FJsonSerializer::Serialize(Json, Writer);
+		return Text;
+	}
+
+	TSharedPtr<FJsonObject> Read(const FString& Text)
+	{
+		TSharedPtr<FJsonObject> Json;
+		const TSharedRef<TJsonReader<TCHAR>> Reader = TJsonReaderFactory<TCHAR>::Create(Text);
+		if (!FJsonSerializer::Deserialize(Reader, Json))
+		{
+			return nullptr;
+		}
+		return Json;
+	}
+}
@@ -0,0 +1,85 @@
+//Project Watcher 2024 & Beyond
+
+#pragma once
+#include "CoreMinimal.h"
+
+class FJsonObject;
+
+/* A session as advertised to the matchmaking service */
+struct FMatchmakingSessionEntry
+{
+	/* Handed out by the service on advertise */
+	FString Id;
+
+	FString OwnerName;
+
+	FString MapName;
+
+	FString Region;
+
+	/* ip:port clients travel to */
+	FString ConnectAddress;
+
+	FString MigrationToken;
+
+	int32 BuildId = 0;
+
+	int32 MaxPlayers = 0;
+
+	int32 OpenSlots = 0;
+
+	bool bPrivate = false;
+
+	TSharedRef<FJsonObject> ToJson() const;
+
+	/**
+	 * Reads an entry written by ToJson
+	 * @return False when a required field is missing
+	 */
+	bool FromJson(const TSharedPtr<FJsonObject>& Json);
+};
+
+/* Privacy part of FMatchmakingQuery, same values as ESessionPrivacyFilter */
+enum class EMatchmakingPrivacy : uint8
+{
+	Any,
+	PublicOnly,
+	PrivateOnly
+};
+
+/* Session query, sent as query string parameters. Empty strings and 0 don't filter */
+struct FMatchmakingQuery
+{
+	FString MapName;
+
+	FString Region;
+
+	int32 MinOpenSlots = 0;
+
+	int32 BuildId = 0;
+
+	EMatchmakingPrivacy Privacy = EMatchmakingPrivacy::Any;
+
+	int32 MaxResults = 50;
+
+	/* ?map=..&region=.. for the service URL */
+	FString ToQueryString() const;
+
+	/**
+	 * Reads the parameters of ToQueryString
+	 * @param Params Query parameters of the request
+	 */
+	static FMatchmakingQuery FromQueryParams(const TMap<FString, FString>& Params);
+
+	/* If the entry passes every set field */
+	bool Matches(const FMatchmakingSessionEntry& Entry) const;
+};
+
+namespace MatchmakingJson
+{
+	/* Condensed JSON text of an object */
+	FString Write(const TSharedRef<FJsonObject>& Json);
+
+	/* Parses JSON text, nullptr when it isn't an object */
+	TSharedPtr<FJsonObject> Read(const FString& Text);
+}
@@ -0,0 +1,415 @@
+//Project Watcher 2024 & Beyond
+
+#include "NetDormancySubsystem.h"
+#include "ActorPoolSubsystem/ActorPoolSubsystem.h"
+#include "Components/SceneComponent.h"
+#include "Engine/Level.h"
+#include "Engine/World.h"
+#include "GameFramework/Info.h"
+#include "HAL/IConsoleManager.h"
+#include "TimerManager.h"
+
+DECLARE_LOG_CATEGORY_EXTERN(LogNetDormancy, Log, All);
+DEFINE_LOG_CATEGORY(LogNetDormancy);
+
+DECLARE_STATS_GROUP(TEXT("NetDormancy"), STATGROUP_NetDormancy, STATCAT_Advanced);
+DECLARE_CYCLE_STAT(TEXT("Register Level"), STAT_NetDormancy_RegisterLevel, STATGROUP_NetDormancy);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Managed Actors"), STAT_NetDormancy_Managed, STATGROUP_NetDormancy);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Timed Wakes Active"), STAT_NetDormancy_Awake, STATGROUP_NetDormancy);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Flushes"), STAT_NetDormancy_Flushes, STATGROUP_NetDormancy);
+
+bool UNetDormancySubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	//Dormancy is decided where actors are replicated from, clients never need this
+	return !IsRunningClientOnly() && Super::ShouldCreateSubsystem(Outer);
+}
+
+void UNetDormancySubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	//The net driver exists by BeginPlay, standalone worlds have nothing to save until someone hosts
+	const ENetMode NetMode = InWorld.GetNetMode();
+	if (NetMode == NM_Standalone || NetMode == NM_Client || !this->bEnableDormancyManagement)
+	{
+		return;
+	}
+
+	this->ResolveClasses();
+
+	for (const ULevel* Level : InWorld.GetLevels())
+	{
+		this->RegisterLevelActors(Level);
+	}
+
+	this->ActorSpawnedHandle = InWorld.AddOnActorSpawnedHandler(FOnActorSpawned::FDelegate::CreateUObject(this, &ThisClass::HandleActorSpawned));
+	this->LevelAddedHandle = FWorldDelegates::LevelAddedToWorld.AddUObject(this, &ThisClass::HandleLevelAdded);
+
+	UE_LOG(LogNetDormancy, Display, TEXT("Managing %d actors on %s"), this->ManagedActors.Num(), *InWorld.GetMapName());
+}
+
+void UNetDormancySubsystem::Deinitialize()
+{
+	if (UWorld* World = GetWorld())
+	{
+		World->RemoveOnActorSpawnedHandler(this->ActorSpawnedHandle);
+		World->GetTimerManager().ClearAllTimersForObject(this);
+	}
+	FWorldDelegates::LevelAddedToWorld.Remove(this->LevelAddedHandle);
+
+	if (!this->ManagedActors.IsEmpty())
+	{
+		this->LogClassStats();
+	}
+
+	DEC_DWORD_STAT_BY(STAT_NetDormancy_Managed, this->ManagedActors.Num());
+	DEC_DWORD_STAT_BY(STAT_NetDormancy_Awake, this->WakeTimers.Num());
+	this->ManagedActors.Empty();
+	this->WakeTimers.Empty();
+	this->ClassStats.Empty();
+
+	Super::Deinitialize();
+}
+
+void UNetDormancySubsystem::FlushActor(AActor* Actor)
+{
+	if (!IsValid(Actor) || !this->IsManaged(Actor))
+	{
+		return;
+	}
+
+	if (FNetDormancyClassStats* Stats = this->ClassStats.Find(Actor->GetClass()))
+	{
+		Stats->Flushes++;
+	}
+	INC_DWORD_STAT(STAT_NetDormancy_Flushes);
+
+	if (this->WakeTimers.Contains(Actor))
+	{
+		//Already awake, the change goes out with the next update
+		Actor->ForceNetUpdate();
+		return;
+	}
+	Actor->FlushNetDormancy();
+}
+
+void UNetDormancySubsystem::WakeActor(AActor* Actor, const float Duration)
+{
+	UWorld* World = GetWorld();
+	if (!World || !IsValid(Actor) || !this->IsManaged(Actor))
+	{
+		return;
+	}
+
+	if (FNetDormancyClassStats* Stats = this->ClassStats.Find(Actor->GetClass()))
+	{
+		Stats->Wakes++;
+	}
+
+	FTimerHandle* Timer = this->WakeTimers.Find(Actor);
+	if (!Timer)
+	{
+		Timer = &this->WakeTimers.Add(Actor);
+		INC_DWORD_STAT(STAT_NetDormancy_Awake);
+		Actor->SetNetDormancy(DORM_Awake);
+		Actor->ForceNetUpdate();
+	}
+
+	const float WakeDuration = Duration > 0.f ? Duration : this->DefaultWakeDuration;
+	World->GetTimerManager().SetTimer(*Timer, FTimerDelegate::CreateUObject(this, &ThisClass::OnWakeExpired, TWeakObjectPtr<AActor>(Actor)), WakeDuration, false);
+}
+
+bool UNetDormancySubsystem::IsManaged(const AActor* Actor) const
+{
+	return Actor && this->ManagedActors.Contains(TWeakObjectPtr<AActor>(const_cast<AActor*>(Actor)));
+}
+
+FNetDormancyClassStats UNetDormancySubsystem::GetClassStats(TSubclassOf<AActor> ActorClass) const
+{
+	const FNetDormancyClassStats* Counters = this->ClassStats.Find(ActorClass.Get());
+	if (!Counters)
+	{
+		return FNetDormancyClassStats();
+	}
+
+	FNetDormancyClassStats Stats = *Counters;
+	for (const TWeakObjectPtr<AActor>& WeakActor : this->ManagedActors)
+	{
+		const AActor* Actor = WeakActor.Get();
+		if (!Actor || Actor->GetClass() != ActorClass)
+		{
+			continue;
+		}
+
+		Stats.Managed++;
+		if (Actor->NetDormancy > DORM_Awake)
+		{
+			Stats.Dormant++;
+		}
+		else
+		{
+			Stats.Awake++;
+		}
+	}
+	return Stats;
+}
+
+void UNetDormancySubsystem::LogClassStats() const
+{
+	int32 TotalAwake = 0;
+	int32 TotalDormant = 0;
+	for (const TPair<TObjectPtr<UClass>, FNetDormancyClassStats>& Pair : this->ClassStats)
+	{
+		const FNetDormancyClassStats Stats = this->GetClassStats(Pair.Key.Get());
+		TotalAwake += Stats.Awake;
+		TotalDormant += Stats.Dormant;
+		UE_LOG(LogNetDormancy, Display, TEXT("%s: Managed %d, Awake %d, Dormant %d, Flushes %d, Wakes %d"),
+			*GetNameSafe(Pair.Key), Stats.Managed, Stats.Awake, Stats.Dormant, Stats.Flushes, Stats.Wakes);
+	}
+	UE_LOG(LogNetDormancy, Display, TEXT("Total: Awake %d, Dormant %d, management %s"), TotalAwake, TotalDormant, this->bEnableDormancyManagement ? TEXT("on") : TEXT("off"));
+}
+
+void UNetDormancySubsystem::SetManagementEnabled(const bool bEnabled)
+{
+	UWorld* World = GetWorld();
+	if (!World || this->bEnableDormancyManagement == bEnabled)
+	{
+		return;
+	}
+	this->bEnableDormancyManagement = bEnabled;
+
+	if (bEnabled && this->ResolvedClasses.IsEmpty() && this->ResolvedInterfaces.IsEmpty())
+	{
+		this->ResolveClasses();
+	}
+
+	this->CompactManagedActors();
+	World->GetTimerManager().ClearAllTimersForObject(this);
+	DEC_DWORD_STAT_BY(STAT_NetDormancy_Awake, this->WakeTimers.Num());
+	this->WakeTimers.Empty();
+
+	if (bEnabled)
+	{
+		//Pick up whatever appeared while we weren't listening
+		for (const ULevel* Level : World->GetLevels())
+		{
+			this->RegisterLevelActors(Level);
+		}
+		if (!this->ActorSpawnedHandle.IsValid())
+		{
+			this->ActorSpawnedHandle = World->AddOnActorSpawnedHandler(FOnActorSpawned::FDelegate::CreateUObject(this, &ThisClass::HandleActorSpawned));
+			this->LevelAddedHandle = FWorldDelegates::LevelAddedToWorld.AddUObject(this, &ThisClass::HandleLevelAdded);
+		}
+		for (const TWeakObjectPtr<AActor>& WeakActor : this->ManagedActors)
+		{
+			if (AActor* Actor = WeakActor.Get())
+			{
+				Actor->SetNetDormancy(DORM_DormantAll);
+			}
+		}
+	}
+	else
+	{
+		for (const TWeakObjectPtr<AActor>& WeakActor : this->ManagedActors)
+		{
+			if (AActor* Actor = WeakActor.Get())
+			{
+				Actor->SetNetDormancy(DORM_Awake);
+			}
+		}
+	}
+
+	UE_LOG(LogNetDormancy, Display, TEXT("Dormancy management %s for %d actors"), bEnabled ? TEXT("enabled") : TEXT("disabled"), this->ManagedActors.Num());
+}
+
+void UNetDormancySubsystem::ResolveClasses()
+{
+	this->ResolvedClasses.Reset();
+	this->ResolvedInterfaces.Reset();
+
+	for (const FSoftClassPath& ClassPath : this->ManagedClasses)
+	{
+		if (UClass* Class = ClassPath.TryLoadClass<AActor>())
+		{
+			this->ResolvedClasses.Add(Class);
+		}
+		else
+		{
+			UE_LOG(LogNetDormancy, Warning, TEXT("Could not load managed class %s"), *ClassPath.ToString());
+		}
+	}
+
+	for (const FSoftClassPath& InterfacePath : this->ManagedInterfaces)
+	{
+		UClass* Interface = InterfacePath.TryLoadClass<UInterface>();
+		if (Interface && Interface->HasAnyClassFlags(CLASS_Interface))
+		{
+			this->ResolvedInterfaces.Add(Interface);
+		}
+		else
+		{
+			UE_LOG(LogNetDormancy, Warning, TEXT("Could not load managed interface %s"), *InterfacePath.ToString());
+		}
+	}
+}
+
+bool UNetDormancySubsystem::ShouldManage(const AActor* Actor) const
+{
+	if (!IsValid(Actor) || !Actor->GetIsReplicated())
+	{
+		return false;
+	}
+
+	//UActorPoolSubsystem drives the dormancy of its actors itself, every other runtime spawn is fair game
+	if (Actor->ActorHasTag(UActorPoolSubsystem::PooledActorTag))
+	{
+		return false;
+	}
+
+	//Hand tuned dormancy wins
+	if (Actor->NetDormancy != DORM_Awake && Actor->NetDormancy != DORM_Initial)
+	{
+		return false;
+	}
+
+	const UClass* ActorClass = Actor->GetClass();
+	for (const UClass* Class : this->ResolvedClasses)
+	{
+		if (ActorClass->IsChildOf(Class))
+		{
+			return true;
+		}
+	}
+	for (const UClass* Interface : this->ResolvedInterfaces)
+	{
+		if (ActorClass->ImplementsInterface(Interface))
+		{
+			return true;
+		}
+	}
+
+	if (this->bManageStaticPlacedActors && Actor->IsNetStartupActor() && !Actor->IsA<AInfo>())
+	{
+		//Static roots can't move, nothing about them changes without gameplay code asking for it
+		const USceneComponent* Root = Actor->GetRootComponent();
+		return Root && Root->Mobility == EComponentMobility::Static;
+	}
+	return false;
+}
+
+void UNetDormancySubsystem::RegisterActor(AActor* Actor)
+{
+	if (!this->ShouldManage(Actor) || this->IsManaged(Actor))
+	{
+		return;
+	}
+
+	this->ManagedActors.Add(Actor);
+	this->ClassStats.FindOrAdd(Actor->GetClass());
+	INC_DWORD_STAT(STAT_NetDormancy_Managed);
+
+	//Placed actors still at DORM_Initial have never replicated, their first flush sends them
+	if (Actor->NetDormancy != DORM_Initial)
+	{
+		Actor->SetNetDormancy(DORM_DormantAll);
+	}
+}
+
+void UNetDormancySubsystem::RegisterLevelActors(const ULevel* Level)
+{
+	SCOPE_CYCLE_COUNTER(STAT_NetDormancy_RegisterLevel);
+
+	if (!Level)
+	{
+		return;
+	}
+
+	for (AActor* Actor : Level->Actors)
+	{
+		this->RegisterActor(Actor);
+	}
+}
+
+void UNetDormancySubsystem::HandleActorSpawned(AActor* Actor)
+{
+	if (this->bEnableDormancyManagement)
+	{
+		this->RegisterActor(Actor);
+	}
+}
+
+void UNetDormancySubsystem::HandleLevelAdded(ULevel* Level, UWorld* World)
+{
+	if (World != GetWorld() || !this->bEnableDormancyManagement)
+	{
+		return;
+	}
+
+	//World partition cells stream in and out all match long, forget the actors of the cells that left
+	this->CompactManagedActors();
+	this->RegisterLevelActors(Level);
+}
+
+void UNetDormancySubsystem::OnWakeExpired(TWeakObjectPtr<AActor> WeakActor)
+{
+	if (this->WakeTimers.Remove(WeakActor) > 0)
+	{
+		DEC_DWORD_STAT(STAT_NetDormancy_Awake);
+	}
+
+	if (AActor* Actor = WeakActor.Get())
+	{
+		Actor->SetNetDormancy(DORM_DormantAll);
+	}
+}
+
+void UNetDormancySubsystem::CompactManagedActors()
+{
+	for (TSet<TWeakObjectPtr<AActor>>::TIterator It(this->ManagedActors); It; ++It)
+	{
+		if (!It->IsValid())
+		{
+			It.RemoveCurrent();
+			DEC_DWORD_STAT(STAT_NetDormancy_Managed);
+		}
+	}
+}
+
+//Console//
+
+/**
+ * Watcher.Dormancy.Stats
+ * Logs awake / dormant counts per managed class
+ */
+static FAutoConsoleCommandWithWorldAndArgs GNetDormancyStatsCommand(
+	TEXT("Watcher.Dormancy.Stats"),
+	TEXT("Logs awake / dormant actors per class managed by UNetDormancySubsystem"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		const UNetDormancySubsystem* NetDormancy = World ? World->GetSubsystem<UNetDormancySubsystem>() : nullptr;
+		if (!NetDormancy)
+		{
+			UE_LOG(LogNetDormancy, Warning, TEXT("No NetDormancySubsystem in this world, it only exists on servers"));
+			return;
+		}
+		NetDormancy->LogClassStats();
+	}));
+
+/**
+ * Watcher.Dormancy.Enable 0/1
+ * Wakes every managed actor (0) or puts them back to sleep (1), compare stat NetServerRepActorsTime between both
+ */
+static FAutoConsoleCommandWithWorldAndArgs GNetDormancyEnableCommand(
+	TEXT("Watcher.Dormancy.Enable"),
+	TEXT("Turns UNetDormancySubsystem on or off at runtime. Args: 0/1"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		UNetDormancySubsystem* NetDormancy = World ? World->GetSubsystem<UNetDormancySubsystem>() : nullptr;
+		if (!NetDormancy || Args.IsEmpty())
+		{
+			return;
+		}
+		NetDormancy->SetManagementEnabled(FCString::Atoi(*Args[0]) != 0);
+	}));
+
+//Console//
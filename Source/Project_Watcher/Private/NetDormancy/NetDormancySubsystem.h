@@ -0,0 +1,172 @@
+//Project Watcher 2024 & Beyond
+
+#pragma once
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "NetDormancySubsystem.generated.h"
+
+class ULevel;
+
+//Wrapper for BP data//
+
+USTRUCT(BlueprintType)
+struct FNetDormancyClassStats
+{
+	GENERATED_USTRUCT_BODY()
+public:
+	/* Managed actors of this class still in the world */
+	UPROPERTY(BlueprintReadOnly, Category = "Net Dormancy")
+	int32 Managed = 0;
+	/* Managed actors currently considered for replication */
+	UPROPERTY(BlueprintReadOnly, Category = "Net Dormancy")
+	int32 Awake = 0;
+	/* Managed actors the net driver skips */
+	UPROPERTY(BlueprintReadOnly, Category = "Net Dormancy")
+	int32 Dormant = 0;
+	/* One-shot flushes sent since the map started */
+	UPROPERTY(BlueprintReadOnly, Category = "Net Dormancy")
+	int32 Flushes = 0;
+	/* Timed wakes since the map started */
+	UPROPERTY(BlueprintReadOnly, Category = "Net Dormancy")
+	int32 Wakes = 0;
+};
+
+//Wrapper for BP data//
+
+/**
+ * Server side world subsystem that keeps interactables and placed static actors out of the net driver's consider list.
+ * Matching actors are put to DORM_DormantAll as they appear (persistent level, streamed cells and runtime spawns)
+ * and only wake when their state changes: FlushActor sends a single update, WakeActor keeps the actor awake
+ * for a while for changes that play out over time (doors, lifts) and puts it back to sleep afterwards.
+ * Interaction code calls one of the two right after changing replicated state, otherwise clients never see it.
+ * Actors whose dormancy was set by hand (anything other than DORM_Awake / DORM_Initial) are left alone.
+ */
+UCLASS(Config=Game)
+class UNetDormancySubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+private:
+	//Settings//
+
+	/* Master switch, Watcher.Dormancy.Enable toggles it at runtime for A/B measurements.
+	 * Keep it off until the interaction paths of the managed classes call FlushActor / WakeActor, dormant actors don't send their changes */
+	UPROPERTY(Config)
+	bool bEnableDormancyManagement = false;
+
+	/* Actors of these classes (and children) are managed */
+	UPROPERTY(Config)
+	TArray<FSoftClassPath> ManagedClasses;
+
+	/* Actors implementing any of these interfaces are managed, e.g. the interaction interface */
+	UPROPERTY(Config)
+	TArray<FSoftClassPath> ManagedInterfaces;
+
+	/* Also manage replicated actors placed in the map whose root component is static */
+	UPROPERTY(Config)
+	bool bManageStaticPlacedActors = true;
+
+	/* Seconds WakeActor keeps an actor awake when no duration is given */
+	UPROPERTY(Config)
+	float DefaultWakeDuration = 2.f;
+
+	//Settings//
+
+	UPROPERTY()
+	TArray<TObjectPtr<UClass>> ResolvedClasses;
+
+	UPROPERTY()
+	TArray<TObjectPtr<UClass>> ResolvedInterfaces;
+
+	TSet<TWeakObjectPtr<AActor>> ManagedActors;
+
+	/* Flush / wake counters keyed by the exact class of the actor, the awake / dormant counts are taken live */
+	UPROPERTY()
+	TMap<TObjectPtr<UClass>, FNetDormancyClassStats> ClassStats;
+
+	/* Timed wakes in progress */
+	TMap<TWeakObjectPtr<AActor>, FTimerHandle> WakeTimers;
+
+	FDelegateHandle ActorSpawnedHandle;
+	FDelegateHandle LevelAddedHandle;
+
+public:
+
+	//Initialization//
+
+	UNetDormancySubsystem() { }
+
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+	virtual void Deinitialize() override;
+
+	//Initialization//
+
+	//Dormancy Interface calls//
+
+	/**
+	 * Sends the current state of a dormant actor once, it stays dormant afterwards. Call after a one-off change
+	 * @param Actor The actor whose replicated state changed
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure=false, Category = "Net Dormancy")
+	void FlushActor(AActor* Actor);
+
+	/**
+	 * Keeps an actor awake for changes that replicate over several frames, then puts it back to sleep
+	 * @param Actor The actor being interacted with
+	 * @param Duration Seconds to stay awake, DefaultWakeDuration when <= 0. Waking an awake actor extends it
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure=false, Category = "Net Dormancy")
+	void WakeActor(AActor* Actor, const float Duration = 0.f);
+
+	/**
+	 * If the actor is managed by this subsystem
+	 * @param Actor The actor to check
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Net Dormancy")
+	bool IsManaged(const AActor* Actor) const;
+
+	/**
+	 * Awake / dormant counts for a single class
+	 * @param ActorClass The exact class to query
+	 * @return The stats, zeroed if no actor of the class is managed
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Net Dormancy")
+	FNetDormancyClassStats GetClassStats(TSubclassOf<AActor> ActorClass) const;
+
+	/* Logs the stats of every managed class */
+	void LogClassStats() const;
+
+	/**
+	 * Turns management on or off, off wakes every managed actor so the cost of considering them shows up again
+	 * @param bEnabled New state
+	 */
+	void SetManagementEnabled(const bool bEnabled);
+
+	//Dormancy Interface calls//
+
+private:
+
+	//Dormancy internals//
+
+	void ResolveClasses();
+
+	/* If the actor matches the configured classes / interfaces or is a placed static actor */
+	bool ShouldManage(const AActor* Actor) const;
+
+	void RegisterActor(AActor* Actor);
+
+	void RegisterLevelActors(const ULevel* Level);
+
+	void HandleActorSpawned(AActor* Actor);
+
+	void HandleLevelAdded(ULevel* Level, UWorld* World);
+
+	void OnWakeExpired(TWeakObjectPtr<AActor> WeakActor);
+
+	/* Drops actors that were destroyed or streamed out */
+	void CompactManagedActors();
+
+	//Dormancy internals//
+};
@@ -0,0 +1,280 @@
+//Project Watcher 2024 & Beyond
+
+#include "ListenServerNetTickSubsystem.h"
+#include "Engine/NetDriver.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformProcess.h"
+#include "WatcherStats/WatcherStats.h"
+
+DECLARE_LOG_CATEGORY_EXTERN(LogListenServerNetTick, Log, All);
+DEFINE_LOG_CATEGORY(LogListenServerNetTick);
+
+DECLARE_STATS_GROUP(TEXT("ListenServerNetTick"), STATGROUP_ListenServerNetTick, STATCAT_Advanced);
+DECLARE_CYCLE_STAT(TEXT("Replicate Actors"), STAT_ListenServerNetTick_Replicate, STATGROUP_ListenServerNetTick);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Passes"), STAT_ListenServerNetTick_Passes, STATGROUP_ListenServerNetTick);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Pass Interval (ms)"), STAT_ListenServerNetTick_Interval, STATGROUP_ListenServerNetTick);
+
+namespace ListenServerNetTick
+{
+	static float InjectStallMs = 0.f;
+	static FAutoConsoleVariableRef CVarInjectStallMs(
+		TEXT("Watcher.NetTick.InjectStallMs"),
+		InjectStallMs,
+		TEXT("Listen server: sleeps the game thread this long at the start of a frame to stand in for a render / GPU hitch, 0 disables."));
+
+	static int32 InjectStallEveryFrames = 60;
+	static FAutoConsoleVariableRef CVarInjectStallEveryFrames(
+		TEXT("Watcher.NetTick.InjectStallEveryFrames"),
+		InjectStallEveryFrames,
+		TEXT("Listen server: frames between two injected stalls."));
+}
+
+bool UListenServerNetTickSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	//Dedicated servers already tick at NetServerMaxTickRate, clients don't replicate
+	return !IsRunningClientOnly() && !IsRunningDedicatedServer() && Super::ShouldCreateSubsystem(Outer);
+}
+
+void UListenServerNetTickSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	//The ?listen net driver exists by BeginPlay
+	if (InWorld.GetNetMode() != NM_ListenServer)
+	{
+		return;
+	}
+
+	this->NetDriver = InWorld.GetNetDriver();
+	this->WorldTickStartHandle = FWorldDelegates::OnWorldTickStart.AddUObject(this, &ThisClass::HandleWorldTickStart);
+	this->PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &ThisClass::HandlePostActorTick);
+	this->PostTickFlushHandle = InWorld.OnPostTickFlush().AddUObject(this, &ThisClass::HandlePostTickFlush);
+
+	this->SetFixedRateEnabled(this->bEnableFixedRateReplication);
+}
+
+void UListenServerNetTickSubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldTickStart.Remove(this->WorldTickStartHandle);
+	FWorldDelegates::OnWorldPostActorTick.Remove(this->PostActorTickHandle);
+	if (UWorld* World = GetWorld())
+	{
+		World->OnPostTickFlush().Remove(this->PostTickFlushHandle);
+	}
+
+	if (UNetDriver* Driver = this->NetDriver.Get())
+	{
+		Driver->bSkipServerReplicateActors = false;
+	}
+
+	if (this->Passes > 0)
+	{
+		this->LogStats();
+	}
+
+	Super::Deinitialize();
+}
+
+FListenServerNetTickStats UListenServerNetTickSubsystem::GetStats() const
+{
+	FListenServerNetTickStats Stats;
+	Stats.Passes = this->Passes;
+	Stats.FramesWithoutPass = this->FramesWithoutPass;
+	Stats.StallsInjected = this->StallsInjected;
+	if (this->Intervals.IsEmpty())
+	{
+		return Stats;
+	}
+
+	double Sum = 0.0;
+	float Max = 0.f;
+	for (const float Interval : this->Intervals)
+	{
+		Sum += Interval;
+		Max = FMath::Max(Max, Interval);
+	}
+	const double Mean = Sum / this->Intervals.Num();
+
+	double SquaredDeviations = 0.0;
+	for (const float Interval : this->Intervals)
+	{
+		SquaredDeviations += FMath::Square(Interval - Mean);
+	}
+
+	Stats.MeanIntervalMs = Mean * 1000.0;
+	Stats.JitterMs = FMath::Sqrt(SquaredDeviations / this->Intervals.Num()) * 1000.0;
+	Stats.P99IntervalMs = WatcherStats::Percentile(this->Intervals, 0.99f) * 1000.f;
+	Stats.MaxIntervalMs = Max * 1000.f;
+	return Stats;
+}
+
+void UListenServerNetTickSubsystem::ResetStats()
+{
+	this->Intervals.Reset();
+	this->NextInterval = 0;
+	this->Passes = 0;
+	this->FramesWithoutPass = 0;
+	this->StallsInjected = 0;
+	this->LastFlushTime = 0.0;
+}
+
+void UListenServerNetTickSubsystem::LogStats() const
+{
+	const FListenServerNetTickStats Stats = this->GetStats();
+	UE_LOG(LogListenServerNetTick, Display, TEXT("%s at %.0f Hz: %d passes, %d frames without one, %d stalls injected"),
+		this->bFixedRateActive ? TEXT("Fixed rate") : TEXT("Every frame"), this->ReplicationRate, Stats.Passes, Stats.FramesWithoutPass, Stats.StallsInjected);
+	UE_LOG(LogListenServerNetTick, Display, TEXT("  Interval mean %.2f ms, jitter %.2f ms, p99 %.2f ms, max %.2f ms"),
+		Stats.MeanIntervalMs, Stats.JitterMs, Stats.P99IntervalMs, Stats.MaxIntervalMs);
+}
+
+void UListenServerNetTickSubsystem::SetFixedRateEnabled(const bool bEnabled, const float NewReplicationRate)
+{
+	UNetDriver* Driver = this->NetDriver.Get();
+	if (!Driver)
+	{
+		return;
+	}
+
+	if (NewReplicationRate > 0.f)
+	{
+		this->ReplicationRate = NewReplicationRate;
+	}
+	this->bEnableFixedRateReplication = bEnabled;
+	this->bFixedRateActive = bEnabled && this->ReplicationRate > 0.f;
+	Driver->bSkipServerReplicateActors = this->bFixedRateActive;
+
+	this->NextPassTime = FPlatformTime::Seconds();
+	this->LastPassTime = 0.0;
+	this->ResetStats();
+
+	UE_LOG(LogListenServerNetTick, Display, TEXT("Listen server replication %s"),
+		*(this->bFixedRateActive ? FString::Printf(TEXT("at a fixed %.0f Hz"), this->ReplicationRate) : FString(TEXT("every frame"))));
+}
+
+void UListenServerNetTickSubsystem::HandleWorldTickStart(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	if (World != GetWorld())
+	{
+		return;
+	}
+
+	++this->Frames;
+	if (ListenServerNetTick::InjectStallMs > 0.f && this->Frames % FMath::Max(1, ListenServerNetTick::InjectStallEveryFrames) == 0)
+	{
+		++this->StallsInjected;
+		FPlatformProcess::Sleep(ListenServerNetTick::InjectStallMs / 1000.f);
+	}
+}
+
+void UListenServerNetTickSubsystem::HandlePostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	if (World != GetWorld())
+	{
+		return;
+	}
+
+	UNetDriver* Driver = this->NetDriver.Get();
+	if (!Driver || !this->bFixedRateActive)
+	{
+		//The net driver replicates this frame itself
+		this->bPassThisFrame = Driver != nullptr;
+		return;
+	}
+
+	const double Now = FPlatformTime::Seconds();
+	if (Now < this->NextPassTime)
+	{
+		this->bPassThisFrame = false;
+		++this->FramesWithoutPass;
+		return;
+	}
+
+	//Phase locked so passes don't drift with the frame rate, a stall longer than an interval starts the phase over
+	const double Interval = 1.0 / this->ReplicationRate;
+	this->NextPassTime = Now - this->NextPassTime > Interval ? Now + Interval : this->NextPassTime + Interval;
+
+#if WITH_SERVER_CODE
+	if (Driver->ClientConnections.Num() > 0)
+	{
+		SCOPE_CYCLE_COUNTER(STAT_ListenServerNetTick_Replicate);
+		Driver->ServerReplicateActors(this->LastPassTime > 0.0 ? Now - this->LastPassTime : DeltaSeconds);
+	}
+#endif
+	this->LastPassTime = Now;
+	this->bPassThisFrame = true;
+}
+
+void UListenServerNetTickSubsystem::HandlePostTickFlush()
+{
+	if (!this->bPassThisFrame)
+	{
+		return;
+	}
+	this->bPassThisFrame = false;
+
+	++this->Passes;
+	INC_DWORD_STAT(STAT_ListenServerNetTick_Passes);
+
+	const double Now = FPlatformTime::Seconds();
+	if (this->LastFlushTime > 0.0)
+	{
+		const float Interval = Now - this->LastFlushTime;
+		SET_FLOAT_STAT(STAT_ListenServerNetTick_Interval, Interval * 1000.f);
+
+		if (this->Intervals.Num() < FMath::Max(1, this->MaxIntervalSamples))
+		{
+			this->Intervals.Add(Interval);
+		}
+		else
+		{
+			this->Intervals[this->NextInterval] = Interval;
+			this->NextInterval = (this->NextInterval + 1) % this->Intervals.Num();
+		}
+	}
+	this->LastFlushTime = Now;
+}
+
+//Console//
+
+/**
+ * Watcher.NetTick.Stats [Reset]
+ * Logs the replication interval / jitter stats of the listen server, Reset starts them over
+ */
+static FAutoConsoleCommandWithWorldAndArgs GListenServerNetTickStatsCommand(
+	TEXT("Watcher.NetTick.Stats"),
+	TEXT("Logs listen server replication interval and jitter. Args: [Reset]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		UListenServerNetTickSubsystem* NetTick = World ? World->GetSubsystem<UListenServerNetTickSubsystem>() : nullptr;
+		if (!NetTick || World->GetNetMode() != NM_ListenServer)
+		{
+			UE_LOG(LogListenServerNetTick, Warning, TEXT("Not a listen server"));
+			return;
+		}
+
+		NetTick->LogStats();
+		if (Args.Num() > 0 && Args[0] == TEXT("Reset"))
+		{
+			NetTick->ResetStats();
+		}
+	}));
+
+/**
+ * Watcher.NetTick.FixedRate 0/1 [Hz]
+ * Replicates every frame (0) or on the fixed schedule (1), run the same Watcher.NetTick.InjectStallMs on both and compare the stats
+ */
+static FAutoConsoleCommandWithWorldAndArgs GListenServerNetTickFixedRateCommand(
+	TEXT("Watcher.NetTick.FixedRate"),
+	TEXT("Toggles fixed rate listen server replication. Args: 0/1 [Hz]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		UListenServerNetTickSubsystem* NetTick = World ? World->GetSubsystem<UListenServerNetTickSubsystem>() : nullptr;
+		if (!NetTick || Args.IsEmpty())
+		{
+			return;
+		}
+
+		NetTick->LogStats();
+		NetTick->SetFixedRateEnabled(FCString::Atoi(*Args[0]) != 0, Args.Num() > 1 ? FCString::Atof(*Args[1]) : 0.f);
+	}));
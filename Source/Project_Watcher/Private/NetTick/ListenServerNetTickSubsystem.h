@@ -0,0 +1,149 @@
+//Project Watcher 2024 & Beyond
+
+#pragma once
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Engine/EngineBaseTypes.h"
+#include "ListenServerNetTickSubsystem.generated.h"
+
+class UNetDriver;
+
+//Wrapper for BP data//
+
+USTRUCT(BlueprintType)
+struct FListenServerNetTickStats
+{
+	GENERATED_USTRUCT_BODY()
+public:
+	/* Frames that sent a replication pass */
+	UPROPERTY(BlueprintReadOnly, Category = "Net Tick")
+	int32 Passes = 0;
+	/* Frames that skipped it, ahead of the schedule */
+	UPROPERTY(BlueprintReadOnly, Category = "Net Tick")
+	int32 FramesWithoutPass = 0;
+	/* Mean time between two flushed passes */
+	UPROPERTY(BlueprintReadOnly, Category = "Net Tick")
+	float MeanIntervalMs = 0.f;
+	/* Standard deviation of the interval, what clients see as uneven updates */
+	UPROPERTY(BlueprintReadOnly, Category = "Net Tick")
+	float JitterMs = 0.f;
+	UPROPERTY(BlueprintReadOnly, Category = "Net Tick")
+	float P99IntervalMs = 0.f;
+	/* Longest gap clients went without an update */
+	UPROPERTY(BlueprintReadOnly, Category = "Net Tick")
+	float MaxIntervalMs = 0.f;
+	/* Frames stalled by Watcher.NetTick.InjectStallMs */
+	UPROPERTY(BlueprintReadOnly, Category = "Net Tick")
+	int32 StallsInjected = 0;
+};
+
+//Wrapper for BP data//
+
+/**
+ * Listen server world subsystem that takes replication off the host's render frame rate.
+ * The net driver is told to skip its per frame ServerReplicateActors, passes are run here instead on a fixed,
+ * phase locked schedule (ReplicationRate), so a host rendering at 144 fps doesn't pay for 144 passes a second
+ * and clients get updates at an even rate. The net driver still lives on the game thread, a frame stalled for
+ * longer than an interval delays the pass, the stats below show how far (max / p99 interval, jitter).
+ * Watcher.NetTick.InjectStallMs stalls frames on purpose to measure it, e.g. on a -nullrhi host.
+ */
+UCLASS(Config=Game)
+class UListenServerNetTickSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+private:
+	//Settings//
+
+	/* Master switch, off until A/B runs show a win. Watcher.NetTick.FixedRate toggles it at runtime for those measurements */
+	UPROPERTY(Config)
+	bool bEnableFixedRateReplication = false;
+
+	/* Replication passes per second, whatever the host renders at */
+	UPROPERTY(Config)
+	float ReplicationRate = 30.f;
+
+	/* Intervals kept for the jitter stats, the oldest get dropped */
+	UPROPERTY(Config)
+	int32 MaxIntervalSamples = 4096;
+
+	//Settings//
+
+	TWeakObjectPtr<UNetDriver> NetDriver;
+
+	/* If the net driver's own pass is currently skipped in favour of ours */
+	bool bFixedRateActive = false;
+
+	/* Set by HandlePostActorTick when this frame carries a pass, read by HandlePostTickFlush */
+	bool bPassThisFrame = false;
+
+	double NextPassTime = 0.0;
+	double LastPassTime = 0.0;
+	double LastFlushTime = 0.0;
+
+	/* Seconds between flushed passes, ring buffer of MaxIntervalSamples */
+	TArray<float> Intervals;
+	int32 NextInterval = 0;
+
+	int32 Passes = 0;
+	int32 FramesWithoutPass = 0;
+	int32 StallsInjected = 0;
+	uint64 Frames = 0;
+
+	FDelegateHandle WorldTickStartHandle;
+	FDelegateHandle PostActorTickHandle;
+	FDelegateHandle PostTickFlushHandle;
+
+public:
+
+	//Initialization//
+
+	UListenServerNetTickSubsystem() { }
+
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+	virtual void Deinitialize() override;
+
+	//Initialization//
+
+	//Net Tick Interface calls//
+
+	/**
+	 * Interval / jitter stats since the map started or the last reset
+	 * @return The stats, zeroed when not hosting
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Net Tick")
+	FListenServerNetTickStats GetStats() const;
+
+	/* Starts the stats over */
+	UFUNCTION(BlueprintCallable, BlueprintPure=false, Category = "Net Tick")
+	void ResetStats();
+
+	/* Logs GetStats */
+	void LogStats() const;
+
+	/**
+	 * Switches between the fixed rate schedule and the net driver's pass every frame, resets the stats
+	 * @param bEnabled Fixed rate when true
+	 * @param NewReplicationRate Passes per second, kept when <= 0
+	 */
+	void SetFixedRateEnabled(const bool bEnabled, const float NewReplicationRate = 0.f);
+
+	//Net Tick Interface calls//
+
+private:
+
+	//Net Tick internals//
+
+	/* Injects the configured stall */
+	void HandleWorldTickStart(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+
+	/* Runs the pass when it's due, right before TickFlush sends it */
+	void HandlePostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+
+	/* Records when the pass actually left */
+	void HandlePostTickFlush();
+
+	//Net Tick internals//
+};
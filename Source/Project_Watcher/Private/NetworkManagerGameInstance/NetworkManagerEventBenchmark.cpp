@@ -0,0 +1,87 @@
+//Project Watcher 2024 & Beyond
+
+#include "NetworkManagerEventBenchmark.h"
+#include "NetworkManagerGameInstance.h"
+#include "HAL/IConsoleManager.h"
+#include "UObject/Package.h"
+
+DECLARE_LOG_CATEGORY_EXTERN(LogNetworkManagerEventBenchmark, Log, All);
+DEFINE_LOG_CATEGORY(LogNetworkManagerEventBenchmark);
+
+void UNetworkManagerEventBenchmarkListener::HandleDynamicEvent(const FName SessionName)
+{
+	++this->Calls;
+}
+
+void UNetworkManagerEventBenchmarkListener::HandleNativeEvent(const FNetworkManagerEvent& Event)
+{
+	++this->Calls;
+}
+
+/**
+ * Watcher.Sessions.EventBenchmark [Listeners=1000] [Broadcasts=1000]
+ * Broadcasts a session complete event through a dynamic multicast delegate (the Blueprint path) and through a native channel,
+ * both with the same amount of listeners, and logs the cost per broadcast and per listener call.
+ */
+static FAutoConsoleCommandWithWorldAndArgs GEventBenchmarkCommand(
+	TEXT("Watcher.Sessions.EventBenchmark"),
+	TEXT("Compares dynamic and native session event broadcast cost. Args: [Listeners=1000] [Broadcasts=1000]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		const int32 NumListeners = FMath::Max(1, Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 1000);
+		const int32 NumBroadcasts = FMath::Max(1, Args.Num() > 1 ? FCString::Atoi(*Args[1]) : 1000);
+
+		FNetworkManager_OnCreateSessionComplete DynamicDelegate;
+		FNetworkManager_OnNativeEvent NativeChannel;
+
+		TArray<UNetworkManagerEventBenchmarkListener*> Listeners;
+		Listeners.Reserve(NumListeners);
+		for (int32 Index = 0; Index < NumListeners; ++Index)
+		{
+			UNetworkManagerEventBenchmarkListener* Listener = NewObject<UNetworkManagerEventBenchmarkListener>(GetTransientPackage());
+			DynamicDelegate.AddDynamic(Listener, &UNetworkManagerEventBenchmarkListener::HandleDynamicEvent);
+			NativeChannel.AddUObject(Listener, &UNetworkManagerEventBenchmarkListener::HandleNativeEvent);
+			Listeners.Add(Listener);
+		}
+
+		FNetworkManagerEvent Event;
+		Event.Type = ENetworkManagerEvent::CreateSessionComplete;
+		Event.SessionName = TEXT("Benchmark Session");
+
+		//Warm both paths so the first timed broadcast doesn't pay for cold caches
+		DynamicDelegate.Broadcast(Event.SessionName);
+		NativeChannel.Broadcast(Event);
+
+		const double DynamicStart = FPlatformTime::Seconds();
+		for (int32 Broadcast = 0; Broadcast < NumBroadcasts; ++Broadcast)
+		{
+			DynamicDelegate.Broadcast(Event.SessionName);
+		}
+		const double DynamicSeconds = FPlatformTime::Seconds() - DynamicStart;
+
+		const double NativeStart = FPlatformTime::Seconds();
+		for (int32 Broadcast = 0; Broadcast < NumBroadcasts; ++Broadcast)
+		{
+			NativeChannel.Broadcast(Event);
+		}
+		const double NativeSeconds = FPlatformTime::Seconds() - NativeStart;
+
+		int64 TotalCalls = 0;
+		for (const UNetworkManagerEventBenchmarkListener* Listener : Listeners)
+		{
+			TotalCalls += Listener->Calls;
+		}
+
+		const double Calls = static_cast<double>(NumListeners) * NumBroadcasts;
+		UE_LOG(LogNetworkManagerEventBenchmark, Display, TEXT("%d listeners x %d broadcasts (%lld calls made)"), NumListeners, NumBroadcasts, TotalCalls);
+		UE_LOG(LogNetworkManagerEventBenchmark, Display, TEXT("  Dynamic: %.3f ms per broadcast, %.1f ns per listener"),
+			DynamicSeconds * 1000.0 / NumBroadcasts, DynamicSeconds * 1e9 / Calls);
+		UE_LOG(LogNetworkManagerEventBenchmark, Display, TEXT("  Native:  %.3f ms per broadcast, %.1f ns per listener"),
+			NativeSeconds * 1000.0 / NumBroadcasts, NativeSeconds * 1e9 / Calls);
+		UE_LOG(LogNetworkManagerEventBenchmark, Display, TEXT("  Native is %.1fx faster"), NativeSeconds > 0.0 ? DynamicSeconds / NativeSeconds : 0.0);
+
+		for (UNetworkManagerEventBenchmarkListener* Listener : Listeners)
+		{
+			Listener->MarkAsGarbage();
+		}
+	}));
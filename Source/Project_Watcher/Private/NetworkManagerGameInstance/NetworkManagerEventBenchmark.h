@@ -0,0 +1,25 @@
+//Project Watcher 2024 & Beyond
+
+#pragma once
+#include "CoreMinimal.h"
+#include "UObject/Object.h"
+#include "NetworkManagerEventBenchmark.generated.h"
+
+struct FNetworkManagerEvent;
+
+/**
+ * Listener used by Watcher.Sessions.EventBenchmark, bound once through the dynamic delegate and once through the native channel
+ * so both dispatch paths call into the same kind of object
+ */
+UCLASS(Transient)
+class UNetworkManagerEventBenchmarkListener : public UObject
+{
+	GENERATED_BODY()
+public:
+	int32 Calls = 0;
+
+	UFUNCTION()
+	void HandleDynamicEvent(const FName SessionName);
+
+	void HandleNativeEvent(const FNetworkManagerEvent& Event);
+};
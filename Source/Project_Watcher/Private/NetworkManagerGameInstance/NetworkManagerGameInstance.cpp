@@ -6,16 +6,30 @@
 #include "OnlineSubsystem.h"
 #include "OnlineSubsystemUtils.h"
 #include "AssetRegistry/AssetData.h"
+#include "Engine/Engine.h"
 #include "Engine/GameInstance.h"
 #include "Engine/LocalPlayer.h"
+#include "Engine/NetConnection.h"
+#include "Engine/NetDriver.h"
+#include "IPAddress.h"
+#include "SocketSubsystem.h"
 #include "GameFramework/PlayerController.h"
 #include "Interfaces/OnlineSessionDelegates.h"
+#include "HAL/IConsoleManager.h"
 #include "Misc/ConfigCacheIni.h"
+#include "Misc/NetworkVersion.h"
 #include "Online/OnlineSessionNames.h"
+#include "Matchmaking/MatchmakingServiceClient.h"
+#include "WatcherMemory/WatcherMemoryTags.h"
+#include "WatcherStats/WatcherStats.h"
 
 DECLARE_LOG_CATEGORY_EXTERN(LogNetworkManager, Log, All);
 DEFINE_LOG_CATEGORY(LogNetworkManager);
 
+DECLARE_STATS_GROUP(TEXT("NetworkManager"), STATGROUP_NetworkManager, STATCAT_Advanced);
+DECLARE_CYCLE_STAT(TEXT("Flush Events"), STAT_NetworkManager_FlushEvents, STATGROUP_NetworkManager);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Events Delivered"), STAT_NetworkManager_EventsDelivered, STATGROUP_NetworkManager);
+
 
 USessionSearchResult* USessionSearchResult::Make(const FOnlineSessionSearchResult& OnlineSessionSearchResultIn)
 {
@@ -52,6 +66,78 @@ FSessionData USessionSearchResult::GetSessionData() const
 	return FSessionData(SessionName, IsPrivate, OpenPlayerSlots, IsFull);
 }
 
+void FSessionSearchFilter::ApplyTo(FOnlineSearchSettings& QuerySettings) const
+{
+	if (this->bMatchBuild)
+	{
+		QuerySettings.Set(SETTING_BUILDID, GetLocalBuildId(), EOnlineComparisonOp::Equals);
+	}
+	if (!this->MapName.IsEmpty())
+	{
+		QuerySettings.Set(SETTING_MAPNAME, this->MapName, EOnlineComparisonOp::Equals);
+	}
+	if (this->MinOpenSlots > 0)
+	{
+		QuerySettings.Set(SEARCH_MINSLOTSAVAILABLE, this->MinOpenSlots, EOnlineComparisonOp::GreaterThanEquals);
+	}
+	if (this->Privacy != ESessionPrivacyFilter::Any)
+	{
+		QuerySettings.Set(SETTING_PRIVATE, this->Privacy == ESessionPrivacyFilter::PrivateOnly, EOnlineComparisonOp::Equals);
+	}
+	if (!this->Region.IsEmpty())
+	{
+		QuerySettings.Set(SETTING_REGION, this->Region, EOnlineComparisonOp::Equals);
+	}
+}
+
+bool FSessionSearchFilter::Matches(const FOnlineSessionSearchResult& SearchResult) const
+{
+	const FOnlineSessionSettings& Settings = SearchResult.Session.SessionSettings;
+
+	if (this->bMatchBuild)
+	{
+		int32 BuildId = 0;
+		if (!Settings.Get(SETTING_BUILDID, BuildId) || BuildId != GetLocalBuildId())
+		{
+			return false;
+		}
+	}
+
+	FString Value;
+	if (!this->MapName.IsEmpty() && (!Settings.Get(SETTING_MAPNAME, Value) || Value != this->MapName))
+	{
+		return false;
+	}
+
+	if (SearchResult.Session.NumOpenPublicConnections + SearchResult.Session.NumOpenPrivateConnections < this->MinOpenSlots)
+	{
+		return false;
+	}
+
+	if (this->Privacy != ESessionPrivacyFilter::Any)
+	{
+		bool IsPrivate = false;
+		Settings.Get(SETTING_PRIVATE, IsPrivate);
+		if (IsPrivate != (this->Privacy == ESessionPrivacyFilter::PrivateOnly))
+		{
+			return false;
+		}
+	}
+
+	if (!this->Region.IsEmpty() && (!Settings.Get(SETTING_REGION, Value) || Value != this->Region))
+	{
+		return false;
+	}
+
+	return true;
+}
+
+int32 FSessionSearchFilter::GetLocalBuildId()
+{
+	//Already covers project version and engine net compatibility, exactly what decides if a connection would be accepted
+	return static_cast<int32>(FNetworkVersion::GetLocalNetworkVersion());
+}
+
 void UNetworkManagerGameInstance::SetSessionName(const FName NewSessionName)
 {
 	this->SessionName = NewSessionName;
@@ -65,11 +151,24 @@ FName UNetworkManagerGameInstance::GetSessionName() const
 FString UNetworkManagerGameInstance::BuildMainGameMapPathForHosting() const
 {
 	const FString HostName = Online::GetIdentityInterface(GetWorld())->GetPlayerNickname(0);
-	return this->MainGameMap + "?Name=" + HostName + "?listen";
+	FString HostPath = this->MainGameMap + "?Name=" + HostName + "?listen";
+	if (this->SessionSettings.IsValid() && this->SessionSettings->bIsLANMatch)
+	{
+		HostPath += "?bIsLanMatch";
+	}
+	return HostPath;
 }
 
 FString UNetworkManagerGameInstance::BuildMainGameMapPathForJoining() const
 {
+	//Service sessions carry their address, the session interface never saw them
+	FString ConnectAddress;
+	if (this->SessionData.Session.SessionSettings.Get(SETTING_CONNECTADDRESS, ConnectAddress))
+	{
+		UE_LOG(LogNetworkManager, Display, TEXT("Client Join path: %s"), *ConnectAddress);
+		return ConnectAddress;
+	}
+
 	IOnlineSessionPtr Session = Online::GetSessionInterface(GetWorld());
 	if (Session.IsValid())
 	{
@@ -83,6 +182,346 @@ FString UNetworkManagerGameInstance::BuildMainGameMapPathForJoining() const
 	return FString();
 }
 
+void UNetworkManagerGameInstance::ApplyNetDriverForConnection(const bool bUseLANDriver)
+{
+	if (!GEngine)
+	{
+		return;
+	}
+
+	if (!bUseLANDriver)
+	{
+		this->RestoreNetDriverDefinitions();
+		return;
+	}
+
+	for (FNetDriverDefinition& Definition : GEngine->NetDriverDefinitions)
+	{
+		if (Definition.DefName == NAME_GameNetDriver && Definition.DriverClassName != this->LANNetDriverClassName)
+		{
+			UE_LOG(LogNetworkManager, Display, TEXT("GameNetDriver now uses %s"), *this->LANNetDriverClassName.ToString());
+			Definition.DriverClassName = this->LANNetDriverClassName;
+		}
+	}
+}
+
+void UNetworkManagerGameInstance::RestoreNetDriverDefinitions()
+{
+	if (!GEngine || this->OriginalNetDriverDefinitions.IsEmpty())
+	{
+		return;
+	}
+
+	for (const FNetDriverDefinition& Original : this->OriginalNetDriverDefinitions)
+	{
+		const FNetDriverDefinition* Current = GEngine->NetDriverDefinitions.FindByPredicate([&Original](const FNetDriverDefinition& Definition)
+		{
+			return Definition.DefName == Original.DefName;
+		});
+		if (!Current || Current->DriverClassName != Original.DriverClassName)
+		{
+			UE_LOG(LogNetworkManager, Display, TEXT("%s back to %s"), *Original.DefName.ToString(), *Original.DriverClassName.ToString());
+		}
+	}
+	GEngine->NetDriverDefinitions = this->OriginalNetDriverDefinitions;
+}
+
+void UNetworkManagerGameInstance::HandleNetworkFailure(UWorld* World, UNetDriver* NetDriver, ENetworkFailure::Type FailureType, const FString& ErrorString)
+{
+	//Whoever retries (reconnect, migration) applies the driver again before it connects
+	this->RestoreNetDriverDefinitions();
+}
+
+void UNetworkManagerGameInstance::HandleTravelFailure(UWorld* World, ETravelFailure::Type FailureType, const FString& ErrorString)
+{
+	this->RestoreNetDriverDefinitions();
+}
+
+TSharedRef<FOnlineSessionSearch> UNetworkManagerGameInstance::MakeSessionSearch(const bool bLANQuery, const int32 MaxSearchResults, const FSessionSearchFilter* Filter) const
+{
+	TSharedRef<FOnlineSessionSearch> Search = MakeShared<FOnlineSessionSearch>();
+	Search->MaxSearchResults = MaxSearchResults;
+	Search->bIsLanQuery = bLANQuery;
+
+	if (bLANQuery)
+	{
+		//LAN discovery is a broadcast, nobody answering quickly means nobody is there
+		Search->TimeoutInSeconds = this->AutoLANSearchTimeout;
+	}
+	else
+	{
+		Search->QuerySettings.Set(SEARCH_PRESENCE, true, EOnlineComparisonOp::Equals);
+	}
+
+	if (Filter)
+	{
+		Filter->ApplyTo(Search->QuerySettings);
+	}
+	return Search;
+}
+
+FSessionRequestId UNetworkManagerGameInstance::QueueFilteredSearch(const int32 MaxSearchResults, const FSessionSearchFilter& Filter, TFunction<void(const FSessionSearchOutcome&)>&& OnComplete)
+{
+	const TSharedRef<FSessionSearchRequest> Request = MakeShared<FSessionSearchRequest>();
+	Request->Filter = Filter;
+	Request->bApplyFilter = true;
+
+	//Splitscreen guests join with us, sessions without room for all of them are no use
+	Request->Filter.MinOpenSlots = FMath::Max(Request->Filter.MinOpenSlots, this->GetNumLocalPlayers());
+
+	//Auto runs the LAN pass first, OnFindSessionsCompletionHandler falls through to Online when it comes back empty
+	Request->bAutoLANPass = this->ConnectionMode == ENetworkManagerConnectionMode::Auto;
+	Request->Search = this->MakeSessionSearch(this->ConnectionMode != ENetworkManagerConnectionMode::Online, MaxSearchResults, &Request->Filter);
+	Request->OnComplete = MoveTemp(OnComplete);
+	return this->QueueSearch(Request);
+}
+
+FSessionRequestId UNetworkManagerGameInstance::QueueSearch(const TSharedRef<FSessionSearchRequest>& Request)
+{
+	Request->Id = this->NextSearchRequestId++;
+	this->SearchQueue.Add(Request);
+	if (!this->bSearchRunning)
+	{
+		this->StartNextSearch();
+	}
+	return Request->Id;
+}
+
+void UNetworkManagerGameInstance::StartNextSearch()
+{
+	while (!this->bSearchRunning && !this->SearchQueue.IsEmpty())
+	{
+		if (this->RunSearch(*this->SearchQueue[0]))
+		{
+			this->bSearchRunning = true;
+			return;
+		}
+
+		FSessionSearchOutcome Outcome;
+		Outcome.Failure = TEXT("Failed to find sessions");
+		this->CompleteRunningSearch(MoveTemp(Outcome));
+	}
+}
+
+bool UNetworkManagerGameInstance::RunSearch(const FSessionSearchRequest& Request)
+{
+	LLM_SCOPE_BYTAG(Watcher_Networking);
+	if (this->MatchmakingService.IsValid() && !Request.Search->bIsLanQuery)
+	{
+		return this->RunServiceQuery(Request);
+	}
+
+	const IOnlineSessionPtr SessionInterface = Online::GetSessionInterface(GetWorld());
+	const ULocalPlayer* LocalPlayer = GetWorld()->GetFirstLocalPlayerFromController();
+	if (!SessionInterface.IsValid() || !LocalPlayer)
+	{
+		return false;
+	}
+
+	return SessionInterface->FindSessions(*LocalPlayer->GetPreferredUniqueNetId(), Request.Search.ToSharedRef());
+}
+
+bool UNetworkManagerGameInstance::RunServiceQuery(const FSessionSearchRequest& Request)
+{
+	FMatchmakingQuery Query;
+	Query.MaxResults = Request.Search->MaxSearchResults;
+	if (Request.bApplyFilter)
+	{
+		Query.MapName = Request.Filter.MapName;
+		Query.Region = Request.Filter.Region;
+		Query.MinOpenSlots = Request.Filter.MinOpenSlots;
+		Query.BuildId = Request.Filter.bMatchBuild ? FSessionSearchFilter::GetLocalBuildId() : 0;
+		Query.Privacy = static_cast<EMatchmakingPrivacy>(Request.Filter.Privacy);
+	}
+
+	//The service doesn't index migration tokens, look through everything and keep the one session carrying ours
+	FString MigrationTokenQuery;
+	Request.Search->QuerySettings.Get(SETTING_MIGRATIONTOKEN, MigrationTokenQuery);
+	if (!MigrationTokenQuery.IsEmpty())
+	{
+		Query.MaxResults = 200;
+	}
+
+	TWeakObjectPtr<ThisClass> WeakThis(this);
+	const TSharedPtr<FOnlineSessionSearch> Search = Request.Search;
+	Search->SearchState = EOnlineAsyncTaskState::InProgress;
+	this->MatchmakingService->Query(Query, [WeakThis, Search, MigrationTokenQuery](const bool bSuccessful, TArray<FMatchmakingSessionEntry>&& Entries)
+	{
+		ThisClass* NetworkManager = WeakThis.Get();
+		if (!NetworkManager || !NetworkManager->bSearchRunning || NetworkManager->SearchQueue[0]->Search != Search)
+		{
+			//Cancelled or shut down while the query was in flight
+			return;
+		}
+
+		Search->SearchResults.Reset();
+		for (const FMatchmakingSessionEntry& Entry : Entries)
+		{
+			if (MigrationTokenQuery.IsEmpty() || Entry.MigrationToken == MigrationTokenQuery)
+			{
+				Search->SearchResults.Add(FMatchmakingServiceClient::ToSearchResult(Entry));
+			}
+		}
+		Search->SearchState = bSuccessful ? EOnlineAsyncTaskState::Done : EOnlineAsyncTaskState::Failed;
+		NetworkManager->OnFindSessionsCompletionHandler(bSuccessful);
+	});
+	return true;
+}
+
+void UNetworkManagerGameInstance::AdvertiseToService()
+{
+	if (!this->MatchmakingService.IsValid() || !this->SessionSettings.IsValid() || !this->AdvertisedSessionId.IsEmpty())
+	{
+		return;
+	}
+
+	const IOnlineIdentityPtr IdentityInterface = Online::GetIdentityInterface(GetWorld());
+	if (!IdentityInterface.IsValid())
+	{
+		UE_LOG(LogNetworkManager, Warning, TEXT("No identity interface, the session isn't advertised to the matchmaking service"));
+		return;
+	}
+
+	FMatchmakingSessionEntry Entry;
+	Entry.OwnerName = IdentityInterface->GetPlayerNickname(0);
+	Entry.MapName = this->MainGameMap;
+	Entry.Region = this->Region;
+	Entry.ConnectAddress = this->GetServiceConnectAddress();
+	Entry.MigrationToken = this->MigrationToken;
+	Entry.BuildId = FSessionSearchFilter::GetLocalBuildId();
+	Entry.MaxPlayers = this->SessionSettings->NumPublicConnections;
+	Entry.OpenSlots = Entry.MaxPlayers - this->GetNumLocalPlayers();
+	this->SessionSettings->Get(SETTING_PRIVATE, Entry.bPrivate);
+
+	TWeakObjectPtr<ThisClass> WeakThis(this);
+	this->MatchmakingService->Advertise(Entry, [WeakThis](const FString& Id)
+	{
+		ThisClass* NetworkManager = WeakThis.Get();
+		if (!NetworkManager || Id.IsEmpty())
+		{
+			return;
+		}
+
+		UE_LOG(LogNetworkManager, Display, TEXT("Session advertised to the matchmaking service as %s"), *Id);
+		NetworkManager->AdvertisedSessionId = Id;
+		if (!NetworkManager->ServiceHeartbeatHandle.IsValid())
+		{
+			NetworkManager->ServiceHeartbeatHandle = FTSTicker::GetCoreTicker().AddTicker(
+				FTickerDelegate::CreateUObject(NetworkManager, &ThisClass::HeartbeatService), NetworkManager->ServiceHeartbeatInterval);
+		}
+	});
+}
+
+bool UNetworkManagerGameInstance::HeartbeatService(float DeltaTime)
+{
+	if (this->AdvertisedSessionId.IsEmpty())
+	{
+		return true;
+	}
+
+	int32 OpenSlots = -1;
+	const IOnlineSessionPtr SessionInterface = Online::GetSessionInterface(GetWorld());
+	if (const FNamedOnlineSession* Session = SessionInterface.IsValid() ? SessionInterface->GetNamedSession(this->GetSessionName()) : nullptr)
+	{
+		OpenSlots = Session->NumOpenPublicConnections + Session->NumOpenPrivateConnections;
+	}
+
+	TWeakObjectPtr<ThisClass> WeakThis(this);
+	this->MatchmakingService->Heartbeat(this->AdvertisedSessionId, OpenSlots, [WeakThis](const bool bKnown)
+	{
+		ThisClass* NetworkManager = WeakThis.Get();
+		if (NetworkManager && !bKnown && !NetworkManager->AdvertisedSessionId.IsEmpty())
+		{
+			//The service restarted or expired us, advertise again
+			UE_LOG(LogNetworkManager, Display, TEXT("Matchmaking service lost session %s, advertising again"), *NetworkManager->AdvertisedSessionId);
+			NetworkManager->AdvertisedSessionId.Reset();
+			NetworkManager->AdvertiseToService();
+		}
+	});
+	return true;
+}
+
+void UNetworkManagerGameInstance::WithdrawFromService()
+{
+	FTSTicker::GetCoreTicker().RemoveTicker(this->ServiceHeartbeatHandle);
+	this->ServiceHeartbeatHandle.Reset();
+
+	if (this->MatchmakingService.IsValid() && !this->AdvertisedSessionId.IsEmpty())
+	{
+		this->MatchmakingService->Withdraw(this->AdvertisedSessionId);
+	}
+	this->AdvertisedSessionId.Reset();
+}
+
+FString UNetworkManagerGameInstance::GetServiceConnectAddress() const
+{
+	if (!this->AdvertisedAddress.IsEmpty())
+	{
+		return this->AdvertisedAddress;
+	}
+
+	bool bCanBindAll = false;
+	const TSharedRef<FInternetAddr> LocalAddress = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->GetLocalHostAddr(*GLog, bCanBindAll);
+	return FString::Printf(TEXT("%s:%d"), *LocalAddress->ToString(false), FURL::UrlConfig.DefaultPort);
+}
+
+void UNetworkManagerGameInstance::CompleteRunningSearch(FSessionSearchOutcome&& Outcome)
+{
+	//Popped before the callback runs, it may queue the next search itself
+	const TSharedRef<FSessionSearchRequest> Request = this->SearchQueue[0];
+	this->SearchQueue.RemoveAt(0);
+	this->bSearchRunning = false;
+
+	if (Request->bCancelled)
+	{
+		Outcome = FSessionSearchOutcome();
+		Outcome.bCancelled = true;
+		Outcome.Failure = TEXT("Cancelled");
+	}
+	Request->OnComplete(Outcome);
+
+	this->StartNextSearch();
+}
+
+void UNetworkManagerGameInstance::BroadcastSearchOutcome(const FSessionSearchOutcome& Outcome)
+{
+	if (Outcome.bSuccessful)
+	{
+		this->CallOnFindSessionsComplete(Outcome.Results);
+	}
+	else
+	{
+		this->CallOnFindSessionsFailure(Outcome.Failure);
+	}
+}
+
+void UNetworkManagerGameInstance::RegisterGuestLocalPlayers(const FName SessionNameIn) const
+{
+	const IOnlineSessionPtr SessionInterface = Online::GetSessionInterface(GetWorld());
+	if (!SessionInterface.IsValid())
+	{
+		return;
+	}
+
+	const TArray<ULocalPlayer*>& LocalPlayers = GetGameInstance()->GetLocalPlayers();
+	for (int32 Index = 1; Index < LocalPlayers.Num(); ++Index)
+	{
+		//Guests without an online account (Steam) still join through the split join, they just don't hold a registered slot
+		const FUniqueNetIdRepl GuestId = LocalPlayers[Index]->GetPreferredUniqueNetId();
+		if (!GuestId.IsValid())
+		{
+			UE_LOG(LogNetworkManager, Display, TEXT("Local player %d has no online id, not registered with %s"), Index, *SessionNameIn.ToString());
+			continue;
+		}
+
+		SessionInterface->RegisterLocalPlayer(*GuestId, SessionNameIn, FOnRegisterLocalPlayerCompleteDelegate::CreateLambda(
+			[Index, SessionNameIn](const FUniqueNetId& PlayerId, const EOnJoinSessionCompleteResult::Type Result)
+		{
+			UE_LOG(LogNetworkManager, Display, TEXT("Local player %d registered with %s: %s"), Index, *SessionNameIn.ToString(), Result == EOnJoinSessionCompleteResult::Success ? TEXT("Success") : TEXT("Failed"));
+		}));
+	}
+}
+
 int32 UNetworkManagerGameInstance::CheckPlayerCountInput(const int32 MaxPlayersIn) const
 {
 	if (MaxPlayersIn >= 1 && MaxPlayersIn <= MaxPlayers)
@@ -107,15 +546,75 @@ void UNetworkManagerGameInstance::Initialize(FSubsystemCollectionBase& Collectio
 {
 	Super::Initialize(Collection);
 	this->SetupCallbacks();
+
+	if (GEngine)
+	{
+		this->OriginalNetDriverDefinitions = GEngine->NetDriverDefinitions;
+		this->NetworkFailureHandle = GEngine->OnNetworkFailure().AddUObject(this, &ThisClass::HandleNetworkFailure);
+		this->TravelFailureHandle = GEngine->OnTravelFailure().AddUObject(this, &ThisClass::HandleTravelFailure);
+	}
+
+	if (this->SessionBackend == ESessionBackend::MatchmakingService)
+	{
+		UE_LOG(LogNetworkManager, Display, TEXT("Sessions go through the matchmaking service at %s"), *this->MatchmakingServiceURL);
+		this->MatchmakingService = MakeShared<FMatchmakingServiceClient>(this->MatchmakingServiceURL);
+	}
 }
 
 void UNetworkManagerGameInstance::Deinitialize()
 {
+	if (this->QuickMatchRequest.bActive)
+	{
+		this->FinishQuickMatch(EQuickMatchResult::Failed, NAME_None, TEXT("Network manager shut down"));
+	}
+
+	//Before the events are dropped, so what the cancelled searches broadcast goes with them
+	this->CancelPendingSearches(TEXT("Shutting down"));
+
+	FTSTicker::GetCoreTicker().RemoveTicker(this->FlushEventsHandle);
+	this->FlushEventsHandle.Reset();
+	this->PendingEvents.Empty();
+
+	//Nobody is going to complete these anymore, let whoever waits on them know
+	for (const TSharedRef<FPendingSessionOp>& Op : this->PendingSessionOps)
+	{
+		FSessionOpOutcome Outcome;
+		Outcome.Failure = TEXT("Network manager shut down");
+		Op->Promise.SetValue(MoveTemp(Outcome));
+	}
+	this->PendingSessionOps.Empty();
+
+	this->WithdrawFromService();
+	this->MatchmakingService.Reset();
+
+	this->RestoreNetDriverDefinitions();
+	if (GEngine)
+	{
+		GEngine->OnNetworkFailure().Remove(this->NetworkFailureHandle);
+		GEngine->OnTravelFailure().Remove(this->TravelFailureHandle);
+	}
+
 	Super::Deinitialize();
 }
 
+void UNetworkManagerGameInstance::SetConnectionMode(const ENetworkManagerConnectionMode NewConnectionMode)
+{
+	this->ConnectionMode = NewConnectionMode;
+}
+
+ENetworkManagerConnectionMode UNetworkManagerGameInstance::GetConnectionMode() const
+{
+	return this->ConnectionMode;
+}
+
+int32 UNetworkManagerGameInstance::GetNumLocalPlayers() const
+{
+	return FMath::Max(1, GetGameInstance()->GetNumLocalPlayers());
+}
+
 void UNetworkManagerGameInstance::CreateSession(const int32 PlayerCount, const bool IsPrivate)
 {
+	LLM_SCOPE_BYTAG(Watcher_Networking);
 	const int32 VerifiedPlayerCount = this->CheckPlayerCountInput(PlayerCount);
 	const IOnlineSessionPtr SessionInterface = Online::GetSessionInterface(GetWorld());
 	
@@ -125,153 +624,919 @@ void UNetworkManagerGameInstance::CreateSession(const int32 PlayerCount, const b
 		return;
 	}
 
-	SessionSettings = MakeShareable(new FOnlineSessionSettings());
-	SessionSettings->NumPublicConnections = 8; //TODO Re enable private VS Public Lobbies
-	SessionSettings->bAllowInvites = true;
-	SessionSettings->bAllowJoinInProgress = true;
-	SessionSettings->bAllowJoinViaPresence = true;//TODO Test joining via presence / using typical steam joining techniques
-	SessionSettings->bAllowJoinViaPresenceFriendsOnly = false;
-	SessionSettings->bIsDedicated = false;
-	SessionSettings->bUsesPresence = true;
-	SessionSettings->bIsLANMatch = false;
-	SessionSettings->bShouldAdvertise = true;
-	SessionSettings->bUseLobbiesIfAvailable = true;
-	SessionSettings->Set(SETTING_MAPNAME, FString(this->MainGameMap), EOnlineDataAdvertisementType::ViaOnlineService);
+	if (this->GetNumLocalPlayers() > VerifiedPlayerCount)
+	{
+		this->CallOnCreateSessionFailure(FString::Printf(TEXT("%d local players don't fit in a %d player session"), this->GetNumLocalPlayers(), VerifiedPlayerCount));
+		return;
+	}
+
+	//Auto peers only look online when the LAN stays quiet, so Auto has to host where their LAN pass looks. Service sessions are direct IP like LAN ones
+	const bool bIsLANMatch = this->ConnectionMode != ENetworkManagerConnectionMode::Online || this->MatchmakingService.IsValid();
+
+	SessionSettings = MakeShareable(new FOnlineSessionSettings());
+	//Every local player takes a connection of its own once registered, the host's guests included, so the requested count is the whole session
+	SessionSettings->NumPublicConnections = VerifiedPlayerCount; //TODO Re enable private VS Public Lobbies
+	SessionSettings->bAllowInvites = true;
+	SessionSettings->bAllowJoinInProgress = true;
+	SessionSettings->bAllowJoinViaPresence = !bIsLANMatch;//TODO Test joining via presence / using typical steam joining techniques
+	SessionSettings->bAllowJoinViaPresenceFriendsOnly = false;
+	SessionSettings->bIsDedicated = false;
+	SessionSettings->bUsesPresence = !bIsLANMatch;
+	SessionSettings->bIsLANMatch = bIsLANMatch;
+	SessionSettings->bShouldAdvertise = true;
+	SessionSettings->bUseLobbiesIfAvailable = !bIsLANMatch;
+	SessionSettings->Set(SETTING_MAPNAME, FString(this->MainGameMap), EOnlineDataAdvertisementType::ViaOnlineService);
+	//Keys FSessionSearchFilter queries on
+	SessionSettings->Set(SETTING_BUILDID, FSessionSearchFilter::GetLocalBuildId(), EOnlineDataAdvertisementType::ViaOnlineService);
+	SessionSettings->Set(SETTING_PRIVATE, IsPrivate, EOnlineDataAdvertisementType::ViaOnlineService);
+	SessionSettings->Set(SETTING_REGION, this->Region, EOnlineDataAdvertisementType::ViaOnlineService);
+
+	if (this->MigrationToken.IsEmpty())
+	{
+		this->MigrationToken = FGuid::NewGuid().ToString(EGuidFormats::Digits);
+	}
+	SessionSettings->Set(SETTING_MIGRATIONTOKEN, this->MigrationToken, EOnlineDataAdvertisementType::ViaOnlineService);
+
+	this->SetSessionName(FName(*(Online::GetIdentityInterface(GetWorld())->GetPlayerNickname(0) + "'s Session")));
+	
+	const ULocalPlayer* LocalPlayer = GetWorld()->GetFirstLocalPlayerFromController();
+	if (!SessionInterface->CreateSession(*LocalPlayer->GetPreferredUniqueNetId(), this->GetSessionName(), *SessionSettings))
+	{
+		this->CallOnCreateSessionFailure(TEXT("Failed to create Session"));
+	}
+}
+
+void UNetworkManagerGameInstance::UpdateSession()
+{
+	LLM_SCOPE_BYTAG(Watcher_Networking);
+	const IOnlineSessionPtr SessionInterface = Online::GetSessionInterface(GetWorld());
+	if (!SessionInterface.IsValid())
+	{
+		CallOnUpdateSessionFailure(TEXT("Session interface isn't Valid"));
+		return;
+	}
+
+	//TODO Update to new Map name proper!
+	const TSharedPtr<FOnlineSessionSettings> UpdatedSessionSettings = MakeShareable(new FOnlineSessionSettings(*SessionSettings));
+	UpdatedSessionSettings->Set(SETTING_MAPNAME, FString("Updated Level Name"), EOnlineDataAdvertisementType::ViaOnlineService);
+
+	if (!SessionInterface->UpdateSession(this->GetSessionName(), *UpdatedSessionSettings))
+	{
+		this->CallOnUpdateSessionFailure(TEXT("Failed to update session"));
+	}
+	else
+	{
+		SessionSettings = UpdatedSessionSettings;
+	}
+}
+
+void UNetworkManagerGameInstance::StartSession()
+{
+	const IOnlineSessionPtr SessionInterface = Online::GetSessionInterface(GetWorld());
+	if (!SessionInterface.IsValid())
+	{
+		this->CallOnStartSessionFailure(TEXT("Session Interface is Invalid"));
+		return;
+	}
+
+	if (!SessionInterface->StartSession(this->GetSessionName()))
+	{
+		this->CallOnStartSessionFailure(TEXT("Failed to start session"));
+	}
+}
+
+void UNetworkManagerGameInstance::EndSession()
+{
+	const IOnlineSessionPtr sessionInterface = Online::GetSessionInterface(GetWorld());
+	if (!sessionInterface.IsValid())
+	{
+		this->CallOnEndSessionFailure(TEXT("Session interface is Invalid"));
+		return;
+	}
+
+	if (!sessionInterface->EndSession(this->GetSessionName()))
+	{
+		this->CallOnEndSessionFailure(TEXT("Failed to end session"));
+	}
+}
+
+void UNetworkManagerGameInstance::DestroySession()
+{
+	const IOnlineSessionPtr SessionInterface = Online::GetSessionInterface(GetWorld());
+
+	//Service joins never went through the session interface, there is nothing for it to destroy
+	const bool bServiceJoin = this->SessionData.Session.SessionSettings.Settings.Contains(SETTING_CONNECTADDRESS);
+	if (bServiceJoin && !(SessionInterface.IsValid() && SessionInterface->GetNamedSession(this->GetSessionName())))
+	{
+		this->OnSessionLeft(this->GetSessionName());
+		return;
+	}
+
+	if (!SessionInterface.IsValid())
+	{
+		this->CallOnDestroySessionFailure(TEXT("SessionInterface is invalid"));
+		return;
+	}
+
+	if (!SessionInterface->DestroySession(this->GetSessionName()))
+	{
+		this->CallOnDestroySessionFailure(TEXT("Failed to destroy session"));
+	}
+}
+
+void UNetworkManagerGameInstance::FindSessions(const int32 MaxSearchResults)
+{
+	this->FindSessionsFiltered(MaxSearchResults, FSessionSearchFilter());
+}
+
+void UNetworkManagerGameInstance::FindSessionsFiltered(const int32 MaxSearchResults, const FSessionSearchFilter& Filter)
+{
+	this->QueueFilteredSearch(MaxSearchResults, Filter, [this](const FSessionSearchOutcome& Outcome)
+	{
+		this->BroadcastSearchOutcome(Outcome);
+	});
+}
+
+void UNetworkManagerGameInstance::SetRegion(const FString& NewRegion)
+{
+	this->Region = NewRegion;
+}
+
+FString UNetworkManagerGameInstance::GetRegion() const
+{
+	return this->Region;
+}
+
+void UNetworkManagerGameInstance::JoinSession(USessionSearchResult* SessionResult)
+{
+	LLM_SCOPE_BYTAG(Watcher_Networking);
+	const FOnlineSession& Session = SessionResult->GetOnlineSessionSearchResult().Session;
+	if (Session.NumOpenPublicConnections + Session.NumOpenPrivateConnections < this->GetNumLocalPlayers())
+	{
+		this->CallOnJoinSessionFailure(TEXT("Not enough open slots for every local player"));
+		return;
+	}
+
+	this->SessionData = SessionResult->GetOnlineSessionSearchResult();
+	this->SetSessionName(FName(*SessionResult->GetSessionData().SessionName));
+
+	this->MigrationToken.Reset();
+	this->SessionData.Session.SessionSettings.Get(SETTING_MIGRATIONTOKEN, this->MigrationToken);
+
+	//Service results aren't known to the session interface, there is nothing to join but the host itself
+	if (this->SessionData.Session.SessionSettings.Settings.Contains(SETTING_CONNECTADDRESS))
+	{
+		this->ApplyNetDriverForConnection(true);
+		this->CallOnJoinSessionComplete(this->GetSessionName());
+		return;
+	}
+	
+	const IOnlineSessionPtr SessionInterface = Online::GetSessionInterface(GetWorld());
+	if (!SessionInterface.IsValid())
+	{
+		this->CallOnJoinSessionFailure(TEXT("SessionInterface is invalid"));
+		return;
+	}
+	
+	//LAN results resolve to ip:port, those have to go over IpNetDriver
+	this->ApplyNetDriverForConnection(this->SessionData.Session.SessionSettings.bIsLANMatch);
+
+	const ULocalPlayer* LocalPlayer = GetWorld()->GetFirstLocalPlayerFromController();
+	if (!SessionInterface->JoinSession(*LocalPlayer->GetPreferredUniqueNetId(), this->GetSessionName(), SessionResult->GetOnlineSessionSearchResult()))
+	{
+		this->RestoreNetDriverDefinitions();
+		this->CallOnJoinSessionFailure(TEXT("Error joining Session"));
+	}
+}
+
+bool UNetworkManagerGameInstance::ServerTravelAsHost_GameMap()
+{
+	this->ApplyNetDriverForConnection(this->SessionSettings.IsValid() && this->SessionSettings->bIsLANMatch);
+
+	//Non seamless travel
+	if (!GetWorld()->ServerTravel(this->BuildMainGameMapPathForHosting()))
+	{
+		this->RestoreNetDriverDefinitions();
+		return false;
+	}
+	return true;
+}
+
+bool UNetworkManagerGameInstance::ServerTravelAsClient_GameMap() const
+{
+	//Non seamless travel
+	if (APlayerController * PlayerController = GetWorld()->GetFirstPlayerController())
+	{
+		PlayerController->ClientTravel(this->BuildMainGameMapPathForJoining(), TRAVEL_Absolute);
+		return true;
+	}
+	
+	return false;
+}
+
+bool UNetworkManagerGameInstance::JoinByAddress(const FString& Address)
+{
+	if (Address.IsEmpty())
+	{
+		return false;
+	}
+
+	APlayerController * PlayerController = GetWorld()->GetFirstPlayerController();
+	if (!PlayerController)
+	{
+		return false;
+	}
+
+	this->ApplyNetDriverForConnection(true);
+	UE_LOG(LogNetworkManager, Display, TEXT("Direct join path: %s"), *Address);
+	PlayerController->ClientTravel(Address, TRAVEL_Absolute);
+	return true;
+}
+
+bool UNetworkManagerGameInstance::JoinByConnectString(const FString& ConnectString, const bool bIsLANMatch)
+{
+	if (ConnectString.IsEmpty())
+	{
+		return false;
+	}
+
+	APlayerController * PlayerController = GetWorld()->GetFirstPlayerController();
+	if (!PlayerController)
+	{
+		return false;
+	}
+
+	this->ApplyNetDriverForConnection(bIsLANMatch);
+	UE_LOG(LogNetworkManager, Display, TEXT("Rejoin path: %s"), *ConnectString);
+	PlayerController->ClientTravel(ConnectString, TRAVEL_Absolute);
+	return true;
+}
+
+FString UNetworkManagerGameInstance::GetJoinedSessionId() const
+{
+	FString ServiceSessionId;
+	if (this->SessionData.Session.SessionSettings.Get(SETTING_SERVICESESSIONID, ServiceSessionId))
+	{
+		return ServiceSessionId;
+	}
+	return this->SessionData.IsValid() ? this->SessionData.GetSessionIdStr() : FString();
+}
+
+FString UNetworkManagerGameInstance::GetJoinedConnectString() const
+{
+	const bool bJoined = this->SessionData.IsValid() || this->SessionData.Session.SessionSettings.Settings.Contains(SETTING_CONNECTADDRESS);
+	return bJoined ? this->BuildMainGameMapPathForJoining() : FString();
+}
+
+bool UNetworkManagerGameInstance::IsJoinedSessionLAN() const
+{
+	return this->SessionData.Session.SessionSettings.bIsLANMatch;
+}
+
+void UNetworkManagerGameInstance::FindSessionById(const FString& SessionId)
+{
+	this->StartFindSessionById(SessionId, [this](const FSessionSearchOutcome& Outcome)
+	{
+		this->BroadcastSearchOutcome(Outcome);
+	});
+}
+
+FSessionRequestId UNetworkManagerGameInstance::StartFindSessionById(const FString& SessionId, TFunction<void(const FSessionSearchOutcome&)>&& OnComplete)
+{
+	LLM_SCOPE_BYTAG(Watcher_Networking);
+	const FSessionRequestId LookupId = this->NextSearchRequestId++;
+	FSessionIdLookup& Lookup = this->PendingIdLookups.Add(LookupId);
+	Lookup.OnComplete = MoveTemp(OnComplete);
+
+	Lookup.TimeoutHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateWeakLambda(this, [this, LookupId](float)
+	{
+		FSessionSearchOutcome Outcome;
+		Outcome.Failure = TEXT("Timed out");
+		this->ResolveIdLookup(LookupId, Outcome);
+		return false;
+	}), FMath::Max(this->FindSessionByIdTimeout, 0.f));
+
+	TWeakObjectPtr<ThisClass> WeakThis(this);
+
+	if (this->MatchmakingService.IsValid())
+	{
+		this->MatchmakingService->FindById(SessionId, [WeakThis, LookupId](const FMatchmakingSessionEntry* Entry)
+		{
+			ThisClass* Manager = WeakThis.Get();
+			if (!Manager)
+			{
+				return;
+			}
+
+			FSessionSearchOutcome Outcome;
+			Outcome.bSuccessful = Entry != nullptr;
+			if (Entry)
+			{
+				Outcome.Results.Add(FMatchmakingServiceClient::ToSearchResult(*Entry));
+			}
+			else
+			{
+				Outcome.Failure = TEXT("Session not found");
+			}
+			Manager->ResolveIdLookup(LookupId, Outcome);
+		});
+		return LookupId;
+	}
+
+	FSessionSearchOutcome Failed;
+	const IOnlineSessionPtr SessionInterface = Online::GetSessionInterface(GetWorld());
+	if (!SessionInterface.IsValid())
+	{
+		Failed.Failure = TEXT("SessionInterface is Invalid");
+		this->ResolveIdLookup(LookupId, Failed);
+		return LookupId;
+	}
+
+	const FUniqueNetIdPtr SessionUniqueId = SessionInterface->CreateSessionIdFromString(SessionId);
+	const ULocalPlayer* LocalPlayer = GetWorld()->GetFirstLocalPlayerFromController();
+	if (!SessionUniqueId.IsValid() || !LocalPlayer)
+	{
+		Failed.Failure = TEXT("Invalid session id");
+		this->ResolveIdLookup(LookupId, Failed);
+		return LookupId;
+	}
+
+	//Completes through its own delegate, so it doesn't wait behind the search queue
+	const FUniqueNetIdRepl LocalPlayerId = LocalPlayer->GetPreferredUniqueNetId();
+	const bool bStarted = SessionInterface->FindSessionById(*LocalPlayerId, *SessionUniqueId, *LocalPlayerId, FOnSingleSessionResultCompleteDelegate::CreateWeakLambda(this,
+		[this, LookupId](const int32 LocalUserNum, const bool Successful, const FOnlineSessionSearchResult& SearchResult)
+	{
+		FSessionSearchOutcome Outcome;
+		Outcome.bSuccessful = Successful && SearchResult.IsValid();
+		if (Outcome.bSuccessful)
+		{
+			Outcome.Results.Add(SearchResult);
+		}
+		else
+		{
+			Outcome.Failure = TEXT("Session not found");
+		}
+		this->ResolveIdLookup(LookupId, Outcome);
+	}));
+
+	if (!bStarted)
+	{
+		Failed.Failure = TEXT("Failed to find session by id");
+		this->ResolveIdLookup(LookupId, Failed);
+	}
+	return LookupId;
+}
+
+void UNetworkManagerGameInstance::ResolveIdLookup(const FSessionRequestId LookupId, const FSessionSearchOutcome& Outcome)
+{
+	FSessionIdLookup Lookup;
+	if (!this->PendingIdLookups.RemoveAndCopyValue(LookupId, Lookup))
+	{
+		return;
+	}
+
+	FTSTicker::GetCoreTicker().RemoveTicker(Lookup.TimeoutHandle);
+	Lookup.OnComplete(Outcome);
+}
+
+void UNetworkManagerGameInstance::CancelPendingSearches(const FString& Reason)
+{
+	FSessionSearchOutcome Outcome;
+	Outcome.bCancelled = true;
+	Outcome.Failure = Reason;
+
+	//Kept set while draining so whatever the callbacks queue waits here instead of starting, and gets drained too
+	this->bSearchRunning = true;
+	while (this->SearchQueue.Num() > 0)
+	{
+		const TSharedRef<FSessionSearchRequest> Request = this->SearchQueue[0];
+		this->SearchQueue.RemoveAt(0);
+		Request->OnComplete(Outcome);
+	}
+	this->bSearchRunning = false;
+
+	TArray<FSessionRequestId> LookupIds;
+	this->PendingIdLookups.GenerateKeyArray(LookupIds);
+	for (const FSessionRequestId LookupId : LookupIds)
+	{
+		this->ResolveIdLookup(LookupId, Outcome);
+	}
+}
+
+TFuture<FSessionSearchOutcome> UNetworkManagerGameInstance::FindSessionsAsync(const int32 MaxSearchResults, const FSessionSearchFilter& Filter, FSessionRequestId* OutRequestId)
+{
+	const TSharedRef<TPromise<FSessionSearchOutcome>> Promise = MakeShared<TPromise<FSessionSearchOutcome>>();
+	TFuture<FSessionSearchOutcome> Future = Promise->GetFuture();
+
+	const FSessionRequestId RequestId = this->QueueFilteredSearch(MaxSearchResults, Filter, [Promise](const FSessionSearchOutcome& Outcome)
+	{
+		Promise->SetValue(Outcome);
+	});
+
+	if (OutRequestId)
+	{
+		*OutRequestId = RequestId;
+	}
+	return Future;
+}
+
+TFuture<FSessionSearchOutcome> UNetworkManagerGameInstance::FindSessionByIdAsync(const FString& SessionId, FSessionRequestId* OutRequestId)
+{
+	const TSharedRef<TPromise<FSessionSearchOutcome>> Promise = MakeShared<TPromise<FSessionSearchOutcome>>();
+	TFuture<FSessionSearchOutcome> Future = Promise->GetFuture();
+
+	const FSessionRequestId RequestId = this->StartFindSessionById(SessionId, [Promise](const FSessionSearchOutcome& Outcome)
+	{
+		Promise->SetValue(Outcome);
+	});
+
+	if (OutRequestId)
+	{
+		*OutRequestId = RequestId;
+	}
+	return Future;
+}
+
+TFuture<FSessionSearchOutcome> UNetworkManagerGameInstance::FindSessionByMigrationTokenAsync(const FString& Token)
+{
+	const TSharedRef<TPromise<FSessionSearchOutcome>> Promise = MakeShared<TPromise<FSessionSearchOutcome>>();
+	TFuture<FSessionSearchOutcome> Future = Promise->GetFuture();
+
+	//The old session is already gone by now, the replacement is hosted with our connection mode so search the way FindSessions does
+	const TSharedRef<FSessionSearchRequest> Request = MakeShared<FSessionSearchRequest>();
+	Request->Search = this->MakeSessionSearch(this->ConnectionMode != ENetworkManagerConnectionMode::Online, 1, nullptr);
+	Request->Search->QuerySettings.Set(SETTING_MIGRATIONTOKEN, Token, EOnlineComparisonOp::Equals);
+	Request->OnComplete = [Promise](const FSessionSearchOutcome& Outcome)
+	{
+		Promise->SetValue(Outcome);
+	};
+	this->QueueSearch(Request);
+	return Future;
+}
+
+bool UNetworkManagerGameInstance::CancelSearch(const FSessionRequestId RequestId)
+{
+	//Id lookups can't be aborted on the backend either, their late answer gets dropped
+	if (this->PendingIdLookups.Contains(RequestId))
+	{
+		FSessionSearchOutcome Outcome;
+		Outcome.bCancelled = true;
+		Outcome.Failure = TEXT("Cancelled");
+		this->ResolveIdLookup(RequestId, Outcome);
+		return true;
+	}
+
+	const int32 Index = this->SearchQueue.IndexOfByPredicate([RequestId](const TSharedRef<FSessionSearchRequest>& Request)
+	{
+		return Request->Id == RequestId;
+	});
+	if (Index == INDEX_NONE || this->SearchQueue[Index]->bCancelled)
+	{
+		return false;
+	}
+
+	const TSharedRef<FSessionSearchRequest> Request = this->SearchQueue[Index];
+	Request->bCancelled = true;
+
+	//Still waiting its turn, the backend never saw it
+	if (Index > 0 || !this->bSearchRunning)
+	{
+		this->SearchQueue.RemoveAt(Index);
+		FSessionSearchOutcome Outcome;
+		Outcome.bCancelled = true;
+		Outcome.Failure = TEXT("Cancelled");
+		Request->OnComplete(Outcome);
+		return true;
+	}
+
+	//Service queries can't be aborted, their late answer gets dropped
+	if (this->MatchmakingService.IsValid() && !Request->Search->bIsLanQuery)
+	{
+		this->CompleteRunningSearch(FSessionSearchOutcome());
+		return true;
+	}
+
+	//Running, the request resolves as cancelled through whichever completion the backend sends first
+	const IOnlineSessionPtr SessionInterface = Online::GetSessionInterface(GetWorld());
+	if (SessionInterface.IsValid())
+	{
+		SessionInterface->CancelFindSessions();
+	}
+	return true;
+}
+
+TFuture<FSessionOpOutcome> UNetworkManagerGameInstance::CreateSessionAsync(const int32 PlayerCount, const bool IsPrivate)
+{
+	return this->RunSessionOp(ENetworkManagerEvent::CreateSessionComplete, ENetworkManagerEvent::CreateSessionFailure, [this, PlayerCount, IsPrivate]()
+	{
+		this->CreateSession(PlayerCount, IsPrivate);
+	});
+}
+
+TFuture<FSessionOpOutcome> UNetworkManagerGameInstance::JoinSessionAsync(USessionSearchResult* SessionResult)
+{
+	return this->RunSessionOp(ENetworkManagerEvent::JoinSessionComplete, ENetworkManagerEvent::JoinSessionFailure, [this, SessionResult]()
+	{
+		this->JoinSession(SessionResult);
+	});
+}
+
+TFuture<FSessionOpOutcome> UNetworkManagerGameInstance::DestroySessionAsync()
+{
+	return this->RunSessionOp(ENetworkManagerEvent::DestroySessionComplete, ENetworkManagerEvent::DestroySessionFailure, [this]()
+	{
+		this->DestroySession();
+	});
+}
+
+TFuture<FSessionOpOutcome> UNetworkManagerGameInstance::RunSessionOp(const ENetworkManagerEvent CompleteEvent, const ENetworkManagerEvent FailureEvent, TFunctionRef<void()> Issue,
+	const ESessionOpListeners Listeners)
+{
+	const TSharedRef<FPendingSessionOp> Op = MakeShared<FPendingSessionOp>();
+	Op->Id = this->NextSessionOpId++;
+	Op->CompleteEvent = CompleteEvent;
+	Op->FailureEvent = FailureEvent;
+	Op->Listeners = Listeners;
+	this->PendingSessionOps.Add(Op);
+	TFuture<FSessionOpOutcome> Future = Op->Promise.GetFuture();
+
+	const FSessionRequestId PreviousIssuingOpId = this->IssuingSessionOpId;
+	this->IssuingSessionOpId = Op->Id;
+	Issue();
+	this->IssuingSessionOpId = PreviousIssuingOpId;
+
+	//Create / join set the session name, the backend answers for it later
+	Op->SessionName = this->GetSessionName();
+	Op->bIssued = true;
+	return Future;
+}
+
+FSessionRequestId UNetworkManagerGameInstance::ClaimSessionOp(const FNetworkManagerEvent& Event)
+{
+	const auto Answers = [&Event](const TSharedRef<FPendingSessionOp>& Op)
+	{
+		return !Op->bRaised && (Op->CompleteEvent == Event.Type || Op->FailureEvent == Event.Type);
+	};
+
+	//Raised from inside the call that issued the op (early failures, service joins, backends failing synchronously)
+	const FSessionRequestId IssuingOpId = this->IssuingSessionOpId;
+	TSharedRef<FPendingSessionOp>* Claimed = this->PendingSessionOps.FindByPredicate([&Answers, IssuingOpId](const TSharedRef<FPendingSessionOp>& Op)
+	{
+		return Op->Id == IssuingOpId && Answers(Op);
+	});
+
+	//The backend answering a call it accepted earlier, it runs one op of a kind per session name
+	if (!Claimed)
+	{
+		Claimed = this->PendingSessionOps.FindByPredicate([&Answers, &Event](const TSharedRef<FPendingSessionOp>& Op)
+		{
+			return Op->bIssued && Op->SessionName == Event.SessionName && Answers(Op);
+		});
+	}
+
+	if (!Claimed)
+	{
+		return 0;
+	}
+	(*Claimed)->bRaised = true;
+	return (*Claimed)->Id;
+}
+
+bool UNetworkManagerGameInstance::IsSessionOpEventQuiet(const FNetworkManagerEvent& Event) const
+{
+	if (Event.RequestId == 0)
+	{
+		return false;
+	}
+
+	const TSharedRef<FPendingSessionOp>* Op = this->PendingSessionOps.FindByPredicate([&Event](const TSharedRef<FPendingSessionOp>& PendingOp)
+	{
+		return PendingOp->Id == Event.RequestId;
+	});
+	if (!Op)
+	{
+		return false;
+	}
+
+	switch ((*Op)->Listeners)
+	{
+	case ESessionOpListeners::None:
+		return true;
+	case ESessionOpListeners::CompleteOnly:
+		return Event.Type == (*Op)->FailureEvent;
+	default:
+		return false;
+	}
+}
+
+void UNetworkManagerGameInstance::ResolveSessionOp(const FNetworkManagerEvent& Event)
+{
+	if (Event.RequestId == 0)
+	{
+		return;
+	}
+
+	const int32 Index = this->PendingSessionOps.IndexOfByPredicate([&Event](const TSharedRef<FPendingSessionOp>& Op)
+	{
+		return Op->Id == Event.RequestId;
+	});
+	if (Index == INDEX_NONE)
+	{
+		return;
+	}
+
+	//Removed first, continuations may start the next op
+	const TSharedRef<FPendingSessionOp> Op = this->PendingSessionOps[Index];
+	this->PendingSessionOps.RemoveAt(Index);
+
+	FSessionOpOutcome Outcome;
+	Outcome.bSuccessful = Event.Type == Op->CompleteEvent;
+	Outcome.SessionName = Event.SessionName;
+	Outcome.Failure = Event.Failure;
+	Op->Promise.SetValue(MoveTemp(Outcome));
+}
+
+namespace NetworkManagerQuickMatch
+{
+	static const TCHAR* ToString(const EQuickMatchResult Result)
+	{
+		switch (Result)
+		{
+		case EQuickMatchResult::Joined: return TEXT("Joined");
+		case EQuickMatchResult::Hosted: return TEXT("Hosted");
+		case EQuickMatchResult::Cancelled: return TEXT("Cancelled");
+		default: return TEXT("Failed");
+		}
+	}
+}
+
+TFuture<FQuickMatchOutcome> UNetworkManagerGameInstance::QuickMatchAsync(const FSessionSearchFilter& Filter, const int32 HostPlayerCount, const bool bTravel)
+{
+	if (this->QuickMatchRequest.bActive)
+	{
+		FQuickMatchOutcome Outcome;
+		Outcome.Failure = TEXT("QuickMatch already running");
+		return MakeFulfilledPromise<FQuickMatchOutcome>(MoveTemp(Outcome)).GetFuture();
+	}
+
+	FQuickMatchRequest& Request = this->QuickMatchRequest;
+	const uint32 Serial = ++Request.Serial;
+	Request.bActive = true;
+	Request.bTravel = bTravel;
+	Request.Filter = Filter;
+	Request.HostPlayerCount = HostPlayerCount;
+	Request.StartTime = FPlatformTime::Seconds();
+	Request.Candidates.Reset();
+	Request.NextCandidate = 0;
+	Request.JoinAttempts = 0;
+	Request.Promise = MakeShared<TPromise<FQuickMatchOutcome>>();
+	TFuture<FQuickMatchOutcome> Future = Request.Promise->GetFuture();
+
+	Request.DeadlineHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &ThisClass::OnQuickMatchDeadline), this->QuickMatchSearchDeadline);
+
+	TWeakObjectPtr<UNetworkManagerGameInstance> WeakThis(this);
+	FSessionRequestId SearchId = 0;
+	this->FindSessionsAsync(this->QuickMatchMaxResults, Filter, &SearchId).Next([WeakThis, Serial](const FSessionSearchOutcome& Outcome)
+	{
+		UNetworkManagerGameInstance* Manager = WeakThis.Get();
+		if (Manager && Manager->IsQuickMatchCurrent(Serial))
+		{
+			Manager->OnQuickMatchSearchComplete(Outcome);
+		}
+	});
+
+	//A search the backend refused resolves right away, it already removed the deadline
+	if (this->IsQuickMatchCurrent(Serial) && Request.DeadlineHandle.IsValid())
+	{
+		Request.SearchId = SearchId;
+	}
+	return Future;
+}
+
+bool UNetworkManagerGameInstance::CancelQuickMatch()
+{
+	if (!this->QuickMatchRequest.bActive)
+	{
+		return false;
+	}
+
+	//Resolved first so the search's cancelled outcome finds nothing to continue
+	const FSessionRequestId SearchId = this->QuickMatchRequest.SearchId;
+	this->FinishQuickMatch(EQuickMatchResult::Cancelled, NAME_None, TEXT("Cancelled"));
+	if (SearchId != 0)
+	{
+		this->CancelSearch(SearchId);
+	}
+	return true;
+}
+
+bool UNetworkManagerGameInstance::IsQuickMatching() const
+{
+	return this->QuickMatchRequest.bActive;
+}
+
+float UNetworkManagerGameInstance::GetQuickMatchMedianSeconds() const
+{
+	return WatcherStats::Percentile(this->QuickMatchTimes, 0.5f);
+}
+
+bool UNetworkManagerGameInstance::IsQuickMatchCurrent(const uint32 Serial) const
+{
+	return this->QuickMatchRequest.bActive && this->QuickMatchRequest.Serial == Serial;
+}
+
+float UNetworkManagerGameInstance::RankQuickMatchCandidate(const FOnlineSessionSearchResult& SearchResult) const
+{
+	//Backends that couldn't measure it report MAX_QUERY_PING, which ranks those last
+	float Cost = SearchResult.PingInMs;
 
-	this->SetSessionName(FName(*(Online::GetIdentityInterface(GetWorld())->GetPlayerNickname(0) + "'s Session")));
-	
-	const ULocalPlayer* LocalPlayer = GetWorld()->GetFirstLocalPlayerFromController();
-	if (!SessionInterface->CreateSession(*LocalPlayer->GetPreferredUniqueNetId(), this->GetSessionName(), *SessionSettings))
+	const int32 OpenSlots = SearchResult.Session.NumOpenPublicConnections + SearchResult.Session.NumOpenPrivateConnections;
+	Cost += FMath::Max(0, OpenSlots - this->GetNumLocalPlayers()) * this->QuickMatchOpenSlotWeight;
+
+	FString SessionRegion;
+	if (SearchResult.Session.SessionSettings.Get(SETTING_REGION, SessionRegion) && SessionRegion != this->Region)
 	{
-		this->CallOnCreateSessionFailure(TEXT("Failed to create Session"));
+		Cost += this->QuickMatchOtherRegionPenalty;
 	}
+	return Cost;
 }
 
-void UNetworkManagerGameInstance::UpdateSession()
+void UNetworkManagerGameInstance::OnQuickMatchSearchComplete(const FSessionSearchOutcome& Outcome)
 {
-	const IOnlineSessionPtr SessionInterface = Online::GetSessionInterface(GetWorld());
-	if (!SessionInterface.IsValid())
+	FQuickMatchRequest& Request = this->QuickMatchRequest;
+	Request.SearchId = 0;
+	FTSTicker::GetCoreTicker().RemoveTicker(Request.DeadlineHandle);
+	Request.DeadlineHandle.Reset();
+
+	if (!Outcome.bSuccessful)
 	{
-		CallOnUpdateSessionFailure(TEXT("Session interface isn't Valid"));
+		UE_LOG(LogNetworkManager, Display, TEXT("QuickMatch found nothing to join (%s), hosting"), *Outcome.Failure);
+		this->QuickMatchHost();
 		return;
 	}
 
-	//TODO Update to new Map name proper!
-	const TSharedPtr<FOnlineSessionSettings> UpdatedSessionSettings = MakeShareable(new FOnlineSessionSettings(*SessionSettings));
-	UpdatedSessionSettings->Set(SETTING_MAPNAME, FString("Updated Level Name"), EOnlineDataAdvertisementType::ViaOnlineService);
-
-	if (!SessionInterface->UpdateSession(this->GetSessionName(), *UpdatedSessionSettings))
+	TArray<TPair<float, int32>> Ranked;
+	Ranked.Reserve(Outcome.Results.Num());
+	for (int32 Index = 0; Index < Outcome.Results.Num(); ++Index)
 	{
-		this->CallOnUpdateSessionFailure(TEXT("Failed to update session"));
+		Ranked.Emplace(this->RankQuickMatchCandidate(Outcome.Results[Index]), Index);
 	}
-	else
+	Ranked.StableSort([](const TPair<float, int32>& A, const TPair<float, int32>& B) { return A.Key < B.Key; });
+
+	Request.Candidates.Reset(Ranked.Num());
+	for (const TPair<float, int32>& Entry : Ranked)
 	{
-		SessionSettings = UpdatedSessionSettings;
+		Request.Candidates.Add(Outcome.Results[Entry.Value]);
 	}
+	Request.NextCandidate = 0;
+
+	UE_LOG(LogNetworkManager, Display, TEXT("QuickMatch found %d candidates after %.2f s"), Request.Candidates.Num(), FPlatformTime::Seconds() - Request.StartTime);
+	this->QuickMatchJoinNext();
 }
 
-void UNetworkManagerGameInstance::StartSession() const
+bool UNetworkManagerGameInstance::OnQuickMatchDeadline(float DeltaTime)
 {
-	const IOnlineSessionPtr SessionInterface = Online::GetSessionInterface(GetWorld());
-	if (!SessionInterface.IsValid())
-	{
-		this->CallOnStartSessionFailure(TEXT("Session Interface is Invalid"));
-		return;
-	}
+	FQuickMatchRequest& Request = this->QuickMatchRequest;
+	Request.DeadlineHandle.Reset();
 
-	if (!SessionInterface->StartSession(this->GetSessionName()))
+	//Resolves the search as cancelled, which hosts
+	if (Request.bActive && Request.SearchId != 0)
 	{
-		this->CallOnStartSessionFailure(TEXT("Failed to start session"));
+		UE_LOG(LogNetworkManager, Display, TEXT("QuickMatch search ran past its %.1f s deadline"), this->QuickMatchSearchDeadline);
+		this->CancelSearch(Request.SearchId);
 	}
+	return false;
 }
 
-void UNetworkManagerGameInstance::EndSession() const
+void UNetworkManagerGameInstance::QuickMatchJoinNext()
 {
-	const IOnlineSessionPtr sessionInterface = Online::GetSessionInterface(GetWorld());
-	if (!sessionInterface.IsValid())
+	FQuickMatchRequest& Request = this->QuickMatchRequest;
+	if (!Request.Candidates.IsValidIndex(Request.NextCandidate))
 	{
-		this->CallOnEndSessionFailure(TEXT("Session interface is Invalid"));
+		UE_LOG(LogNetworkManager, Display, TEXT("QuickMatch couldn't join any of %d candidates, hosting"), Request.Candidates.Num());
+		this->QuickMatchHost();
 		return;
 	}
 
-	if (!sessionInterface->EndSession(this->GetSessionName()))
+	++Request.JoinAttempts;
+	const uint32 Serial = Request.Serial;
+	USessionSearchResult* Candidate = USessionSearchResult::Make(Request.Candidates[Request.NextCandidate++]);
+	TWeakObjectPtr<UNetworkManagerGameInstance> WeakThis(this);
+
+	//Listeners only hear about the join that worked, a failed candidate isn't a failure of the QuickMatch
+	this->RunSessionOp(ENetworkManagerEvent::JoinSessionComplete, ENetworkManagerEvent::JoinSessionFailure, [this, Candidate]()
 	{
-		this->CallOnEndSessionFailure(TEXT("Failed to end session"));
-	}
+		this->JoinSession(Candidate);
+	}, ESessionOpListeners::CompleteOnly).Next([WeakThis, Serial](const FSessionOpOutcome& Outcome)
+	{
+		UNetworkManagerGameInstance* Manager = WeakThis.Get();
+		if (Manager && Manager->IsQuickMatchCurrent(Serial))
+		{
+			Manager->OnQuickMatchJoinComplete(Outcome);
+		}
+	});
 }
 
-void UNetworkManagerGameInstance::DestroySession() const
+void UNetworkManagerGameInstance::OnQuickMatchJoinComplete(const FSessionOpOutcome& Outcome)
 {
-	const IOnlineSessionPtr SessionInterface = Online::GetSessionInterface(GetWorld());
-	if (!SessionInterface.IsValid())
+	if (Outcome.bSuccessful)
 	{
-		this->CallOnDestroySessionFailure(TEXT("SessionInterface is invalid"));
+		this->FinishQuickMatch(EQuickMatchResult::Joined, Outcome.SessionName, FString());
 		return;
 	}
 
-	if (!SessionInterface->DestroySession(this->GetSessionName()))
-	{
-		this->CallOnDestroySessionFailure(TEXT("Failed to destroy session"));
-	}
-}
+	UE_LOG(LogNetworkManager, Display, TEXT("QuickMatch join failed (%s), trying the next candidate"), *Outcome.Failure);
 
-void UNetworkManagerGameInstance::FindSessions(const int32 MaxSearchResults)
-{
+	//A failed join can leave the named session behind, the next join / create would then fail as already in session.
+	//Nobody outside saw that session, so its destroy stays internal too (no splash screen, no asset state switch, no reconnect reset)
 	const IOnlineSessionPtr SessionInterface = Online::GetSessionInterface(GetWorld());
-	if (!SessionInterface.IsValid())
+	if (SessionInterface.IsValid() && SessionInterface->GetNamedSession(this->GetSessionName()))
 	{
-		this->CallOnFindSessionsFailure(TEXT("SessionInterface is Invalid"));
+		const uint32 Serial = this->QuickMatchRequest.Serial;
+		TWeakObjectPtr<UNetworkManagerGameInstance> WeakThis(this);
+		this->RunSessionOp(ENetworkManagerEvent::DestroySessionComplete, ENetworkManagerEvent::DestroySessionFailure, [this]()
+		{
+			this->DestroySession();
+		}, ESessionOpListeners::None).Next([WeakThis, Serial](const FSessionOpOutcome&)
+		{
+			UNetworkManagerGameInstance* Manager = WeakThis.Get();
+			if (Manager && Manager->IsQuickMatchCurrent(Serial))
+			{
+				Manager->QuickMatchJoinNext();
+			}
+		});
 		return;
 	}
+	this->QuickMatchJoinNext();
+}
 
-	SessionSearch = MakeShareable(new FOnlineSessionSearch());
-	SessionSearch->MaxSearchResults = MaxSearchResults;
-	SessionSearch->bIsLanQuery = false;
-
-	SessionSearch->QuerySettings.Set(SEARCH_PRESENCE, true, EOnlineComparisonOp::Equals);
-
-	const ULocalPlayer* LocalPlayer = GetWorld()->GetFirstLocalPlayerFromController();
-	if (!SessionInterface->FindSessions(*LocalPlayer->GetPreferredUniqueNetId(), SessionSearch.ToSharedRef()))
+void UNetworkManagerGameInstance::QuickMatchHost()
+{
+	const uint32 Serial = this->QuickMatchRequest.Serial;
+	TWeakObjectPtr<UNetworkManagerGameInstance> WeakThis(this);
+	this->CreateSessionAsync(this->QuickMatchRequest.HostPlayerCount, false).Next([WeakThis, Serial](const FSessionOpOutcome& Outcome)
 	{
-		this->CallOnFindSessionsFailure(TEXT("Failed to find sessions"));
-	}
+		UNetworkManagerGameInstance* Manager = WeakThis.Get();
+		if (Manager && Manager->IsQuickMatchCurrent(Serial))
+		{
+			Manager->FinishQuickMatch(Outcome.bSuccessful ? EQuickMatchResult::Hosted : EQuickMatchResult::Failed, Outcome.SessionName, Outcome.Failure);
+		}
+	});
 }
 
-void UNetworkManagerGameInstance::JoinSession(USessionSearchResult* SessionResult)
+void UNetworkManagerGameInstance::FinishQuickMatch(const EQuickMatchResult Result, const FName SessionNameIn, const FString& Failure)
 {
-	this->SessionData = SessionResult->GetOnlineSessionSearchResult();
-	this->SetSessionName(FName(*SessionResult->GetSessionData().SessionName));
-	
-	const IOnlineSessionPtr SessionInterface = Online::GetSessionInterface(GetWorld());
-	if (!SessionInterface.IsValid())
+	FQuickMatchRequest& Request = this->QuickMatchRequest;
+	FTSTicker::GetCoreTicker().RemoveTicker(Request.DeadlineHandle);
+	Request.DeadlineHandle.Reset();
+	Request.bActive = false;
+	Request.SearchId = 0;
+	Request.Candidates.Reset();
+
+	FQuickMatchOutcome Outcome;
+	Outcome.Result = Result;
+	Outcome.SessionName = SessionNameIn;
+	Outcome.Failure = Failure;
+	Outcome.SecondsToMatch = FPlatformTime::Seconds() - Request.StartTime;
+	Outcome.JoinAttempts = Request.JoinAttempts;
+
+	if (Result == EQuickMatchResult::Joined || Result == EQuickMatchResult::Hosted)
 	{
-		this->CallOnJoinSessionFailure(TEXT("SessionInterface is invalid"));
-		return;
+		this->QuickMatchTimes.Add(Outcome.SecondsToMatch);
+		UE_LOG(LogNetworkManager, Display, TEXT("QuickMatch %s %s in %.2f s after %d join attempts, median %.2f s over %d matches"),
+			NetworkManagerQuickMatch::ToString(Result), *SessionNameIn.ToString(), Outcome.SecondsToMatch, Outcome.JoinAttempts,
+			this->GetQuickMatchMedianSeconds(), this->QuickMatchTimes.Num());
+
+		if (Request.bTravel)
+		{
+			if (Result == EQuickMatchResult::Joined)
+			{
+				this->ServerTravelAsClient_GameMap();
+			}
+			else
+			{
+				this->ServerTravelAsHost_GameMap();
+			}
+		}
 	}
-	
-	const ULocalPlayer* LocalPlayer = GetWorld()->GetFirstLocalPlayerFromController();
-	if (!SessionInterface->JoinSession(*LocalPlayer->GetPreferredUniqueNetId(), this->GetSessionName(), SessionResult->GetOnlineSessionSearchResult()))
+	else
 	{
-		this->CallOnJoinSessionFailure(TEXT("Error joining Session"));
+		UE_LOG(LogNetworkManager, Display, TEXT("QuickMatch %s after %.2f s: %s"), NetworkManagerQuickMatch::ToString(Result), Outcome.SecondsToMatch, *Failure);
 	}
+
+	//Moved out first, whoever waits on it may start the next QuickMatch
+	const TSharedPtr<TPromise<FQuickMatchOutcome>> Promise = MoveTemp(Request.Promise);
+	Promise->SetValue(MoveTemp(Outcome));
 }
 
-bool UNetworkManagerGameInstance::ServerTravelAsHost_GameMap() const
+void UNetworkManagerGameInstance::SetMigrationToken(const FString& NewMigrationToken)
 {
-	//Non seamless travel
-	return GetWorld()->ServerTravel(this->BuildMainGameMapPathForHosting());
+	this->MigrationToken = NewMigrationToken;
 }
 
-bool UNetworkManagerGameInstance::ServerTravelAsClient_GameMap() const
+FString UNetworkManagerGameInstance::GetMigrationToken() const
 {
-	//Non seamless travel
-	if (APlayerController * PlayerController = GetWorld()->GetFirstPlayerController())
-	{
-		PlayerController->ClientTravel(this->BuildMainGameMapPathForJoining(), TRAVEL_Absolute);
-		return true;
-	}
-	
-	return false;
+	return this->MigrationToken;
 }
 
 void UNetworkManagerGameInstance::SetupCallbacks()
@@ -280,195 +1545,262 @@ void UNetworkManagerGameInstance::SetupCallbacks()
 	check(SessionInterface.IsValid());
 	
 	SessionInterface->AddOnCreateSessionCompleteDelegate_Handle(FOnCreateSessionCompleteDelegate::CreateUObject(this, &ThisClass::OnCreateSessionCompletionHandler));
-	SessionInterface->AddOnUpdateSessionCompleteDelegate_Handle(FOnUpdateSessionCompleteDelegate::CreateUObject(this, &ThisClass::OnCreateSessionCompletionHandler));
+	SessionInterface->AddOnUpdateSessionCompleteDelegate_Handle(FOnUpdateSessionCompleteDelegate::CreateUObject(this, &ThisClass::OnUpdateSessionCompletionHandler));
 	SessionInterface->AddOnStartSessionCompleteDelegate_Handle(FOnStartSessionCompleteDelegate::CreateUObject(this, &ThisClass::OnStartSessionCompletionHandler));
 	SessionInterface->AddOnEndSessionCompleteDelegate_Handle(FOnEndSessionCompleteDelegate::CreateUObject(this, &ThisClass::OnEndSessionCompletionHandler));
 	SessionInterface->AddOnDestroySessionCompleteDelegate_Handle(FOnDestroySessionCompleteDelegate::CreateUObject(this, &ThisClass::OnDestroySessionCompletionHandler));
 	SessionInterface->AddOnFindSessionsCompleteDelegate_Handle(FOnFindSessionsCompleteDelegate::CreateUObject(this, &ThisClass::OnFindSessionsCompletionHandler));
+	SessionInterface->AddOnCancelFindSessionsCompleteDelegate_Handle(FOnCancelFindSessionsCompleteDelegate::CreateUObject(this, &ThisClass::OnCancelFindSessionsCompletionHandler));
 	SessionInterface->AddOnJoinSessionCompleteDelegate_Handle(FOnJoinSessionCompleteDelegate::CreateUObject(this, &UNetworkManagerGameInstance::OnJoinSessionCompletionHandler));
 }
 
-void UNetworkManagerGameInstance::CallOnCreateSessionComplete(const FName SessionNameIn) const
+namespace NetworkManagerEvents
 {
-	if (this->OnCreateSessionComplete.IsBound())
+	static const TCHAR* ToString(const ENetworkManagerEvent Event)
 	{
-		this->OnCreateSessionComplete.Broadcast(SessionNameIn);
+		static const TCHAR* Names[] =
+		{
+			TEXT("OnCreateSessionComplete"), TEXT("OnCreateSessionFailure"),
+			TEXT("OnUpdateSessionComplete"), TEXT("OnUpdateSessionFailure"),
+			TEXT("OnStartSessionComplete"), TEXT("OnStartSessionFailure"),
+			TEXT("OnEndSessionComplete"), TEXT("OnEndSessionFailure"),
+			TEXT("OnDestroySessionComplete"), TEXT("OnDestroySessionFailure"),
+			TEXT("OnFindSessionsComplete"), TEXT("OnFindSessionsFailure"),
+			TEXT("OnJoinSessionComplete"), TEXT("OnJoinSessionFailure")
+		};
+		static_assert(UE_ARRAY_COUNT(Names) == static_cast<int32>(ENetworkManagerEvent::Count), "Every event needs a name");
+		return Names[static_cast<int32>(Event)];
 	}
-	else
+
+	static FNetworkManagerEvent MakeComplete(const ENetworkManagerEvent Type, const FName SessionName)
 	{
-		UE_LOG(LogNetworkManager, Warning, TEXT("Nothing bound to OnCreateSessionComplete"));
+		FNetworkManagerEvent Event;
+		Event.Type = Type;
+		Event.SessionName = SessionName;
+		return Event;
 	}
-}
 
-void UNetworkManagerGameInstance::CallOnCreateSessionFailure(const FString& FailureIn) const
-{
-	if (this->OnCreateSessionFailure.IsBound())
+	static FNetworkManagerEvent MakeFailure(const ENetworkManagerEvent Type, const FString& Failure, const FName SessionName = NAME_None)
 	{
-		this->OnCreateSessionFailure.Broadcast(FailureIn);
+		FNetworkManagerEvent Event;
+		Event.Type = Type;
+		Event.SessionName = SessionName;
+		Event.Failure = Failure;
+		return Event;
 	}
-	else
+
+	template<typename DelegateType, typename... ArgTypes>
+	static bool BroadcastIfBound(const DelegateType& Delegate, ArgTypes&&... Args)
 	{
-		UE_LOG(LogNetworkManager, Warning, TEXT("Nothing bound to OnCreateSessionFailure: %s"), *FailureIn);
+		if (!Delegate.IsBound())
+		{
+			return false;
+		}
+		Delegate.Broadcast(Forward<ArgTypes>(Args)...);
+		return true;
 	}
 }
 
-void UNetworkManagerGameInstance::CallOnUpdateSessionComplete(const FName SessionNameIn) const
+void UNetworkManagerGameInstance::RemoveNativeListener(const void* Listener)
 {
-	if (this->OnUpdateSessionComplete.IsBound())
+	for (FNetworkManager_OnNativeEvent& Channel : this->NativeEvents)
 	{
-		this->OnUpdateSessionComplete.Broadcast(SessionNameIn);
-	}
-	else
-	{
-		UE_LOG(LogNetworkManager, Warning, TEXT("Nothing bound to OnUpdateSessionComplete"));
+		Channel.RemoveAll(Listener);
 	}
 }
 
-void UNetworkManagerGameInstance::CallOnUpdateSessionFailure(const FString& FailureIn) const
+void UNetworkManagerGameInstance::QueueEvent(FNetworkManagerEvent&& Event)
 {
-	if (this->OnUpdateSessionFailure.IsBound())
-	{
-		this->OnUpdateSessionFailure.Broadcast(FailureIn);
-	}
-	else
+	Event.RequestId = this->ClaimSessionOp(Event);
+	this->PendingEvents.Add(MoveTemp(Event));
+	if (!this->FlushEventsHandle.IsValid())
 	{
-		UE_LOG(LogNetworkManager, Warning, TEXT("Nothing bound to OnUpdateSessionFailure: %s"), *FailureIn);
+		this->FlushEventsHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &ThisClass::FlushEvents));
 	}
 }
 
-void UNetworkManagerGameInstance::CallOnStartSessionComplete(const FName SessionNameIn) const
+bool UNetworkManagerGameInstance::FlushEvents(float DeltaTime)
 {
-	if (this->OnStartSessionComplete.IsBound())
-	{
-		this->OnStartSessionComplete.Broadcast(SessionNameIn);
-	}
-	else
+	SCOPE_CYCLE_COUNTER(STAT_NetworkManager_FlushEvents);
+
+	//Listeners can raise new events while we dispatch, those get their own flush next frame
+	TArray<FNetworkManagerEvent> Events = MoveTemp(this->PendingEvents);
+	this->PendingEvents.Reset();
+	this->FlushEventsHandle.Reset();
+
+	for (const FNetworkManagerEvent& Event : Events)
 	{
-		UE_LOG(LogNetworkManager, Warning, TEXT("Nothing bound to OnStartSessionComplete"));
+		//Internal steps (QuickMatch moving past a candidate and cleaning up after it) only answer their caller
+		if (this->IsSessionOpEventQuiet(Event))
+		{
+			this->ResolveSessionOp(Event);
+			continue;
+		}
+
+		FNetworkManager_OnNativeEvent& Channel = this->OnNativeEvent(Event.Type);
+		const bool bNativeBound = Channel.IsBound();
+		Channel.Broadcast(Event);
+		this->ResolveSessionOp(Event);
+
+		if (!this->BroadcastDynamicEvent(Event) && !bNativeBound)
+		{
+			if (Event.Failure.IsEmpty())
+			{
+				UE_LOG(LogNetworkManager, Warning, TEXT("Nothing bound to %s"), NetworkManagerEvents::ToString(Event.Type));
+			}
+			else
+			{
+				UE_LOG(LogNetworkManager, Warning, TEXT("Nothing bound to %s: %s"), NetworkManagerEvents::ToString(Event.Type), *Event.Failure);
+			}
+		}
 	}
+
+	INC_DWORD_STAT_BY(STAT_NetworkManager_EventsDelivered, Events.Num());
+	return false;
 }
 
-void UNetworkManagerGameInstance::CallOnStartSessionFailure(const FString& FailureIn) const
+bool UNetworkManagerGameInstance::BroadcastDynamicEvent(const FNetworkManagerEvent& Event)
 {
-	if (this->OnStartSessionFailure.IsBound())
-	{
-		this->OnStartSessionFailure.Broadcast(FailureIn);
-	}
-	else
+	using namespace NetworkManagerEvents;
+
+	switch (Event.Type)
 	{
-		UE_LOG(LogNetworkManager, Warning, TEXT("Nothing bound to OnStartSessionFailure: %s"), *FailureIn);
+	case ENetworkManagerEvent::CreateSessionComplete:
+		return BroadcastIfBound(this->OnCreateSessionComplete, Event.SessionName);
+	case ENetworkManagerEvent::CreateSessionFailure:
+		return BroadcastIfBound(this->OnCreateSessionFailure, Event.Failure);
+	case ENetworkManagerEvent::UpdateSessionComplete:
+		return BroadcastIfBound(this->OnUpdateSessionComplete, Event.SessionName);
+	case ENetworkManagerEvent::UpdateSessionFailure:
+		return BroadcastIfBound(this->OnUpdateSessionFailure, Event.Failure);
+	case ENetworkManagerEvent::StartSessionComplete:
+		return BroadcastIfBound(this->OnStartSessionComplete, Event.SessionName);
+	case ENetworkManagerEvent::StartSessionFailure:
+		return BroadcastIfBound(this->OnStartSessionFailure, Event.Failure);
+	case ENetworkManagerEvent::EndSessionComplete:
+		return BroadcastIfBound(this->OnEndSessionComplete, Event.SessionName);
+	case ENetworkManagerEvent::EndSessionFailure:
+		return BroadcastIfBound(this->OnEndSessionFailure, Event.Failure);
+	case ENetworkManagerEvent::DestroySessionComplete:
+		return BroadcastIfBound(this->OnDestroySessionComplete, Event.SessionName);
+	case ENetworkManagerEvent::DestroySessionFailure:
+		return BroadcastIfBound(this->OnDestroySessionFailure, Event.Failure);
+	case ENetworkManagerEvent::FindSessionsComplete:
+		{
+			if (!this->OnFindSessionsComplete.IsBound())
+			{
+				return false;
+			}
+
+			//Only Blueprint needs the UObject wrappers, make them when someone listens
+			TArray<USessionSearchResult*> SessionResults;
+			SessionResults.Reserve(Event.SearchResults.Num());
+			for (const FOnlineSessionSearchResult& SearchResult : Event.SearchResults)
+			{
+				SessionResults.Add(USessionSearchResult::Make(SearchResult));
+			}
+			this->OnFindSessionsComplete.Broadcast(SessionResults);
+			return true;
+		}
+	case ENetworkManagerEvent::FindSessionsFailure:
+		return BroadcastIfBound(this->OnFindSessionsFailure, Event.Failure);
+	case ENetworkManagerEvent::JoinSessionComplete:
+		return BroadcastIfBound(this->OnJoinSessionComplete, Event.SessionName);
+	case ENetworkManagerEvent::JoinSessionFailure:
+		return BroadcastIfBound(this->OnJoinSessionFailure, Event.Failure);
+	default:
+		return false;
 	}
 }
 
-void UNetworkManagerGameInstance::CallOnEndSessionComplete(const FName SessionNameIn) const
+void UNetworkManagerGameInstance::CallOnCreateSessionComplete(const FName SessionNameIn)
 {
-	if (this->OnEndSessionComplete.IsBound())
-	{
-		this->OnEndSessionComplete.Broadcast(SessionNameIn);
-	}
-	else
-	{
-		UE_LOG(LogNetworkManager, Warning, TEXT("Nothing bound to OnEndSessionComplete"));
-	}
+	this->QueueEvent(NetworkManagerEvents::MakeComplete(ENetworkManagerEvent::CreateSessionComplete, SessionNameIn));
 }
 
-void UNetworkManagerGameInstance::CallOnEndSessionFailure(const FString& FailureIn) const
+void UNetworkManagerGameInstance::CallOnCreateSessionFailure(const FString& FailureIn, const FName SessionNameIn)
 {
-	if (this->OnEndSessionFailure.IsBound())
-	{
-		this->OnEndSessionFailure.Broadcast(FailureIn);
-	}
-	else
-	{
-		UE_LOG(LogNetworkManager, Warning, TEXT("Nothing bound to OnEndSessionFailure: %s"), *FailureIn);
-	}
+	this->QueueEvent(NetworkManagerEvents::MakeFailure(ENetworkManagerEvent::CreateSessionFailure, FailureIn, SessionNameIn));
 }
 
-void UNetworkManagerGameInstance::CallOnDestroySessionComplete(const FName SessionNameIn) const
+void UNetworkManagerGameInstance::CallOnUpdateSessionComplete(const FName SessionNameIn)
 {
-	if (this->OnDestroySessionComplete.IsBound())
-	{
-		this->OnDestroySessionComplete.Broadcast(SessionNameIn);
-	}
-	else
-	{
-		UE_LOG(LogNetworkManager, Warning, TEXT("Nothing bound to OnDestroySessionComplete"));
-	}
+	this->QueueEvent(NetworkManagerEvents::MakeComplete(ENetworkManagerEvent::UpdateSessionComplete, SessionNameIn));
 }
 
-void UNetworkManagerGameInstance::CallOnDestroySessionFailure(const FString& FailureIn) const
+void UNetworkManagerGameInstance::CallOnUpdateSessionFailure(const FString& FailureIn)
 {
-	if (this->OnDestroySessionFailure.IsBound())
-	{
-		this->OnDestroySessionFailure.Broadcast(FailureIn);
-	}
-	else
-	{
-		UE_LOG(LogNetworkManager, Warning, TEXT("Nothing bound to OnDestroySessionFailure: %s"), *FailureIn);
-	}
+	this->QueueEvent(NetworkManagerEvents::MakeFailure(ENetworkManagerEvent::UpdateSessionFailure, FailureIn));
 }
 
-void UNetworkManagerGameInstance::CallOnFindSessionsComplete(const TArray<USessionSearchResult*>& SessionResultsIn) const
+void UNetworkManagerGameInstance::CallOnStartSessionComplete(const FName SessionNameIn)
 {
-	if (this->OnFindSessionsComplete.IsBound())
-	{
-		this->OnFindSessionsComplete.Broadcast(SessionResultsIn);
-	}
-	else
-	{
-		UE_LOG(LogNetworkManager, Warning, TEXT("Nothing bound to OnFindSessionsComplete"));
-	}
+	this->QueueEvent(NetworkManagerEvents::MakeComplete(ENetworkManagerEvent::StartSessionComplete, SessionNameIn));
 }
 
-void UNetworkManagerGameInstance::CallOnFindSessionsFailure(const FString& FailureIn) const
+void UNetworkManagerGameInstance::CallOnStartSessionFailure(const FString& FailureIn)
 {
-	if (this->OnFindSessionsFailure.IsBound())
-	{
-		this->OnFindSessionsFailure.Broadcast(FailureIn);
-	}
-	else
-	{
-		UE_LOG(LogNetworkManager, Warning, TEXT("Nothing bound to OnFindSessionsFailure: %s"), *FailureIn);
-	}
+	this->QueueEvent(NetworkManagerEvents::MakeFailure(ENetworkManagerEvent::StartSessionFailure, FailureIn));
 }
 
-void UNetworkManagerGameInstance::CallOnJoinSessionComplete(const FName SessionIn) const
+void UNetworkManagerGameInstance::CallOnEndSessionComplete(const FName SessionNameIn)
 {
-	if (this->OnJoinSessionComplete.IsBound())
-	{
-		this->OnJoinSessionComplete.Broadcast(SessionIn);
-	}
-	else
-	{
-		UE_LOG(LogNetworkManager, Warning, TEXT("Nothing bound to OnJoinSessionComplete"));
-	}
+	this->QueueEvent(NetworkManagerEvents::MakeComplete(ENetworkManagerEvent::EndSessionComplete, SessionNameIn));
 }
 
-void UNetworkManagerGameInstance::CallOnJoinSessionFailure(const FString& FailureIn) const
+void UNetworkManagerGameInstance::CallOnEndSessionFailure(const FString& FailureIn)
 {
-	if (this->OnJoinSessionFailure.IsBound())
-	{
-		this->OnJoinSessionFailure.Broadcast(FailureIn);
-	}
-	else
-	{
-		UE_LOG(LogNetworkManager, Warning, TEXT("Nothing bound to OnJoinSessionFailure: %s"), *FailureIn);
-	}
+	this->QueueEvent(NetworkManagerEvents::MakeFailure(ENetworkManagerEvent::EndSessionFailure, FailureIn));
+}
+
+void UNetworkManagerGameInstance::CallOnDestroySessionComplete(const FName SessionNameIn)
+{
+	this->QueueEvent(NetworkManagerEvents::MakeComplete(ENetworkManagerEvent::DestroySessionComplete, SessionNameIn));
+}
+
+void UNetworkManagerGameInstance::CallOnDestroySessionFailure(const FString& FailureIn, const FName SessionNameIn)
+{
+	this->QueueEvent(NetworkManagerEvents::MakeFailure(ENetworkManagerEvent::DestroySessionFailure, FailureIn, SessionNameIn));
+}
+
+void UNetworkManagerGameInstance::CallOnFindSessionsComplete(const TArray<FOnlineSessionSearchResult>& SessionResultsIn)
+{
+	FNetworkManagerEvent Event;
+	Event.Type = ENetworkManagerEvent::FindSessionsComplete;
+	Event.SearchResults = SessionResultsIn;
+	this->QueueEvent(MoveTemp(Event));
+}
+
+void UNetworkManagerGameInstance::CallOnFindSessionsFailure(const FString& FailureIn)
+{
+	this->QueueEvent(NetworkManagerEvents::MakeFailure(ENetworkManagerEvent::FindSessionsFailure, FailureIn));
+}
+
+void UNetworkManagerGameInstance::CallOnJoinSessionComplete(const FName SessionIn)
+{
+	this->QueueEvent(NetworkManagerEvents::MakeComplete(ENetworkManagerEvent::JoinSessionComplete, SessionIn));
+}
+
+void UNetworkManagerGameInstance::CallOnJoinSessionFailure(const FString& FailureIn, const FName SessionNameIn)
+{
+	this->QueueEvent(NetworkManagerEvents::MakeFailure(ENetworkManagerEvent::JoinSessionFailure, FailureIn, SessionNameIn));
 }
 
-void UNetworkManagerGameInstance::OnCreateSessionCompletionHandler(const FName SessionNameIn, const bool Successful) const
+void UNetworkManagerGameInstance::OnCreateSessionCompletionHandler(const FName SessionNameIn, const bool Successful)
 {
 	if (Successful)
 	{
+		this->RegisterGuestLocalPlayers(SessionNameIn);
+		this->AdvertiseToService();
 		this->CallOnCreateSessionComplete(SessionNameIn);
 	}
 	else
 	{
-		this->CallOnCreateSessionFailure(TEXT("Failed to create Session"));
+		this->CallOnCreateSessionFailure(TEXT("Failed to create Session"), SessionNameIn);
 	}
 }
 
-void UNetworkManagerGameInstance::OnUpdateSessionCompletionHandler(const FName SessionNameIn, const bool Successful) const
+void UNetworkManagerGameInstance::OnUpdateSessionCompletionHandler(const FName SessionNameIn, const bool Successful)
 {
 	if (Successful)
 	{
@@ -476,11 +1808,11 @@ void UNetworkManagerGameInstance::OnUpdateSessionCompletionHandler(const FName S
 	}
 	else
 	{
-		this->CallOnCreateSessionFailure(TEXT("Failed to update Session"));
+		this->CallOnUpdateSessionFailure(TEXT("Failed to update Session"));
 	}
 }
 
-void UNetworkManagerGameInstance::OnStartSessionCompletionHandler(const FName SessionNameIn, const bool Successful) const
+void UNetworkManagerGameInstance::OnStartSessionCompletionHandler(const FName SessionNameIn, const bool Successful)
 {
 	if (Successful)
 	{
@@ -492,7 +1824,7 @@ void UNetworkManagerGameInstance::OnStartSessionCompletionHandler(const FName Se
 	}
 }
 
-void UNetworkManagerGameInstance::OnEndSessionCompletionHandler(const FName SessionNameIn, const bool Successful) const
+void UNetworkManagerGameInstance::OnEndSessionCompletionHandler(const FName SessionNameIn, const bool Successful)
 {
 	if (Successful)
 	{
@@ -504,65 +1836,293 @@ void UNetworkManagerGameInstance::OnEndSessionCompletionHandler(const FName Sess
 	}
 }
 
-void UNetworkManagerGameInstance::OnDestroySessionCompletionHandler(const FName SessionNameIn, const bool Successful) const
+void UNetworkManagerGameInstance::OnDestroySessionCompletionHandler(const FName SessionNameIn, const bool Successful)
 {
 	if (Successful)
 	{
-		this->CallOnDestroySessionComplete(SessionNameIn);
+		this->OnSessionLeft(SessionNameIn);
 	}
 	else
 	{
-		this->CallOnDestroySessionFailure(TEXT("Failed to destroy session"));
+		this->CallOnDestroySessionFailure(TEXT("Failed to destroy session"), SessionNameIn);
 	}
 }
 
-void UNetworkManagerGameInstance::OnFindSessionsCompletionHandler(const bool Successful) const
+void UNetworkManagerGameInstance::OnSessionLeft(const FName SessionNameIn)
 {
-	if (Successful)
-	{		
-		TArray<USessionSearchResult*> FoundSessions;
-		
-		for (FOnlineSessionSearchResult SearchResult : SessionSearch->SearchResults)
+	this->RestoreNetDriverDefinitions();
+	this->SessionData = FOnlineSessionSearchResult();
+	this->MigrationToken.Reset();
+	this->WithdrawFromService();
+	this->CallOnDestroySessionComplete(SessionNameIn);
+}
+
+void UNetworkManagerGameInstance::OnFindSessionsCompletionHandler(bool Successful)
+{
+	LLM_SCOPE_BYTAG(Watcher_Networking);
+	if (!this->bSearchRunning)
+	{
+		return;
+	}
+
+	FSessionSearchRequest& Request = *this->SearchQueue[0];
+
+	//Backends settle the search they were given before broadcasting, one still in progress isn't what completed.
+	//That's a search we cancelled finishing late (Steam doesn't abort the query), its results aren't this request's
+	if (Request.Search->SearchState == EOnlineAsyncTaskState::InProgress)
+	{
+		UE_LOG(LogNetworkManager, Display, TEXT("Dropped a find sessions completion that belongs to a cancelled search"));
+		return;
+	}
+
+	if (Request.bAutoLANPass && !Request.bCancelled)
+	{
+		Request.bAutoLANPass = false;
+		if (!Successful || Request.Search->SearchResults.IsEmpty())
 		{
-			FoundSessions.Add(USessionSearchResult::Make(SearchResult));
+			UE_LOG(LogNetworkManager, Display, TEXT("No LAN sessions answered, searching online"));
+			Request.Search = this->MakeSessionSearch(false, Request.Search->MaxSearchResults, &Request.Filter);
+			if (this->RunSearch(Request))
+			{
+				return;
+			}
+			Successful = false;
 		}
+	}
 
-		if (!FoundSessions.IsEmpty())
+	FSessionSearchOutcome Outcome;
+	if (Successful)
+	{
+		int32 FilteredLocally = 0;
+		for (const FOnlineSessionSearchResult& SearchResult : Request.Search->SearchResults)
 		{
-			this->CallOnFindSessionsComplete(FoundSessions);
+			//Backends that ignore QuerySettings (Null) still hand back everything
+			if (Request.bApplyFilter && !Request.Filter.Matches(SearchResult))
+			{
+				++FilteredLocally;
+				continue;
+			}
+			Outcome.Results.Add(SearchResult);
 		}
-		else
+
+		UE_LOG(LogNetworkManager, Display, TEXT("Search returned %d sessions, %d didn't match the filter"), Request.Search->SearchResults.Num(), FilteredLocally);
+
+		Outcome.bSuccessful = !Outcome.Results.IsEmpty();
+		if (!Outcome.bSuccessful)
 		{
-			this->CallOnFindSessionsFailure(TEXT("No Sessions Found"));
+			Outcome.Failure = TEXT("No Sessions Found");
 		}
 	}
 	else
 	{
-		this->CallOnFindSessionsFailure(TEXT("Failed to Find Sessions"));
+		Outcome.Failure = TEXT("Failed to Find Sessions");
+	}
+
+	this->CompleteRunningSearch(MoveTemp(Outcome));
+}
+
+void UNetworkManagerGameInstance::OnCancelFindSessionsCompletionHandler(const bool Successful)
+{
+	if (this->bSearchRunning && this->SearchQueue[0]->bCancelled)
+	{
+		this->CompleteRunningSearch(FSessionSearchOutcome());
 	}
 }
 
-void UNetworkManagerGameInstance::OnJoinSessionCompletionHandler(const FName SessionNameIn, const EOnJoinSessionCompleteResult::Type Result) const
+void UNetworkManagerGameInstance::OnJoinSessionCompletionHandler(const FName SessionNameIn, const EOnJoinSessionCompleteResult::Type Result)
 {
 	switch(Result)
 	{
 	case EOnJoinSessionCompleteResult::Type::Success:
+		this->RegisterGuestLocalPlayers(SessionNameIn);
 		this->CallOnJoinSessionComplete(SessionNameIn);
-		break;
+		return;
 	case EOnJoinSessionCompleteResult::Type::SessionIsFull:
-		this->CallOnJoinSessionFailure(TEXT("Session is full"));
+		this->CallOnJoinSessionFailure(TEXT("Session is full"), SessionNameIn);
 		break;
 	case EOnJoinSessionCompleteResult::Type::UnknownError:
-		this->CallOnJoinSessionFailure(TEXT("Unknown error when joining session"));
+		this->CallOnJoinSessionFailure(TEXT("Unknown error when joining session"), SessionNameIn);
 		break;
 	case EOnJoinSessionCompleteResult::Type::AlreadyInSession:
-		this->CallOnJoinSessionFailure(TEXT("Already in session"));
+		this->CallOnJoinSessionFailure(TEXT("Already in session"), SessionNameIn);
 		break;
 	case EOnJoinSessionCompleteResult::Type::CouldNotRetrieveAddress:
-		this->CallOnJoinSessionFailure(TEXT("Couldn't retrieve address"));
+		this->CallOnJoinSessionFailure(TEXT("Couldn't retrieve address"), SessionNameIn);
 		break;
 	case EOnJoinSessionCompleteResult::Type::SessionDoesNotExist:
-		this->CallOnJoinSessionFailure(TEXT("Session doesn't exist"));
+		this->CallOnJoinSessionFailure(TEXT("Session doesn't exist"), SessionNameIn);
 		break;
 	}
+
+	//Every other result leaves us outside the session, JoinSession already switched the driver for it
+	this->RestoreNetDriverDefinitions();
 }
+
+/**
+ * Watcher.Sessions.Find [Map=Path] [MinSlots=N] [Privacy=Any|Public|Private] [Region=Name] [AnyBuild]
+ * Runs a filtered search, the completion log shows how many results the backend returned and how many were filtered locally.
+ * Backends that filter server side (Steam) should report 0 filtered, Null reports everything it dropped.
+ */
+static FAutoConsoleCommandWithWorldAndArgs GFindSessionsCommand(
+	TEXT("Watcher.Sessions.Find"),
+	TEXT("Filtered session search. Args: [Map=Path] [MinSlots=N] [Privacy=Any|Public|Private] [Region=Name] [AnyBuild]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		const UGameInstance* GameInstance = World ? World->GetGameInstance() : nullptr;
+		UNetworkManagerGameInstance* NetworkManager = GameInstance ? GameInstance->GetSubsystem<UNetworkManagerGameInstance>() : nullptr;
+		if (!NetworkManager)
+		{
+			return;
+		}
+
+		FSessionSearchFilter Filter;
+		for (const FString& Arg : Args)
+		{
+			FString Key;
+			FString Value;
+			if (!Arg.Split(TEXT("="), &Key, &Value))
+			{
+				Key = Arg;
+			}
+
+			if (Key == TEXT("Map"))
+			{
+				Filter.WithMap(Value);
+			}
+			else if (Key == TEXT("MinSlots"))
+			{
+				Filter.WithMinOpenSlots(FCString::Atoi(*Value));
+			}
+			else if (Key == TEXT("Privacy"))
+			{
+				Filter.WithPrivacy(Value == TEXT("Public") ? ESessionPrivacyFilter::PublicOnly : Value == TEXT("Private") ? ESessionPrivacyFilter::PrivateOnly : ESessionPrivacyFilter::Any);
+			}
+			else if (Key == TEXT("Region"))
+			{
+				Filter.WithRegion(Value);
+			}
+			else if (Key == TEXT("AnyBuild"))
+			{
+				Filter.WithAnyBuild();
+			}
+		}
+
+		NetworkManager->FindSessionsFiltered(50, Filter);
+	}));
+
+/**
+ * Watcher.Sessions.ConnectionStats
+ * Host side cost of every client connection, splitscreen guests ride on their owner's connection as child connections.
+ * Comparing per player bandwidth and channels of a connection with guests against one without shows what a guest adds.
+ */
+static FAutoConsoleCommandWithWorldAndArgs GConnectionStatsCommand(
+	TEXT("Watcher.Sessions.ConnectionStats"),
+	TEXT("Logs bandwidth and open channels per client connection and per player on it (host only)"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		const UNetDriver* NetDriver = World ? World->GetNetDriver() : nullptr;
+		if (!NetDriver || !NetDriver->IsServer())
+		{
+			UE_LOG(LogNetworkManager, Warning, TEXT("Not hosting"));
+			return;
+		}
+
+		int32 TotalPlayers = 0;
+		int64 TotalOutBytes = 0;
+		for (const UNetConnection* Connection : NetDriver->ClientConnections)
+		{
+			//Viewers replicated to through this connection, each one adds relevancy checks on the host
+			const int32 Players = 1 + Connection->Children.Num();
+			UE_LOG(LogNetworkManager, Display, TEXT("%s: %d players, out %d B/s (%d B/s per player), in %d B/s, %d open channels, %.0f ms ping"),
+				*Connection->LowLevelGetRemoteAddress(true), Players, Connection->OutBytesPerSecond, Connection->OutBytesPerSecond / Players,
+				Connection->InBytesPerSecond, Connection->OpenChannels.Num(), Connection->AvgLag * 1000.f);
+
+			TotalPlayers += Players;
+			TotalOutBytes += Connection->OutBytesPerSecond;
+		}
+
+		UE_LOG(LogNetworkManager, Display, TEXT("%d connections carrying %d remote players, out %lld B/s (%lld B/s per player)"),
+			NetDriver->ClientConnections.Num(), TotalPlayers, TotalOutBytes, TotalPlayers > 0 ? TotalOutBytes / TotalPlayers : 0);
+	}));
+
+/**
+ * Watcher.Sessions.QuickMatch [Runs=10] [Region=Name]
+ * Runs QuickMatches back to back without travelling, leaving the session after each one, and logs the median / p90 time to match.
+ * With the Null subsystem, start a few other instances hosting on the LAN first, a run that finds none of them measures the host fallback.
+ */
+static FAutoConsoleCommandWithWorldAndArgs GQuickMatchCommand(
+	TEXT("Watcher.Sessions.QuickMatch"),
+	TEXT("Times back to back QuickMatches without travelling. Args: [Runs=10] [Region=Name]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		const UGameInstance* GameInstance = World ? World->GetGameInstance() : nullptr;
+		UNetworkManagerGameInstance* NetworkManager = GameInstance ? GameInstance->GetSubsystem<UNetworkManagerGameInstance>() : nullptr;
+		if (!NetworkManager || NetworkManager->IsQuickMatching())
+		{
+			return;
+		}
+
+		struct FQuickMatchRuns
+		{
+			TWeakObjectPtr<UNetworkManagerGameInstance> NetworkManager;
+			FSessionSearchFilter Filter;
+			int32 Runs = 10;
+			int32 Joined = 0;
+			int32 Hosted = 0;
+			TArray<float> Seconds;
+		};
+
+		const TSharedRef<FQuickMatchRuns> State = MakeShared<FQuickMatchRuns>();
+		State->NetworkManager = NetworkManager;
+		for (const FString& Arg : Args)
+		{
+			FString Key;
+			FString Value;
+			if (Arg.Split(TEXT("="), &Key, &Value) && Key == TEXT("Region"))
+			{
+				State->Filter.WithRegion(Value);
+			}
+			else if (Arg.IsNumeric())
+			{
+				State->Runs = FMath::Max(1, FCString::Atoi(*Arg));
+			}
+		}
+
+		TSharedRef<TFunction<void()>> RunNext = MakeShared<TFunction<void()>>();
+		*RunNext = [State, WeakRunNext = TWeakPtr<TFunction<void()>>(RunNext)]()
+		{
+			UNetworkManagerGameInstance* Manager = State->NetworkManager.Get();
+			const TSharedPtr<TFunction<void()>> Next = WeakRunNext.Pin();
+			if (!Manager || !Next.IsValid())
+			{
+				return;
+			}
+
+			if (State->Seconds.Num() >= State->Runs)
+			{
+				UE_LOG(LogNetworkManager, Display, TEXT("QuickMatch: %d runs, %d joined, %d hosted, median %.2f s, p90 %.2f s"),
+					State->Runs, State->Joined, State->Hosted, WatcherStats::Percentile(State->Seconds, 0.5f), WatcherStats::Percentile(State->Seconds, 0.9f));
+				return;
+			}
+
+			Manager->QuickMatchAsync(State->Filter, 8, false).Next([State, Next](const FQuickMatchOutcome& Outcome)
+			{
+				UNetworkManagerGameInstance* Manager = State->NetworkManager.Get();
+				if (!Manager || (Outcome.Result != EQuickMatchResult::Joined && Outcome.Result != EQuickMatchResult::Hosted))
+				{
+					UE_LOG(LogNetworkManager, Warning, TEXT("QuickMatch runs stopped: %s"), *Outcome.Failure);
+					return;
+				}
+
+				++(Outcome.Result == EQuickMatchResult::Joined ? State->Joined : State->Hosted);
+				State->Seconds.Add(Outcome.SecondsToMatch);
+
+				//Leave before the next run so it starts from the menu state again
+				Manager->DestroySessionAsync().Next([Next](const FSessionOpOutcome&)
+				{
+					(*Next)();
+				});
+			});
+		};
+		(*RunNext)();
+	}));
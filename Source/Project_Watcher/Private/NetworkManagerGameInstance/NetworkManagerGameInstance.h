@@ -2,13 +2,68 @@
 
 #pragma once
 #include "CoreMinimal.h"
+#include "Engine/Engine.h"
 #include "Engine/GameInstance.h"
 #include "OnlineSessionSettings.h"
 #include "Interfaces/OnlineSessionInterface.h"
+#include "Containers/StaticArray.h"
+#include "Containers/Ticker.h"
+#include "Async/Future.h"
 #include "NetworkManagerGameInstance.generated.h"
 
+class FMatchmakingServiceClient;
+
+/* Session setting carrying the host migration token, a replacement session advertises the token of the session it replaces */
+#define SETTING_MIGRATIONTOKEN FName(TEXT("MIGRATIONTOKEN"))
+
+/* Session setting carrying the host's network version, peers only get sessions they can actually connect to */
+#define SETTING_BUILDID FName(TEXT("BUILDID"))
+
+/* Session setting telling if the host made the session private */
+#define SETTING_PRIVATE FName(TEXT("PRIVATE"))
+
+/* Session setting carrying the ip:port of sessions found through the matchmaking service */
+#define SETTING_CONNECTADDRESS FName(TEXT("CONNECTADDRESS"))
+
+/* Session setting carrying the id the matchmaking service gave the session */
+#define SETTING_SERVICESESSIONID FName(TEXT("SERVICESESSIONID"))
+
 //Wrapper for BP data//
 
+/* How sessions are hosted / discovered */
+UENUM(BlueprintType)
+enum class ENetworkManagerConnectionMode : uint8
+{
+	/* Steam sessions over SteamSockets, relayed when needed */
+	Online,
+	/* LAN broadcast discovery and direct IpNetDriver connections */
+	LAN,
+	/* Search the LAN first and only fall back to Steam when nobody answers, hosting is LAN so other Auto peers find us on their first pass */
+	Auto
+};
+
+/* Where sessions are advertised and searched for, picked in DefaultGame.ini */
+UENUM(BlueprintType)
+enum class ESessionBackend : uint8
+{
+	/* The platform's session interface (Steam, Null) */
+	OnlineSubsystem,
+	/* The matchmaking service (UMatchmakingServiceCommandlet), sessions are hosted and joined over IpNetDriver */
+	MatchmakingService
+};
+
+/* How a QuickMatch ended */
+UENUM(BlueprintType)
+enum class EQuickMatchResult : uint8
+{
+	/* Joined the best ranked session that would take us */
+	Joined,
+	/* Nothing suitable turned up before the deadline, or none of it took us, so we host */
+	Hosted,
+	Failed,
+	Cancelled
+};
+
 USTRUCT(Blueprintable)
 struct FSessionData
 {
@@ -34,6 +89,63 @@ public:
 	}
 };
 
+/* Privacy part of FSessionSearchFilter */
+UENUM(BlueprintType)
+enum class ESessionPrivacyFilter : uint8
+{
+	Any,
+	PublicOnly,
+	PrivateOnly
+};
+
+/**
+ * Typed session query, pushed to the backend as QuerySettings so full / incompatible sessions never take up the result budget.
+ * Every field matches a key advertised by CreateSession, empty strings don't filter.
+ * Results are checked against it again on arrival for backends that ignore QuerySettings (Null).
+ */
+USTRUCT(BlueprintType)
+struct FSessionSearchFilter
+{
+	GENERATED_USTRUCT_BODY()
+public:
+	/* Only sessions hosted with our network version (SETTING_BUILDID) */
+	UPROPERTY(BlueprintReadWrite, Category = "Online")
+	bool bMatchBuild = true;
+	/* Map path the session advertises (SETTING_MAPNAME) */
+	UPROPERTY(BlueprintReadWrite, Category = "Online")
+	FString MapName = "";
+	/* Open public + private connections the session needs, 0 also returns full sessions */
+	UPROPERTY(BlueprintReadWrite, Category = "Online")
+	int32 MinOpenSlots = 1;
+	UPROPERTY(BlueprintReadWrite, Category = "Online")
+	ESessionPrivacyFilter Privacy = ESessionPrivacyFilter::Any;
+	/* Region the host advertises (SETTING_REGION) */
+	UPROPERTY(BlueprintReadWrite, Category = "Online")
+	FString Region = "";
+
+	FSessionSearchFilter& WithMap(const FString& MapNameIn) { MapName = MapNameIn; return *this; }
+	FSessionSearchFilter& WithMinOpenSlots(const int32 MinOpenSlotsIn) { MinOpenSlots = MinOpenSlotsIn; return *this; }
+	FSessionSearchFilter& WithPrivacy(const ESessionPrivacyFilter PrivacyIn) { Privacy = PrivacyIn; return *this; }
+	FSessionSearchFilter& WithRegion(const FString& RegionIn) { Region = RegionIn; return *this; }
+	FSessionSearchFilter& WithAnyBuild() { bMatchBuild = false; return *this; }
+
+	/**
+	 * Writes the filter as comparison ops
+	 * @param QuerySettings The search's QuerySettings
+	 */
+	void ApplyTo(FOnlineSearchSettings& QuerySettings) const;
+
+	/**
+	 * Same checks as ApplyTo, on a result we already have
+	 * @param SearchResult The result to check
+	 * @return If the result passes every set field
+	 */
+	bool Matches(const FOnlineSessionSearchResult& SearchResult) const;
+
+	/* The value advertised as SETTING_BUILDID */
+	static int32 GetLocalBuildId();
+};
+
 UCLASS(BlueprintType)
 class USessionSearchResult : public UObject
 {
@@ -85,11 +197,102 @@ DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FNetworkManager_OnFindSessionsFailur
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FNetworkManager_OnJoinSessionComplete, const FName, Session);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FNetworkManager_OnJoinSessionFailure, const FString&, Failure);
 
+//Native session events//
+
+/* Identifies a search started through FindSessionsAsync so it can be cancelled, or a create / join / destroy request. 0 is never handed out */
+using FSessionRequestId = uint32;
+
+/* Every event the network manager raises, each one has its own native channel */
+enum class ENetworkManagerEvent : uint8
+{
+	CreateSessionComplete,
+	CreateSessionFailure,
+	UpdateSessionComplete,
+	UpdateSessionFailure,
+	StartSessionComplete,
+	StartSessionFailure,
+	EndSessionComplete,
+	EndSessionFailure,
+	DestroySessionComplete,
+	DestroySessionFailure,
+	FindSessionsComplete,
+	FindSessionsFailure,
+	JoinSessionComplete,
+	JoinSessionFailure,
+	Count
+};
+
+/* Payload of a native session event, which members are filled depends on the event */
+struct FNetworkManagerEvent
+{
+	ENetworkManagerEvent Type = ENetworkManagerEvent::Count;
+
+	/* *Complete events except FindSessionsComplete, failures carry it when the backend named the session */
+	FName SessionName;
+
+	/* *Failure events */
+	FString Failure;
+
+	/* Create / join / destroy request the event answers, 0 when it wasn't raised for one */
+	FSessionRequestId RequestId = 0;
+
+	/* FindSessionsComplete */
+	TArray<FOnlineSessionSearchResult> SearchResults;
+};
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FNetworkManager_OnNativeEvent, const FNetworkManagerEvent&);
+
+//Native session events//
+
+//Session requests//
+
+/* What a search request resolves to */
+struct FSessionSearchOutcome
+{
+	/* At least one session was found */
+	bool bSuccessful = false;
+
+	bool bCancelled = false;
+
+	FString Failure;
+
+	TArray<FOnlineSessionSearchResult> Results;
+};
+
+/* What a create / join / destroy request resolves to */
+struct FSessionOpOutcome
+{
+	bool bSuccessful = false;
+
+	FName SessionName;
+
+	FString Failure;
+};
+
+/* What a QuickMatch resolves to */
+struct FQuickMatchOutcome
+{
+	EQuickMatchResult Result = EQuickMatchResult::Failed;
+
+	/* Session we joined or host */
+	FName SessionName;
+
+	FString Failure;
+
+	/* From the call to the join / create completing */
+	float SecondsToMatch = 0.f;
+
+	/* Joins tried, the failed ones included */
+	int32 JoinAttempts = 0;
+};
+
+//Session requests//
+
 /**
  * Game subsystem that handles requests for hosting and joining online games.
  * One subsystem is created for each game instance and can be accessed from blueprints or C++ code.
  */
-UCLASS(BlueprintType)
+UCLASS(BlueprintType, Config=Game)
 class UNetworkManagerGameInstance : public UGameInstanceSubsystem
 {
 	GENERATED_BODY()
@@ -99,9 +302,6 @@ private:
 	/* SessionSettings established by host */
 	TSharedPtr<FOnlineSessionSettings> SessionSettings;
 
-	/* SessionSearch Results by clients */
-	TSharedPtr<FOnlineSessionSearch> SessionSearch;
-
 	/* The name of the session we are a part of, gets set on JoinSession (Client) or CreateSession (Host) */
 	FName SessionName = TEXT("Default Game Session");
 
@@ -117,6 +317,183 @@ private:
 	
 	/* The data of the session we are a part of from the perspective of the client */
 	FOnlineSessionSearchResult SessionData;
+
+	/* Online / LAN / Auto, see ENetworkManagerConnectionMode */
+	ENetworkManagerConnectionMode ConnectionMode = ENetworkManagerConnectionMode::Online;
+
+	/* GEngine->NetDriverDefinitions as DefaultEngine.ini set them up, put back whenever we stop using the LAN driver */
+	TArray<FNetDriverDefinition> OriginalNetDriverDefinitions;
+
+	FDelegateHandle NetworkFailureHandle;
+	FDelegateHandle TravelFailureHandle;
+
+	/* Identifies the session across a host migration, made up by the original host and carried over by its replacement */
+	FString MigrationToken;
+
+	/* Region advertised by sessions we host, players pick theirs through SetRegion */
+	UPROPERTY(Config)
+	FString Region = TEXT("Default");
+
+	/* Where online searches go and hosted sessions get advertised, LAN searches always broadcast */
+	UPROPERTY(Config)
+	ESessionBackend SessionBackend = ESessionBackend::OnlineSubsystem;
+
+	/* Root URL of the matchmaking service */
+	UPROPERTY(Config)
+	FString MatchmakingServiceURL = TEXT("http://127.0.0.1:8420");
+
+	/* ip:port advertised to the service, the local host address and default port when empty */
+	UPROPERTY(Config)
+	FString AdvertisedAddress;
+
+	/* Seconds between heartbeats of the session we advertise, has to stay under the service's TTL */
+	UPROPERTY(Config)
+	float ServiceHeartbeatInterval = 10.f;
+
+	/* Set when SessionBackend is MatchmakingService */
+	TSharedPtr<FMatchmakingServiceClient> MatchmakingService;
+
+	/* Id the service gave the session we host, empty when not advertised */
+	FString AdvertisedSessionId;
+
+	FTSTicker::FDelegateHandle ServiceHeartbeatHandle;
+
+	/* Seconds a QuickMatch searches before it gives up and hosts */
+	UPROPERTY(Config)
+	float QuickMatchSearchDeadline = 3.f;
+
+	/* Results a QuickMatch asks for, the candidates it tries joining in rank order */
+	UPROPERTY(Config)
+	int32 QuickMatchMaxResults = 20;
+
+	/* Ranking: ms of ping every slot left open after we join is worth, favours filling sessions that are almost full */
+	UPROPERTY(Config)
+	float QuickMatchOpenSlotWeight = 10.f;
+
+	/* Ranking: ms of ping added to sessions hosted in another region than ours */
+	UPROPERTY(Config)
+	float QuickMatchOtherRegionPenalty = 100.f;
+
+	/* The QuickMatch in flight, one at a time */
+	struct FQuickMatchRequest
+	{
+		/* Bumped by every QuickMatch, continuations of an older one see it changed and drop out */
+		uint32 Serial = 0;
+
+		bool bActive = false;
+
+		/* Travel into the game map once matched */
+		bool bTravel = true;
+
+		FSessionSearchFilter Filter;
+
+		/* PlayerCount of the session we host when nothing is joined */
+		int32 HostPlayerCount = 0;
+
+		double StartTime = 0.0;
+
+		/* Set while the search runs */
+		FSessionRequestId SearchId = 0;
+
+		FTSTicker::FDelegateHandle DeadlineHandle;
+
+		/* Search results, best ranked first */
+		TArray<FOnlineSessionSearchResult> Candidates;
+
+		int32 NextCandidate = 0;
+
+		int32 JoinAttempts = 0;
+
+		TSharedPtr<TPromise<FQuickMatchOutcome>> Promise;
+	};
+
+	FQuickMatchRequest QuickMatchRequest;
+
+	/* Seconds every QuickMatch that joined or hosted took */
+	TArray<float> QuickMatchTimes;
+
+	/* A search and whoever waits on its results, every request owns its own search object */
+	struct FSessionSearchRequest
+	{
+		FSessionRequestId Id = 0;
+
+		TSharedPtr<FOnlineSessionSearch> Search;
+
+		/* Reused by the Auto online pass and checked again on the results */
+		FSessionSearchFilter Filter;
+
+		/* False for searches that bring their own keys (migration token) */
+		bool bApplyFilter = false;
+
+		/* Set while an Auto search is running its LAN pass */
+		bool bAutoLANPass = false;
+
+		bool bCancelled = false;
+
+		TFunction<void(const FSessionSearchOutcome&)> OnComplete;
+	};
+
+	/* The backends run one search at a time, the rest wait here. The first one is running while bSearchRunning is set */
+	TArray<TSharedRef<FSessionSearchRequest>> SearchQueue;
+
+	bool bSearchRunning = false;
+
+	FSessionRequestId NextSearchRequestId = 1;
+
+	/* A FindSessionById waiting on its backend, resolved by whichever of its answer, the timeout, a cancel or shut down comes first */
+	struct FSessionIdLookup
+	{
+		TFunction<void(const FSessionSearchOutcome&)> OnComplete;
+
+		FTSTicker::FDelegateHandle TimeoutHandle;
+	};
+
+	/* Keyed by the same ids searches use, so CancelSearch covers both */
+	TMap<FSessionRequestId, FSessionIdLookup> PendingIdLookups;
+
+	/* Which outcomes of a session op reach the session listeners, internal steps keep theirs to the caller */
+	enum class ESessionOpListeners : uint8
+	{
+		All,
+		/* Failures only resolve the future, e.g. a QuickMatch join that moves on to the next candidate */
+		CompleteOnly,
+		None
+	};
+
+	/* A create / join / destroy request, resolved by the event carrying its Id */
+	struct FPendingSessionOp
+	{
+		FSessionRequestId Id = 0;
+		ENetworkManagerEvent CompleteEvent = ENetworkManagerEvent::Count;
+		ENetworkManagerEvent FailureEvent = ENetworkManagerEvent::Count;
+
+		/* Session the backend is working on for us, set once the call handed it over */
+		FName SessionName;
+		bool bIssued = false;
+
+		/* An event carrying Id has been queued, later ones belong to someone else */
+		bool bRaised = false;
+
+		ESessionOpListeners Listeners = ESessionOpListeners::All;
+
+		TPromise<FSessionOpOutcome> Promise;
+	};
+
+	TArray<TSharedRef<FPendingSessionOp>> PendingSessionOps;
+
+	FSessionRequestId NextSessionOpId = 1;
+
+	/* Op whose call is on the stack, events raised synchronously by that call are its answer */
+	FSessionRequestId IssuingSessionOpId = 0;
+
+	/* Native listeners, one channel per ENetworkManagerEvent */
+	TStaticArray<FNetworkManager_OnNativeEvent, static_cast<int32>(ENetworkManagerEvent::Count)> NativeEvents;
+
+	/* Events raised since the last flush */
+	TArray<FNetworkManagerEvent> PendingEvents;
+
+	/* Set while a flush is scheduled for the next frame */
+	FTSTicker::FDelegateHandle FlushEventsHandle;
 	
 	//Settings//
 
@@ -134,6 +511,162 @@ private:
 
 	/* Main Game Level path used for joining */
 	FString BuildMainGameMapPathForJoining() const;
+
+	/* Driver used for LAN and direct IP play */
+	const FName LANNetDriverClassName = TEXT("/Script/OnlineSubsystemUtils.IpNetDriver");
+
+	/* How long LAN searches (and the LAN pass of an Auto search) wait for broadcast replies */
+	UPROPERTY(Config)
+	float AutoLANSearchTimeout = 1.5f;
+
+	/* How long a FindSessionById waits for the backend before it fails, the OSS call isn't guaranteed to answer */
+	UPROPERTY(Config)
+	float FindSessionByIdTimeout = 10.f;
+
+	/**
+	 * Points the GameNetDriver definition at IpNetDriver or back at the original definitions
+	 * Has to happen before the listen / connect that should use it
+	 * @param bUseLANDriver If LAN / direct IP traffic is expected
+	 */
+	void ApplyNetDriverForConnection(const bool bUseLANDriver);
+
+	/* Puts GEngine->NetDriverDefinitions back the way Initialize found them, called on every path that gives up a connection */
+	void RestoreNetDriverDefinitions();
+
+	/* A join that never made it (pending driver failed, travel failed) must not leave the LAN driver behind */
+	void HandleNetworkFailure(UWorld* World, UNetDriver* NetDriver, ENetworkFailure::Type FailureType, const FString& ErrorString);
+
+	void HandleTravelFailure(UWorld* World, ETravelFailure::Type FailureType, const FString& ErrorString);
+
+	/**
+	 * Builds the search object of a request
+	 * @param bLANQuery LAN broadcast or online query
+	 * @param MaxSearchResults Max amount of sessions we want to find
+	 * @param Filter Keys pushed to the backend, nullptr for none
+	 */
+	TSharedRef<FOnlineSessionSearch> MakeSessionSearch(const bool bLANQuery, const int32 MaxSearchResults, const FSessionSearchFilter* Filter) const;
+
+	/**
+	 * Queues a filtered search following the connection mode
+	 * @param MaxSearchResults Max amount of sessions we want to find
+	 * @param Filter Build / map / open slots / privacy / region requirements
+	 * @param OnComplete Gets the outcome, exactly once
+	 * @return Id of the request
+	 */
+	FSessionRequestId QueueFilteredSearch(const int32 MaxSearchResults, const FSessionSearchFilter& Filter, TFunction<void(const FSessionSearchOutcome&)>&& OnComplete);
+
+	/* Adds a request to SearchQueue and starts it when nothing else is running */
+	FSessionRequestId QueueSearch(const TSharedRef<FSessionSearchRequest>& Request);
+
+	/* Starts the first queued search, failing the ones the backend refuses */
+	void StartNextSearch();
+
+	/**
+	 * Hands the search of a request to the backend
+	 * @return If the backend took it
+	 */
+	bool RunSearch(const FSessionSearchRequest& Request);
+
+	/**
+	 * Sends the search of a request to the matchmaking service, completes through OnFindSessionsCompletionHandler like the OSS does
+	 * @return If the query was sent
+	 */
+	bool RunServiceQuery(const FSessionSearchRequest& Request);
+
+	/* Advertises the session we just created to the matchmaking service and starts its heartbeat */
+	void AdvertiseToService();
+
+	/* Heartbeat ticker, advertises again when the service forgot the session */
+	bool HeartbeatService(float DeltaTime);
+
+	/* Removes the session we host from the matchmaking service */
+	void WithdrawFromService();
+
+	/* ip:port peers reach this host on */
+	FString GetServiceConnectAddress() const;
+
+	/* Pops the running search, hands it its outcome and moves on to the next one */
+	void CompleteRunningSearch(FSessionSearchOutcome&& Outcome);
+
+	/* Shared events for the searches started through FindSessions */
+	void BroadcastSearchOutcome(const FSessionSearchOutcome& Outcome);
+
+	/**
+	 * Looks a session up by id, runs next to queued searches since the backend completes it per call
+	 * @param SessionId Id string of the session
+	 * @param OnComplete Gets the outcome, exactly once
+	 * @return Id to pass to CancelSearch
+	 */
+	FSessionRequestId StartFindSessionById(const FString& SessionId, TFunction<void(const FSessionSearchOutcome&)>&& OnComplete);
+
+	/**
+	 * Hands a lookup its outcome, answers for lookups that already timed out or got cancelled are dropped
+	 * @param LookupId Id StartFindSessionById handed out
+	 * @param Outcome What the lookup resolves with
+	 */
+	void ResolveIdLookup(const FSessionRequestId LookupId, const FSessionSearchOutcome& Outcome);
+
+	/**
+	 * Resolves every queued or running search and id lookup as cancelled, nobody is going to complete them anymore
+	 * @param Reason Failure the outcomes carry
+	 */
+	void CancelPendingSearches(const FString& Reason);
+
+	/**
+	 * Issues a create / join / destroy call and returns a promise only its own answer resolves
+	 * @param CompleteEvent Event that resolves it successfully
+	 * @param FailureEvent Event that fails it
+	 * @param Issue The call itself
+	 * @param Listeners Which outcomes get broadcast besides resolving the future
+	 */
+	TFuture<FSessionOpOutcome> RunSessionOp(const ENetworkManagerEvent CompleteEvent, const ENetworkManagerEvent FailureEvent, TFunctionRef<void()> Issue,
+		const ESessionOpListeners Listeners = ESessionOpListeners::All);
+
+	/**
+	 * Finds the pending op a freshly raised event answers and marks it raised
+	 * @param Event Event being queued
+	 * @return The op id, 0 if the event wasn't raised for a pending op
+	 */
+	FSessionRequestId ClaimSessionOp(const FNetworkManagerEvent& Event);
+
+	/* Resolves the pending op the event was raised for, if any */
+	void ResolveSessionOp(const FNetworkManagerEvent& Event);
+
+	/* If the op the event was raised for keeps this outcome from the session listeners */
+	bool IsSessionOpEventQuiet(const FNetworkManagerEvent& Event) const;
+
+	/* If the continuation of a QuickMatch step still belongs to the QuickMatch in flight */
+	bool IsQuickMatchCurrent(const uint32 Serial) const;
+
+	/**
+	 * Cost of joining a search result, lower is better
+	 * @param SearchResult Result passing the QuickMatch filter
+	 * @return Ping in ms plus the open slot / region weights
+	 */
+	float RankQuickMatchCandidate(const FOnlineSessionSearchResult& SearchResult) const;
+
+	/* Ranks what the search found and starts joining, hosts when it found nothing in time */
+	void OnQuickMatchSearchComplete(const FSessionSearchOutcome& Outcome);
+
+	/* Deadline ticker, cancels the search so the QuickMatch hosts. Always returns false */
+	bool OnQuickMatchDeadline(float DeltaTime);
+
+	/* Joins the next candidate, hosts once they ran out */
+	void QuickMatchJoinNext();
+
+	void OnQuickMatchJoinComplete(const FSessionOpOutcome& Outcome);
+
+	void QuickMatchHost();
+
+	/* Records the time to match, travels if asked and resolves the QuickMatch */
+	void FinishQuickMatch(const EQuickMatchResult Result, const FName SessionNameIn, const FString& Failure);
+
+	/**
+	 * Registers the splitscreen guests with the session the first local player created or joined,
+	 * so they hold their slots and the engine joins them over the first player's connection
+	 * @param SessionNameIn Session to register them with
+	 */
+	void RegisterGuestLocalPlayers(const FName SessionNameIn) const;
 	
 private:
 	/**
@@ -157,9 +690,30 @@ public:
 
 	//Network Interface calls//
 
+	/**
+	 * Selects how the next sessions get hosted and discovered
+	 * @param NewConnectionMode Online, LAN or Auto
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure=false, Category = "Network Manager")
+	void SetConnectionMode(const ENetworkManagerConnectionMode NewConnectionMode);
+
+	/**
+	 * The current connection mode
+	 * @return ENetworkManagerConnectionMode
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Network Manager")
+	ENetworkManagerConnectionMode GetConnectionMode() const;
+
+	/**
+	 * Local players that host or join together, each of them takes a slot in the session
+	 * @return At least 1
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Network Manager")
+	int32 GetNumLocalPlayers() const;
+
 	/**
 	 * Used to Create a new game Session
-	 * @param PlayerCount The desired PlayerCount for this session
+	 * @param PlayerCount The desired PlayerCount for this session, local splitscreen guests included
 	 * @param IsPrivate If the session is private or publicly join-able
 	 */
 	UFUNCTION(BlueprintCallable, BlueprintPure=false, Category = "Network Manager")
@@ -176,27 +730,49 @@ public:
 	 * Starts the session
 	 */
 	UFUNCTION(BlueprintCallable, BlueprintPure=false, Category = "Network Manager")
-	void StartSession() const;
+	void StartSession();
 
 	/**
 	 * Ends the session, Graceful shutdown notifies players in advance
 	 */
 	UFUNCTION(BlueprintCallable, BlueprintPure=false, Category = "Network Manager")
-	void EndSession() const;
+	void EndSession();
 
 	/**
 	 * Destroys the session, hard shutdown
 	 */
 	UFUNCTION(BlueprintCallable, BlueprintPure=false, Category = "Network Manager")
-	void DestroySession() const;
+	void DestroySession();
 
 	/**
-	 * Finds Sessions
+	 * Finds Sessions running our build with at least one open slot
 	 * @param MaxSearchResults Max amount of sessions we want to find
 	 */
 	UFUNCTION(BlueprintCallable, BlueprintPure=false, Category = "Network Manager")
 	void FindSessions(const int32 MaxSearchResults);
 
+	/**
+	 * Finds Sessions, filtered by the backend
+	 * @param MaxSearchResults Max amount of sessions we want to find
+	 * @param Filter Build / map / open slots / privacy / region requirements
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure=false, Category = "Network Manager")
+	void FindSessionsFiltered(const int32 MaxSearchResults, const FSessionSearchFilter& Filter);
+
+	/**
+	 * Region advertised by the sessions we host
+	 * @param NewRegion Region name, matched as is by FSessionSearchFilter::Region
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure=false, Category = "Network Manager")
+	void SetRegion(const FString& NewRegion);
+
+	/**
+	 * Region advertised by the sessions we host
+	 * @return The region name
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Network Manager")
+	FString GetRegion() const;
+
 	/**
 	 * Tries to join the given session
 	 * @param SessionResult The session we want to join
@@ -209,7 +785,7 @@ public:
 	 * @return If we could server travel
 	 */
 	UFUNCTION(BlueprintCallable, BlueprintPure=false, Category = "Network Manager")
-	bool ServerTravelAsHost_GameMap() const;
+	bool ServerTravelAsHost_GameMap();
 	
 	/**
 	 * Try to server travel to the current map in the current session as a client
@@ -218,10 +794,145 @@ public:
 	UFUNCTION(BlueprintCallable, BlueprintPure=false, Category = "Network Manager")
 	bool ServerTravelAsClient_GameMap() const;
 
+	/**
+	 * Connects straight to a host by address over IpNetDriver, skipping session discovery
+	 * @param Address Host address, ip:port
+	 * @return If we could start travelling
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure=false, Category = "Network Manager")
+	bool JoinByAddress(const FString& Address);
+
+	/**
+	 * Travels straight to a host we already resolved, with the net driver its session type needs
+	 * @param ConnectString Resolved connect string of the session (ip:port or steam.id)
+	 * @param bIsLANMatch If the session was a LAN session
+	 * @return If we could start travelling
+	 */
+	bool JoinByConnectString(const FString& ConnectString, const bool bIsLANMatch);
+
+	/**
+	 * Id of the session we joined as a client
+	 * @return Empty when we didn't join one
+	 */
+	FString GetJoinedSessionId() const;
+
+	/**
+	 * Resolved connect string of the session we joined as a client
+	 * @return Empty when it can't be resolved
+	 */
+	FString GetJoinedConnectString() const;
+
+	/* If the session we joined as a client is a LAN session */
+	bool IsJoinedSessionLAN() const;
+
+	/**
+	 * Looks up a single session by id, the result comes through OnFindSessionsComplete / OnFindSessionsFailure
+	 * @param SessionId Id string of the session, as returned by GetJoinedSessionId
+	 */
+	void FindSessionById(const FString& SessionId);
+
+	//Requests, C++ handles of every session op. Blueprint uses the async action nodes in SessionAsyncActions.h//
+
+	/**
+	 * Filtered search owned by the caller, it doesn't raise OnFindSessionsComplete and doesn't disturb other searches.
+	 * Searches queue up behind each other since the backends only run one at a time
+	 * @param MaxSearchResults Max amount of sessions we want to find
+	 * @param Filter Build / map / open slots / privacy / region requirements
+	 * @param OutRequestId Set to the id to pass to CancelSearch
+	 * @return Resolved on the game thread once the search finishes, fails or gets cancelled
+	 */
+	TFuture<FSessionSearchOutcome> FindSessionsAsync(const int32 MaxSearchResults, const FSessionSearchFilter& Filter, FSessionRequestId* OutRequestId = nullptr);
+
+	/**
+	 * Session lookup by id owned by the caller, fails after FindSessionByIdTimeout when the backend never answers
+	 * @param SessionId Id string of the session
+	 * @param OutRequestId Set to the id to pass to CancelSearch
+	 * @return Resolved with at most one result
+	 */
+	TFuture<FSessionSearchOutcome> FindSessionByIdAsync(const FString& SessionId, FSessionRequestId* OutRequestId = nullptr);
+
+	/**
+	 * Search for the replacement session advertising the given token, owned by the caller like FindSessionsAsync
+	 * @param Token Migration token of the session that lost its host
+	 * @return Resolved with the sessions carrying the token, bSuccessful only when there is at least one
+	 */
+	TFuture<FSessionSearchOutcome> FindSessionByMigrationTokenAsync(const FString& Token);
+
+	/**
+	 * Cancels a search started by FindSessionsAsync or a lookup started by FindSessionByIdAsync, it resolves with bCancelled set
+	 * @param RequestId Id handed out by FindSessionsAsync / FindSessionByIdAsync
+	 * @return If the search was still pending
+	 */
+	bool CancelSearch(const FSessionRequestId RequestId);
+
+	/* CreateSession resolved by its own completion, the shared events still fire */
+	TFuture<FSessionOpOutcome> CreateSessionAsync(const int32 PlayerCount, const bool IsPrivate);
+
+	/* JoinSession resolved by its own completion, the shared events still fire */
+	TFuture<FSessionOpOutcome> JoinSessionAsync(USessionSearchResult* SessionResult);
+
+	/* DestroySession resolved by its own completion, the shared events still fire */
+	TFuture<FSessionOpOutcome> DestroySessionAsync();
+
+	/**
+	 * One call matchmaking: searches with the filter until QuickMatchSearchDeadline, joins the best ranked result
+	 * and falls through to the next one when a join fails (full, gone...), hosts when nothing was found or joined
+	 * @param Filter Build / map / open slots / privacy / region requirements
+	 * @param HostPlayerCount PlayerCount of the session we host if it comes to that
+	 * @param bTravel Travel into the game map once matched, the benchmark stays on the menu
+	 * @return Resolved once joined, hosting, failed or cancelled
+	 */
+	TFuture<FQuickMatchOutcome> QuickMatchAsync(const FSessionSearchFilter& Filter, const int32 HostPlayerCount, const bool bTravel = true);
+
+	/**
+	 * Stops the QuickMatch in flight, it resolves as cancelled. A join / create already sent still completes through the shared events
+	 * @return If a QuickMatch was running
+	 */
+	bool CancelQuickMatch();
+
+	/* If a QuickMatch is in flight */
+	bool IsQuickMatching() const;
+
+	/**
+	 * Median time to match of the QuickMatches that joined or hosted
+	 * @return 0 when none did yet
+	 */
+	float GetQuickMatchMedianSeconds() const;
+
+	//Requests//
+
+	/**
+	 * Token the next CreateSession advertises, a new one is made up when empty
+	 * @param NewMigrationToken Token of the session being replaced
+	 */
+	void SetMigrationToken(const FString& NewMigrationToken);
+
+	/**
+	 * Token of the session we host or joined
+	 * @return Empty when not in a session
+	 */
+	FString GetMigrationToken() const;
+
 	//Network Interface calls//
 
 	//Network Interface Delegates//
 
+	/**
+	 * Native channel of an event, for C++ listeners. Events are queued as they happen and delivered together
+	 * once per frame, native listeners first, then the Blueprint delegates below
+	 * @param Event Event to listen to
+	 * @return The channel to add to
+	 */
+	FNetworkManager_OnNativeEvent& OnNativeEvent(const ENetworkManagerEvent Event) { return this->NativeEvents[static_cast<int32>(Event)]; }
+
+	/**
+	 * Removes a listener from every native channel
+	 * @param Listener Object whose bindings get removed
+	 */
+	void RemoveNativeListener(const void* Listener);
+
+	/* Blueprint adaptors of the native channels */
+
 	UPROPERTY(BlueprintCallable, BlueprintAssignable, Category = "Network Manager")
 	FNetworkManager_OnCreateSessionComplete OnCreateSessionComplete;
 	UPROPERTY(BlueprintCallable, BlueprintAssignable, Category = "Network Manager")
@@ -269,26 +980,42 @@ private:
 
 	//Network Interface Delegate callers//
 	
-	void CallOnCreateSessionComplete(const FName SessionNameIn) const;
-	void CallOnCreateSessionFailure(const FString& FailureIn) const;
+	void CallOnCreateSessionComplete(const FName SessionNameIn);
+	void CallOnCreateSessionFailure(const FString& FailureIn, const FName SessionNameIn = NAME_None);
+
+	void CallOnUpdateSessionComplete(const FName SessionNameIn);
+	void CallOnUpdateSessionFailure(const FString& FailureIn);
 
-	void CallOnUpdateSessionComplete(const FName SessionNameIn) const;
-	void CallOnUpdateSessionFailure(const FString& FailureIn) const;
+	void CallOnStartSessionComplete(const FName SessionNameIn);
+	void CallOnStartSessionFailure(const FString& FailureIn);
 
-	void CallOnStartSessionComplete(const FName SessionNameIn) const;
-	void CallOnStartSessionFailure(const FString& FailureIn) const;
+	void CallOnEndSessionComplete(const FName SessionNameIn);
+	void CallOnEndSessionFailure(const FString& FailureIn);
 
-	void CallOnEndSessionComplete(const FName SessionNameIn) const;
-	void CallOnEndSessionFailure(const FString& FailureIn) const;
+	void CallOnDestroySessionComplete(const FName SessionNameIn);
+	void CallOnDestroySessionFailure(const FString& FailureIn, const FName SessionNameIn = NAME_None);
 
-	void CallOnDestroySessionComplete(const FName SessionNameIn) const;
-	void CallOnDestroySessionFailure(const FString& FailureIn) const;
+	void CallOnFindSessionsComplete(const TArray<FOnlineSessionSearchResult>& SessionResultsIn);
+	void CallOnFindSessionsFailure(const FString& FailureIn);
 
-	void CallOnFindSessionsComplete(const TArray<USessionSearchResult*>& SessionResultsIn) const;
-	void CallOnFindSessionsFailure(const FString& FailureIn) const;
+	void CallOnJoinSessionComplete(const FName SessionIn);
+	void CallOnJoinSessionFailure(const FString& FailureIn, const FName SessionNameIn = NAME_None);
 
-	void CallOnJoinSessionComplete(const FName SessionIn) const;
-	void CallOnJoinSessionFailure(const FString& FailureIn) const;
+	/**
+	 * Queues an event for the next flush
+	 * @param Event Event to deliver
+	 */
+	void QueueEvent(FNetworkManagerEvent&& Event);
+
+	/* Delivers the queued events, native listeners first then the Blueprint adaptor. Ticker callback, always returns false */
+	bool FlushEvents(float DeltaTime);
+
+	/**
+	 * Blueprint adaptor, broadcasts the dynamic delegate matching the event
+	 * @param Event Event to broadcast
+	 * @return If anything was bound to it
+	 */
+	bool BroadcastDynamicEvent(const FNetworkManagerEvent& Event);
 
 	//Network Interface Delegate callers//
 
@@ -299,49 +1026,64 @@ private:
 	 * @param SessionNameIn SessionName
 	 * @param Successful Operation succeeded
 	 */
-	void OnCreateSessionCompletionHandler(const FName SessionNameIn, const bool Successful) const;
+	void OnCreateSessionCompletionHandler(const FName SessionNameIn, const bool Successful);
 
 	/**
 	 * Called by the IOnlineSessionInterface when create session completes
 	 * @param SessionNameIn SessionName that was updated
 	 * @param Successful Operation succeeded
 	 */
-	void OnUpdateSessionCompletionHandler(const FName SessionNameIn, const bool Successful) const;
+	void OnUpdateSessionCompletionHandler(const FName SessionNameIn, const bool Successful);
 
 	/**
 	 * Called by the IOnlineSessionInterface when a session update completes
 	 * @param SessionNameIn SessionName that was updated
 	 * @param Successful Operation succeeded
 	 */
-	void OnStartSessionCompletionHandler(const FName SessionNameIn, const bool Successful) const;
+	void OnStartSessionCompletionHandler(const FName SessionNameIn, const bool Successful);
 
 	/**
 	 * Called by the IOnlineSessionInterface when a session update completes
 	 * @param SessionNameIn SessionName that was ended
 	 * @param Successful Operation succeeded
 	 */
-	void OnEndSessionCompletionHandler(const FName SessionNameIn, const bool Successful) const;
+	void OnEndSessionCompletionHandler(const FName SessionNameIn, const bool Successful);
 
 	/**
 	 * Called by the IOnlineSessionInterface when a session is destroyed
 	 * @param SessionNameIn SessionName that was destroyed
 	 * @param Successful Operation succeeded
 	 */
-	void OnDestroySessionCompletionHandler(const FName SessionNameIn, const bool Successful) const;
+	void OnDestroySessionCompletionHandler(const FName SessionNameIn, const bool Successful);
+
+	/**
+	 * Forgets the session we were in and reports it destroyed, shared by the session interface and service join paths
+	 * @param SessionNameIn SessionName we left
+	 */
+	void OnSessionLeft(const FName SessionNameIn);
 
 	/**
 	 * Called by the IOnlineSessionInterface when it's done searching for sessions
-	 * Found Session Results get stored in SessionSearch
+	 * Found Session Results get stored in the running request's search
+	 * @param Successful Operation succeeded
+	 */
+	void OnFindSessionsCompletionHandler(const bool Successful);
+
+	/**
+	 * Called by the IOnlineSessionInterface when the running search got cancelled
 	 * @param Successful Operation succeeded
 	 */
-	void OnFindSessionsCompletionHandler(const bool Successful) const;
+	void OnCancelFindSessionsCompletionHandler(const bool Successful);
 
 	/**
 	 * Called by the IOnlineSessionInterface when it's done trying to join a session
 	 * @param SessionNameIn Session we are trying to join
 	 * @param Result State returned about whether you could join the session
 	 */
-	void OnJoinSessionCompletionHandler(const FName SessionNameIn, const EOnJoinSessionCompleteResult::Type Result) const;
+	void OnJoinSessionCompletionHandler(const FName SessionNameIn, const EOnJoinSessionCompleteResult::Type Result);
 
 	//Bindable functions, These get called by the IOnlineInterface//
+
+	friend class FHostMigrationReplacementSearchTest;
+	friend class FReconnectSessionSearchTest;
 };
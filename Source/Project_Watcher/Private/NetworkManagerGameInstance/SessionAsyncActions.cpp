@@ -0,0 +1,216 @@
+//Project Watcher 2024 & Beyond
+
+#include "SessionAsyncActions.h"
+#include "Engine/GameInstance.h"
+#include "Kismet/GameplayStatics.h"
+
+namespace SessionAsyncActions
+{
+	UNetworkManagerGameInstance* GetNetworkManager(const UObject* WorldContextObject)
+	{
+		const UGameInstance* GameInstance = UGameplayStatics::GetGameInstance(WorldContextObject);
+		return GameInstance ? GameInstance->GetSubsystem<UNetworkManagerGameInstance>() : nullptr;
+	}
+}
+
+UFindSessionsAsyncAction* UFindSessionsAsyncAction::FindSessionsAsync(UObject* WorldContextObject, const int32 MaxSearchResults, const FSessionSearchFilter& Filter)
+{
+	UFindSessionsAsyncAction* Action = NewObject<UFindSessionsAsyncAction>();
+	Action->NetworkManager = SessionAsyncActions::GetNetworkManager(WorldContextObject);
+	Action->MaxSearchResults = MaxSearchResults;
+	Action->Filter = Filter;
+	Action->RegisterWithGameInstance(WorldContextObject);
+	return Action;
+}
+
+void UFindSessionsAsyncAction::Activate()
+{
+	UNetworkManagerGameInstance* Manager = this->NetworkManager.Get();
+	if (!Manager)
+	{
+		FSessionSearchOutcome Outcome;
+		Outcome.Failure = TEXT("NetworkManager is Invalid");
+		this->HandleOutcome(Outcome);
+		return;
+	}
+
+	TWeakObjectPtr<UFindSessionsAsyncAction> WeakThis(this);
+	Manager->FindSessionsAsync(this->MaxSearchResults, this->Filter, &this->RequestId).Next([WeakThis](const FSessionSearchOutcome& Outcome)
+	{
+		if (UFindSessionsAsyncAction* Action = WeakThis.Get())
+		{
+			Action->HandleOutcome(Outcome);
+		}
+	});
+}
+
+void UFindSessionsAsyncAction::Cancel()
+{
+	//Resolves through HandleOutcome as cancelled, which no longer broadcasts
+	if (UNetworkManagerGameInstance* Manager = this->NetworkManager.Get())
+	{
+		Manager->CancelSearch(this->RequestId);
+	}
+	Super::Cancel();
+}
+
+void UFindSessionsAsyncAction::HandleOutcome(const FSessionSearchOutcome& Outcome)
+{
+	if (this->ShouldBroadcastDelegates() && !Outcome.bCancelled)
+	{
+		TArray<USessionSearchResult*> SessionResults;
+		SessionResults.Reserve(Outcome.Results.Num());
+		for (const FOnlineSessionSearchResult& Result : Outcome.Results)
+		{
+			SessionResults.Add(USessionSearchResult::Make(Result));
+		}
+
+		if (Outcome.bSuccessful)
+		{
+			this->OnSuccess.Broadcast(SessionResults, Outcome.Failure);
+		}
+		else
+		{
+			this->OnFailure.Broadcast(SessionResults, Outcome.Failure);
+		}
+	}
+	this->SetReadyToDestroy();
+}
+
+USessionOpAsyncAction* USessionOpAsyncAction::Make(UObject* WorldContextObject, const ESessionAsyncOp Op)
+{
+	USessionOpAsyncAction* Action = NewObject<USessionOpAsyncAction>();
+	Action->NetworkManager = SessionAsyncActions::GetNetworkManager(WorldContextObject);
+	Action->Op = Op;
+	Action->RegisterWithGameInstance(WorldContextObject);
+	return Action;
+}
+
+USessionOpAsyncAction* USessionOpAsyncAction::CreateSessionAsync(UObject* WorldContextObject, const int32 PlayerCount, const bool IsPrivate)
+{
+	USessionOpAsyncAction* Action = Make(WorldContextObject, ESessionAsyncOp::Create);
+	Action->PlayerCount = PlayerCount;
+	Action->bIsPrivate = IsPrivate;
+	return Action;
+}
+
+USessionOpAsyncAction* USessionOpAsyncAction::JoinSessionAsync(UObject* WorldContextObject, USessionSearchResult* SessionResult)
+{
+	USessionOpAsyncAction* Action = Make(WorldContextObject, ESessionAsyncOp::Join);
+	Action->SessionResult = SessionResult;
+	return Action;
+}
+
+USessionOpAsyncAction* USessionOpAsyncAction::DestroySessionAsync(UObject* WorldContextObject)
+{
+	return Make(WorldContextObject, ESessionAsyncOp::Destroy);
+}
+
+void USessionOpAsyncAction::Activate()
+{
+	UNetworkManagerGameInstance* Manager = this->NetworkManager.Get();
+	if (!Manager)
+	{
+		FSessionOpOutcome Outcome;
+		Outcome.Failure = TEXT("NetworkManager is Invalid");
+		this->HandleOutcome(Outcome);
+		return;
+	}
+
+	TFuture<FSessionOpOutcome> Future;
+	switch (this->Op)
+	{
+	case ESessionAsyncOp::Create:
+		Future = Manager->CreateSessionAsync(this->PlayerCount, this->bIsPrivate);
+		break;
+	case ESessionAsyncOp::Join:
+		Future = Manager->JoinSessionAsync(this->SessionResult);
+		break;
+	case ESessionAsyncOp::Destroy:
+		Future = Manager->DestroySessionAsync();
+		break;
+	}
+
+	TWeakObjectPtr<USessionOpAsyncAction> WeakThis(this);
+	Future.Next([WeakThis](const FSessionOpOutcome& Outcome)
+	{
+		if (USessionOpAsyncAction* Action = WeakThis.Get())
+		{
+			Action->HandleOutcome(Outcome);
+		}
+	});
+}
+
+void USessionOpAsyncAction::HandleOutcome(const FSessionOpOutcome& Outcome)
+{
+	if (this->ShouldBroadcastDelegates())
+	{
+		if (Outcome.bSuccessful)
+		{
+			this->OnSuccess.Broadcast(Outcome.SessionName, Outcome.Failure);
+		}
+		else
+		{
+			this->OnFailure.Broadcast(Outcome.SessionName, Outcome.Failure);
+		}
+	}
+	this->SetReadyToDestroy();
+}
+
+UQuickMatchAsyncAction* UQuickMatchAsyncAction::QuickMatchAsync(UObject* WorldContextObject, const FSessionSearchFilter& Filter, const int32 HostPlayerCount, const bool bTravel)
+{
+	UQuickMatchAsyncAction* Action = NewObject<UQuickMatchAsyncAction>();
+	Action->NetworkManager = SessionAsyncActions::GetNetworkManager(WorldContextObject);
+	Action->Filter = Filter;
+	Action->HostPlayerCount = HostPlayerCount;
+	Action->bTravel = bTravel;
+	Action->RegisterWithGameInstance(WorldContextObject);
+	return Action;
+}
+
+void UQuickMatchAsyncAction::Activate()
+{
+	UNetworkManagerGameInstance* Manager = this->NetworkManager.Get();
+	if (!Manager)
+	{
+		FQuickMatchOutcome Outcome;
+		Outcome.Failure = TEXT("NetworkManager is Invalid");
+		this->HandleOutcome(Outcome);
+		return;
+	}
+
+	TWeakObjectPtr<UQuickMatchAsyncAction> WeakThis(this);
+	Manager->QuickMatchAsync(this->Filter, this->HostPlayerCount, this->bTravel).Next([WeakThis](const FQuickMatchOutcome& Outcome)
+	{
+		if (UQuickMatchAsyncAction* Action = WeakThis.Get())
+		{
+			Action->HandleOutcome(Outcome);
+		}
+	});
+}
+
+void UQuickMatchAsyncAction::Cancel()
+{
+	//Resolves through HandleOutcome as cancelled, which no longer broadcasts
+	if (UNetworkManagerGameInstance* Manager = this->NetworkManager.Get())
+	{
+		Manager->CancelQuickMatch();
+	}
+	Super::Cancel();
+}
+
+void UQuickMatchAsyncAction::HandleOutcome(const FQuickMatchOutcome& Outcome)
+{
+	if (this->ShouldBroadcastDelegates() && Outcome.Result != EQuickMatchResult::Cancelled)
+	{
+		if (Outcome.Result == EQuickMatchResult::Joined || Outcome.Result == EQuickMatchResult::Hosted)
+		{
+			this->OnSuccess.Broadcast(Outcome.Result, Outcome.SessionName, Outcome.Failure, Outcome.SecondsToMatch);
+		}
+		else
+		{
+			this->OnFailure.Broadcast(Outcome.Result, Outcome.SessionName, Outcome.Failure, Outcome.SecondsToMatch);
+		}
+	}
+	this->SetReadyToDestroy();
+}
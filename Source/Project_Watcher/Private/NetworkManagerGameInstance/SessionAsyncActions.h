@@ -0,0 +1,161 @@
+//Project Watcher 2024 & Beyond
+
+#pragma once
+#include "CoreMinimal.h"
+#include "Engine/CancellableAsyncAction.h"
+#include "NetworkManagerGameInstance.h"
+#include "SessionAsyncActions.generated.h"
+
+//Wrapper for BP data//
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FSessionAsyncAction_OnSearchComplete, const TArray<USessionSearchResult*>&, SessionResults, const FString&, Failure);
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FSessionAsyncAction_OnOpComplete, const FName, SessionName, const FString&, Failure);
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_FourParams(FSessionAsyncAction_OnQuickMatchComplete, const EQuickMatchResult, Result, const FName, SessionName, const FString&, Failure, const float, SecondsToMatch);
+
+//Wrapper for BP data//
+
+/**
+ * Latent Blueprint node for a filtered session search. Every node owns its own search,
+ * so several can be in flight without stealing each other's results from OnFindSessionsComplete.
+ * Cancelling the node cancels the search itself.
+ */
+UCLASS()
+class UFindSessionsAsyncAction : public UCancellableAsyncAction
+{
+	GENERATED_BODY()
+private:
+	TWeakObjectPtr<UNetworkManagerGameInstance> NetworkManager;
+
+	int32 MaxSearchResults = 0;
+
+	FSessionSearchFilter Filter;
+
+	FSessionRequestId RequestId = 0;
+
+public:
+	/**
+	 * Searches for sessions matching the filter
+	 * @param MaxSearchResults Max amount of sessions we want to find
+	 * @param Filter Build / map / open slots / privacy / region requirements
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Online", meta = (BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject"))
+	static UFindSessionsAsyncAction* FindSessionsAsync(UObject* WorldContextObject, const int32 MaxSearchResults, const FSessionSearchFilter& Filter);
+
+	UPROPERTY(BlueprintAssignable)
+	FSessionAsyncAction_OnSearchComplete OnSuccess;
+
+	UPROPERTY(BlueprintAssignable)
+	FSessionAsyncAction_OnSearchComplete OnFailure;
+
+	virtual void Activate() override;
+
+	virtual void Cancel() override;
+
+private:
+	void HandleOutcome(const FSessionSearchOutcome& Outcome);
+};
+
+/* Which op a USessionOpAsyncAction runs */
+enum class ESessionAsyncOp : uint8
+{
+	Create,
+	Join,
+	Destroy
+};
+
+/**
+ * Latent Blueprint node for create / join / destroy, resolved by the completion of its own op.
+ * The backends can't abort these, cancelling only stops the node from firing.
+ */
+UCLASS()
+class USessionOpAsyncAction : public UCancellableAsyncAction
+{
+	GENERATED_BODY()
+private:
+	TWeakObjectPtr<UNetworkManagerGameInstance> NetworkManager;
+
+	ESessionAsyncOp Op = ESessionAsyncOp::Create;
+
+	int32 PlayerCount = 0;
+
+	bool bIsPrivate = false;
+
+	UPROPERTY()
+	TObjectPtr<USessionSearchResult> SessionResult;
+
+public:
+	/**
+	 * Creates a session
+	 * @param PlayerCount Max amount of players
+	 * @param IsPrivate If the session is private
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Online", meta = (BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject"))
+	static USessionOpAsyncAction* CreateSessionAsync(UObject* WorldContextObject, const int32 PlayerCount, const bool IsPrivate);
+
+	/**
+	 * Joins a session found by a search
+	 * @param SessionResult Session to join
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Online", meta = (BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject"))
+	static USessionOpAsyncAction* JoinSessionAsync(UObject* WorldContextObject, USessionSearchResult* SessionResult);
+
+	/* Destroys the current session */
+	UFUNCTION(BlueprintCallable, Category = "Online", meta = (BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject"))
+	static USessionOpAsyncAction* DestroySessionAsync(UObject* WorldContextObject);
+
+	UPROPERTY(BlueprintAssignable)
+	FSessionAsyncAction_OnOpComplete OnSuccess;
+
+	UPROPERTY(BlueprintAssignable)
+	FSessionAsyncAction_OnOpComplete OnFailure;
+
+	virtual void Activate() override;
+
+private:
+	static USessionOpAsyncAction* Make(UObject* WorldContextObject, const ESessionAsyncOp Op);
+
+	void HandleOutcome(const FSessionOpOutcome& Outcome);
+};
+
+/**
+ * Latent Blueprint node for QuickMatch, OnSuccess fires once joined or hosting.
+ * Cancelling the node cancels the QuickMatch.
+ */
+UCLASS()
+class UQuickMatchAsyncAction : public UCancellableAsyncAction
+{
+	GENERATED_BODY()
+private:
+	TWeakObjectPtr<UNetworkManagerGameInstance> NetworkManager;
+
+	FSessionSearchFilter Filter;
+
+	int32 HostPlayerCount = 0;
+
+	bool bTravel = true;
+
+public:
+	/**
+	 * Joins the best session matching the filter, or hosts one when none turns up in time
+	 * @param Filter Build / map / open slots / privacy / region requirements
+	 * @param HostPlayerCount Max amount of players of the session we host if it comes to that
+	 * @param bTravel Travel into the game map once matched
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Online", meta = (BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject"))
+	static UQuickMatchAsyncAction* QuickMatchAsync(UObject* WorldContextObject, const FSessionSearchFilter& Filter, const int32 HostPlayerCount = 8, const bool bTravel = true);
+
+	UPROPERTY(BlueprintAssignable)
+	FSessionAsyncAction_OnQuickMatchComplete OnSuccess;
+
+	UPROPERTY(BlueprintAssignable)
+	FSessionAsyncAction_OnQuickMatchComplete OnFailure;
+
+	virtual void Activate() override;
+
+	virtual void Cancel() override;
+
+private:
+	void HandleOutcome(const FQuickMatchOutcome& Outcome);
+};
@@ -0,0 +1,592 @@
+//Project Watcher 2024 & Beyond
+
+#include "DictionaryCompressionHandlerComponent.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/ConfigCacheIni.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/BitReader.h"
+#include "Serialization/BitWriter.h"
+#include "WatcherMemory/WatcherMemoryTags.h"
+
+THIRD_PARTY_INCLUDES_START
+#include "zlib.h"
+THIRD_PARTY_INCLUDES_END
+
+DECLARE_LOG_CATEGORY_EXTERN(LogPacketCompression, Log, All);
+DEFINE_LOG_CATEGORY(LogPacketCompression);
+
+DECLARE_STATS_GROUP(TEXT("PacketCompression"), STATGROUP_PacketCompression, STATCAT_Advanced);
+DECLARE_CYCLE_STAT(TEXT("Compress"), STAT_PacketCompression_Compress, STATGROUP_PacketCompression);
+DECLARE_CYCLE_STAT(TEXT("Decompress"), STAT_PacketCompression_Decompress, STATGROUP_PacketCompression);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Outgoing Raw Bytes"), STAT_PacketCompression_RawBytes, STATGROUP_PacketCompression);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Outgoing Sent Bytes"), STAT_PacketCompression_SentBytes, STATGROUP_PacketCompression);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Packets Compressed"), STAT_PacketCompression_Compressed, STATGROUP_PacketCompression);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Packets Sent Raw"), STAT_PacketCompression_Raw, STATGROUP_PacketCompression);
+
+namespace PacketCompression
+{
+	/* Config section shared by both ends of the connection */
+	static const TCHAR* ConfigSection = TEXT("DictionaryCompression");
+
+	/* Bumped when the packet format changes so old and new builds don't agree on compressing */
+	static constexpr uint32 ProtocolVersion = 1;
+
+	/* Handshake bit + config hash + peer confirmation bit + compressed bit */
+	static constexpr int32 HeaderBits = 1 + 32 + 1 + 1;
+
+	static int32 CapturePackets = 0;
+	static FAutoConsoleVariableRef CVarCapturePackets(
+		TEXT("Watcher.Net.CapturePackets"),
+		CapturePackets,
+		TEXT("Records raw outgoing game packets to Saved/PacketCaptures for dictionary training."),
+		FConsoleVariableDelegate::CreateLambda([](IConsoleVariable* Variable)
+		{
+			//Turning it off finishes the file so it can be trained on right away
+			if (Variable->GetInt() == 0)
+			{
+				FPacketCaptureRecorder::Get().Stop();
+			}
+		}));
+
+	/* Process wide totals so ratio / cost survive connections coming and going */
+	static std::atomic<int64> TotalRawBytes = 0;
+	static std::atomic<int64> TotalSentBytes = 0;
+	static std::atomic<int64> TotalCompressCycles = 0;
+	static std::atomic<int64> TotalDecompressCycles = 0;
+	static std::atomic<int64> TotalPackets = 0;
+
+	static FString GetDictionaryPath()
+	{
+		FString DictionaryPath = TEXT("Content/Net/PacketDictionary.bin");
+		GConfig->GetString(ConfigSection, TEXT("DictionaryPath"), DictionaryPath, GEngineIni);
+		return FPaths::Combine(FPaths::ProjectDir(), DictionaryPath);
+	}
+}
+
+FDictionaryCompressionHandlerComponent::FDictionaryCompressionHandlerComponent()
+	: HandlerComponent(FName(TEXT("DictionaryCompressionHandlerComponent")))
+{
+}
+
+FDictionaryCompressionHandlerComponent::~FDictionaryCompressionHandlerComponent()
+{
+	this->ReleaseStreams();
+}
+
+void FDictionaryCompressionHandlerComponent::Initialize()
+{
+	LLM_SCOPE_BYTAG(Watcher_Networking);
+
+	GConfig->GetBool(PacketCompression::ConfigSection, TEXT("bEnableCompression"), this->bEnableCompression, GEngineIni);
+	GConfig->GetInt(PacketCompression::ConfigSection, TEXT("CompressionLevel"), this->CompressionLevel, GEngineIni);
+	this->CompressionLevel = FMath::Clamp(this->CompressionLevel, 1, 9);
+
+	//Disabled, packets only carry the header and the capture runs
+	if (this->bEnableCompression)
+	{
+		const FString DictionaryPath = PacketCompression::GetDictionaryPath();
+		if (!FFileHelper::LoadFileToArray(this->Dictionary, *DictionaryPath, FILEREAD_Silent))
+		{
+			UE_LOG(LogPacketCompression, Log, TEXT("No packet dictionary at %s, compressing without one"), *DictionaryPath);
+		}
+
+		if (!this->InitStreams())
+		{
+			UE_LOG(LogPacketCompression, Error, TEXT("zlib failed to initialize, packet compression is disabled for this connection"));
+			this->ReleaseStreams();
+			this->bStreamsFailed = true;
+		}
+	}
+
+	//Hash 0 tells the peer we won't compress or decompress, any other value has to match exactly
+	if (this->bEnableCompression && !this->bStreamsFailed)
+	{
+		this->LocalConfigHash = FCrc::MemCrc32(this->Dictionary.GetData(), this->Dictionary.Num(), PacketCompression::ProtocolVersion);
+		this->LocalConfigHash = this->LocalConfigHash != 0 ? this->LocalConfigHash : 1;
+	}
+
+	//Stays active either way, the peer expects the header on every packet
+	SetActive(true);
+	SetState(UE::Handler::Component::State::Initialized);
+	Initialized();
+}
+
+bool FDictionaryCompressionHandlerComponent::IsValid() const
+{
+	//A failed zlib init only turns compression off, the handshake tells the peer
+	return true;
+}
+
+bool FDictionaryCompressionHandlerComponent::ReadHandshake(FBitReader& Packet)
+{
+	const bool bHandshake = !!Packet.ReadBit();
+	this->bPeerHandshaking = bHandshake;
+	if (!bHandshake)
+	{
+		return !Packet.IsError();
+	}
+
+	uint32 PeerConfigHash = 0;
+	Packet << PeerConfigHash;
+	const bool bPeerGotOurs = !!Packet.ReadBit();
+	if (Packet.IsError())
+	{
+		return false;
+	}
+
+	this->bPeerReceivedConfig |= bPeerGotOurs;
+	if (!this->bReceivedPeerConfig)
+	{
+		this->bReceivedPeerConfig = true;
+		this->bCompressionAgreed = this->LocalConfigHash != 0 && PeerConfigHash == this->LocalConfigHash;
+		if (this->bCompressionAgreed)
+		{
+			UE_LOG(LogPacketCompression, Log, TEXT("Peer agreed on packet compression (dictionary %08x)"), this->LocalConfigHash);
+		}
+		else if (this->LocalConfigHash != PeerConfigHash)
+		{
+			UE_LOG(LogPacketCompression, Warning, TEXT("Peer packet compression config %08x doesn't match ours %08x (bEnableCompression, dictionary or zlib init differ), sending raw packets"),
+				PeerConfigHash, this->LocalConfigHash);
+		}
+	}
+	return true;
+}
+
+bool FDictionaryCompressionHandlerComponent::ShouldSendHandshake() const
+{
+	//Keep answering while the peer is still sending its own, our confirmation may have been lost
+	return !this->bReceivedPeerConfig || !this->bPeerReceivedConfig || this->bPeerHandshaking;
+}
+
+bool FDictionaryCompressionHandlerComponent::InitStreams()
+{
+	//Window just big enough for the dictionary plus a whole packet so every match stays in reach,
+	//the per packet copy of the primed stream shrinks with it
+	const int32 WindowBits = FMath::Clamp(static_cast<int32>(FMath::CeilLogTwo(static_cast<uint32>(this->Dictionary.Num() + MAX_PACKET_SIZE))), 9, MAX_WBITS);
+	const int32 MemLevel = FMath::Clamp(WindowBits - 7, 1, MAX_MEM_LEVEL);
+
+	//Deflate state, window, prev, head and pending buffers, with room to spare for the state struct and alignment
+	this->PrimedArena.Memory.SetNumUninitialized(16 * 1024 + (1 << WindowBits) * 4 + (1 << (MemLevel + 7)) * 2 + (1 << (MemLevel + 6)) * 5);
+	this->PrimedArena.Used = 0;
+
+	//Raw deflate, the packet flag replaces the zlib header
+	this->PrimedDeflateStream = new z_stream();
+	FMemory::Memzero(*this->PrimedDeflateStream);
+	this->PrimedDeflateStream->zalloc = &FDictionaryCompressionHandlerComponent::ZlibArenaAlloc;
+	this->PrimedDeflateStream->zfree = &FDictionaryCompressionHandlerComponent::ZlibArenaFree;
+	this->PrimedDeflateStream->opaque = &this->PrimedArena;
+	const int32 DeflateResult = deflateInit2(this->PrimedDeflateStream, this->CompressionLevel, Z_DEFLATED, -WindowBits, MemLevel, Z_DEFAULT_STRATEGY);
+	if (DeflateResult != Z_OK)
+	{
+		UE_LOG(LogPacketCompression, Error, TEXT("deflateInit2 failed (%d)"), DeflateResult);
+		return false;
+	}
+
+	//Hashed once here, every packet starts from a copy of this state
+	if (this->Dictionary.Num() > 0 && deflateSetDictionary(this->PrimedDeflateStream, this->Dictionary.GetData(), this->Dictionary.Num()) != Z_OK)
+	{
+		UE_LOG(LogPacketCompression, Error, TEXT("deflateSetDictionary failed"));
+		return false;
+	}
+
+	//Copies allocate through the source's opaque, point it at the packet arena which needs exactly what the primed stream took
+	this->PacketArena.Memory.SetNumUninitialized(this->PrimedArena.Used);
+	this->PrimedDeflateStream->opaque = &this->PacketArena;
+	this->DeflateStream = new z_stream();
+	FMemory::Memzero(*this->DeflateStream);
+
+	this->InflateStream = new z_stream();
+	FMemory::Memzero(*this->InflateStream);
+	const int32 InflateResult = inflateInit2(this->InflateStream, -MAX_WBITS);
+	if (InflateResult != Z_OK)
+	{
+		UE_LOG(LogPacketCompression, Error, TEXT("inflateInit2 failed (%d)"), InflateResult);
+		return false;
+	}
+
+	return true;
+}
+
+void FDictionaryCompressionHandlerComponent::ReleaseStreams()
+{
+	//deflateEnd / inflateEnd only report an error for streams that never finished initializing
+	if (this->PrimedDeflateStream)
+	{
+		deflateEnd(this->PrimedDeflateStream);
+		delete this->PrimedDeflateStream;
+		this->PrimedDeflateStream = nullptr;
+	}
+
+	//Its state lives in PacketArena, nothing to end
+	delete this->DeflateStream;
+	this->DeflateStream = nullptr;
+
+	if (this->InflateStream)
+	{
+		inflateEnd(this->InflateStream);
+		delete this->InflateStream;
+		this->InflateStream = nullptr;
+	}
+}
+
+void* FDictionaryCompressionHandlerComponent::ZlibArenaAlloc(void* Opaque, unsigned int Items, unsigned int Size)
+{
+	FZlibArena& Arena = *static_cast<FZlibArena*>(Opaque);
+	const int64 Offset = Align(static_cast<int64>(Arena.Used), 16);
+	const int64 Bytes = static_cast<int64>(Items) * Size;
+	if (Offset + Bytes > Arena.Memory.Num())
+	{
+		//zlib reports Z_MEM_ERROR, the packet goes out raw
+		return nullptr;
+	}
+
+	Arena.Used = static_cast<int32>(Offset + Bytes);
+	return Arena.Memory.GetData() + Offset;
+}
+
+void FDictionaryCompressionHandlerComponent::Incoming(FIncomingPacketRef PacketRef)
+{
+	FBitReader& Packet = PacketRef.Packet;
+	if (Packet.GetBitsLeft() <= 0)
+	{
+		return;
+	}
+
+	if (!this->ReadHandshake(Packet))
+	{
+		Packet.SetError();
+		return;
+	}
+
+	const bool bCompressed = !!Packet.ReadBit();
+	if (!bCompressed || Packet.IsError())
+	{
+		//Raw packets just continue from after the header
+		return;
+	}
+
+	//The peer only compresses after seeing our matching hash, anything else is corrupt
+	if (this->LocalConfigHash == 0)
+	{
+		Packet.SetError();
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_PacketCompression_Decompress);
+	const uint32 StartCycles = FPlatformTime::Cycles();
+
+	uint32 UncompressedBits = 0;
+	Packet.SerializeIntPacked(UncompressedBits);
+
+	const int64 CompressedBits = Packet.GetBitsLeft();
+	if (Packet.IsError() || CompressedBits <= 0 || UncompressedBits == 0 || UncompressedBits > MAX_PACKET_SIZE * 8)
+	{
+		Packet.SetError();
+		return;
+	}
+
+	const int32 CompressedBytes = static_cast<int32>(CompressedBits / 8);
+	this->CompressedBuffer.SetNumUninitialized(CompressedBytes, EAllowShrinking::No);
+	Packet.SerializeBits(this->CompressedBuffer.GetData(), CompressedBytes * 8);
+
+	const int32 UncompressedBytes = static_cast<int32>((UncompressedBits + 7) / 8);
+	if (!this->Decompress(this->CompressedBuffer.GetData(), CompressedBytes, UncompressedBytes))
+	{
+		UE_LOG(LogPacketCompression, Warning, TEXT("Dropping packet that failed to decompress, are both ends using the same dictionary?"));
+		Packet.SetError();
+		return;
+	}
+
+	FBitReader DecompressedPacket(this->DecompressedBuffer.GetData(), UncompressedBits);
+	Packet = DecompressedPacket;
+
+	PacketCompression::TotalDecompressCycles += FPlatformTime::Cycles() - StartCycles;
+}
+
+void FDictionaryCompressionHandlerComponent::Outgoing(FBitWriter& Packet, FOutPacketTraits& Traits)
+{
+	const int64 PacketBits = Packet.GetNumBits();
+	const int32 PacketBytes = static_cast<int32>(Packet.GetNumBytes());
+
+	if (PacketCompression::CapturePackets != 0)
+	{
+		FPacketCaptureRecorder::Get().Record(Packet.GetData(), PacketBytes);
+	}
+
+	FBitWriter ProcessedPacket(PacketBits + GetReservedPacketBits() + 64, true);
+
+	const bool bSendHandshake = this->ShouldSendHandshake();
+	ProcessedPacket.WriteBit(bSendHandshake ? 1 : 0);
+	if (bSendHandshake)
+	{
+		uint32 ConfigHash = this->LocalConfigHash;
+		ProcessedPacket << ConfigHash;
+		ProcessedPacket.WriteBit(this->bReceivedPeerConfig ? 1 : 0);
+	}
+
+	int32 CompressedBytes = INDEX_NONE;
+	if (this->bCompressionAgreed && PacketBits > 0)
+	{
+		SCOPE_CYCLE_COUNTER(STAT_PacketCompression_Compress);
+		const uint32 StartCycles = FPlatformTime::Cycles();
+		CompressedBytes = this->Compress(Packet.GetData(), PacketBytes);
+		PacketCompression::TotalCompressCycles += FPlatformTime::Cycles() - StartCycles;
+	}
+
+	//Packed size has to pay for itself
+	uint32 UncompressedBits = static_cast<uint32>(PacketBits);
+	const bool bSendCompressed = CompressedBytes != INDEX_NONE && (CompressedBytes * 8 + 40) < PacketBits;
+
+	ProcessedPacket.WriteBit(bSendCompressed ? 1 : 0);
+	if (bSendCompressed)
+	{
+		ProcessedPacket.SerializeIntPacked(UncompressedBits);
+		ProcessedPacket.Serialize(this->CompressedBuffer.GetData(), CompressedBytes);
+		INC_DWORD_STAT(STAT_PacketCompression_Compressed);
+	}
+	else
+	{
+		ProcessedPacket.SerializeBits(Packet.GetData(), PacketBits);
+		INC_DWORD_STAT(STAT_PacketCompression_Raw);
+	}
+
+	INC_DWORD_STAT_BY(STAT_PacketCompression_RawBytes, PacketBytes);
+	INC_DWORD_STAT_BY(STAT_PacketCompression_SentBytes, ProcessedPacket.GetNumBytes());
+	PacketCompression::TotalRawBytes += PacketBytes;
+	PacketCompression::TotalSentBytes += ProcessedPacket.GetNumBytes();
+	PacketCompression::TotalPackets++;
+
+	Packet = MoveTemp(ProcessedPacket);
+}
+
+int32 FDictionaryCompressionHandlerComponent::GetReservedPacketBits() const
+{
+	//Worst case is a raw packet behind the full handshake, compressed ones are only sent when smaller
+	return PacketCompression::HeaderBits;
+}
+
+int32 FDictionaryCompressionHandlerComponent::Compress(const uint8* Source, const int32 SourceBytes)
+{
+	//Starting from a copy of the primed stream skips resetting and rehashing the dictionary for every packet
+	this->PacketArena.Used = 0;
+	if (deflateCopy(this->DeflateStream, this->PrimedDeflateStream) != Z_OK)
+	{
+		return INDEX_NONE;
+	}
+
+	this->CompressedBuffer.SetNumUninitialized(static_cast<int32>(deflateBound(this->DeflateStream, SourceBytes)), EAllowShrinking::No);
+
+	this->DeflateStream->next_in = const_cast<Bytef*>(Source);
+	this->DeflateStream->avail_in = SourceBytes;
+	this->DeflateStream->next_out = this->CompressedBuffer.GetData();
+	this->DeflateStream->avail_out = this->CompressedBuffer.Num();
+
+	if (deflate(this->DeflateStream, Z_FINISH) != Z_STREAM_END)
+	{
+		return INDEX_NONE;
+	}
+
+	return static_cast<int32>(this->DeflateStream->total_out);
+}
+
+bool FDictionaryCompressionHandlerComponent::Decompress(const uint8* Source, const int32 SourceBytes, const int32 ExpectedBytes)
+{
+	inflateReset(this->InflateStream);
+	if (this->Dictionary.Num() > 0)
+	{
+		inflateSetDictionary(this->InflateStream, this->Dictionary.GetData(), this->Dictionary.Num());
+	}
+
+	this->DecompressedBuffer.SetNumUninitialized(ExpectedBytes, EAllowShrinking::No);
+
+	this->InflateStream->next_in = const_cast<Bytef*>(Source);
+	this->InflateStream->avail_in = SourceBytes;
+	this->InflateStream->next_out = this->DecompressedBuffer.GetData();
+	this->InflateStream->avail_out = ExpectedBytes;
+
+	const int32 Result = inflate(this->InflateStream, Z_FINISH);
+	return Result == Z_STREAM_END && static_cast<int32>(this->InflateStream->total_out) == ExpectedBytes;
+}
+
+TSharedPtr<HandlerComponent> UDictionaryCompressionComponentFactory::CreateComponentInstance(FString& Options)
+{
+	return MakeShared<FDictionaryCompressionHandlerComponent>();
+}
+
+//Capture / Training//
+
+FPacketCaptureRecorder& FPacketCaptureRecorder::Get()
+{
+	static FPacketCaptureRecorder Recorder;
+	return Recorder;
+}
+
+FPacketCaptureRecorder::~FPacketCaptureRecorder()
+{
+	this->Stop();
+}
+
+void FPacketCaptureRecorder::Stop()
+{
+	FScopeLock ScopeLock(&this->Lock);
+	if (this->CaptureWriter.IsValid())
+	{
+		this->CaptureWriter->Close();
+		this->CaptureWriter.Reset();
+	}
+}
+
+void FPacketCaptureRecorder::Record(const uint8* Data, const int32 NumBytes)
+{
+	if (NumBytes <= 0 || NumBytes > MAX_uint16)
+	{
+		return;
+	}
+
+	FScopeLock ScopeLock(&this->Lock);
+	if (!this->CaptureWriter.IsValid())
+	{
+		const FString FileName = FPaths::Combine(GetCaptureDirectory(), FString::Printf(TEXT("Capture_%s_%s.bin"),
+			IsRunningDedicatedServer() ? TEXT("Server") : TEXT("Client"), *FDateTime::Now().ToString()));
+		this->CaptureWriter.Reset(IFileManager::Get().CreateFileWriter(*FileName));
+		if (!this->CaptureWriter.IsValid())
+		{
+			return;
+		}
+		UE_LOG(LogPacketCompression, Display, TEXT("Capturing packets to %s"), *FileName);
+	}
+
+	uint16 RecordSize = static_cast<uint16>(NumBytes);
+	*this->CaptureWriter << RecordSize;
+	this->CaptureWriter->Serialize(const_cast<uint8*>(Data), NumBytes);
+}
+
+bool FPacketCaptureRecorder::TrainDictionary(const int32 MaxDictionaryBytes, TArray<uint8>& OutDictionary)
+{
+	//Repeated byte sequences across packets are what the preset dictionary can remove, so count fixed length
+	//n-grams over every captured packet and keep the ones shared by the most packets. Overlapping grams aren't merged,
+	//a sequence longer than GramLength can end up in the dictionary as several shifted copies
+	constexpr int32 GramLength = 8;
+
+	//The open capture is still buffered, finish it so its packets count
+	Get().Stop();
+
+	TArray<FString> CaptureFiles;
+	IFileManager::Get().FindFiles(CaptureFiles, *FPaths::Combine(GetCaptureDirectory(), TEXT("*.bin")), true, false);
+
+	TMap<uint64, int32> GramCounts;
+	int64 TotalBytes = 0;
+	for (const FString& CaptureFile : CaptureFiles)
+	{
+		TArray<uint8> FileData;
+		if (!FFileHelper::LoadFileToArray(FileData, *FPaths::Combine(GetCaptureDirectory(), CaptureFile)))
+		{
+			continue;
+		}
+
+		int32 Offset = 0;
+		while (Offset + 2 <= FileData.Num())
+		{
+			const int32 RecordSize = FileData[Offset] | (FileData[Offset + 1] << 8);
+			Offset += 2;
+			if (Offset + RecordSize > FileData.Num())
+			{
+				break;
+			}
+
+			TSet<uint64> SeenInPacket;
+			for (int32 Index = 0; Index + GramLength <= RecordSize; ++Index)
+			{
+				uint64 Gram = 0;
+				FMemory::Memcpy(&Gram, FileData.GetData() + Offset + Index, GramLength);
+				//Count each gram once per packet, we care about how many packets share it
+				bool bAlreadySeen = false;
+				SeenInPacket.Add(Gram, &bAlreadySeen);
+				if (!bAlreadySeen)
+				{
+					GramCounts.FindOrAdd(Gram)++;
+				}
+			}
+
+			TotalBytes += RecordSize;
+			Offset += RecordSize;
+		}
+	}
+
+	if (GramCounts.Num() == 0)
+	{
+		return false;
+	}
+
+	GramCounts.ValueSort([](const int32 A, const int32 B) { return A > B; });
+
+	TArray<uint64> Selected;
+	const int32 MaxGrams = MaxDictionaryBytes / GramLength;
+	for (const TPair<uint64, int32>& Pair : GramCounts)
+	{
+		if (Pair.Value < 2 || Selected.Num() >= MaxGrams)
+		{
+			break;
+		}
+		Selected.Add(Pair.Key);
+	}
+
+	//zlib matches closer to the end of the dictionary with shorter distances, so most frequent goes last
+	OutDictionary.Reset(Selected.Num() * GramLength);
+	for (int32 Index = Selected.Num() - 1; Index >= 0; --Index)
+	{
+		OutDictionary.Append(reinterpret_cast<const uint8*>(&Selected[Index]), GramLength);
+	}
+
+	UE_LOG(LogPacketCompression, Display, TEXT("Trained %d byte dictionary from %d capture files (%lld bytes, %d distinct grams)"),
+		OutDictionary.Num(), CaptureFiles.Num(), TotalBytes, GramCounts.Num());
+	return OutDictionary.Num() > 0;
+}
+
+FString FPacketCaptureRecorder::GetCaptureDirectory()
+{
+	return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("PacketCaptures"));
+}
+
+static FAutoConsoleCommand GTrainPacketDictionaryCommand(
+	TEXT("Watcher.Net.TrainPacketDictionary"),
+	TEXT("Trains the packet compression dictionary from Saved/PacketCaptures. Args: [MaxBytes=16384]"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		const int32 MaxBytes = FMath::Clamp(Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 16384, 256, 32768);
+
+		TArray<uint8> Dictionary;
+		if (!FPacketCaptureRecorder::TrainDictionary(MaxBytes, Dictionary))
+		{
+			UE_LOG(LogPacketCompression, Warning, TEXT("Not enough captured packets to train a dictionary, run with Watcher.Net.CapturePackets 1 first"));
+			return;
+		}
+
+		const FString DictionaryPath = PacketCompression::GetDictionaryPath();
+		if (FFileHelper::SaveArrayToFile(Dictionary, *DictionaryPath))
+		{
+			UE_LOG(LogPacketCompression, Display, TEXT("Wrote dictionary to %s, ship it with both client and server"), *DictionaryPath);
+		}
+	}));
+
+static FAutoConsoleCommand GPacketCompressionStatsCommand(
+	TEXT("Watcher.Net.CompressionStats"),
+	TEXT("Logs the packet compression ratio and CPU cost since startup."),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+		const int64 RawBytes = PacketCompression::TotalRawBytes;
+		const int64 SentBytes = PacketCompression::TotalSentBytes;
+		const int64 Packets = FMath::Max<int64>(PacketCompression::TotalPackets, 1);
+		const double CompressMs = FPlatformTime::ToMilliseconds64(PacketCompression::TotalCompressCycles);
+		const double DecompressMs = FPlatformTime::ToMilliseconds64(PacketCompression::TotalDecompressCycles);
+
+		UE_LOG(LogPacketCompression, Display, TEXT("Packets %lld, raw %lld bytes, sent %lld bytes, ratio %.3f"),
+			PacketCompression::TotalPackets.load(), RawBytes, SentBytes, RawBytes > 0 ? static_cast<double>(SentBytes) / RawBytes : 1.0);
+		UE_LOG(LogPacketCompression, Display, TEXT("Compress %.3f ms total (%.2f us/packet), decompress %.3f ms total"),
+			CompressMs, CompressMs * 1000.0 / Packets, DecompressMs);
+	}));
+
+//Capture / Training//
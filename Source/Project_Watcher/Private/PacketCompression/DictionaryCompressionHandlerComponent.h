@@ -0,0 +1,160 @@
+//Project Watcher 2024 & Beyond
+
+#pragma once
+#include "CoreMinimal.h"
+#include "PacketHandler.h"
+#include "DictionaryCompressionHandlerComponent.generated.h"
+
+struct z_stream_s;
+
+/**
+ * Packet handler component that deflates outgoing packets against a preset dictionary trained on our own traffic.
+ *
+ * Every packet starts with a handshake bit and a compressed bit. Until both ends know each other's config the handshake
+ * bit is set and followed by the config hash (0 when bEnableCompression in [DictionaryCompression] is off or zlib failed
+ * to initialize, the dictionary CRC otherwise) and whether the peer's hash has arrived yet. A side only compresses once
+ * the peer's hash matches its own, so mismatched settings, dictionaries or a failed zlib init fall back to sending raw
+ * packets instead of corrupting the connection. Only compresses when it actually saves space.
+ * The component can stay in the handler profile with compression off and still be used to capture training data.
+ */
+class FDictionaryCompressionHandlerComponent : public HandlerComponent
+{
+public:
+	FDictionaryCompressionHandlerComponent();
+
+	virtual ~FDictionaryCompressionHandlerComponent() override;
+
+	//HandlerComponent//
+
+	virtual void Initialize() override;
+
+	virtual bool IsValid() const override;
+
+	virtual void Incoming(FIncomingPacketRef PacketRef) override;
+
+	virtual void Outgoing(FBitWriter& Packet, FOutPacketTraits& Traits) override;
+
+	virtual void IncomingConnectionless(FIncomingPacketRef PacketRef) override {}
+
+	virtual void OutgoingConnectionless(const TSharedPtr<const FInternetAddr>& Address, FBitWriter& Packet, FOutPacketTraits& Traits) override {}
+
+	virtual int32 GetReservedPacketBits() const override;
+
+	//HandlerComponent//
+
+private:
+
+	/* Sets up the primed deflate stream and the inflate stream, returns false if zlib refused either */
+	bool InitStreams();
+
+	/* Frees both streams */
+	void ReleaseStreams();
+
+	/* Reads the handshake in front of an incoming packet, returns false if the packet is malformed */
+	bool ReadHandshake(FBitReader& Packet);
+
+	/* If the handshake still has to go out with the next packet */
+	bool ShouldSendHandshake() const;
+
+	/* zalloc / zfree of the arena backed streams, Opaque is the FZlibArena */
+	static void* ZlibArenaAlloc(void* Opaque, unsigned int Items, unsigned int Size);
+	static void ZlibArenaFree(void* Opaque, void* Address) {}
+
+	/* Deflates Source into CompressedBuffer, returns the compressed size or INDEX_NONE */
+	int32 Compress(const uint8* Source, const int32 SourceBytes);
+
+	/* Inflates Source into DecompressedBuffer, returns false on corrupt input */
+	bool Decompress(const uint8* Source, const int32 SourceBytes, const int32 ExpectedBytes);
+
+	/* Compression wanted by our config, only used once the peer's handshake agrees */
+	bool bEnableCompression = false;
+
+	/* Set when zlib refused to initialize, we then advertise compression as off */
+	bool bStreamsFailed = false;
+
+	/* Dictionary CRC we advertise, 0 when we can't compress */
+	uint32 LocalConfigHash = 0;
+
+	/* Set once the peer's handshake arrived */
+	bool bReceivedPeerConfig = false;
+
+	/* Set once the peer confirmed it received our handshake */
+	bool bPeerReceivedConfig = false;
+
+	/* The last packet from the peer still carried its handshake, it is waiting on our confirmation */
+	bool bPeerHandshaking = true;
+
+	/* Both ends advertised the same non zero hash */
+	bool bCompressionAgreed = false;
+
+	/* zlib level, packets are small so the fast levels do nearly as well */
+	int32 CompressionLevel = 6;
+
+	/* Trained dictionary shared by both ends of the connection */
+	TArray<uint8> Dictionary;
+
+	/* Bump allocator zlib allocates from, so copying the primed stream per packet never touches the heap */
+	struct FZlibArena
+	{
+		TArray<uint8> Memory;
+		int32 Used = 0;
+	};
+
+	/* Deflate stream with the dictionary already hashed in, never compresses anything itself */
+	z_stream_s* PrimedDeflateStream = nullptr;
+
+	/* Per packet copy of PrimedDeflateStream, its state lives in PacketArena */
+	z_stream_s* DeflateStream = nullptr;
+
+	z_stream_s* InflateStream = nullptr;
+
+	FZlibArena PrimedArena;
+	FZlibArena PacketArena;
+
+	TArray<uint8> CompressedBuffer;
+	TArray<uint8> DecompressedBuffer;
+};
+
+/**
+ * Factory referenced from the PacketHandlerProfileConfig Components list
+ */
+UCLASS()
+class UDictionaryCompressionComponentFactory : public UHandlerComponentFactory
+{
+	GENERATED_BODY()
+public:
+	virtual TSharedPtr<HandlerComponent> CreateComponentInstance(FString& Options) override;
+};
+
+/**
+ * Records raw outgoing packets while Watcher.Net.CapturePackets is on so a dictionary can be trained from real sessions.
+ * Captures go to Saved/PacketCaptures as length prefixed records.
+ */
+class FPacketCaptureRecorder
+{
+public:
+	static FPacketCaptureRecorder& Get();
+
+	~FPacketCaptureRecorder();
+
+	/* Appends a packet when capturing is on, thread safe */
+	void Record(const uint8* Data, const int32 NumBytes);
+
+	/* Flushes and closes the current capture file, the next Record starts a new one */
+	void Stop();
+
+	/**
+	 * Builds a dictionary from every capture file on disk
+	 * @param MaxDictionaryBytes zlib uses at most 32KB of dictionary, smaller ones reset faster per packet
+	 * @param OutDictionary The trained dictionary, most useful content last as zlib prefers
+	 * @return If enough captured data was found
+	 */
+	static bool TrainDictionary(const int32 MaxDictionaryBytes, TArray<uint8>& OutDictionary);
+
+	/* Folder the captures are written to */
+	static FString GetCaptureDirectory();
+
+private:
+	FCriticalSection Lock;
+	TUniquePtr<FArchive> CaptureWriter;
+};
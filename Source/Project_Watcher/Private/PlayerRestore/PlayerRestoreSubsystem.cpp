@@ -0,0 +1,116 @@
+//Project Watcher 2024 & Beyond
+
+#include "PlayerRestoreSubsystem.h"
+#include "GameFramework/GameModeBase.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
+
+DECLARE_LOG_CATEGORY_EXTERN(LogPlayerRestore, Log, All);
+DEFINE_LOG_CATEGORY(LogPlayerRestore);
+
+void UPlayerRestoreSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+	this->PostLoginHandle = FGameModeEvents::GameModePostLoginEvent.AddUObject(this, &ThisClass::OnPostLogin);
+}
+
+void UPlayerRestoreSubsystem::Deinitialize()
+{
+	FGameModeEvents::GameModePostLoginEvent.Remove(this->PostLoginHandle);
+
+	for (const TPair<TWeakObjectPtr<APlayerController>, FDelegateHandle>& Pair : this->PawnWaits)
+	{
+		if (APlayerController* PlayerController = Pair.Key.Get())
+		{
+			PlayerController->GetOnNewPawnNotifier().Remove(Pair.Value);
+		}
+	}
+	this->PawnWaits.Empty();
+	this->PendingRestores.Empty();
+
+	Super::Deinitialize();
+}
+
+void UPlayerRestoreSubsystem::AddPendingRestore(const FString& PlayerId, const FPlayerRestoreData& Data, const float TimeToLive)
+{
+	if (PlayerId.IsEmpty())
+	{
+		return;
+	}
+
+	FPendingRestore& Pending = this->PendingRestores.FindOrAdd(PlayerId);
+	Pending.Data = Data;
+	Pending.ExpiresAt = FPlatformTime::Seconds() + TimeToLive;
+}
+
+void UPlayerRestoreSubsystem::ClearPendingRestores()
+{
+	this->PendingRestores.Empty();
+}
+
+int32 UPlayerRestoreSubsystem::GetNumPendingRestores() const
+{
+	return this->PendingRestores.Num();
+}
+
+void UPlayerRestoreSubsystem::OnPostLogin(AGameModeBase* GameMode, APlayerController* NewPlayer)
+{
+	if (!NewPlayer || this->PendingRestores.IsEmpty())
+	{
+		return;
+	}
+
+	//The pawn usually doesn't exist yet at PostLogin, wait for the possession
+	if (this->TryRestore(NewPlayer, NewPlayer->GetPawn()))
+	{
+		return;
+	}
+
+	const TWeakObjectPtr<APlayerController> WeakController(NewPlayer);
+	this->PawnWaits.Add(WeakController, NewPlayer->GetOnNewPawnNotifier().AddUObject(this, &ThisClass::OnNewPawn, WeakController));
+}
+
+void UPlayerRestoreSubsystem::OnNewPawn(APawn* NewPawn, TWeakObjectPtr<APlayerController> WeakController)
+{
+	APlayerController* PlayerController = WeakController.Get();
+	if (!PlayerController || !NewPawn)
+	{
+		return;
+	}
+
+	if (this->TryRestore(PlayerController, NewPawn))
+	{
+		FDelegateHandle Handle;
+		if (this->PawnWaits.RemoveAndCopyValue(WeakController, Handle))
+		{
+			PlayerController->GetOnNewPawnNotifier().Remove(Handle);
+		}
+	}
+}
+
+bool UPlayerRestoreSubsystem::TryRestore(APlayerController* PlayerController, APawn* Pawn)
+{
+	if (!Pawn || !PlayerController->PlayerState)
+	{
+		return false;
+	}
+
+	const FString PlayerId = PlayerController->PlayerState->GetUniqueId().ToString();
+	FPendingRestore Pending;
+	if (!this->PendingRestores.RemoveAndCopyValue(PlayerId, Pending))
+	{
+		return false;
+	}
+
+	if (Pending.ExpiresAt < FPlatformTime::Seconds())
+	{
+		UE_LOG(LogPlayerRestore, Verbose, TEXT("Restore for %s expired"), *PlayerId);
+		return true;
+	}
+
+	Pawn->TeleportTo(Pending.Data.Location, Pending.Data.Rotation);
+	PlayerController->ClientSetRotation(Pending.Data.ControlRotation);
+	UE_LOG(LogPlayerRestore, Display, TEXT("Restored %s to %s"), *PlayerId, *Pending.Data.Location.ToString());
+	return true;
+}
@@ -0,0 +1,96 @@
+//Project Watcher 2024 & Beyond
+
+#pragma once
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "PlayerRestoreSubsystem.generated.h"
+
+class AGameModeBase;
+class APawn;
+class APlayerController;
+
+//Wrapper for BP data//
+
+/* Authoritative player state that gets put back when the player (re)logs in on this server */
+USTRUCT(BlueprintType)
+struct FPlayerRestoreData
+{
+	GENERATED_USTRUCT_BODY()
+public:
+	UPROPERTY(BlueprintReadWrite, Category = "Player Restore")
+	FVector_NetQuantize Location = FVector::ZeroVector;
+	UPROPERTY(BlueprintReadWrite, Category = "Player Restore")
+	FRotator Rotation = FRotator::ZeroRotator;
+	UPROPERTY(BlueprintReadWrite, Category = "Player Restore")
+	FRotator ControlRotation = FRotator::ZeroRotator;
+};
+
+//Wrapper for BP data//
+
+/**
+ * Server side store of player state keyed by unique net id.
+ * Whoever knows where a player should be (a migration snapshot, a player that just dropped) adds an entry,
+ * the next time that player logs in and gets a pawn it is moved back into place.
+ */
+UCLASS()
+class UPlayerRestoreSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+private:
+	struct FPendingRestore
+	{
+		FPlayerRestoreData Data;
+		double ExpiresAt = 0.0;
+	};
+
+	/* Unique net id string -> state to restore */
+	TMap<FString, FPendingRestore> PendingRestores;
+
+	/* Controllers we are waiting on a pawn for */
+	TMap<TWeakObjectPtr<APlayerController>, FDelegateHandle> PawnWaits;
+
+	FDelegateHandle PostLoginHandle;
+
+public:
+
+	//Initialization//
+
+	UPlayerRestoreSubsystem() { }
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	virtual void Deinitialize() override;
+
+	//Initialization//
+
+	//Player Restore Interface calls//
+
+	/**
+	 * Queues state to restore for a player
+	 * @param PlayerId Unique net id string of the player
+	 * @param Data Where the player should be put back
+	 * @param TimeToLive Seconds the entry stays valid
+	 */
+	void AddPendingRestore(const FString& PlayerId, const FPlayerRestoreData& Data, const float TimeToLive);
+
+	/* Drops every queued restore */
+	void ClearPendingRestores();
+
+	/* Amount of players still waiting to be restored */
+	int32 GetNumPendingRestores() const;
+
+	//Player Restore Interface calls//
+
+private:
+
+	//Restore internals//
+
+	void OnPostLogin(AGameModeBase* GameMode, APlayerController* NewPlayer);
+
+	void OnNewPawn(APawn* NewPawn, TWeakObjectPtr<APlayerController> WeakController);
+
+	/* Applies and consumes the entry for the controller's player, returns false if nothing was pending */
+	bool TryRestore(APlayerController* PlayerController, APawn* Pawn);
+
+	//Restore internals//
+};
@@ -0,0 +1,73 @@
+//Project Watcher 2024 & Beyond
+
+#include "ProjectileReplicator.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Engine/World.h"
+
+AProjectileReplicator::AProjectileReplicator()
+{
+	PrimaryActorTick.bCanEverTick = false;
+
+	bReplicates = true;
+	bAlwaysRelevant = true;
+	SetReplicatingMovement(false);
+	//Nothing is property replicated, the RPCs carry all the data. Unreliable multicasts go out with the actor's
+	//next net update, so the subsystem forces one per flushed batch and the rate only bounds the idle case
+	NetUpdateFrequency = 60.f;
+	MinNetUpdateFrequency = 10.f;
+
+	ProjectileInstances = CreateDefaultSubobject<UInstancedStaticMeshComponent>(TEXT("ProjectileInstances"));
+	ProjectileInstances->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	ProjectileInstances->SetCanEverAffectNavigation(false);
+	ProjectileInstances->SetCastShadow(false);
+	ProjectileInstances->SetMobility(EComponentMobility::Movable);
+	RootComponent = ProjectileInstances;
+}
+
+void AProjectileReplicator::MulticastSpawnProjectiles_Implementation(const TArray<FProjectileSpawnParams>& Spawns)
+{
+	//The authority already added these when they were fired
+	if (HasAuthority())
+	{
+		return;
+	}
+
+	if (UProjectileSimulationSubsystem* ProjectileSimulation = GetWorld()->GetSubsystem<UProjectileSimulationSubsystem>())
+	{
+		ProjectileSimulation->ReceiveReplicatedSpawns(Spawns);
+	}
+}
+
+void AProjectileReplicator::MulticastProjectileImpacts_Implementation(const TArray<FProjectileImpactParams>& Impacts)
+{
+	//The authority already removed these when its traces hit
+	if (HasAuthority())
+	{
+		return;
+	}
+
+	if (UProjectileSimulationSubsystem* ProjectileSimulation = GetWorld()->GetSubsystem<UProjectileSimulationSubsystem>())
+	{
+		ProjectileSimulation->ReceiveReplicatedImpacts(Impacts);
+	}
+}
+
+void AProjectileReplicator::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (UProjectileSimulationSubsystem* ProjectileSimulation = GetWorld()->GetSubsystem<UProjectileSimulationSubsystem>())
+	{
+		ProjectileSimulation->RegisterReplicator(this);
+	}
+}
+
+void AProjectileReplicator::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UProjectileSimulationSubsystem* ProjectileSimulation = GetWorld()->GetSubsystem<UProjectileSimulationSubsystem>())
+	{
+		ProjectileSimulation->UnregisterReplicator(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
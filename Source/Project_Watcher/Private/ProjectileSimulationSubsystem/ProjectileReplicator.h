@@ -0,0 +1,49 @@
+//Project Watcher 2024 & Beyond
+
+#pragma once
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "ProjectileSimulationSubsystem.h"
+#include "ProjectileReplicator.generated.h"
+
+class UInstancedStaticMeshComponent;
+
+/**
+ * Single always relevant actor per world that carries projectile spawn and impact events to clients
+ * and owns the instanced mesh every projectile is drawn with.
+ * Spawned by UProjectileSimulationSubsystem on the authority.
+ */
+UCLASS(NotPlaceable, Transient)
+class AProjectileReplicator : public AActor
+{
+	GENERATED_BODY()
+private:
+	/* One instance per in-flight projectile */
+	UPROPERTY(VisibleAnywhere, Category = "Projectile")
+	TObjectPtr<UInstancedStaticMeshComponent> ProjectileInstances;
+
+public:
+	AProjectileReplicator();
+
+	/**
+	 * Sends a batch of projectile spawns to every client
+	 * @param Spawns The deterministic parameters of each projectile
+	 */
+	UFUNCTION(NetMulticast, Unreliable)
+	void MulticastSpawnProjectiles(const TArray<FProjectileSpawnParams>& Spawns);
+
+	/**
+	 * Sends a batch of server decided impacts to every client
+	 * @param Impacts The projectiles that hit something and where
+	 */
+	UFUNCTION(NetMulticast, Unreliable)
+	void MulticastProjectileImpacts(const TArray<FProjectileImpactParams>& Impacts);
+
+	/* Returns the instanced mesh used for projectile visuals */
+	UInstancedStaticMeshComponent* GetProjectileInstances() const { return this->ProjectileInstances; }
+
+protected:
+	virtual void BeginPlay() override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+};
@@ -0,0 +1,518 @@
+//Project Watcher 2024 & Beyond
+
+#include "ProjectileSimulationSubsystem.h"
+#include "ProjectileReplicator.h"
+#include "CollisionQueryParams.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
+#include "GameFramework/GameStateBase.h"
+#include "HAL/IConsoleManager.h"
+#include "Math/VectorRegister.h"
+
+DECLARE_LOG_CATEGORY_EXTERN(LogProjectileSimulation, Log, All);
+DEFINE_LOG_CATEGORY(LogProjectileSimulation);
+
+DECLARE_STATS_GROUP(TEXT("ProjectileSimulation"), STATGROUP_ProjectileSimulation, STATCAT_Advanced);
+DECLARE_CYCLE_STAT(TEXT("Tick"), STAT_Projectile_Tick, STATGROUP_ProjectileSimulation);
+DECLARE_CYCLE_STAT(TEXT("Integrate"), STAT_Projectile_Integrate, STATGROUP_ProjectileSimulation);
+DECLARE_CYCLE_STAT(TEXT("Issue Collision Traces"), STAT_Projectile_Collision, STATGROUP_ProjectileSimulation);
+DECLARE_CYCLE_STAT(TEXT("Update Visuals"), STAT_Projectile_Visuals, STATGROUP_ProjectileSimulation);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Projectiles In Flight"), STAT_Projectile_Num, STATGROUP_ProjectileSimulation);
+
+//Buffer//
+
+void FProjectileBuffer::Add(const FVector& Position, const FVector& Velocity, const float Gravity, const float InitialAge, const uint32 Id, AActor* Instigator)
+{
+	const int32 Index = Ids.Add(Id);
+	Instigators.Add(Instigator);
+
+	const int32 Padded = PaddedNum();
+	FFloatLane* Lanes[] = { &PosX, &PosY, &PosZ, &PrevX, &PrevY, &PrevZ, &VelX, &VelY, &VelZ, &GravityScale, &Age };
+	for (FFloatLane* Lane : Lanes)
+	{
+		if (Lane->Num() < Padded)
+		{
+			Lane->SetNumZeroed(Padded);
+		}
+	}
+
+	PosX[Index] = PrevX[Index] = Position.X;
+	PosY[Index] = PrevY[Index] = Position.Y;
+	PosZ[Index] = PrevZ[Index] = Position.Z;
+	VelX[Index] = Velocity.X;
+	VelY[Index] = Velocity.Y;
+	VelZ[Index] = Velocity.Z;
+	GravityScale[Index] = Gravity;
+	Age[Index] = InitialAge;
+}
+
+void FProjectileBuffer::RemoveAtSwap(const int32 Index)
+{
+	const int32 LastIndex = Num() - 1;
+	FFloatLane* Lanes[] = { &PosX, &PosY, &PosZ, &PrevX, &PrevY, &PrevZ, &VelX, &VelY, &VelZ, &GravityScale, &Age };
+	for (FFloatLane* Lane : Lanes)
+	{
+		(*Lane)[Index] = (*Lane)[LastIndex];
+		(*Lane)[LastIndex] = 0.f;
+	}
+
+	Ids.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	Instigators.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+
+	const int32 Padded = PaddedNum();
+	for (FFloatLane* Lane : Lanes)
+	{
+		Lane->SetNum(Padded, EAllowShrinking::No);
+	}
+}
+
+void FProjectileBuffer::Reset()
+{
+	FFloatLane* Lanes[] = { &PosX, &PosY, &PosZ, &PrevX, &PrevY, &PrevZ, &VelX, &VelY, &VelZ, &GravityScale, &Age };
+	for (FFloatLane* Lane : Lanes)
+	{
+		Lane->Reset();
+	}
+	Ids.Reset();
+	Instigators.Reset();
+}
+
+//Buffer//
+
+void UProjectileSimulationSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+	this->TraceDelegate.BindUObject(this, &ThisClass::OnTraceCompleted);
+}
+
+void UProjectileSimulationSubsystem::Deinitialize()
+{
+	this->ClearProjectiles();
+	this->TraceDelegate.Unbind();
+	Super::Deinitialize();
+}
+
+void UProjectileSimulationSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	if (this->IsAuthority())
+	{
+		FActorSpawnParameters SpawnParameters;
+		SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		SpawnParameters.ObjectFlags |= RF_Transient;
+		InWorld.SpawnActor<AProjectileReplicator>(AProjectileReplicator::StaticClass(), FTransform::Identity, SpawnParameters);
+	}
+}
+
+void UProjectileSimulationSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_Projectile_Tick);
+	Super::Tick(DeltaTime);
+
+	this->FlushReplication();
+	this->Simulate(DeltaTime, true);
+	this->UpdateVisuals();
+}
+
+TStatId UProjectileSimulationSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UProjectileSimulationSubsystem, STATGROUP_Tickables);
+}
+
+int32 UProjectileSimulationSubsystem::FireProjectile(const FVector& Origin, const FVector& Direction, const float Speed, const float GravityScale, AActor* Instigator)
+{
+	if (!this->IsAuthority())
+	{
+		UE_LOG(LogProjectileSimulation, Warning, TEXT("FireProjectile called without authority, projectiles are spawned by the server"));
+		return 0;
+	}
+
+	FProjectileSpawnParams Params;
+	Params.Origin = Origin;
+	Params.Direction = Direction.GetSafeNormal();
+	Params.Speed = Speed;
+	Params.GravityScale = GravityScale;
+	Params.ServerSpawnTime = this->GetServerWorldTime();
+	Params.ProjectileId = this->NextProjectileId++;
+	Params.Instigator = Instigator;
+
+	//Id 0 is reserved for "nothing fired"
+	if (this->NextProjectileId == 0)
+	{
+		this->NextProjectileId = 1;
+	}
+
+	this->AddProjectile(Params, 0.f);
+	this->PendingReplication.Add(Params);
+	return static_cast<int32>(Params.ProjectileId);
+}
+
+int32 UProjectileSimulationSubsystem::GetNumProjectiles() const
+{
+	return this->Buffer.Num();
+}
+
+void UProjectileSimulationSubsystem::Simulate(const float DeltaSeconds, const bool bRunCollision)
+{
+	if (this->Buffer.Num() == 0)
+	{
+		return;
+	}
+
+	this->Integrate(DeltaSeconds);
+	//Clients never trace, their projectiles end when the server's impact arrives or they expire
+	if (bRunCollision && this->IsAuthority())
+	{
+		this->IssueCollisionTraces();
+	}
+	this->RemoveExpired();
+
+	SET_DWORD_STAT(STAT_Projectile_Num, this->Buffer.Num());
+}
+
+int32 UProjectileSimulationSubsystem::TraceAllBlocking() const
+{
+	const UWorld* World = GetWorld();
+	int32 Hits = 0;
+	for (int32 Index = 0; Index < this->Buffer.Num(); ++Index)
+	{
+		const FVector Start(this->Buffer.PrevX[Index], this->Buffer.PrevY[Index], this->Buffer.PrevZ[Index]);
+		const FVector End(this->Buffer.PosX[Index], this->Buffer.PosY[Index], this->Buffer.PosZ[Index]);
+		FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(ProjectileTrace), false, this->Buffer.Instigators[Index].Get());
+		if (World->LineTraceTestByChannel(Start, End, this->TraceChannel, QueryParams))
+		{
+			Hits++;
+		}
+	}
+	return Hits;
+}
+
+void UProjectileSimulationSubsystem::ClearProjectiles()
+{
+	this->Buffer.Reset();
+	this->IdToIndex.Reset();
+	this->PendingReplication.Reset();
+	this->PendingImpacts.Reset();
+	SET_DWORD_STAT(STAT_Projectile_Num, 0);
+}
+
+void UProjectileSimulationSubsystem::RegisterReplicator(AProjectileReplicator* ReplicatorIn)
+{
+	this->Replicator = ReplicatorIn;
+
+	if (GetWorld()->GetNetMode() != NM_DedicatedServer && this->ProjectileMesh.IsValid())
+	{
+		if (UStaticMesh* Mesh = Cast<UStaticMesh>(this->ProjectileMesh.TryLoad()))
+		{
+			this->Replicator->GetProjectileInstances()->SetStaticMesh(Mesh);
+		}
+	}
+}
+
+void UProjectileSimulationSubsystem::UnregisterReplicator(AProjectileReplicator* ReplicatorIn)
+{
+	if (this->Replicator == ReplicatorIn)
+	{
+		this->Replicator = nullptr;
+	}
+}
+
+void UProjectileSimulationSubsystem::ReceiveReplicatedSpawns(const TArray<FProjectileSpawnParams>& Spawns)
+{
+	const double ServerTime = this->GetServerWorldTime();
+	for (const FProjectileSpawnParams& Params : Spawns)
+	{
+		//Fast forward by the latency so the client sees the projectile where the server has it
+		const float Elapsed = FMath::Max(0.f, static_cast<float>(ServerTime - Params.ServerSpawnTime));
+		if (Elapsed < this->MaxLifetime)
+		{
+			this->AddProjectile(Params, Elapsed);
+		}
+	}
+}
+
+void UProjectileSimulationSubsystem::ReceiveReplicatedImpacts(const TArray<FProjectileImpactParams>& Impacts)
+{
+	for (const FProjectileImpactParams& Impact : Impacts)
+	{
+		//The spawn may have been dropped or the projectile already expired locally
+		const int32* Index = this->IdToIndex.Find(Impact.ProjectileId);
+		if (!Index)
+		{
+			continue;
+		}
+
+		AActor* Instigator = this->Buffer.Instigators[*Index].Get();
+		const FVector Start(this->Buffer.PrevX[*Index], this->Buffer.PrevY[*Index], this->Buffer.PrevZ[*Index]);
+		this->RemoveProjectileAt(*Index);
+
+		FHitResult Hit(Impact.HitActor, nullptr, Impact.Location, Impact.Normal);
+		Hit.TraceStart = Start;
+		Hit.TraceEnd = Impact.Location;
+		this->OnProjectileImpactDelegate.Broadcast(Impact.ProjectileId, Instigator, Hit);
+	}
+}
+
+bool UProjectileSimulationSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UProjectileSimulationSubsystem::AddProjectile(const FProjectileSpawnParams& Params, const float InitialAge)
+{
+	const float GravityZ = GetWorld()->GetGravityZ() * Params.GravityScale;
+	const FVector InitialVelocity = FVector(Params.Direction) * Params.Speed;
+
+	//Closed form of the integrator so late joiners land on the same trajectory
+	const FVector Velocity = InitialVelocity + FVector(0.f, 0.f, GravityZ * InitialAge);
+	const FVector Position = FVector(Params.Origin) + InitialVelocity * InitialAge + FVector(0.f, 0.f, 0.5f * GravityZ * InitialAge * InitialAge);
+
+	this->IdToIndex.Add(Params.ProjectileId, this->Buffer.Num());
+	this->Buffer.Add(Position, Velocity, Params.GravityScale, InitialAge, Params.ProjectileId, Params.Instigator);
+}
+
+void UProjectileSimulationSubsystem::RemoveProjectileAt(const int32 Index)
+{
+	const int32 LastIndex = this->Buffer.Num() - 1;
+	this->IdToIndex.Remove(this->Buffer.Ids[Index]);
+	if (Index != LastIndex)
+	{
+		this->IdToIndex.Add(this->Buffer.Ids[LastIndex], Index);
+	}
+	this->Buffer.RemoveAtSwap(Index);
+}
+
+void UProjectileSimulationSubsystem::Integrate(const float DeltaSeconds)
+{
+	SCOPE_CYCLE_COUNTER(STAT_Projectile_Integrate);
+
+	const int32 Padded = this->Buffer.PaddedNum();
+	FMemory::Memcpy(this->Buffer.PrevX.GetData(), this->Buffer.PosX.GetData(), Padded * sizeof(float));
+	FMemory::Memcpy(this->Buffer.PrevY.GetData(), this->Buffer.PosY.GetData(), Padded * sizeof(float));
+	FMemory::Memcpy(this->Buffer.PrevZ.GetData(), this->Buffer.PosZ.GetData(), Padded * sizeof(float));
+
+	float* RESTRICT PosX = this->Buffer.PosX.GetData();
+	float* RESTRICT PosY = this->Buffer.PosY.GetData();
+	float* RESTRICT PosZ = this->Buffer.PosZ.GetData();
+	const float* RESTRICT VelX = this->Buffer.VelX.GetData();
+	const float* RESTRICT VelY = this->Buffer.VelY.GetData();
+	float* RESTRICT VelZ = this->Buffer.VelZ.GetData();
+	const float* RESTRICT Gravity = this->Buffer.GravityScale.GetData();
+	float* RESTRICT Age = this->Buffer.Age.GetData();
+
+	const VectorRegister4Float Delta = VectorSetFloat1(DeltaSeconds);
+	const VectorRegister4Float GravityStep = VectorSetFloat1(GetWorld()->GetGravityZ() * DeltaSeconds);
+
+	//Padding lanes are zeroed so they integrate to zero and never need masking
+	for (int32 Index = 0; Index < Padded; Index += 4)
+	{
+		const VectorRegister4Float NewVelZ = VectorMultiplyAdd(VectorLoadAligned(Gravity + Index), GravityStep, VectorLoadAligned(VelZ + Index));
+		VectorStoreAligned(NewVelZ, VelZ + Index);
+
+		VectorStoreAligned(VectorMultiplyAdd(VectorLoadAligned(VelX + Index), Delta, VectorLoadAligned(PosX + Index)), PosX + Index);
+		VectorStoreAligned(VectorMultiplyAdd(VectorLoadAligned(VelY + Index), Delta, VectorLoadAligned(PosY + Index)), PosY + Index);
+		VectorStoreAligned(VectorMultiplyAdd(NewVelZ, Delta, VectorLoadAligned(PosZ + Index)), PosZ + Index);
+
+		VectorStoreAligned(VectorAdd(VectorLoadAligned(Age + Index), Delta), Age + Index);
+	}
+}
+
+void UProjectileSimulationSubsystem::RemoveExpired()
+{
+	//Walk backwards so RemoveAtSwap only ever pulls in lanes we've already checked
+	for (int32 Index = this->Buffer.Num() - 1; Index >= 0; --Index)
+	{
+		if (this->Buffer.Age[Index] >= this->MaxLifetime)
+		{
+			this->RemoveProjectileAt(Index);
+		}
+	}
+}
+
+void UProjectileSimulationSubsystem::IssueCollisionTraces()
+{
+	SCOPE_CYCLE_COUNTER(STAT_Projectile_Collision);
+
+	UWorld* World = GetWorld();
+	for (int32 Index = 0; Index < this->Buffer.Num(); ++Index)
+	{
+		const FVector Start(this->Buffer.PrevX[Index], this->Buffer.PrevY[Index], this->Buffer.PrevZ[Index]);
+		const FVector End(this->Buffer.PosX[Index], this->Buffer.PosY[Index], this->Buffer.PosZ[Index]);
+		FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(ProjectileTrace), false, this->Buffer.Instigators[Index].Get());
+
+		//Results come back next frame in one batch through OnTraceCompleted
+		World->AsyncLineTraceByChannel(EAsyncTraceType::Single, Start, End, this->TraceChannel, QueryParams, FCollisionResponseParams::DefaultResponseParam, &this->TraceDelegate, this->Buffer.Ids[Index]);
+	}
+}
+
+void UProjectileSimulationSubsystem::OnTraceCompleted(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum)
+{
+	if (TraceDatum.OutHits.IsEmpty() || !TraceDatum.OutHits[0].bBlockingHit)
+	{
+		return;
+	}
+
+	//The projectile may have expired or already hit something on an earlier segment
+	const int32* Index = this->IdToIndex.Find(TraceDatum.UserData);
+	if (!Index)
+	{
+		return;
+	}
+
+	const FHitResult& Hit = TraceDatum.OutHits[0];
+	AActor* Instigator = this->Buffer.Instigators[*Index].Get();
+	this->RemoveProjectileAt(*Index);
+
+	FProjectileImpactParams& Impact = this->PendingImpacts.AddDefaulted_GetRef();
+	Impact.ProjectileId = static_cast<uint32>(TraceDatum.UserData);
+	Impact.Location = Hit.ImpactPoint;
+	Impact.Normal = Hit.ImpactNormal;
+	Impact.HitActor = Hit.GetActor();
+
+	this->OnProjectileImpactDelegate.Broadcast(TraceDatum.UserData, Instigator, Hit);
+}
+
+void UProjectileSimulationSubsystem::FlushReplication()
+{
+	if (this->PendingReplication.IsEmpty() && this->PendingImpacts.IsEmpty())
+	{
+		return;
+	}
+
+	if (this->Replicator && GetWorld()->GetNetMode() != NM_Standalone)
+	{
+		const int32 ChunkSize = FMath::Max(this->MaxSpawnsPerRPC, 1);
+		for (int32 Start = 0; Start < this->PendingReplication.Num(); Start += ChunkSize)
+		{
+			const int32 Count = FMath::Min(ChunkSize, this->PendingReplication.Num() - Start);
+			this->Replicator->MulticastSpawnProjectiles(TArray<FProjectileSpawnParams>(this->PendingReplication.GetData() + Start, Count));
+		}
+		for (int32 Start = 0; Start < this->PendingImpacts.Num(); Start += ChunkSize)
+		{
+			const int32 Count = FMath::Min(ChunkSize, this->PendingImpacts.Num() - Start);
+			this->Replicator->MulticastProjectileImpacts(TArray<FProjectileImpactParams>(this->PendingImpacts.GetData() + Start, Count));
+		}
+
+		//Unreliable multicasts wait for the actor's next net update, send this frame's batch now
+		this->Replicator->ForceNetUpdate();
+	}
+
+	this->PendingReplication.Reset();
+	this->PendingImpacts.Reset();
+}
+
+void UProjectileSimulationSubsystem::UpdateVisuals() const
+{
+	SCOPE_CYCLE_COUNTER(STAT_Projectile_Visuals);
+
+	if (!this->Replicator || GetWorld()->GetNetMode() == NM_DedicatedServer)
+	{
+		return;
+	}
+
+	UInstancedStaticMeshComponent* Instances = this->Replicator->GetProjectileInstances();
+	if (!Instances->GetStaticMesh())
+	{
+		return;
+	}
+
+	TArray<FTransform> Transforms;
+	Transforms.SetNumUninitialized(this->Buffer.Num());
+	for (int32 Index = 0; Index < this->Buffer.Num(); ++Index)
+	{
+		const FVector Velocity(this->Buffer.VelX[Index], this->Buffer.VelY[Index], this->Buffer.VelZ[Index]);
+		const FVector Position(this->Buffer.PosX[Index], this->Buffer.PosY[Index], this->Buffer.PosZ[Index]);
+		Transforms[Index] = FTransform(Velocity.Rotation(), Position);
+	}
+
+	if (Instances->GetInstanceCount() == Transforms.Num())
+	{
+		Instances->BatchUpdateInstancesTransforms(0, Transforms, true, true, true);
+	}
+	else
+	{
+		Instances->ClearInstances();
+		Instances->AddInstances(Transforms, false, true);
+	}
+}
+
+bool UProjectileSimulationSubsystem::IsAuthority() const
+{
+	const UWorld* World = GetWorld();
+	return World && World->GetNetMode() != NM_Client;
+}
+
+double UProjectileSimulationSubsystem::GetServerWorldTime() const
+{
+	const UWorld* World = GetWorld();
+	if (const AGameStateBase* GameState = World->GetGameState())
+	{
+		return GameState->GetServerWorldTimeSeconds();
+	}
+	return World->GetTimeSeconds();
+}
+
+//Benchmark//
+
+/**
+ * Watcher.Projectiles.Benchmark [Frames=120] [Count...]
+ * Fills the buffer with N projectiles fanned out from the world origin and reports the average per-frame
+ * cost of the SIMD integration pass and of one batch of collision segments, for each requested count.
+ */
+static FAutoConsoleCommandWithWorldAndArgs GProjectileBenchmarkCommand(
+	TEXT("Watcher.Projectiles.Benchmark"),
+	TEXT("Measures UProjectileSimulationSubsystem frame cost. Args: [Frames=120] [Count...=100 1000 10000]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		UProjectileSimulationSubsystem* ProjectileSimulation = World ? World->GetSubsystem<UProjectileSimulationSubsystem>() : nullptr;
+		if (!ProjectileSimulation || World->GetNetMode() == NM_Client)
+		{
+			UE_LOG(LogProjectileSimulation, Warning, TEXT("Projectile benchmark needs an authoritative game world"));
+			return;
+		}
+
+		const int32 Frames = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 120;
+		TArray<int32> Counts;
+		for (int32 ArgIndex = 1; ArgIndex < Args.Num(); ++ArgIndex)
+		{
+			Counts.Add(FCString::Atoi(*Args[ArgIndex]));
+		}
+		if (Counts.IsEmpty())
+		{
+			Counts = { 100, 1000, 10000 };
+		}
+
+		constexpr float FixedDelta = 1.f / 60.f;
+		FRandomStream Random(1337);
+
+		for (const int32 Count : Counts)
+		{
+			ProjectileSimulation->ClearProjectiles();
+			for (int32 Index = 0; Index < Count; ++Index)
+			{
+				ProjectileSimulation->FireProjectile(FVector(0.f, 0.f, 500.f), Random.VRand(), 5000.f, 1.f, nullptr);
+			}
+
+			double IntegrateSeconds = 0.0;
+			double CollisionSeconds = 0.0;
+			for (int32 Frame = 0; Frame < Frames; ++Frame)
+			{
+				double StartTime = FPlatformTime::Seconds();
+				ProjectileSimulation->Simulate(FixedDelta, false);
+				IntegrateSeconds += FPlatformTime::Seconds() - StartTime;
+
+				StartTime = FPlatformTime::Seconds();
+				ProjectileSimulation->TraceAllBlocking();
+				CollisionSeconds += FPlatformTime::Seconds() - StartTime;
+			}
+
+			UE_LOG(LogProjectileSimulation, Display, TEXT("%6d projectiles: integrate %.4f ms/frame, collision %.4f ms/frame over %d frames"),
+				Count, IntegrateSeconds * 1000.0 / Frames, CollisionSeconds * 1000.0 / Frames, Frames);
+		}
+
+		ProjectileSimulation->ClearProjectiles();
+	}));
+
+//Benchmark//
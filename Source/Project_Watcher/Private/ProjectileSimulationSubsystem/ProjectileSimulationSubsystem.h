@@ -0,0 +1,258 @@
+//Project Watcher 2024 & Beyond
+
+#pragma once
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Engine/EngineTypes.h"
+#include "Engine/NetSerialization.h"
+#include "WorldCollision.h"
+#include "ProjectileSimulationSubsystem.generated.h"
+
+class AProjectileReplicator;
+
+//Wrapper for BP data//
+
+/**
+ * Everything a client needs to reproduce a projectile's flight.
+ * This is what gets replicated instead of a per-projectile actor.
+ * Origin and direction are quantized on the wire and clients fast forward with the closed form, so the
+ * client trajectory is a close approximation of the server's, not an exact copy. Hits are decided by the server.
+ */
+USTRUCT(BlueprintType)
+struct FProjectileSpawnParams
+{
+	GENERATED_USTRUCT_BODY()
+public:
+	UPROPERTY(BlueprintReadWrite, Category = "Projectile")
+	FVector_NetQuantize Origin = FVector::ZeroVector;
+	UPROPERTY(BlueprintReadWrite, Category = "Projectile")
+	FVector_NetQuantizeNormal Direction = FVector::ForwardVector;
+	UPROPERTY(BlueprintReadWrite, Category = "Projectile")
+	float Speed = 5000.f;
+	UPROPERTY(BlueprintReadWrite, Category = "Projectile")
+	float GravityScale = 0.f;
+	/* Server world time the projectile was fired at, clients fast forward from this */
+	UPROPERTY(BlueprintReadWrite, Category = "Projectile")
+	double ServerSpawnTime = 0.0;
+	UPROPERTY()
+	uint32 ProjectileId = 0;
+	UPROPERTY(BlueprintReadWrite, Category = "Projectile")
+	TObjectPtr<AActor> Instigator = nullptr;
+};
+
+/**
+ * A hit decided by the server, sent to clients so they stop drawing the projectile where it actually hit.
+ */
+USTRUCT(BlueprintType)
+struct FProjectileImpactParams
+{
+	GENERATED_USTRUCT_BODY()
+public:
+	UPROPERTY()
+	uint32 ProjectileId = 0;
+	UPROPERTY(BlueprintReadOnly, Category = "Projectile")
+	FVector_NetQuantize Location = FVector::ZeroVector;
+	UPROPERTY(BlueprintReadOnly, Category = "Projectile")
+	FVector_NetQuantizeNormal Normal = FVector::UpVector;
+	UPROPERTY(BlueprintReadOnly, Category = "Projectile")
+	TObjectPtr<AActor> HitActor = nullptr;
+};
+
+//Wrapper for BP data//
+
+DECLARE_MULTICAST_DELEGATE_ThreeParams(FOnProjectileImpact, const uint32 /*ProjectileId*/, AActor* /*Instigator*/, const FHitResult& /*Hit*/);
+
+/**
+ * Structure of arrays buffer for every in-flight projectile.
+ * Float lanes are padded to a multiple of 4 so the integrator can always run full SIMD registers.
+ */
+struct FProjectileBuffer
+{
+	using FFloatLane = TArray<float, TAlignedHeapAllocator<16>>;
+
+	FFloatLane PosX, PosY, PosZ;
+	FFloatLane PrevX, PrevY, PrevZ;
+	FFloatLane VelX, VelY, VelZ;
+	FFloatLane GravityScale;
+	FFloatLane Age;
+
+	TArray<uint32> Ids;
+	TArray<TWeakObjectPtr<AActor>> Instigators;
+
+	int32 Num() const { return Ids.Num(); }
+
+	/* Lane count rounded up to the SIMD width */
+	int32 PaddedNum() const { return Align(Ids.Num(), 4); }
+
+	void Add(const FVector& Position, const FVector& Velocity, const float Gravity, const float InitialAge, const uint32 Id, AActor* Instigator);
+
+	void RemoveAtSwap(const int32 Index);
+
+	void Reset();
+};
+
+/**
+ * Simulates every projectile in the world in one batched pass per frame instead of one actor + movement component each.
+ * Only the server traces for hits. Clients receive compact spawn and impact events through AProjectileReplicator
+ * and simulate visuals only, a projectile disappears on a client when the server reports its impact.
+ */
+UCLASS(Config=Game)
+class UProjectileSimulationSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+private:
+	//Settings//
+
+	/* Seconds before a projectile that hasn't hit anything is culled */
+	UPROPERTY(Config)
+	float MaxLifetime = 5.f;
+
+	/* Channel the batched collision traces run on */
+	UPROPERTY(Config)
+	TEnumAsByte<ECollisionChannel> TraceChannel = ECC_Visibility;
+
+	/* Mesh used for the instanced visuals on non dedicated-server worlds */
+	UPROPERTY(Config)
+	FSoftObjectPath ProjectileMesh;
+
+	/* Spawn and impact events are flushed in RPCs of at most this many entries */
+	UPROPERTY(Config)
+	int32 MaxSpawnsPerRPC = 64;
+
+	//Settings//
+
+	FProjectileBuffer Buffer;
+
+	/* ProjectileId -> index in Buffer, kept in sync by RemoveAtSwap */
+	TMap<uint32, int32> IdToIndex;
+
+	/* Spawns fired this frame that still need to be sent to clients */
+	TArray<FProjectileSpawnParams> PendingReplication;
+
+	/* Impacts the server decided since the last flush that still need to be sent to clients */
+	TArray<FProjectileImpactParams> PendingImpacts;
+
+	UPROPERTY()
+	TObjectPtr<AProjectileReplicator> Replicator;
+
+	uint32 NextProjectileId = 1;
+
+	FTraceDelegate TraceDelegate;
+
+	FOnProjectileImpact OnProjectileImpactDelegate;
+
+public:
+
+	//Initialization//
+
+	UProjectileSimulationSubsystem() { }
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	virtual void Deinitialize() override;
+
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+	//Initialization//
+
+	//Tickable//
+
+	virtual void Tick(float DeltaTime) override;
+
+	virtual TStatId GetStatId() const override;
+
+	//Tickable//
+
+	//Projectile Interface calls//
+
+	/**
+	 * Fires a projectile, only the authority may fire, clients get it through replication
+	 * @param Origin World location of the muzzle
+	 * @param Direction Flight direction, normalized internally
+	 * @param Speed Initial speed in cm/s
+	 * @param GravityScale Multiplier on world gravity
+	 * @param Instigator Actor ignored by the collision traces and reported on impact
+	 * @return The ProjectileId or 0 if nothing was fired
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure=false, Category = "Projectile")
+	int32 FireProjectile(const FVector& Origin, const FVector& Direction, const float Speed, const float GravityScale, AActor* Instigator);
+
+	/* Amount of in-flight projectiles */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Projectile")
+	int32 GetNumProjectiles() const;
+
+	/**
+	 * Fired when a projectile hits something. On the authority this comes from its own traces,
+	 * on clients from the server's replicated impacts, only the authority should apply gameplay effects from it
+	 */
+	FOnProjectileImpact& OnProjectileImpact() { return this->OnProjectileImpactDelegate; }
+
+	/**
+	 * Advances every projectile, exposed for the benchmark command
+	 * @param DeltaSeconds Step size
+	 * @param bRunCollision Whether to issue the batched collision traces, ignored on clients
+	 */
+	void Simulate(const float DeltaSeconds, const bool bRunCollision);
+
+	/**
+	 * Runs this frame's collision segments as blocking traces, exposed for the benchmark command
+	 * @return Amount of projectiles that would have hit something
+	 */
+	int32 TraceAllBlocking() const;
+
+	/* Removes every projectile without reporting impacts */
+	void ClearProjectiles();
+
+	//Projectile Interface calls//
+
+	//Replication//
+
+	void RegisterReplicator(AProjectileReplicator* ReplicatorIn);
+
+	void UnregisterReplicator(AProjectileReplicator* ReplicatorIn);
+
+	/* Called on clients when the replicator receives spawn events */
+	void ReceiveReplicatedSpawns(const TArray<FProjectileSpawnParams>& Spawns);
+
+	/* Called on clients when the replicator receives the server's impacts */
+	void ReceiveReplicatedImpacts(const TArray<FProjectileImpactParams>& Impacts);
+
+	//Replication//
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+
+	//Simulation internals//
+
+	void AddProjectile(const FProjectileSpawnParams& Params, const float InitialAge);
+
+	void RemoveProjectileAt(const int32 Index);
+
+	/* Vectorized semi-implicit euler over every lane */
+	void Integrate(const float DeltaSeconds);
+
+	/* Culls expired projectiles */
+	void RemoveExpired();
+
+	/* Issues one async line trace per projectile covering this frame's movement */
+	void IssueCollisionTraces();
+
+	/* Async trace callback on the authority, UserData carries the ProjectileId */
+	void OnTraceCompleted(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum);
+
+	/* Sends queued spawns and impacts to clients */
+	void FlushReplication();
+
+	/* Mirrors the buffer onto the replicator's instanced mesh */
+	void UpdateVisuals() const;
+
+	/* Authority side of the simulation */
+	bool IsAuthority() const;
+
+	/* Server clock shared with clients */
+	double GetServerWorldTime() const;
+
+	//Simulation internals//
+};
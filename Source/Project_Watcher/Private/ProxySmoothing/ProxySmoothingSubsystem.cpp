@@ -0,0 +1,234 @@
+//Project Watcher 2024 & Beyond
+
+#include "ProxySmoothingSubsystem.h"
+#include "WatcherCharacterMovementComponent.h"
+#include "Async/ParallelFor.h"
+#include "Components/SceneComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "HAL/IConsoleManager.h"
+
+DECLARE_LOG_CATEGORY_EXTERN(LogProxySmoothing, Log, All);
+DEFINE_LOG_CATEGORY(LogProxySmoothing);
+
+DECLARE_STATS_GROUP(TEXT("ProxySmoothing"), STATGROUP_ProxySmoothing, STATCAT_Advanced);
+DECLARE_CYCLE_STAT(TEXT("Smooth"), STAT_ProxySmoothing_Smooth, STATGROUP_ProxySmoothing);
+DECLARE_CYCLE_STAT(TEXT("Write Back"), STAT_ProxySmoothing_WriteBack, STATGROUP_ProxySmoothing);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Proxies Smoothed"), STAT_ProxySmoothing_Num, STATGROUP_ProxySmoothing);
+
+namespace ProxySmoothing
+{
+	static int32 BatchedSmoothing = 1;
+	static FAutoConsoleVariableRef CVarBatchedSmoothing(
+		TEXT("Watcher.Movement.BatchedSmoothing"),
+		BatchedSmoothing,
+		TEXT("Smooth simulated proxies in one batched pass instead of inside each movement component."));
+
+	static int32 ParallelThreshold = 32;
+	static FAutoConsoleVariableRef CVarParallelThreshold(
+		TEXT("Watcher.Movement.SmoothingParallelThreshold"),
+		ParallelThreshold,
+		TEXT("Proxies needed before the batched smoothing goes wide on worker threads, below it the dispatch costs more than it saves."));
+
+	/* Entries per worker task, keeps each task well above the scheduling overhead */
+	static constexpr int32 MinBatchSize = 16;
+
+	/* UCharacterMovementComponent::SmoothClientPosition_Interpolate, Exponential branch */
+	static void SmoothEntry(FProxySmoothingEntry& Entry)
+	{
+		if (Entry.DeltaSeconds < Entry.SmoothLocationTime)
+		{
+			Entry.TranslationOffset *= (1.f - Entry.DeltaSeconds / Entry.SmoothLocationTime);
+		}
+		else
+		{
+			Entry.TranslationOffset = FVector::ZeroVector;
+		}
+
+		if (Entry.DeltaSeconds < Entry.SmoothRotationTime)
+		{
+			Entry.RotationOffset = FQuat::FastLerp(Entry.RotationOffset, Entry.RotationTarget, Entry.DeltaSeconds / Entry.SmoothRotationTime).GetNormalized();
+		}
+		else
+		{
+			Entry.RotationOffset = Entry.RotationTarget;
+		}
+
+		Entry.bComplete = Entry.TranslationOffset.IsNearlyZero(1e-2f) && Entry.RotationOffset.Equals(Entry.RotationTarget, 1e-5f);
+		if (Entry.bComplete)
+		{
+			Entry.TranslationOffset = FVector::ZeroVector;
+			Entry.RotationOffset = Entry.RotationTarget;
+		}
+	}
+}
+
+bool UProxySmoothingSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	//Dedicated servers don't render proxies
+	return !IsRunningDedicatedServer() && Super::ShouldCreateSubsystem(Outer);
+}
+
+void UProxySmoothingSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (this->Entries.IsEmpty())
+	{
+		return;
+	}
+
+	SET_DWORD_STAT(STAT_ProxySmoothing_Num, this->Entries.Num());
+	SmoothEntries(this->Entries, true);
+
+	{
+		SCOPE_CYCLE_COUNTER(STAT_ProxySmoothing_WriteBack);
+		for (int32 Index = 0; Index < this->Entries.Num(); ++Index)
+		{
+			if (UWatcherCharacterMovementComponent* Component = this->Components[Index].Get())
+			{
+				const FProxySmoothingEntry& Entry = this->Entries[Index];
+				Component->ApplyBatchedSmoothing(Entry.TranslationOffset, Entry.RotationOffset, Entry.bComplete);
+			}
+		}
+	}
+
+	this->Components.Reset();
+	this->Entries.Reset();
+}
+
+TStatId UProxySmoothingSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UProxySmoothingSubsystem, STATGROUP_Tickables);
+}
+
+bool UProxySmoothingSubsystem::IsBatchingEnabled()
+{
+	return ProxySmoothing::BatchedSmoothing != 0;
+}
+
+void UProxySmoothingSubsystem::QueueSmoothing(UWatcherCharacterMovementComponent* Component, const FProxySmoothingEntry& Entry)
+{
+	this->Components.Add(Component);
+	this->Entries.Add(Entry);
+}
+
+void UProxySmoothingSubsystem::SmoothEntries(TArrayView<FProxySmoothingEntry> InOutEntries, const bool bAllowParallel)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ProxySmoothing_Smooth);
+
+	const int32 Num = InOutEntries.Num();
+	if (!bAllowParallel || Num < ProxySmoothing::ParallelThreshold)
+	{
+		for (FProxySmoothingEntry& Entry : InOutEntries)
+		{
+			ProxySmoothing::SmoothEntry(Entry);
+		}
+		return;
+	}
+
+	const int32 NumBatches = FMath::DivideAndRoundUp(Num, ProxySmoothing::MinBatchSize);
+	ParallelFor(NumBatches, [InOutEntries, Num](const int32 Batch)
+	{
+		const int32 End = FMath::Min((Batch + 1) * ProxySmoothing::MinBatchSize, Num);
+		for (int32 Index = Batch * ProxySmoothing::MinBatchSize; Index < End; ++Index)
+		{
+			ProxySmoothing::SmoothEntry(InOutEntries[Index]);
+		}
+	});
+}
+
+bool UProxySmoothingSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+//Benchmark//
+
+/**
+ * Watcher.Movement.SmoothingBenchmark [Frames]
+ * Smooths 8, 32 and 64 synthetic proxies the way the engine does (interpolate + mesh update per proxy)
+ * and through the batched path, writing to real scene components so the game thread write back is included.
+ */
+static FAutoConsoleCommandWithWorldAndArgs GProxySmoothingBenchmarkCommand(
+	TEXT("Watcher.Movement.SmoothingBenchmark"),
+	TEXT("Compares per proxy smoothing against the batched pass at 8/32/64 proxies. Args: [Frames=1000]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		if (!World)
+		{
+			return;
+		}
+
+		const int32 Frames = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 1000;
+		const int32 ProxyCounts[] = { 8, 32, 64 };
+
+		FActorSpawnParameters SpawnParameters;
+		SpawnParameters.ObjectFlags |= RF_Transient;
+		AActor* Host = World->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity, SpawnParameters);
+		USceneComponent* Root = NewObject<USceneComponent>(Host);
+		Host->SetRootComponent(Root);
+		Root->RegisterComponent();
+
+		TArray<USceneComponent*> Meshes;
+		for (int32 Index = 0; Index < ProxyCounts[UE_ARRAY_COUNT(ProxyCounts) - 1]; ++Index)
+		{
+			USceneComponent* Mesh = NewObject<USceneComponent>(Host);
+			Mesh->SetupAttachment(Root);
+			Mesh->RegisterComponent();
+			Meshes.Add(Mesh);
+		}
+
+		FRandomStream Random(1234);
+		const auto MakeEntries = [&Random](const int32 Num)
+		{
+			TArray<FProxySmoothingEntry> Entries;
+			Entries.SetNum(Num);
+			for (FProxySmoothingEntry& Entry : Entries)
+			{
+				Entry.TranslationOffset = Random.GetUnitVector() * Random.FRandRange(5.f, 50.f);
+				Entry.RotationOffset = FRotator(0.f, Random.FRandRange(-20.f, 20.f), 0.f).Quaternion();
+				Entry.SmoothLocationTime = 0.1f;
+				Entry.SmoothRotationTime = 0.05f;
+				Entry.DeltaSeconds = 1.f / 240.f;
+			}
+			return Entries;
+		};
+
+		for (const int32 Num : ProxyCounts)
+		{
+			//Per proxy, like every movement component smoothing itself
+			TArray<FProxySmoothingEntry> Entries = MakeEntries(Num);
+			double StartTime = FPlatformTime::Seconds();
+			for (int32 Frame = 0; Frame < Frames; ++Frame)
+			{
+				for (int32 Index = 0; Index < Num; ++Index)
+				{
+					UProxySmoothingSubsystem::SmoothEntries(MakeArrayView(&Entries[Index], 1), false);
+					Meshes[Index]->SetRelativeLocationAndRotation(Entries[Index].TranslationOffset, Entries[Index].RotationOffset);
+				}
+			}
+			const double SerialSeconds = FPlatformTime::Seconds() - StartTime;
+
+			//Batched
+			Entries = MakeEntries(Num);
+			StartTime = FPlatformTime::Seconds();
+			for (int32 Frame = 0; Frame < Frames; ++Frame)
+			{
+				UProxySmoothingSubsystem::SmoothEntries(Entries, true);
+				for (int32 Index = 0; Index < Num; ++Index)
+				{
+					Meshes[Index]->SetRelativeLocationAndRotation(Entries[Index].TranslationOffset, Entries[Index].RotationOffset);
+				}
+			}
+			const double BatchedSeconds = FPlatformTime::Seconds() - StartTime;
+
+			UE_LOG(LogProxySmoothing, Display, TEXT("%2d proxies: per proxy %.2f us/frame, batched %.2f us/frame (%s)"),
+				Num, SerialSeconds * 1000000.0 / Frames, BatchedSeconds * 1000000.0 / Frames,
+				Num >= ProxySmoothing::ParallelThreshold ? TEXT("parallel") : TEXT("inline"));
+		}
+
+		Host->Destroy();
+	}));
+
+//Benchmark//
@@ -0,0 +1,80 @@
+//Project Watcher 2024 & Beyond
+
+#pragma once
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ProxySmoothingSubsystem.generated.h"
+
+class UWatcherCharacterMovementComponent;
+
+/* Smoothing state of one proxy, gathered on the game thread and advanced on workers */
+struct FProxySmoothingEntry
+{
+	FQuat RotationOffset = FQuat::Identity;
+	FQuat RotationTarget = FQuat::Identity;
+	FVector TranslationOffset = FVector::ZeroVector;
+	float SmoothLocationTime = 0.f;
+	float SmoothRotationTime = 0.f;
+	float DeltaSeconds = 0.f;
+	bool bComplete = false;
+};
+
+/**
+ * Smooths the meshes of every simulated proxy using UWatcherCharacterMovementComponent in one pass per frame.
+ * Proxies queue their state from their own movement tick, this subsystem ticks after all actors,
+ * runs the exponential smoothing over the contiguous buffer (on workers once there are enough proxies)
+ * and writes the results back to the meshes in a single game thread loop.
+ * Toggle with Watcher.Movement.BatchedSmoothing, inspect with stat ProxySmoothing.
+ */
+UCLASS()
+class UProxySmoothingSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+private:
+	/* Parallel to Entries */
+	TArray<TWeakObjectPtr<UWatcherCharacterMovementComponent>> Components;
+
+	TArray<FProxySmoothingEntry> Entries;
+
+public:
+
+	//Initialization//
+
+	UProxySmoothingSubsystem() { }
+
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+
+	//Initialization//
+
+	//Tickable//
+
+	virtual void Tick(float DeltaTime) override;
+
+	virtual TStatId GetStatId() const override;
+
+	//Tickable//
+
+	//Smoothing Interface calls//
+
+	/* If proxies should queue instead of smoothing themselves */
+	static bool IsBatchingEnabled();
+
+	/**
+	 * Queues a proxy for this frame's batched pass
+	 * @param Component The proxy's movement component
+	 * @param Entry Its current smoothing state
+	 */
+	void QueueSmoothing(UWatcherCharacterMovementComponent* Component, const FProxySmoothingEntry& Entry);
+
+	/**
+	 * Advances every entry by its DeltaSeconds, exposed for the benchmark command
+	 * @param InOutEntries Entries to advance in place
+	 * @param bAllowParallel Run on workers when the buffer is over the parallel threshold
+	 */
+	static void SmoothEntries(TArrayView<FProxySmoothingEntry> InOutEntries, const bool bAllowParallel);
+
+	//Smoothing Interface calls//
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+};
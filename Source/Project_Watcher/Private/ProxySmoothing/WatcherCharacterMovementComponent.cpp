@@ -0,0 +1,50 @@
+//Project Watcher 2024 & Beyond
+
+#include "WatcherCharacterMovementComponent.h"
+#include "ProxySmoothingSubsystem.h"
+#include "Engine/World.h"
+#include "GameFramework/Character.h"
+
+void UWatcherCharacterMovementComponent::ApplyBatchedSmoothing(const FVector& TranslationOffset, const FQuat& RotationOffset, const bool bComplete)
+{
+	FNetworkPredictionData_Client_Character* ClientData = GetPredictionData_Client_Character();
+	if (!HasValidData() || !ClientData)
+	{
+		return;
+	}
+
+	ClientData->MeshTranslationOffset = TranslationOffset;
+	ClientData->MeshRotationOffset = RotationOffset;
+	bNetworkSmoothingComplete = bComplete;
+
+	SmoothClientPosition_UpdateVisuals();
+}
+
+void UWatcherCharacterMovementComponent::SmoothClientPosition(float DeltaSeconds)
+{
+	//Listen server smoothing of remote autonomous proxies keeps the engine path
+	if (!HasValidData() || CharacterOwner->GetLocalRole() != ROLE_SimulatedProxy
+		|| NetworkSmoothingMode != ENetworkSmoothingMode::Exponential || !UProxySmoothingSubsystem::IsBatchingEnabled())
+	{
+		Super::SmoothClientPosition(DeltaSeconds);
+		return;
+	}
+
+	UProxySmoothingSubsystem* ProxySmoothing = GetWorld()->GetSubsystem<UProxySmoothingSubsystem>();
+	const FNetworkPredictionData_Client_Character* ClientData = GetPredictionData_Client_Character();
+	if (!ProxySmoothing || !ClientData)
+	{
+		Super::SmoothClientPosition(DeltaSeconds);
+		return;
+	}
+
+	//Same inputs UCharacterMovementComponent::SmoothClientPosition_Interpolate reads, faster interpolation when stopped
+	FProxySmoothingEntry Entry;
+	Entry.TranslationOffset = ClientData->MeshTranslationOffset;
+	Entry.RotationOffset = ClientData->MeshRotationOffset;
+	Entry.RotationTarget = ClientData->MeshRotationTarget;
+	Entry.SmoothLocationTime = Velocity.IsZero() ? 0.5f * ClientData->SmoothNetUpdateTime : ClientData->SmoothNetUpdateTime;
+	Entry.SmoothRotationTime = ClientData->SmoothNetUpdateRotationTime;
+	Entry.DeltaSeconds = DeltaSeconds;
+	ProxySmoothing->QueueSmoothing(this, Entry);
+}
@@ -0,0 +1,30 @@
+//Project Watcher 2024 & Beyond
+
+#pragma once
+#include "CoreMinimal.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "WatcherCharacterMovementComponent.generated.h"
+
+/**
+ * Character movement that hands its simulated proxy mesh smoothing to UProxySmoothingSubsystem
+ * so every proxy in the world is smoothed in one batched pass instead of one at a time.
+ * Only Exponential smoothing is batched, the other modes run the engine path unchanged.
+ */
+UCLASS()
+class UWatcherCharacterMovementComponent : public UCharacterMovementComponent
+{
+	GENERATED_BODY()
+public:
+
+	/**
+	 * Called by UProxySmoothingSubsystem with this frame's result
+	 * @param TranslationOffset New mesh translation offset
+	 * @param RotationOffset New mesh rotation offset
+	 * @param bComplete If the mesh reached its target
+	 */
+	void ApplyBatchedSmoothing(const FVector& TranslationOffset, const FQuat& RotationOffset, const bool bComplete);
+
+protected:
+
+	virtual void SmoothClientPosition(float DeltaSeconds) override;
+};
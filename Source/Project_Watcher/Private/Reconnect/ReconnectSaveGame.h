@@ -0,0 +1,27 @@
+//Project Watcher 2024 & Beyond
+
+#pragma once
+#include "CoreMinimal.h"
+#include "GameFramework/SaveGame.h"
+#include "ReconnectSaveGame.generated.h"
+
+/* Identity of the last session we played in as a client, kept on disk so a restarted game can still rejoin it */
+UCLASS()
+class UReconnectSaveGame : public USaveGame
+{
+	GENERATED_BODY()
+public:
+	UPROPERTY()
+	FString SessionId;
+
+	/* Resolved connect string of the host (ip:port or steam.id) */
+	UPROPERTY()
+	FString ConnectString;
+
+	UPROPERTY()
+	bool bIsLANMatch = false;
+
+	/* When we last arrived in the session's game map, in UTC */
+	UPROPERTY()
+	FDateTime SavedAt;
+};
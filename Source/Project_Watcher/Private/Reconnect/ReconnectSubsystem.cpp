@@ -0,0 +1,441 @@
+//Project Watcher 2024 & Beyond
+
+#include "ReconnectSubsystem.h"
+#include "ReconnectSaveGame.h"
+#include "HostMigration/HostMigrationSubsystem.h"
+#include "NetworkManagerGameInstance/NetworkManagerGameInstance.h"
+#include "PlayerRestore/PlayerRestoreSubsystem.h"
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "Engine/NetConnection.h"
+#include "Engine/NetDriver.h"
+#include "Engine/World.h"
+#include "GameFramework/GameModeBase.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
+#include "Kismet/GameplayStatics.h"
+#include "TimerManager.h"
+#include "UObject/UObjectGlobals.h"
+
+DECLARE_LOG_CATEGORY_EXTERN(LogReconnect, Log, All);
+DEFINE_LOG_CATEGORY(LogReconnect);
+
+namespace Reconnect
+{
+	static const FString SlotName = TEXT("LastSession");
+}
+
+static FAutoConsoleCommandWithWorldAndArgs GReconnectSimulateDropCommand(
+	TEXT("Watcher.Reconnect.SimulateDrop"),
+	TEXT("Closes the client's connection to the host as if the network dropped, the reconnect logs how long it took to get back in game"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		UNetDriver* NetDriver = World ? World->GetNetDriver() : nullptr;
+		if (!NetDriver || !NetDriver->ServerConnection)
+		{
+			UE_LOG(LogReconnect, Warning, TEXT("Not connected to a host"));
+			return;
+		}
+
+		UE_LOG(LogReconnect, Display, TEXT("Simulating a dropped connection"));
+		NetDriver->ServerConnection->Close();
+	}));
+
+void UReconnectSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+	Collection.InitializeDependency<UPlayerRestoreSubsystem>();
+	Collection.InitializeDependency<UHostMigrationSubsystem>();
+
+	if (GEngine)
+	{
+		this->NetworkFailureHandle = GEngine->OnNetworkFailure().AddUObject(this, &ThisClass::HandleNetworkFailure);
+		this->TravelFailureHandle = GEngine->OnTravelFailure().AddUObject(this, &ThisClass::HandleTravelFailure);
+	}
+	FCoreUObjectDelegates::PostLoadMapWithWorld.AddUObject(this, &ThisClass::HandlePostLoadMap);
+	this->LogoutHandle = FGameModeEvents::GameModeLogoutEvent.AddUObject(this, &ThisClass::HandleLogout);
+
+	if (UNetworkManagerGameInstance* NetworkManager = Collection.InitializeDependency<UNetworkManagerGameInstance>())
+	{
+		NetworkManager->OnNativeEvent(ENetworkManagerEvent::DestroySessionComplete).AddUObject(this, &ThisClass::HandleSessionDestroyed);
+		NetworkManager->OnNativeEvent(ENetworkManagerEvent::DestroySessionFailure).AddUObject(this, &ThisClass::HandleSessionDestroyFailure);
+	}
+
+	if (UGameplayStatics::DoesSaveGameExist(Reconnect::SlotName, 0))
+	{
+		this->LastSession = Cast<UReconnectSaveGame>(UGameplayStatics::LoadGameFromSlot(Reconnect::SlotName, 0));
+	}
+}
+
+void UReconnectSubsystem::Deinitialize()
+{
+	if (GEngine)
+	{
+		GEngine->OnNetworkFailure().Remove(this->NetworkFailureHandle);
+		GEngine->OnTravelFailure().Remove(this->TravelFailureHandle);
+	}
+	FCoreUObjectDelegates::PostLoadMapWithWorld.RemoveAll(this);
+	FGameModeEvents::GameModeLogoutEvent.Remove(this->LogoutHandle);
+
+	if (UNetworkManagerGameInstance* NetworkManager = this->GetNetworkManager())
+	{
+		NetworkManager->RemoveNativeListener(this);
+	}
+
+	GetGameInstance()->GetTimerManager().ClearTimer(this->AttemptTimer);
+
+	Super::Deinitialize();
+}
+
+bool UReconnectSubsystem::CanRejoinLastSession() const
+{
+	if (!this->LastSession || this->LastSession->ConnectString.IsEmpty())
+	{
+		return false;
+	}
+
+	return (FDateTime::UtcNow() - this->LastSession->SavedAt).GetTotalSeconds() <= this->ReconnectWindow;
+}
+
+bool UReconnectSubsystem::RejoinLastSession()
+{
+	if (this->IsReconnecting() || this->IsHostMigrating() || !this->CanRejoinLastSession())
+	{
+		return false;
+	}
+
+	UE_LOG(LogReconnect, Display, TEXT("Rejoining session %s"), *this->LastSession->SessionId);
+	this->RecoveryStartTime = FPlatformTime::Seconds();
+	this->DirectAttempts = 0;
+	this->StartDirectAttempt();
+	return true;
+}
+
+void UReconnectSubsystem::ForgetLastSession()
+{
+	this->LastSession = nullptr;
+	if (UGameplayStatics::DoesSaveGameExist(Reconnect::SlotName, 0))
+	{
+		UGameplayStatics::DeleteGameInSlot(Reconnect::SlotName, 0);
+	}
+}
+
+bool UReconnectSubsystem::IsReconnecting() const
+{
+	return this->Phase != EReconnectPhase::Idle;
+}
+
+UNetworkManagerGameInstance* UReconnectSubsystem::GetNetworkManager() const
+{
+	return GetGameInstance()->GetSubsystem<UNetworkManagerGameInstance>();
+}
+
+bool UReconnectSubsystem::IsHostMigrating() const
+{
+	const UHostMigrationSubsystem* HostMigration = GetGameInstance()->GetSubsystem<UHostMigrationSubsystem>();
+	return HostMigration && HostMigration->IsMigrating();
+}
+
+void UReconnectSubsystem::HandleNetworkFailure(UWorld* World, UNetDriver* NetDriver, ENetworkFailure::Type FailureType, const FString& ErrorString)
+{
+	if (!this->bEnableReconnect || !NetDriver)
+	{
+		return;
+	}
+
+	//A direct attempt that couldn't connect fails on the pending net driver
+	if (this->Phase == EReconnectPhase::DirectRejoin && NetDriver->NetDriverName == NAME_PendingNetDriver)
+	{
+		UE_LOG(LogReconnect, Display, TEXT("Direct rejoin %d/%d failed: %s"), this->DirectAttempts, this->MaxDirectAttempts, *ErrorString);
+		this->OnDirectAttemptFailed();
+		return;
+	}
+
+	if (NetDriver->NetDriverName != NAME_GameNetDriver)
+	{
+		return;
+	}
+
+	if (this->Phase == EReconnectPhase::Travelling)
+	{
+		this->FinishReconnect(false);
+		return;
+	}
+
+	const bool bDropped = FailureType == ENetworkFailure::ConnectionLost || FailureType == ENetworkFailure::ConnectionTimeout;
+	if (this->IsReconnecting() || !bDropped || !NetDriver->ServerConnection || !this->CanRejoinLastSession())
+	{
+		return;
+	}
+
+	UE_LOG(LogReconnect, Display, TEXT("Lost the connection to the host (%s), reconnecting to %s"), ENetworkFailure::ToString(FailureType), *this->LastSession->SessionId);
+	this->RecoveryStartTime = FPlatformTime::Seconds();
+	this->DirectAttempts = 0;
+
+	//The engine sends us back to the default map first, the reconnect continues once that load finishes
+	this->Phase = EReconnectPhase::WaitingForMenu;
+}
+
+void UReconnectSubsystem::HandleTravelFailure(UWorld* World, ETravelFailure::Type FailureType, const FString& ErrorString)
+{
+	switch (this->Phase)
+	{
+	case EReconnectPhase::DirectRejoin:
+		UE_LOG(LogReconnect, Display, TEXT("Direct rejoin %d/%d failed: %s"), this->DirectAttempts, this->MaxDirectAttempts, *ErrorString);
+		this->OnDirectAttemptFailed();
+		break;
+	case EReconnectPhase::Travelling:
+		this->FinishReconnect(false);
+		break;
+	default:
+		break;
+	}
+}
+
+void UReconnectSubsystem::HandlePostLoadMap(UWorld* LoadedWorld)
+{
+	if (!LoadedWorld || LoadedWorld->GetGameInstance() != GetGameInstance())
+	{
+		return;
+	}
+
+	if (LoadedWorld->GetNetMode() == NM_Client)
+	{
+		if (this->Phase == EReconnectPhase::DirectRejoin || this->Phase == EReconnectPhase::Travelling)
+		{
+			this->FinishReconnect(true);
+		}
+		this->RememberSession();
+		return;
+	}
+
+	if (this->Phase != EReconnectPhase::WaitingForMenu)
+	{
+		return;
+	}
+
+	if (this->IsHostMigrating())
+	{
+		UE_LOG(LogReconnect, Display, TEXT("Host migration is handling the drop"));
+		this->Phase = EReconnectPhase::Idle;
+		return;
+	}
+
+	this->StartDirectAttempt();
+}
+
+void UReconnectSubsystem::HandleLogout(AGameModeBase* GameMode, AController* Exiting)
+{
+	const APlayerController* PlayerController = Cast<APlayerController>(Exiting);
+	if (!this->bRestoreReconnectingPlayers || !GameMode || !PlayerController || PlayerController->IsLocalController())
+	{
+		return;
+	}
+
+	//Everyone logs out when the map goes away, that isn't a player leaving
+	const UWorld* World = GameMode->GetWorld();
+	if (!World || World->bIsTearingDown || World->GetGameInstance() != GetGameInstance())
+	{
+		return;
+	}
+
+	const APawn* Pawn = PlayerController->GetPawn();
+	const APlayerState* PlayerState = PlayerController->PlayerState;
+	if (!Pawn || !PlayerState || !PlayerState->GetUniqueId().IsValid())
+	{
+		return;
+	}
+
+	FPlayerRestoreData Data;
+	Data.Location = Pawn->GetActorLocation();
+	Data.Rotation = Pawn->GetActorRotation();
+	Data.ControlRotation = PlayerController->GetControlRotation();
+
+	if (UPlayerRestoreSubsystem* PlayerRestore = GetGameInstance()->GetSubsystem<UPlayerRestoreSubsystem>())
+	{
+		PlayerRestore->AddPendingRestore(PlayerState->GetUniqueId().ToString(), Data, this->RestoreTimeToLive);
+	}
+}
+
+void UReconnectSubsystem::RememberSession()
+{
+	const UNetworkManagerGameInstance* NetworkManager = this->GetNetworkManager();
+	if (!this->bEnableReconnect || !NetworkManager)
+	{
+		return;
+	}
+
+	//Direct joins by address have no session to look up again
+	const FString SessionId = NetworkManager->GetJoinedSessionId();
+	const FString ConnectString = NetworkManager->GetJoinedConnectString();
+	if (SessionId.IsEmpty() || ConnectString.IsEmpty())
+	{
+		return;
+	}
+
+	if (!this->LastSession)
+	{
+		this->LastSession = Cast<UReconnectSaveGame>(UGameplayStatics::CreateSaveGameObject(UReconnectSaveGame::StaticClass()));
+	}
+
+	this->LastSession->SessionId = SessionId;
+	this->LastSession->ConnectString = ConnectString;
+	this->LastSession->bIsLANMatch = NetworkManager->IsJoinedSessionLAN();
+	this->LastSession->SavedAt = FDateTime::UtcNow();
+
+	//Async, the map just loaded and a hitch here is visible
+	UGameplayStatics::AsyncSaveGameToSlot(this->LastSession, Reconnect::SlotName, 0);
+}
+
+void UReconnectSubsystem::StartDirectAttempt()
+{
+	this->Phase = EReconnectPhase::DirectRejoin;
+	this->DirectAttempts++;
+	UE_LOG(LogReconnect, Display, TEXT("Direct rejoin %d/%d to %s"), this->DirectAttempts, this->MaxDirectAttempts, *this->LastSession->ConnectString);
+
+	if (!this->GetNetworkManager()->JoinByConnectString(this->LastSession->ConnectString, this->LastSession->bIsLANMatch))
+	{
+		this->OnDirectAttemptFailed();
+		return;
+	}
+
+	GetGameInstance()->GetTimerManager().SetTimer(this->AttemptTimer, this, &ThisClass::OnDirectAttemptTimeout, this->DirectAttemptTimeout, false);
+}
+
+void UReconnectSubsystem::OnDirectAttemptTimeout()
+{
+	if (this->Phase != EReconnectPhase::DirectRejoin)
+	{
+		return;
+	}
+
+	UE_LOG(LogReconnect, Display, TEXT("Direct rejoin %d/%d timed out"), this->DirectAttempts, this->MaxDirectAttempts);
+	if (FWorldContext* WorldContext = GetGameInstance()->GetWorldContext())
+	{
+		GEngine->CancelPending(*WorldContext);
+	}
+	this->OnDirectAttemptFailed();
+}
+
+void UReconnectSubsystem::OnDirectAttemptFailed()
+{
+	FTimerManager& TimerManager = GetGameInstance()->GetTimerManager();
+	TimerManager.ClearTimer(this->AttemptTimer);
+
+	if (this->DirectAttempts < this->MaxDirectAttempts)
+	{
+		TimerManager.SetTimer(this->AttemptTimer, this, &ThisClass::StartDirectAttempt, this->DirectRetryInterval, false);
+		return;
+	}
+
+	//The host may have moved (new address, relay), the session id still finds it
+	UE_LOG(LogReconnect, Display, TEXT("Direct rejoin gave up, searching for session %s"), *this->LastSession->SessionId);
+	this->Phase = EReconnectPhase::DestroyingOldSession;
+	this->GetNetworkManager()->DestroySession();
+}
+
+void UReconnectSubsystem::FinishReconnect(const bool bSuccessful)
+{
+	const float SecondsToRecover = static_cast<float>(FPlatformTime::Seconds() - this->RecoveryStartTime);
+	if (bSuccessful)
+	{
+		UE_LOG(LogReconnect, Display, TEXT("Back in game after %.2f s (%d direct attempts)"), SecondsToRecover, this->DirectAttempts);
+	}
+	else
+	{
+		UE_LOG(LogReconnect, Warning, TEXT("Reconnect failed after %.2f s"), SecondsToRecover);
+	}
+
+	GetGameInstance()->GetTimerManager().ClearTimer(this->AttemptTimer);
+	this->Phase = EReconnectPhase::Idle;
+
+	//The session is gone, don't offer it again
+	if (!bSuccessful)
+	{
+		this->ForgetLastSession();
+	}
+
+	this->OnReconnectComplete.Broadcast(bSuccessful, SecondsToRecover);
+}
+
+void UReconnectSubsystem::HandleSessionDestroyed(const FNetworkManagerEvent& Event)
+{
+	//Leaving on purpose, nothing to come back to
+	if (this->Phase == EReconnectPhase::Idle)
+	{
+		this->ForgetLastSession();
+		return;
+	}
+
+	if (this->Phase != EReconnectPhase::DestroyingOldSession)
+	{
+		return;
+	}
+
+	//Owned lookup, so a server browser or QuickMatch search finishing meanwhile can't hand us its results
+	this->Phase = EReconnectPhase::SearchingSession;
+	TWeakObjectPtr<ThisClass> WeakThis(this);
+	this->GetNetworkManager()->FindSessionByIdAsync(this->LastSession->SessionId).Next([WeakThis](const FSessionSearchOutcome& Outcome)
+	{
+		if (ThisClass* Reconnect = WeakThis.Get())
+		{
+			Reconnect->OnSessionSearchComplete(Outcome);
+		}
+	});
+}
+
+void UReconnectSubsystem::HandleSessionDestroyFailure(const FNetworkManagerEvent& Event)
+{
+	//After a restart there is no local session to destroy
+	if (this->Phase == EReconnectPhase::DestroyingOldSession)
+	{
+		this->HandleSessionDestroyed(Event);
+	}
+}
+
+void UReconnectSubsystem::OnSessionSearchComplete(const FSessionSearchOutcome& Outcome)
+{
+	if (this->Phase != EReconnectPhase::SearchingSession)
+	{
+		return;
+	}
+
+	if (!Outcome.bSuccessful || Outcome.Results.IsEmpty())
+	{
+		UE_LOG(LogReconnect, Warning, TEXT("Session %s is gone: %s"), *this->LastSession->SessionId, *Outcome.Failure);
+		this->FinishReconnect(false);
+		return;
+	}
+
+	this->Phase = EReconnectPhase::JoiningSession;
+	TWeakObjectPtr<ThisClass> WeakThis(this);
+	this->GetNetworkManager()->JoinSessionAsync(USessionSearchResult::Make(Outcome.Results[0])).Next([WeakThis](const FSessionOpOutcome& JoinOutcome)
+	{
+		if (ThisClass* Reconnect = WeakThis.Get())
+		{
+			Reconnect->OnSessionJoinComplete(JoinOutcome);
+		}
+	});
+}
+
+void UReconnectSubsystem::OnSessionJoinComplete(const FSessionOpOutcome& Outcome)
+{
+	if (this->Phase != EReconnectPhase::JoiningSession)
+	{
+		return;
+	}
+
+	if (!Outcome.bSuccessful)
+	{
+		UE_LOG(LogReconnect, Warning, TEXT("Couldn't join session %s: %s"), *this->LastSession->SessionId, *Outcome.Failure);
+		this->FinishReconnect(false);
+		return;
+	}
+
+	this->Phase = EReconnectPhase::Travelling;
+	if (!this->GetNetworkManager()->ServerTravelAsClient_GameMap())
+	{
+		this->FinishReconnect(false);
+	}
+}
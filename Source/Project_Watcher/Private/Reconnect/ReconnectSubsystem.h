@@ -0,0 +1,193 @@
+//Project Watcher 2024 & Beyond
+
+#pragma once
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Engine/EngineBaseTypes.h"
+#include "ReconnectSubsystem.generated.h"
+
+class AController;
+class AGameModeBase;
+class UNetDriver;
+class UReconnectSaveGame;
+class UNetworkManagerGameInstance;
+struct FNetworkManagerEvent;
+struct FSessionOpOutcome;
+struct FSessionSearchOutcome;
+
+//Wrapper for BP data//
+
+/* Where a reconnect currently is */
+UENUM(BlueprintType)
+enum class EReconnectPhase : uint8
+{
+	Idle,
+	/* Connection dropped, waiting for the engine to put us back on the menu map */
+	WaitingForMenu,
+	/* Travelling straight to the cached connect string */
+	DirectRejoin,
+	/* Direct attempts ran out, clearing the dead session before looking it up again */
+	DestroyingOldSession,
+	/* Looking the session up by id */
+	SearchingSession,
+	JoiningSession,
+	/* Travelling into the game map of the session we found */
+	Travelling
+};
+
+//Wrapper for BP data//
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FReconnect_OnReconnectComplete, const bool, Successful, const float, SecondsToRecover);
+
+/**
+ * Gets a client back into the session it dropped out of without going through the server browser.
+ * The session id and resolved connect string are kept (and saved to disk) every time we arrive in a game map as a client.
+ * When the connection drops, the client travels straight back to the cached host a bounded number of times,
+ * then falls back to looking the session up by id and joining it the usual way.
+ * On the server, the state of a player that logs out is handed to UPlayerRestoreSubsystem so they come back where they left.
+ * Host migration takes precedence: when it handles the drop this subsystem stays out of the way.
+ */
+UCLASS(Config=Game)
+class UReconnectSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+private:
+	//Settings//
+
+	/* Master switch, when off a drop sends the player back to the menu as before */
+	UPROPERTY(Config)
+	bool bEnableReconnect = true;
+
+	/* Direct travels to the cached host before falling back to the search */
+	UPROPERTY(Config)
+	int32 MaxDirectAttempts = 3;
+
+	/* Seconds a direct travel may stay pending before it counts as failed */
+	UPROPERTY(Config)
+	float DirectAttemptTimeout = 5.f;
+
+	/* Seconds between direct travels */
+	UPROPERTY(Config)
+	float DirectRetryInterval = 1.f;
+
+	/* Seconds the saved session stays worth rejoining */
+	UPROPERTY(Config)
+	float ReconnectWindow = 300.f;
+
+	/* Server: keep the state of players that log out so a reconnect puts them back */
+	UPROPERTY(Config)
+	bool bRestoreReconnectingPlayers = true;
+
+	/* Server: seconds a logged out player's state stays valid */
+	UPROPERTY(Config)
+	float RestoreTimeToLive = 120.f;
+
+	//Settings//
+
+	UPROPERTY()
+	TObjectPtr<UReconnectSaveGame> LastSession;
+
+	EReconnectPhase Phase = EReconnectPhase::Idle;
+
+	/* When the connection dropped or the rejoin was requested */
+	double RecoveryStartTime = 0.0;
+
+	int32 DirectAttempts = 0;
+
+	FTimerHandle AttemptTimer;
+
+	FDelegateHandle NetworkFailureHandle;
+	FDelegateHandle TravelFailureHandle;
+	FDelegateHandle LogoutHandle;
+
+public:
+
+	//Initialization//
+
+	UReconnectSubsystem() { }
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	virtual void Deinitialize() override;
+
+	//Initialization//
+
+	//Reconnect Interface calls//
+
+	/**
+	 * If there is a recent enough session to rejoin, e.g. to show a Rejoin button after a crash
+	 * @return true when the saved session is within ReconnectWindow
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Reconnect")
+	bool CanRejoinLastSession() const;
+
+	/**
+	 * Rejoins the saved session from the menu, the result comes through OnReconnectComplete
+	 * @return If the rejoin started
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Reconnect")
+	bool RejoinLastSession();
+
+	/* Forgets the saved session, on disk too */
+	UFUNCTION(BlueprintCallable, Category = "Reconnect")
+	void ForgetLastSession();
+
+	/**
+	 * If a reconnect is in progress
+	 * @return Phase != Idle
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Reconnect")
+	bool IsReconnecting() const;
+
+	UPROPERTY(BlueprintCallable, BlueprintAssignable, Category = "Reconnect")
+	FReconnect_OnReconnectComplete OnReconnectComplete;
+
+	//Reconnect Interface calls//
+
+private:
+
+	//Reconnect internals//
+
+	UNetworkManagerGameInstance* GetNetworkManager() const;
+
+	/* If host migration has taken over the drop */
+	bool IsHostMigrating() const;
+
+	void HandleNetworkFailure(UWorld* World, UNetDriver* NetDriver, ENetworkFailure::Type FailureType, const FString& ErrorString);
+
+	void HandleTravelFailure(UWorld* World, ETravelFailure::Type FailureType, const FString& ErrorString);
+
+	void HandlePostLoadMap(UWorld* LoadedWorld);
+
+	/* Server: hands the leaving player's state to UPlayerRestoreSubsystem */
+	void HandleLogout(AGameModeBase* GameMode, AController* Exiting);
+
+	/* Caches and saves the session we just arrived in */
+	void RememberSession();
+
+	void StartDirectAttempt();
+
+	void OnDirectAttemptTimeout();
+
+	void OnDirectAttemptFailed();
+
+	void FinishReconnect(const bool bSuccessful);
+
+	/* Our own lookup of the saved session id resolved */
+	void OnSessionSearchComplete(const FSessionSearchOutcome& Outcome);
+
+	/* Our own join of the session we found resolved */
+	void OnSessionJoinComplete(const FSessionOpOutcome& Outcome);
+
+	//Reconnect internals//
+
+	//Network Manager callbacks//
+
+	void HandleSessionDestroyed(const FNetworkManagerEvent& Event);
+
+	void HandleSessionDestroyFailure(const FNetworkManagerEvent& Event);
+
+	//Network Manager callbacks//
+
+	friend class FReconnectSessionSearchTest;
+};
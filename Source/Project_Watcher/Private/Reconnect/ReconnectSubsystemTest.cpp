@@ -0,0 +1,59 @@
+//Project Watcher 2024 & Beyond
+
+#include "ReconnectSubsystem.h"
+#include "ReconnectSaveGame.h"
+#include "NetworkManagerGameInstance/NetworkManagerGameInstance.h"
+#include "WatcherTests/WatcherTestGameInstance.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/**
+ * Project.Watcher.Reconnect.SessionSearch
+ * Puts a client into the session lookup and the join and checks that only the outcomes of its own requests move the reconnect on,
+ * find sessions / join session completions broadcast for somebody else must not make it join or travel anywhere.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FReconnectSessionSearchTest, "Project.Watcher.Reconnect.SessionSearch",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FReconnectSessionSearchTest::RunTest(const FString& Parameters)
+{
+	const FWatcherTestGameInstance GameInstance;
+	UReconnectSubsystem* Reconnect = GameInstance.GetSubsystem<UReconnectSubsystem>();
+	UNetworkManagerGameInstance* NetworkManager = GameInstance.GetSubsystem<UNetworkManagerGameInstance>();
+	if (!TestNotNull(TEXT("Reconnect subsystem"), Reconnect) || !TestNotNull(TEXT("Network manager"), NetworkManager))
+	{
+		return false;
+	}
+
+	//Not saved, a failed reconnect would delete the slot
+	Reconnect->LastSession = NewObject<UReconnectSaveGame>(Reconnect);
+	Reconnect->LastSession->SessionId = TEXT("TestSession");
+	Reconnect->LastSession->ConnectString = TEXT("127.0.0.1:7777");
+	Reconnect->LastSession->SavedAt = FDateTime::UtcNow();
+	Reconnect->RecoveryStartTime = FPlatformTime::Seconds();
+
+	//Somebody else's search (server browser, QuickMatch...) finishing while our lookup is in flight
+	Reconnect->Phase = EReconnectPhase::SearchingSession;
+	NetworkManager->CallOnFindSessionsComplete({ FOnlineSessionSearchResult() });
+	NetworkManager->FlushEvents(0.f);
+	TestTrue(TEXT("Still searching after an unrelated search completed"), Reconnect->Phase == EReconnectPhase::SearchingSession);
+
+	//Somebody else's join finishing while ours is in flight
+	Reconnect->Phase = EReconnectPhase::JoiningSession;
+	NetworkManager->CallOnJoinSessionComplete(NetworkManager->GetSessionName());
+	NetworkManager->FlushEvents(0.f);
+	TestTrue(TEXT("Still joining after an unrelated join completed"), Reconnect->Phase == EReconnectPhase::JoiningSession);
+
+	//A lookup resolving after the reconnect ended must not start a join
+	Reconnect->Phase = EReconnectPhase::Idle;
+	FSessionSearchOutcome Late;
+	Late.bSuccessful = true;
+	Late.Results.Add(FOnlineSessionSearchResult());
+	Reconnect->OnSessionSearchComplete(Late);
+	TestTrue(TEXT("Late lookup outcome ignored"), Reconnect->Phase == EReconnectPhase::Idle);
+
+	return true;
+}
+
+#endif //WITH_DEV_AUTOMATION_TESTS
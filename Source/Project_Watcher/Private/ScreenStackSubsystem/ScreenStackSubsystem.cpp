@@ -0,0 +1,368 @@
+//Project Watcher 2024 & Beyond
+
+#include "ScreenStackSubsystem.h"
+#include "NetworkManagerGameInstance/NetworkManagerGameInstance.h"
+#include "HostMigration/HostMigrationSubsystem.h"
+#include "Reconnect/ReconnectSubsystem.h"
+#include "WatcherMemory/WatcherMemoryTags.h"
+#include "Blueprint/UserWidget.h"
+#include "Engine/AssetManager.h"
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "Engine/GameViewportClient.h"
+#include "UObject/UObjectGlobals.h"
+
+DECLARE_LOG_CATEGORY_EXTERN(LogScreenStack, Log, All);
+DEFINE_LOG_CATEGORY(LogScreenStack);
+
+DECLARE_STATS_GROUP(TEXT("ScreenStack"), STATGROUP_ScreenStack, STATCAT_Advanced);
+DECLARE_CYCLE_STAT(TEXT("Screen Transition"), STAT_ScreenStack_Transition, STATGROUP_ScreenStack);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Widgets Created"), STAT_ScreenStack_WidgetsCreated, STATGROUP_ScreenStack);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Widgets Reused"), STAT_ScreenStack_WidgetsReused, STATGROUP_ScreenStack);
+
+void UScreenStackSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	FCoreUObjectDelegates::PreLoadMap.AddUObject(this, &ThisClass::OnPreLoadMap);
+
+	if (UNetworkManagerGameInstance* NetworkManager = Collection.InitializeDependency<UNetworkManagerGameInstance>())
+	{
+		NetworkManager->OnNativeEvent(ENetworkManagerEvent::CreateSessionComplete).AddUObject(this, &ThisClass::HandleSessionCreated);
+		NetworkManager->OnNativeEvent(ENetworkManagerEvent::JoinSessionComplete).AddUObject(this, &ThisClass::HandleSessionJoined);
+		NetworkManager->OnNativeEvent(ENetworkManagerEvent::DestroySessionComplete).AddUObject(this, &ThisClass::HandleSessionDestroyed);
+		NetworkManager->OnNativeEvent(ENetworkManagerEvent::CreateSessionFailure).AddUObject(this, &ThisClass::HandleSessionFailure);
+		NetworkManager->OnNativeEvent(ENetworkManagerEvent::JoinSessionFailure).AddUObject(this, &ThisClass::HandleSessionFailure);
+	}
+
+	//Dedicated servers never show UI
+	if (!IsRunningDedicatedServer())
+	{
+		this->PreloadScreens(this->PreloadOnStartup);
+	}
+}
+
+void UScreenStackSubsystem::Deinitialize()
+{
+	FCoreUObjectDelegates::PreLoadMap.RemoveAll(this);
+
+	if (UNetworkManagerGameInstance* NetworkManager = GetGameInstance()->GetSubsystem<UNetworkManagerGameInstance>())
+	{
+		NetworkManager->RemoveNativeListener(this);
+	}
+
+	for (TPair<EWatcherScreen, TSharedPtr<FStreamableHandle>>& Pair : this->LoadHandles)
+	{
+		if (Pair.Value.IsValid())
+		{
+			Pair.Value->CancelHandle();
+		}
+	}
+	this->LoadHandles.Empty();
+	this->Stack.Empty();
+	this->WidgetPools.Empty();
+
+	Super::Deinitialize();
+}
+
+void UScreenStackSubsystem::PreloadScreens(const TArray<EWatcherScreen>& Screens)
+{
+	LLM_SCOPE_BYTAG(Watcher_UI);
+	for (const EWatcherScreen Screen : Screens)
+	{
+		if (this->LoadedClasses.Contains(Screen) || this->LoadHandles.Contains(Screen))
+		{
+			continue;
+		}
+
+		const TSoftClassPtr<UUserWidget> SoftClass = this->ResolveScreenClass(Screen);
+		if (SoftClass.IsNull())
+		{
+			UE_LOG(LogScreenStack, Warning, TEXT("No widget class configured for screen %s"), *UEnum::GetValueAsString(Screen));
+			continue;
+		}
+
+		this->LoadHandles.Add(Screen, UAssetManager::GetStreamableManager().RequestAsyncLoad(
+			SoftClass.ToSoftObjectPath(),
+			FStreamableDelegate::CreateUObject(this, &ThisClass::OnScreenClassLoaded, Screen),
+			FStreamableManager::AsyncLoadHighPriority));
+	}
+}
+
+void UScreenStackSubsystem::PushScreen(const EWatcherScreen Screen)
+{
+	if (Screen == EWatcherScreen::None)
+	{
+		return;
+	}
+
+	if (const TSubclassOf<UUserWidget>* WidgetClass = this->LoadedClasses.Find(Screen))
+	{
+		this->PushLoadedScreen(Screen, *WidgetClass);
+		return;
+	}
+
+	//Not resident yet, push as soon as the load lands. Only the latest request wins
+	this->DeferredScreen = Screen;
+	this->bDeferredReplace = false;
+	this->TransitionStats.DeferredPushes++;
+	this->PreloadScreens({ Screen });
+}
+
+void UScreenStackSubsystem::PopScreen()
+{
+	if (this->Stack.IsEmpty())
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_ScreenStack_Transition);
+	const double StartTime = FPlatformTime::Seconds();
+
+	const FScreenStackEntry Top = this->Stack.Pop();
+	this->ReleaseWidget(Top.Widget);
+	this->ShowTopScreen();
+
+	this->RecordTransition(StartTime);
+}
+
+void UScreenStackSubsystem::ReplaceScreen(const EWatcherScreen Screen)
+{
+	if (Screen == EWatcherScreen::None)
+	{
+		this->ReleaseTopScreen();
+		return;
+	}
+
+	if (const TSubclassOf<UUserWidget>* WidgetClass = this->LoadedClasses.Find(Screen))
+	{
+		this->ReleaseTopScreen();
+		this->PushLoadedScreen(Screen, *WidgetClass);
+		return;
+	}
+
+	//Keep the current screen up while the load lands so the stack is never empty in between
+	this->DeferredScreen = Screen;
+	this->bDeferredReplace = true;
+	this->TransitionStats.DeferredPushes++;
+	this->PreloadScreens({ Screen });
+}
+
+void UScreenStackSubsystem::ClearScreens()
+{
+	while (!this->Stack.IsEmpty())
+	{
+		const FScreenStackEntry Top = this->Stack.Pop();
+		this->ReleaseWidget(Top.Widget);
+	}
+	this->DeferredScreen = EWatcherScreen::None;
+	this->bDeferredReplace = false;
+}
+
+EWatcherScreen UScreenStackSubsystem::GetTopScreen() const
+{
+	return this->Stack.IsEmpty() ? EWatcherScreen::None : this->Stack.Last().Screen;
+}
+
+FScreenTransitionStats UScreenStackSubsystem::GetTransitionStats() const
+{
+	return this->TransitionStats;
+}
+
+bool UScreenStackSubsystem::IsSessionRecoveryInProgress() const
+{
+	const UGameInstance* GameInstance = GetGameInstance();
+	const UHostMigrationSubsystem* HostMigration = GameInstance->GetSubsystem<UHostMigrationSubsystem>();
+	const UReconnectSubsystem* Reconnect = GameInstance->GetSubsystem<UReconnectSubsystem>();
+	const UNetworkManagerGameInstance* NetworkManager = GameInstance->GetSubsystem<UNetworkManagerGameInstance>();
+	return (HostMigration && HostMigration->IsMigrating())
+		|| (Reconnect && Reconnect->IsReconnecting())
+		|| (NetworkManager && NetworkManager->IsQuickMatching());
+}
+
+TSoftClassPtr<UUserWidget> UScreenStackSubsystem::ResolveScreenClass(const EWatcherScreen Screen) const
+{
+	const FScreenClassEntry* Entry = this->ScreenClasses.FindByPredicate([Screen](const FScreenClassEntry& Candidate)
+	{
+		return Candidate.Screen == Screen;
+	});
+
+	if (!Entry)
+	{
+		return TSoftClassPtr<UUserWidget>();
+	}
+
+	if (!Entry->UltraWideWidgetClass.IsNull() && GEngine && GEngine->GameViewport)
+	{
+		FVector2D ViewportSize;
+		GEngine->GameViewport->GetViewportSize(ViewportSize);
+		if (ViewportSize.Y > 0.f && ViewportSize.X / ViewportSize.Y >= this->UltraWideAspectRatio)
+		{
+			return Entry->UltraWideWidgetClass;
+		}
+	}
+
+	return Entry->WidgetClass;
+}
+
+void UScreenStackSubsystem::OnScreenClassLoaded(const EWatcherScreen Screen)
+{
+	LLM_SCOPE_BYTAG(Watcher_UI);
+	TSubclassOf<UUserWidget> WidgetClass = this->ResolveScreenClass(Screen).Get();
+	if (!WidgetClass)
+	{
+		UE_LOG(LogScreenStack, Error, TEXT("Failed to load widget class for screen %s"), *UEnum::GetValueAsString(Screen));
+		this->LoadHandles.Remove(Screen);
+		return;
+	}
+
+	this->LoadedClasses.Add(Screen, WidgetClass);
+
+	if (this->DeferredScreen == Screen)
+	{
+		this->DeferredScreen = EWatcherScreen::None;
+		if (this->bDeferredReplace)
+		{
+			this->bDeferredReplace = false;
+			this->ReleaseTopScreen();
+		}
+		this->PushLoadedScreen(Screen, WidgetClass);
+	}
+}
+
+UUserWidget* UScreenStackSubsystem::AcquireWidget(TSubclassOf<UUserWidget> WidgetClass)
+{
+	LLM_SCOPE_BYTAG(Watcher_UI);
+	FScreenWidgetPool& Pool = this->WidgetPools.FindOrAdd(WidgetClass);
+	while (!Pool.Widgets.IsEmpty())
+	{
+		UUserWidget* Widget = Pool.Widgets.Pop(EAllowShrinking::No);
+		if (IsValid(Widget))
+		{
+			this->TransitionStats.WidgetsReused++;
+			INC_DWORD_STAT(STAT_ScreenStack_WidgetsReused);
+			return Widget;
+		}
+	}
+
+	this->TransitionStats.WidgetsCreated++;
+	INC_DWORD_STAT(STAT_ScreenStack_WidgetsCreated);
+	return CreateWidget<UUserWidget>(GetGameInstance(), WidgetClass);
+}
+
+void UScreenStackSubsystem::ReleaseWidget(UUserWidget* Widget)
+{
+	if (!IsValid(Widget))
+	{
+		return;
+	}
+
+	Widget->RemoveFromParent();
+	this->WidgetPools.FindOrAdd(Widget->GetClass()).Widgets.Add(Widget);
+}
+
+void UScreenStackSubsystem::PushLoadedScreen(const EWatcherScreen Screen, TSubclassOf<UUserWidget> WidgetClass)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ScreenStack_Transition);
+	const double StartTime = FPlatformTime::Seconds();
+
+	UUserWidget* Widget = this->AcquireWidget(WidgetClass);
+	if (!Widget)
+	{
+		UE_LOG(LogScreenStack, Error, TEXT("Failed to create widget for screen %s"), *UEnum::GetValueAsString(Screen));
+		return;
+	}
+
+	if (!this->Stack.IsEmpty() && IsValid(this->Stack.Last().Widget))
+	{
+		this->Stack.Last().Widget->SetVisibility(ESlateVisibility::Collapsed);
+	}
+
+	FScreenStackEntry& Entry = this->Stack.AddDefaulted_GetRef();
+	Entry.Screen = Screen;
+	Entry.Widget = Widget;
+
+	//Headless runs (automation, -nullrhi) have no viewport to add to, the stack and pool still work
+	if (!Widget->IsInViewport() && GetGameInstance()->GetGameViewportClient())
+	{
+		Widget->AddToViewport(this->Stack.Num());
+	}
+	this->ShowTopScreen();
+
+	this->RecordTransition(StartTime);
+}
+
+void UScreenStackSubsystem::ShowTopScreen()
+{
+	if (this->Stack.IsEmpty())
+	{
+		this->OnScreenChanged.Broadcast(EWatcherScreen::None, nullptr);
+		return;
+	}
+
+	const FScreenStackEntry& Top = this->Stack.Last();
+	if (IsValid(Top.Widget))
+	{
+		Top.Widget->SetVisibility(ESlateVisibility::SelfHitTestInvisible);
+	}
+	this->OnScreenChanged.Broadcast(Top.Screen, Top.Widget);
+}
+
+void UScreenStackSubsystem::RecordTransition(const double StartTime)
+{
+	const float ElapsedMs = static_cast<float>((FPlatformTime::Seconds() - StartTime) * 1000.0);
+	this->TransitionStats.LastTransitionMs = ElapsedMs;
+	this->TransitionStats.PeakTransitionMs = FMath::Max(this->TransitionStats.PeakTransitionMs, ElapsedMs);
+	this->TransitionStats.Transitions++;
+	UE_LOG(LogScreenStack, Verbose, TEXT("Screen transition to %s took %.3f ms"), *UEnum::GetValueAsString(this->GetTopScreen()), ElapsedMs);
+}
+
+void UScreenStackSubsystem::OnPreLoadMap(const FString& MapName)
+{
+	this->ClearScreens();
+}
+
+void UScreenStackSubsystem::ReleaseTopScreen()
+{
+	if (!this->Stack.IsEmpty())
+	{
+		const FScreenStackEntry Top = this->Stack.Pop();
+		this->ReleaseWidget(Top.Widget);
+	}
+}
+
+void UScreenStackSubsystem::HandleSessionCreated(const FNetworkManagerEvent& Event)
+{
+	this->ReplaceScreen(EWatcherScreen::LoadingScreen);
+}
+
+void UScreenStackSubsystem::HandleSessionJoined(const FNetworkManagerEvent& Event)
+{
+	this->ReplaceScreen(EWatcherScreen::LoadingScreen);
+}
+
+void UScreenStackSubsystem::HandleSessionDestroyed(const FNetworkManagerEvent& Event)
+{
+	//Migration, reconnect and QuickMatch destroy the old session on their way to the next one
+	if (this->IsSessionRecoveryInProgress())
+	{
+		return;
+	}
+
+	this->ClearScreens();
+	this->PushScreen(EWatcherScreen::SplashScreen);
+}
+
+void UScreenStackSubsystem::HandleSessionFailure(const FNetworkManagerEvent& Event)
+{
+	//A failed attempt inside a recovery is retried, keep the loading screen up
+	if (this->IsSessionRecoveryInProgress())
+	{
+		return;
+	}
+
+	if (this->GetTopScreen() == EWatcherScreen::LoadingScreen)
+	{
+		this->PopScreen();
+	}
+}
@@ -0,0 +1,256 @@
+//Project Watcher 2024 & Beyond
+
+#pragma once
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Engine/StreamableManager.h"
+#include "ScreenStackSubsystem.generated.h"
+
+class UUserWidget;
+struct FNetworkManagerEvent;
+
+//Wrapper for BP data//
+
+UENUM(BlueprintType)
+enum class EWatcherScreen : uint8
+{
+	None,
+	SplashScreen,
+	FindSessions,
+	CreateSession,
+	LoadingScreen,
+	Pause
+};
+
+/* Config entry mapping a screen to its widget classes, mirrors the AR_ScreenType_Resolvers pairs */
+USTRUCT()
+struct FScreenClassEntry
+{
+	GENERATED_USTRUCT_BODY()
+public:
+	UPROPERTY()
+	EWatcherScreen Screen = EWatcherScreen::None;
+	/* 16:9 widget, used for every aspect ratio that has no dedicated variant */
+	UPROPERTY()
+	TSoftClassPtr<UUserWidget> WidgetClass;
+	/* Optional 21:9 widget */
+	UPROPERTY()
+	TSoftClassPtr<UUserWidget> UltraWideWidgetClass;
+};
+
+USTRUCT(BlueprintType)
+struct FScreenTransitionStats
+{
+	GENERATED_USTRUCT_BODY()
+public:
+	/* Game thread time of the last push / pop / replace */
+	UPROPERTY(BlueprintReadOnly, Category = "Screen Stack")
+	float LastTransitionMs = 0.f;
+	/* Slowest transition so far */
+	UPROPERTY(BlueprintReadOnly, Category = "Screen Stack")
+	float PeakTransitionMs = 0.f;
+	UPROPERTY(BlueprintReadOnly, Category = "Screen Stack")
+	int32 Transitions = 0;
+	/* Widgets that had to be constructed with CreateWidget */
+	UPROPERTY(BlueprintReadOnly, Category = "Screen Stack")
+	int32 WidgetsCreated = 0;
+	/* Widgets served from the pool */
+	UPROPERTY(BlueprintReadOnly, Category = "Screen Stack")
+	int32 WidgetsReused = 0;
+	/* Pushes that had to wait on a class that wasn't loaded yet */
+	UPROPERTY(BlueprintReadOnly, Category = "Screen Stack")
+	int32 DeferredPushes = 0;
+};
+
+USTRUCT()
+struct FScreenWidgetPool
+{
+	GENERATED_USTRUCT_BODY()
+public:
+	UPROPERTY()
+	TArray<TObjectPtr<UUserWidget>> Widgets;
+};
+
+USTRUCT()
+struct FScreenStackEntry
+{
+	GENERATED_USTRUCT_BODY()
+public:
+	UPROPERTY()
+	EWatcherScreen Screen = EWatcherScreen::None;
+	UPROPERTY()
+	TObjectPtr<UUserWidget> Widget = nullptr;
+};
+
+//Wrapper for BP data//
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FScreenStack_OnScreenChanged, const EWatcherScreen, NewTopScreen, UUserWidget*, Widget);
+
+/**
+ * Native screen flow for the AR_Screen widgets.
+ * Screen widget classes are async loaded ahead of need, instances are pooled and reused instead of
+ * being created / destroyed on every switch, and session events from UNetworkManagerGameInstance drive
+ * the loading screen without going through Blueprint. Session events that are part of a recovery
+ * (host migration, reconnect, QuickMatch) leave the stack alone.
+ */
+UCLASS(Config=Game)
+class UScreenStackSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+private:
+	//Settings//
+
+	/* Widget classes per screen */
+	UPROPERTY(Config)
+	TArray<FScreenClassEntry> ScreenClasses;
+
+	/* Screens loaded as soon as the game instance starts */
+	UPROPERTY(Config)
+	TArray<EWatcherScreen> PreloadOnStartup;
+
+	/* Viewport aspect ratio from which the 21:9 variant is used */
+	UPROPERTY(Config)
+	float UltraWideAspectRatio = 2.2f;
+
+	//Settings//
+
+	/* Bottom to top */
+	UPROPERTY()
+	TArray<FScreenStackEntry> Stack;
+
+	/* Parked widget instances keyed by class */
+	UPROPERTY()
+	TMap<TSubclassOf<UUserWidget>, FScreenWidgetPool> WidgetPools;
+
+	/* Classes resolved by the async loads */
+	UPROPERTY()
+	TMap<EWatcherScreen, TSubclassOf<UUserWidget>> LoadedClasses;
+
+	/* In flight / completed loads, kept so the classes stay resident */
+	TMap<EWatcherScreen, TSharedPtr<FStreamableHandle>> LoadHandles;
+
+	/* Latest push requested for a class that was still loading */
+	EWatcherScreen DeferredScreen = EWatcherScreen::None;
+
+	/* The deferred push replaces the top screen once it lands, the top stays up until then */
+	bool bDeferredReplace = false;
+
+	FScreenTransitionStats TransitionStats;
+
+public:
+
+	//Initialization//
+
+	UScreenStackSubsystem() { }
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	virtual void Deinitialize() override;
+
+	//Initialization//
+
+	//Screen Stack Interface calls//
+
+	/**
+	 * Starts async loading the widget classes for the given screens
+	 * @param Screens Screens expected to be shown soon
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure=false, Category = "Screen Stack")
+	void PreloadScreens(const TArray<EWatcherScreen>& Screens);
+
+	/**
+	 * Shows a screen on top of the current one, the current one gets collapsed
+	 * If the class isn't loaded yet the push happens as soon as it is
+	 * @param Screen The screen to show
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure=false, Category = "Screen Stack")
+	void PushScreen(const EWatcherScreen Screen);
+
+	/**
+	 * Removes the top screen and shows the one below it
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure=false, Category = "Screen Stack")
+	void PopScreen();
+
+	/**
+	 * Swaps the top screen for another one
+	 * If the class isn't loaded yet the current screen stays up until it is
+	 * @param Screen The screen to show
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure=false, Category = "Screen Stack")
+	void ReplaceScreen(const EWatcherScreen Screen);
+
+	/**
+	 * Returns every screen to the pool
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure=false, Category = "Screen Stack")
+	void ClearScreens();
+
+	/* The screen currently on top */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Screen Stack")
+	EWatcherScreen GetTopScreen() const;
+
+	/* Transition timings and allocation counts */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Screen Stack")
+	FScreenTransitionStats GetTransitionStats() const;
+
+	/**
+	 * If a host migration, reconnect or QuickMatch is working on the session right now
+	 * The session event handlers check it before a destroyed / failed session sends the player back to the splash screen, AR_ScreenLogic can too
+	 * @return If session events are part of a recovery the player shouldn't see
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Screen Stack")
+	bool IsSessionRecoveryInProgress() const;
+
+	UPROPERTY(BlueprintCallable, BlueprintAssignable, Category = "Screen Stack")
+	FScreenStack_OnScreenChanged OnScreenChanged;
+
+	//Screen Stack Interface calls//
+
+private:
+
+	//Stack internals//
+
+	/* Resolves the soft class for a screen given the current viewport */
+	TSoftClassPtr<UUserWidget> ResolveScreenClass(const EWatcherScreen Screen) const;
+
+	/* Called when an async class load finishes */
+	void OnScreenClassLoaded(const EWatcherScreen Screen);
+
+	/* Takes a widget from the pool or creates one */
+	UUserWidget* AcquireWidget(TSubclassOf<UUserWidget> WidgetClass);
+
+	/* Removes the widget from the viewport and parks it */
+	void ReleaseWidget(UUserWidget* Widget);
+
+	/* Does the actual push once the class is loaded */
+	void PushLoadedScreen(const EWatcherScreen Screen, TSubclassOf<UUserWidget> WidgetClass);
+
+	/* Makes the top entry visible and broadcasts OnScreenChanged */
+	void ShowTopScreen();
+
+	/* Records how long a transition took */
+	void RecordTransition(const double StartTime);
+
+	/* Viewport widgets don't survive LoadMap, return them to the pool first */
+	void OnPreLoadMap(const FString& MapName);
+
+	/* Pops the top entry back into the pool without showing the one below, the caller pushes next */
+	void ReleaseTopScreen();
+
+	//Stack internals//
+
+	//Network Manager bindings//
+
+	void HandleSessionCreated(const FNetworkManagerEvent& Event);
+
+	void HandleSessionJoined(const FNetworkManagerEvent& Event);
+
+	void HandleSessionDestroyed(const FNetworkManagerEvent& Event);
+
+	void HandleSessionFailure(const FNetworkManagerEvent& Event);
+
+	//Network Manager bindings//
+
+	friend class FScreenStackTransitionTest;
+};
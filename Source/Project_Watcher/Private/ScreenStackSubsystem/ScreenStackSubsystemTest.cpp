@@ -0,0 +1,99 @@
+//Project Watcher 2024 & Beyond
+
+#include "ScreenStackSubsystem.h"
+#include "WatcherTests/WatcherTestGameInstance.h"
+#include "Blueprint/UserWidget.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/**
+ * Project.Watcher.ScreenStack.Transitions
+ * Cycles two screens and checks that, once the pool is warm, every push reuses the same pooled instance,
+ * the pool and stack hold what they should after each transition and no widget gets constructed. Timings are only logged.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FScreenStackTransitionTest, "Project.Watcher.ScreenStack.Transitions",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+namespace ScreenStackTest
+{
+	/* Transitions measured once the pool is warm */
+	static constexpr int32 Cycles = 200;
+}
+
+bool FScreenStackTransitionTest::RunTest(const FString& Parameters)
+{
+	const FWatcherTestGameInstance GameInstance;
+	UScreenStackSubsystem* ScreenStack = GameInstance.GetSubsystem<UScreenStackSubsystem>();
+	if (!TestNotNull(TEXT("Screen stack subsystem"), ScreenStack))
+	{
+		return false;
+	}
+
+	//Resolved synchronously so the measured pushes aren't deferred behind the async loads
+	for (const EWatcherScreen Screen : { EWatcherScreen::SplashScreen, EWatcherScreen::LoadingScreen })
+	{
+		const TSubclassOf<UUserWidget> WidgetClass = ScreenStack->ResolveScreenClass(Screen).LoadSynchronous();
+		if (!TestNotNull(*FString::Printf(TEXT("Widget class for %s"), *UEnum::GetValueAsString(Screen)), WidgetClass.Get()))
+		{
+			return false;
+		}
+		ScreenStack->LoadedClasses.Add(Screen, WidgetClass);
+	}
+
+	//Warm up, every class gets constructed once
+	ScreenStack->PushScreen(EWatcherScreen::SplashScreen);
+	ScreenStack->ReplaceScreen(EWatcherScreen::LoadingScreen);
+	ScreenStack->ReplaceScreen(EWatcherScreen::SplashScreen);
+	TestTrue(TEXT("Splash screen on top after warm up"), ScreenStack->GetTopScreen() == EWatcherScreen::SplashScreen);
+
+	const TSubclassOf<UUserWidget> LoadingClass = ScreenStack->LoadedClasses.FindChecked(EWatcherScreen::LoadingScreen);
+	auto ParkedLoadingScreens = [ScreenStack, LoadingClass]()
+	{
+		const FScreenWidgetPool* Pool = ScreenStack->WidgetPools.Find(LoadingClass);
+		return Pool ? Pool->Widgets.Num() : 0;
+	};
+	TestEqual(TEXT("Stack depth after warm up"), ScreenStack->Stack.Num(), 1);
+	TestEqual(TEXT("Loading screens parked after warm up"), ParkedLoadingScreens(), 1);
+
+	const FScreenTransitionStats WarmStats = ScreenStack->GetTransitionStats();
+	const UUserWidget* const PooledLoadingScreen = ScreenStack->WidgetPools.FindChecked(LoadingClass).Widgets.Last();
+
+	float TotalMs = 0.f;
+	int32 SameInstancePushes = 0;
+	int32 MismatchedTransitions = 0;
+	for (int32 Cycle = 0; Cycle < ScreenStackTest::Cycles; ++Cycle)
+	{
+		ScreenStack->PushScreen(EWatcherScreen::LoadingScreen);
+		TotalMs += ScreenStack->GetTransitionStats().LastTransitionMs;
+		SameInstancePushes += ScreenStack->Stack.Last().Widget == PooledLoadingScreen ? 1 : 0;
+		MismatchedTransitions += ScreenStack->Stack.Num() != 2 || ParkedLoadingScreens() != 0 ? 1 : 0;
+
+		ScreenStack->PopScreen();
+		TotalMs += ScreenStack->GetTransitionStats().LastTransitionMs;
+		MismatchedTransitions += ScreenStack->Stack.Num() != 1 || ParkedLoadingScreens() != 1 ? 1 : 0;
+	}
+
+	const FScreenTransitionStats Stats = ScreenStack->GetTransitionStats();
+	const int32 Transitions = Stats.Transitions - WarmStats.Transitions;
+	const float AverageMs = Transitions > 0 ? TotalMs / Transitions : 0.f;
+	AddInfo(FString::Printf(TEXT("%d warm transitions, average %.4f ms, peak %.4f ms, %d widgets created, %d reused"),
+		Transitions, AverageMs, Stats.PeakTransitionMs, Stats.WidgetsCreated, Stats.WidgetsReused));
+
+	TestEqual(TEXT("Warm transitions"), Transitions, ScreenStackTest::Cycles * 2);
+	TestEqual(TEXT("Widgets constructed by warm transitions"), Stats.WidgetsCreated, WarmStats.WidgetsCreated);
+	TestEqual(TEXT("Widgets served from the pool"), Stats.WidgetsReused - WarmStats.WidgetsReused, ScreenStackTest::Cycles);
+	TestEqual(TEXT("Pushes that reused the pooled loading screen"), SameInstancePushes, ScreenStackTest::Cycles);
+	TestEqual(TEXT("Transitions with the wrong stack depth or pool count"), MismatchedTransitions, 0);
+
+	//A replace with a class that is still loading keeps the current screen up
+	ScreenStack->LoadedClasses.Remove(EWatcherScreen::LoadingScreen);
+	ScreenStack->ReplaceScreen(EWatcherScreen::LoadingScreen);
+	TestTrue(TEXT("Top screen kept while the replacement loads"), ScreenStack->GetTopScreen() == EWatcherScreen::SplashScreen);
+	ScreenStack->LoadedClasses.Add(EWatcherScreen::LoadingScreen, LoadingClass);
+
+	ScreenStack->ClearScreens();
+	return true;
+}
+
+#endif //WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,145 @@
+//Project Watcher 2024 & Beyond
+
+#include "ServerCookReportCommandlet.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "UObject/Package.h"
+#include "UObject/UObjectHash.h"
+
+DECLARE_LOG_CATEGORY_EXTERN(LogServerCookReport, Log, All);
+DEFINE_LOG_CATEGORY(LogServerCookReport);
+
+namespace ServerCookReport
+{
+	/* Packages loaded between garbage collections, keeps the commandlet's memory flat on big maps */
+	static constexpr int32 PackagesPerCollect = 200;
+
+	struct FClassTotals
+	{
+		int32 Objects = 0;
+		int64 Bytes = 0;
+	};
+}
+
+UServerCookReportCommandlet::UServerCookReportCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+	HelpDescription = TEXT("Reports the objects a dedicated server cook strips from the project's packages");
+	HelpUsage = TEXT("-run=ServerCookReport [-Paths=/Game/Core/Maps+/Game/World_Building] [-Out=Saved/ServerCook/Report.csv]");
+}
+
+int32 UServerCookReportCommandlet::Main(const FString& Params)
+{
+	FString PathsValue = TEXT("/Game");
+	FParse::Value(*Params, TEXT("Paths="), PathsValue);
+	TArray<FString> Paths;
+	PathsValue.ParseIntoArray(Paths, TEXT("+"));
+
+	FString OutFile = FPaths::ProjectSavedDir() / TEXT("ServerCook/Report.csv");
+	FParse::Value(*Params, TEXT("Out="), OutFile);
+
+	//The exclusion list is applied when the cooker settings are first created, make sure that happened
+	if (UClass* CookerSettingsClass = FindObject<UClass>(nullptr, TEXT("/Script/UnrealEd.CookerSettings")))
+	{
+		CookerSettingsClass->GetDefaultObject();
+	}
+
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+	AssetRegistry.SearchAllAssets(true);
+
+	FARFilter Filter;
+	Filter.bRecursivePaths = true;
+	for (const FString& Path : Paths)
+	{
+		Filter.PackagePaths.Add(FName(*Path));
+	}
+
+	TArray<FAssetData> Assets;
+	AssetRegistry.GetAssets(Filter, Assets);
+
+	TSet<FName> PackageNames;
+	for (const FAssetData& Asset : Assets)
+	{
+		PackageNames.Add(Asset.PackageName);
+	}
+
+	UE_LOG(LogServerCookReport, Display, TEXT("Scanning %d packages under %s"), PackageNames.Num(), *PathsValue);
+
+	TMap<FName, ServerCookReport::FClassTotals> StrippedByClass;
+	int32 PackagesScanned = 0;
+	int32 PackagesFullyStripped = 0;
+
+	for (const FName PackageName : PackageNames)
+	{
+		UPackage* Package = LoadPackage(nullptr, *PackageName.ToString(), LOAD_NoWarn | LOAD_Quiet);
+		if (!Package)
+		{
+			UE_LOG(LogServerCookReport, Warning, TEXT("Couldn't load %s"), *PackageName.ToString());
+			continue;
+		}
+		++PackagesScanned;
+
+		bool bKeepsAnAsset = false;
+		bool bHasAsset = false;
+		ForEachObjectWithPackage(Package, [&StrippedByClass, &bKeepsAnAsset, &bHasAsset](UObject* Object)
+		{
+			const bool bStripped = !Object->NeedsLoadForServer();
+			if (Object->IsAsset())
+			{
+				bHasAsset = true;
+				bKeepsAnAsset |= !bStripped;
+			}
+
+			//Children of a stripped object go with it, only count the outermost one
+			const UObject* Outer = Object->GetOuter();
+			if (bStripped && (!Outer || Outer->IsA<UPackage>() || Outer->NeedsLoadForServer()))
+			{
+				ServerCookReport::FClassTotals& Totals = StrippedByClass.FindOrAdd(Object->GetClass()->GetFName());
+				++Totals.Objects;
+				Totals.Bytes += Object->GetResourceSizeBytes(EResourceSizeMode::Exclusive);
+			}
+			return true;
+		});
+
+		//Nothing left to save, the package isn't staged for the server at all
+		if (bHasAsset && !bKeepsAnAsset)
+		{
+			++PackagesFullyStripped;
+		}
+
+		if (PackagesScanned % ServerCookReport::PackagesPerCollect == 0)
+		{
+			CollectGarbage(RF_NoFlags);
+		}
+	}
+
+	StrippedByClass.ValueSort([](const ServerCookReport::FClassTotals& A, const ServerCookReport::FClassTotals& B) { return A.Bytes > B.Bytes; });
+
+	int64 TotalBytes = 0;
+	int32 TotalObjects = 0;
+	FString Report = TEXT("Class,Objects,ApproxBytes\n");
+	for (const TPair<FName, ServerCookReport::FClassTotals>& Pair : StrippedByClass)
+	{
+		Report += FString::Printf(TEXT("%s,%d,%lld\n"), *Pair.Key.ToString(), Pair.Value.Objects, Pair.Value.Bytes);
+		UE_LOG(LogServerCookReport, Display, TEXT("  %-40s %8d objects %10.2f MB"), *Pair.Key.ToString(), Pair.Value.Objects, Pair.Value.Bytes / (1024.0 * 1024.0));
+		TotalBytes += Pair.Value.Bytes;
+		TotalObjects += Pair.Value.Objects;
+	}
+
+	UE_LOG(LogServerCookReport, Display, TEXT("Server cook strips %d objects (~%.2f MB, editor sizes) across %d packages, %d of %d packages are dropped entirely"),
+		TotalObjects, TotalBytes / (1024.0 * 1024.0), PackagesScanned, PackagesFullyStripped, PackagesScanned);
+
+	if (!FFileHelper::SaveStringToFile(Report, *OutFile))
+	{
+		UE_LOG(LogServerCookReport, Error, TEXT("Couldn't write %s"), *OutFile);
+		return 1;
+	}
+
+	UE_LOG(LogServerCookReport, Display, TEXT("Report written to %s"), *OutFile);
+	return 0;
+}
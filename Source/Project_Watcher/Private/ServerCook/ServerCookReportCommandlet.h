@@ -0,0 +1,23 @@
+//Project Watcher 2024 & Beyond
+
+#pragma once
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ServerCookReportCommandlet.generated.h"
+
+/**
+ * Reports what a dedicated server cook strips from the project's packages.
+ * Loads every package under the given paths and collects the objects whose NeedsLoadForServer() is false,
+ * which is what the cooker leaves out of server packages (ClassesExcludedOnDedicatedServer in DefaultEngine.ini plus engine rules).
+ *
+ * UnrealEditor-Cmd Project_Watcher.uproject -run=ServerCookReport [-Paths=/Game/Core/Maps+/Game/World_Building] [-Out=Saved/ServerCook/Report.csv]
+ */
+UCLASS()
+class UServerCookReportCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+public:
+	UServerCookReportCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
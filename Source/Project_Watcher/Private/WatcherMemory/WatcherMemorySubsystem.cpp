@@ -0,0 +1,189 @@
+//Project Watcher 2024 & Beyond
+
+#include "WatcherMemorySubsystem.h"
+#include "WatcherMemoryTags.h"
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "Engine/Level.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/CommandLine.h"
+#include "Misc/PackageName.h"
+#include "TimerManager.h"
+#include "UObject/UObjectGlobals.h"
+
+DECLARE_LOG_CATEGORY_EXTERN(LogWatcherMemory, Log, All);
+DEFINE_LOG_CATEGORY(LogWatcherMemory);
+
+void UWatcherMemorySubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	if (this->bCheckBudgets && !this->Budgets.IsEmpty())
+	{
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+		if (FLowLevelMemTracker::IsEnabled())
+		{
+			this->BudgetTickerHandle = FTSTicker::GetCoreTicker().AddTicker(
+				FTickerDelegate::CreateUObject(this, &ThisClass::CheckBudgets), this->BudgetCheckInterval);
+		}
+		else
+#endif
+		{
+			UE_LOG(LogWatcherMemory, Log, TEXT("Memory budgets configured but LLM is off, run with -llm to check them"));
+		}
+	}
+
+	this->bCaptureMemReports |= FParse::Param(FCommandLine::Get(), TEXT("WatcherMemReports"));
+	if (this->bCaptureMemReports)
+	{
+		FCoreUObjectDelegates::PostLoadMapWithWorld.AddUObject(this, &ThisClass::HandlePostLoadMap);
+		FWorldDelegates::LevelAddedToWorld.AddUObject(this, &ThisClass::HandleLevelAddedToWorld);
+	}
+}
+
+void UWatcherMemorySubsystem::Deinitialize()
+{
+	FTSTicker::GetCoreTicker().RemoveTicker(this->BudgetTickerHandle);
+	FCoreUObjectDelegates::PostLoadMapWithWorld.RemoveAll(this);
+	FWorldDelegates::LevelAddedToWorld.RemoveAll(this);
+	GetGameInstance()->GetTimerManager().ClearTimer(this->CaptureTimer);
+
+	Super::Deinitialize();
+}
+
+void UWatcherMemorySubsystem::CaptureMemReport(const FString& Label)
+{
+	if (!GEngine)
+	{
+		return;
+	}
+
+	const int32 Capture = ++this->CaptureCounts.FindOrAdd(Label);
+	const FString ReportName = FString::Printf(TEXT("%s_Cycle%02d"), *Label, Capture);
+	UE_LOG(LogWatcherMemory, Display, TEXT("Capturing memreport %s"), *ReportName);
+
+	this->LogBudgets();
+	GEngine->Exec(GetGameInstance()->GetWorld(), *FString::Printf(TEXT("MemReport -full NAME=%s"), *ReportName));
+}
+
+void UWatcherMemorySubsystem::LogBudgets() const
+{
+	for (const FWatcherMemoryBudget& Budget : this->Budgets)
+	{
+		const int64 Bytes = GetTagBytes(Budget.TagName);
+		if (Bytes == INDEX_NONE)
+		{
+			UE_LOG(LogWatcherMemory, Display, TEXT("LLM is off, run with -llm for tag sizes"));
+			return;
+		}
+
+		UE_LOG(LogWatcherMemory, Display, TEXT("%-24s %8.2f / %8.2f MB"), *Budget.TagName.ToString(), Bytes / (1024.0 * 1024.0), Budget.BudgetMB);
+	}
+}
+
+bool UWatcherMemorySubsystem::CheckBudgets(float DeltaTime)
+{
+	for (const FWatcherMemoryBudget& Budget : this->Budgets)
+	{
+		const int64 Bytes = GetTagBytes(Budget.TagName);
+		const double MB = Bytes / (1024.0 * 1024.0);
+
+		if (Bytes == INDEX_NONE || MB <= Budget.BudgetMB)
+		{
+			this->OverBudgetTags.Remove(Budget.TagName);
+			continue;
+		}
+
+		bool bAlreadyOver = false;
+		this->OverBudgetTags.Add(Budget.TagName, &bAlreadyOver);
+		if (bAlreadyOver)
+		{
+			continue;
+		}
+
+		if (Budget.bEnsureWhenExceeded)
+		{
+			ensureMsgf(false, TEXT("LLM tag %s is over budget: %.2f / %.2f MB"), *Budget.TagName.ToString(), MB, Budget.BudgetMB);
+		}
+		else
+		{
+			UE_LOG(LogWatcherMemory, Warning, TEXT("LLM tag %s is over budget: %.2f / %.2f MB"), *Budget.TagName.ToString(), MB, Budget.BudgetMB);
+		}
+	}
+
+	return true;
+}
+
+int64 UWatcherMemorySubsystem::GetTagBytes(const FName TagName)
+{
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+	if (FLowLevelMemTracker::IsEnabled())
+	{
+		return FLowLevelMemTracker::Get().GetTagAmountForTracker(ELLMTracker::Default, TagName, ELLMTagSet::None, UE::LLM::ESizeParams::Default);
+	}
+#endif
+	return INDEX_NONE;
+}
+
+void UWatcherMemorySubsystem::HandlePostLoadMap(UWorld* LoadedWorld)
+{
+	if (LoadedWorld && LoadedWorld->GetGameInstance() == GetGameInstance())
+	{
+		this->ScheduleCaptureForMap(FPackageName::GetShortName(LoadedWorld->GetOutermost()->GetName()));
+	}
+}
+
+void UWatcherMemorySubsystem::HandleLevelAddedToWorld(ULevel* Level, UWorld* World)
+{
+	//Streamed sub levels, the lobby and the game content live in those
+	if (Level && World && World->GetGameInstance() == GetGameInstance() && !Level->IsPersistentLevel())
+	{
+		this->ScheduleCaptureForMap(FPackageName::GetShortName(Level->GetOutermost()->GetName()));
+	}
+}
+
+void UWatcherMemorySubsystem::ScheduleCaptureForMap(const FString& MapName)
+{
+	const FMemReportCapturePoint* CapturePoint = this->CapturePoints.FindByPredicate([&MapName](const FMemReportCapturePoint& Candidate)
+	{
+		return MapName.EndsWith(Candidate.MapName);
+	});
+
+	if (!CapturePoint)
+	{
+		return;
+	}
+
+	//Only the latest load matters if several arrive within the delay
+	GetGameInstance()->GetTimerManager().SetTimer(this->CaptureTimer,
+		FTimerDelegate::CreateUObject(this, &ThisClass::CaptureMemReport, CapturePoint->Label), this->MemReportDelay, false);
+}
+
+//Console//
+
+static FAutoConsoleCommandWithWorldAndArgs GWatcherMemoryBudgetsCommand(
+	TEXT("Watcher.Memory.Budgets"),
+	TEXT("Logs the size of every budgeted Watcher LLM tag, needs -llm."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		const UGameInstance* GameInstance = World ? World->GetGameInstance() : nullptr;
+		if (const UWatcherMemorySubsystem* WatcherMemory = GameInstance ? GameInstance->GetSubsystem<UWatcherMemorySubsystem>() : nullptr)
+		{
+			WatcherMemory->LogBudgets();
+		}
+	}));
+
+static FAutoConsoleCommandWithWorldAndArgs GWatcherMemoryReportCommand(
+	TEXT("Watcher.Memory.Report"),
+	TEXT("Writes a labelled memreport. Args: [Label=Manual]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		const UGameInstance* GameInstance = World ? World->GetGameInstance() : nullptr;
+		if (UWatcherMemorySubsystem* WatcherMemory = GameInstance ? GameInstance->GetSubsystem<UWatcherMemorySubsystem>() : nullptr)
+		{
+			WatcherMemory->CaptureMemReport(Args.Num() > 0 ? Args[0] : TEXT("Manual"));
+		}
+	}));
+
+//Console//
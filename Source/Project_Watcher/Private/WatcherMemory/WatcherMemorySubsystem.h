@@ -0,0 +1,135 @@
+//Project Watcher 2024 & Beyond
+
+#pragma once
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "WatcherMemorySubsystem.generated.h"
+
+class ULevel;
+
+//Wrapper for BP data//
+
+/* Upper bound for one LLM tag */
+USTRUCT()
+struct FWatcherMemoryBudget
+{
+	GENERATED_USTRUCT_BODY()
+public:
+	/* LLM tag path, Watcher/Networking etc */
+	UPROPERTY(Config)
+	FName TagName;
+	UPROPERTY(Config)
+	float BudgetMB = 0.f;
+	/* Raise an ensure instead of a warning, for budgets that CI should catch */
+	UPROPERTY(Config)
+	bool bEnsureWhenExceeded = false;
+};
+
+/* A map (persistent or streamed in) that triggers a memreport once it is loaded */
+USTRUCT()
+struct FMemReportCapturePoint
+{
+	GENERATED_USTRUCT_BODY()
+public:
+	/* Short package name of the level, MainMenu_Map etc */
+	UPROPERTY(Config)
+	FString MapName;
+	/* Written into the report name together with how many times it was captured */
+	UPROPERTY(Config)
+	FString Label;
+};
+
+//Wrapper for BP data//
+
+/**
+ * Watches the Watcher LLM tags against the budgets in [/Script/Project_Watcher.WatcherMemorySubsystem]
+ * and writes memreports at the configured points so consecutive session cycles can be diffed for leaks.
+ * Budgets need the tracker, so run with -llm. Capturing is enabled by config or -WatcherMemReports.
+ */
+UCLASS(Config=Game)
+class UWatcherMemorySubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+private:
+	//Settings//
+
+	UPROPERTY(Config)
+	bool bCheckBudgets = true;
+
+	/* Seconds between budget checks */
+	UPROPERTY(Config)
+	float BudgetCheckInterval = 5.f;
+
+	UPROPERTY(Config)
+	TArray<FWatcherMemoryBudget> Budgets;
+
+	UPROPERTY(Config)
+	bool bCaptureMemReports = false;
+
+	/* Seconds to let a freshly loaded map settle before capturing */
+	UPROPERTY(Config)
+	float MemReportDelay = 5.f;
+
+	UPROPERTY(Config)
+	TArray<FMemReportCapturePoint> CapturePoints;
+
+	//Settings//
+
+	FTSTicker::FDelegateHandle BudgetTickerHandle;
+
+	/* Tags currently over budget, so each excursion is only reported once */
+	TSet<FName> OverBudgetTags;
+
+	/* Label -> captures taken so far */
+	TMap<FString, int32> CaptureCounts;
+
+	FTimerHandle CaptureTimer;
+
+public:
+
+	//Initialization//
+
+	UWatcherMemorySubsystem() { }
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	virtual void Deinitialize() override;
+
+	//Initialization//
+
+	//Memory Interface calls//
+
+	/**
+	 * Writes a memreport now
+	 * @param Label Name the report is filed under
+	 */
+	void CaptureMemReport(const FString& Label);
+
+	/* Logs every budgeted tag with its current size */
+	void LogBudgets() const;
+
+	//Memory Interface calls//
+
+private:
+
+	//Memory internals//
+
+	bool CheckBudgets(float DeltaTime);
+
+	/**
+	 * Current size of an LLM tag
+	 * @param TagName LLM tag path
+	 * @return Bytes, INDEX_NONE when the tracker is off
+	 */
+	static int64 GetTagBytes(const FName TagName);
+
+	void HandlePostLoadMap(UWorld* LoadedWorld);
+
+	void HandleLevelAddedToWorld(ULevel* Level, UWorld* World);
+
+	/* Queues a capture if the map is a capture point */
+	void ScheduleCaptureForMap(const FString& MapName);
+
+	//Memory internals//
+};
@@ -0,0 +1,15 @@
+//Project Watcher 2024 & Beyond
+
+#include "WatcherMemoryTags.h"
+#include "Stats/Stats.h"
+
+DECLARE_STATS_GROUP(TEXT("WatcherMemory"), STATGROUP_WatcherMemory, STATCAT_Advanced);
+DECLARE_LLM_MEMORY_STAT(TEXT("Watcher"), STAT_WatcherLLM, STATGROUP_WatcherMemory);
+DECLARE_LLM_MEMORY_STAT(TEXT("Networking"), STAT_WatcherNetworkingLLM, STATGROUP_WatcherMemory);
+DECLARE_LLM_MEMORY_STAT(TEXT("Characters"), STAT_WatcherCharactersLLM, STATGROUP_WatcherMemory);
+DECLARE_LLM_MEMORY_STAT(TEXT("UI"), STAT_WatcherUILLM, STATGROUP_WatcherMemory);
+
+LLM_DEFINE_TAG(Watcher, NAME_None, NAME_None, GET_STATFNAME(STAT_WatcherLLM), NAME_None);
+LLM_DEFINE_TAG(Watcher_Networking, NAME_None, TEXT("Watcher"), GET_STATFNAME(STAT_WatcherNetworkingLLM), NAME_None);
+LLM_DEFINE_TAG(Watcher_Characters, NAME_None, TEXT("Watcher"), GET_STATFNAME(STAT_WatcherCharactersLLM), NAME_None);
+LLM_DEFINE_TAG(Watcher_UI, NAME_None, TEXT("Watcher"), GET_STATFNAME(STAT_WatcherUILLM), NAME_None);
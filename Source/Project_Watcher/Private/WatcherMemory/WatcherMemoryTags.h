@@ -0,0 +1,15 @@
+//Project Watcher 2024 & Beyond
+
+#pragma once
+#include "CoreMinimal.h"
+#include "HAL/LowLevelMemTracker.h"
+
+/**
+ * Low Level Memory tracker tags for memory owned by our own code, visible with -llm and in stat LLMFULL / stat WatcherMemory.
+ * Scope allocations with LLM_SCOPE_BYTAG(Watcher_Networking) etc, the names used by budgets are the display paths
+ * Watcher, Watcher/Networking, Watcher/Characters and Watcher/UI.
+ */
+LLM_DECLARE_TAG(Watcher);
+LLM_DECLARE_TAG(Watcher_Networking);
+LLM_DECLARE_TAG(Watcher_Characters);
+LLM_DECLARE_TAG(Watcher_UI);
@@ -0,0 +1,38 @@
+//Project Watcher 2024 & Beyond
+
+#pragma once
+#include "CoreMinimal.h"
+
+/**
+ * Small sample statistics shared by the benchmark, net tick and matchmaking reports.
+ * Percentiles use the nearest rank method, P = 1 returns the max and an empty set returns 0.
+ */
+namespace WatcherStats
+{
+	/**
+	 * Value below which Fraction of the samples fall
+	 * @param Sorted Samples sorted ascending
+	 * @param Fraction 0..1, 0.95 for p95
+	 */
+	template<typename T>
+	T PercentileSorted(const TArray<T>& Sorted, const double Fraction)
+	{
+		if (Sorted.IsEmpty())
+		{
+			return T(0);
+		}
+		return Sorted[FMath::Clamp(FMath::CeilToInt(Fraction * Sorted.Num()) - 1, 0, Sorted.Num() - 1)];
+	}
+
+	/**
+	 * Value below which Fraction of the samples fall, sorts a copy
+	 * @param Values Samples in any order
+	 * @param Fraction 0..1, 0.95 for p95
+	 */
+	template<typename T>
+	T Percentile(TArray<T> Values, const double Fraction)
+	{
+		Values.Sort();
+		return PercentileSorted(Values, Fraction);
+	}
+}
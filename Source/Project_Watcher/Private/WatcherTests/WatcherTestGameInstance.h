@@ -0,0 +1,64 @@
+//Project Watcher 2024 & Beyond
+
+#pragma once
+#include "CoreMinimal.h"
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/**
+ * Game instance for the automation tests, runs headless on a standalone game instance so no session,
+ * viewport or second process is needed, e.g.
+ * UnrealEditor-Cmd Project_Watcher.uproject -nullrhi -ExecCmds="Automation RunTests Project.Watcher; Quit"
+ * Every game instance subsystem is initialized, the instance and its world are torn down when this goes out of scope.
+ */
+class FWatcherTestGameInstance : public FNoncopyable
+{
+public:
+	FWatcherTestGameInstance()
+	{
+		if (!GEngine)
+		{
+			return;
+		}
+
+		this->GameInstance = NewObject<UGameInstance>(GEngine);
+		this->GameInstance->AddToRoot();
+		this->GameInstance->InitializeStandalone();
+		this->World = this->GameInstance->GetWorld();
+	}
+
+	~FWatcherTestGameInstance()
+	{
+		if (!this->GameInstance)
+		{
+			return;
+		}
+
+		this->GameInstance->Shutdown();
+		if (this->World)
+		{
+			GEngine->DestroyWorldContext(this->World);
+			this->World->DestroyWorld(false);
+		}
+		this->GameInstance->RemoveFromRoot();
+	}
+
+	/* Null when there is no engine to create it with */
+	UGameInstance* Get() const { return this->GameInstance; }
+
+	template<typename T>
+	T* GetSubsystem() const
+	{
+		return this->GameInstance ? this->GameInstance->GetSubsystem<T>() : nullptr;
+	}
+
+private:
+	UGameInstance* GameInstance = nullptr;
+
+	UWorld* World = nullptr;
+};
+
+#endif //WITH_DEV_AUTOMATION_TESTS
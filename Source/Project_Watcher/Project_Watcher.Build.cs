@@ -9,6 +9,8 @@ public class Project_Watcher : ModuleRules
 		PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
 
 		PublicDependencyModuleNames.AddRange(new string[] { "Core", "CoreUObject", "Engine", "InputCore", "EnhancedInput", "OnlineSubsystem", "OnlineSubsystemUtils" });
+		PrivateDependencyModuleNames.AddRange(new string[] { "UMG", "Slate", "SlateCore", "PacketHandler", "Json", "MassEntity", "MassCommon", "AssetRegistry", "HTTP", "HTTPServer", "Sockets" });
+		AddEngineThirdPartyPrivateStaticDependencies(Target, "zlib");
 		DynamicallyLoadedModuleNames.Add("OnlineSubsystemSteam");
     }
 }
@@ -10,14 +10,19 @@
 #include "EnhancedInputComponent.h"
 #include "EnhancedInputSubsystems.h"
 #include "InputActionValue.h"
+#include "WatcherMemory/WatcherMemoryTags.h"
+#include "ProxySmoothing/WatcherCharacterMovementComponent.h"
 
 DEFINE_LOG_CATEGORY(LogTemplateCharacter);
 
 //////////////////////////////////////////////////////////////////////////
 // AProject_WatcherCharacter
 
-AProject_WatcherCharacter::AProject_WatcherCharacter()
+AProject_WatcherCharacter::AProject_WatcherCharacter(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer.SetDefaultSubobjectClass<UWatcherCharacterMovementComponent>(ACharacter::CharacterMovementComponentName))
 {
+	LLM_SCOPE_BYTAG(Watcher_Characters);
+
 	// Set size for collision capsule
 	GetCapsuleComponent()->InitCapsuleSize(42.f, 96.0f);
 		
@@ -56,6 +61,8 @@ AProject_WatcherCharacter::AProject_WatcherCharacter()
 
 void AProject_WatcherCharacter::BeginPlay()
 {
+	LLM_SCOPE_BYTAG(Watcher_Characters);
+
 	// Call the base class  
 	Super::BeginPlay();
 }
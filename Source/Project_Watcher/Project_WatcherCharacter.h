@@ -45,7 +45,7 @@ class AProject_WatcherCharacter : public ACharacter
 	UInputAction* LookAction;
 
 public:
-	AProject_WatcherCharacter();
+	AProject_WatcherCharacter(const FObjectInitializer& ObjectInitializer);
 	
 
 protected: